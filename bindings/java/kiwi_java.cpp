@@ -249,7 +249,7 @@ public:
 	static constexpr std::string_view className = "kr/pe/bab2min/Kiwi$MorphemeSet";
 
 	kiwi::Kiwi* kiwiObj = nullptr;
-	std::unordered_set<const kiwi::Morpheme*> morphSet;
+	kiwi::MorphemeSet morphSet;
 
 	JMorphemeSet(JKiwi* _kiwiObj = nullptr);
 
@@ -258,7 +258,7 @@ public:
 		if (!kiwiObj) return -1;
 		auto found = kiwiObj->findMorpheme(form, tag);
 		int added = 0;
-		for(auto& m : found) added += morphSet.emplace(m).second ? 1 : 0;
+		for(auto& m : found) added += morphSet.insert(m) ? 1 : 0;
 		return added;
 	}
 };
@@ -426,6 +426,7 @@ public:
 JMorphemeSet::JMorphemeSet(JKiwi* _kiwiObj)
 	: kiwiObj{ _kiwiObj }
 {
+	if (kiwiObj) morphSet.reset(*kiwiObj);
 }
 
 JMultipleTokenResult::JMultipleTokenResult(jni::JUniqueGlobalRef<JKiwi>&& _dp,
@@ -0,0 +1,110 @@
+/**
+ * @file AnalysisContext.h
+ * @author bab2min (bab2min@gmail.com)
+ * @brief 형태소 분석에 쓰이는 임시 버퍼를 소유하는 AnalysisContext 클래스를 담고 있는 헤더 파일
+ * @version 0.17.0
+ * @date 2022-09-01
+ *
+ *
+ */
+#pragma once
+
+#include <chrono>
+#include <memory>
+
+namespace kiwi
+{
+	/**
+	 * @brief 한 번의 분석에 허용되는 작업량의 상한.
+	 * @details 상한에 도달하면 경로 탐색은 남은 부분을 노드마다 가장 좋은 경로 하나만 남기는 탐욕적 탐색으로 전환한다.
+	 * 이렇게 얻은 결과는 최적이 아닐 수 있으며, `AnalysisContext::isDegraded()`로 확인할 수 있다.
+	 */
+	struct AnalysisBudget
+	{
+		size_t maxTransitions = 0; /**< 평가할 수 있는 언어 모델 전이의 최대 횟수. 0이면 제한하지 않는다. */
+		std::chrono::microseconds timeLimit{ 0 }; /**< 분석에 쓸 수 있는 최대 시간. 0이면 제한하지 않는다. */
+
+		AnalysisBudget(size_t _maxTransitions = 0, std::chrono::microseconds _timeLimit = std::chrono::microseconds{ 0 })
+			: maxTransitions{ _maxTransitions }, timeLimit{ _timeLimit }
+		{
+		}
+
+		bool unlimited() const
+		{
+			return !maxTransitions && !timeLimit.count();
+		}
+	};
+
+	/**
+	 * @brief 형태소 분석 중에 쓰이는 임시 버퍼들(정규화된 문자열, 형태 그래프, 경로 탐색용 해시맵 등)을 소유하는 객체.
+	 *
+	 * @details 같은 AnalysisContext를 여러 번의 `kiwi::Kiwi::analyze()` 호출에 넘기면 한 번 확보한 버퍼를 재사용한다.
+	 * 분석이 끝났을 때 보유한 버퍼의 크기가 high-water mark를 넘으면 버퍼를 모두 해제하므로,
+	 * 한 번 매우 긴 문서를 분석하더라도 그 최대 크기만큼의 메모리를 계속 붙잡고 있지 않는다.
+	 * AnalysisContext를 받지 않는 기존 `analyze()`는 스레드마다 하나씩 있는 기본 AnalysisContext를 사용한다.
+	 *
+	 * @note 하나의 AnalysisContext는 한 번에 하나의 분석에만 쓸 수 있다.
+	 * 여러 스레드에서 동시에 분석하려면 스레드마다 별도의 AnalysisContext를 사용해야 한다.
+	 * 청크 단위 병렬 탐색 등으로 스레드 풀에서 수행되는 작업은 각 작업 스레드의 기본 AnalysisContext를 사용한다.
+	 */
+	class AnalysisContext
+	{
+	public:
+		class Impl;
+
+		static constexpr size_t defaultHighWaterMark = 16 * 1024 * 1024;
+
+		/**
+		 * @param highWaterMark 분석이 끝난 뒤 이 크기(바이트)를 넘는 버퍼는 해제한다. 0이면 매번 해제한다.
+		 */
+		explicit AnalysisContext(size_t highWaterMark = defaultHighWaterMark);
+		~AnalysisContext();
+
+		AnalysisContext(const AnalysisContext&) = delete;
+		AnalysisContext& operator=(const AnalysisContext&) = delete;
+		AnalysisContext(AnalysisContext&&) noexcept;
+		AnalysisContext& operator=(AnalysisContext&&) noexcept;
+
+		size_t getHighWaterMark() const;
+		void setHighWaterMark(size_t highWaterMark);
+
+		/**
+		 * @brief 현재 보유하고 있는 버퍼들의 대략적인 크기(바이트)
+		 */
+		size_t memoryUsage() const;
+
+		/**
+		 * @brief high-water mark를 넘어서 버퍼를 해제한 횟수
+		 */
+		size_t shrinkCount() const;
+
+		/**
+		 * @brief 보유한 버퍼를 모두 해제한다. 분석이 진행 중인 동안에는 호출할 수 없다.
+		 */
+		void shrink();
+
+		const AnalysisBudget& getBudget() const;
+
+		/**
+		 * @brief 이 컨텍스트로 수행하는 분석마다 적용할 작업량 상한을 설정한다.
+		 * @note 상한이 설정된 분석은 청크 단위 병렬 탐색(`kiwi::Kiwi::setParallelChunks()`)을 쓰지 않고 호출한 스레드에서 순서대로 탐색하므로, 
+		 * 상한과 `isDegraded()`는 분석 전체에 대해 정확하게 적용된다.
+		 */
+		void setBudget(const AnalysisBudget& budget);
+
+		/**
+		 * @brief 가장 최근의 분석이 작업량 상한에 도달하여 탐욕적 탐색으로 전환되었는지 여부
+		 */
+		bool isDegraded() const;
+
+		/**
+		 * @brief 가장 최근의 분석에서 평가한 언어 모델 전이의 횟수
+		 */
+		size_t usedTransitions() const;
+
+		Impl& impl() const { return *pimpl; }
+
+	private:
+		std::unique_ptr<Impl> pimpl;
+	};
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <memory>
+#include <kiwi/FrozenTrie.h>
+
+namespace kiwi
+{
+	namespace utils
+	{
+		/**
+		 * @brief base/check 두 배열로 자식 노드를 찾는 Aho-Corasick 트라이.
+		 *
+		 * @details `FrozenTrie`와 같은 `nextOpt`/`fail`/`val` 인터페이스를 제공하므로 같은 탐색 코드에 그대로 쓸 수 있다.
+		 * 키는 등장 빈도 순으로 1부터 시작하는 조밀한 코드로 바뀌어 저장되며,
+		 * 자식 노드는 `nodes[base + code]`에 위치하고 그 노드의 `check`가 부모 노드의 위치와 같을 때만 유효하다.
+		 * 따라서 한 번의 전이는 코드표와 노드 배열을 한 번씩 읽는 것으로 끝나고, 자식 수에 따른 탐색이 필요 없다.
+		 *
+		 * 루트에서 도달할 수 없는 앞쪽 노드(`ContinuousTrie`에서 루트 뒤에 미리 예약해둔 노드들)는
+		 * 원래 인덱스와 같은 위치에 배치되므로 `value(idx)`로 그대로 접근할 수 있다.
+		 */
+		template<class _Key, class _Value, class _HasSubmatch = detail::HasSubmatch<_Value>>
+		class DoubleArrayTrie : public _HasSubmatch
+		{
+			static_assert(sizeof(_Key) <= 2, "DoubleArrayTrie supports only 8 or 16-bit keys.");
+		public:
+			using Key = _Key;
+			using Value = _Value;
+			using Code = uint16_t;
+
+			static constexpr uint32_t npos = (uint32_t)-1;
+
+			struct Node
+			{
+				uint32_t base = 0;
+				uint32_t check = npos;
+				int32_t lower = 0;
+
+				template<ArchType arch>
+				const Node* nextOpt(const DoubleArrayTrie& dat, Key c) const;
+
+				template<ArchType arch>
+				const Node* findFail(const DoubleArrayTrie& dat, Key c) const;
+
+				const Node* fail() const;
+				const Value& val(const DoubleArrayTrie& dat) const;
+			};
+		private:
+			size_t numSlots = 0;
+			size_t numCodes = 0;
+			std::unique_ptr<Node[]> nodes;
+			std::unique_ptr<Value[]> values;
+			std::unique_ptr<Code[]> codes;
+
+			static constexpr size_t codeTableSize = (size_t)1 << (sizeof(Key) * 8);
+
+		public:
+			DoubleArrayTrie() = default;
+
+			template<class TrieNode, class Xform = detail::NodeToVal>
+			DoubleArrayTrie(const ContinuousTrie<TrieNode>& trie, Xform xform = {});
+
+			DoubleArrayTrie(const DoubleArrayTrie& o);
+			DoubleArrayTrie(DoubleArrayTrie&&) noexcept = default;
+
+			DoubleArrayTrie& operator=(const DoubleArrayTrie& o);
+			DoubleArrayTrie& operator=(DoubleArrayTrie&& o) noexcept = default;
+
+			bool empty() const { return !numSlots; }
+
+			/**
+			 * @brief 빈 칸을 포함한 노드 배열의 크기
+			 */
+			size_t size() const { return numSlots; }
+			const Node* root() const { return nodes.get(); }
+
+			const Value& value(size_t idx) const { return values[idx]; };
+
+			bool hasMatch(_Value v) const { return !this->isNull(v) && !this->hasSubmatch(v); }
+
+			/**
+			 * @brief 트라이를 스트림에 기록한다.
+			 * 
+			 * @param toIdx 값을 정수 인덱스로 바꾸는 함수
+			 */
+			template<class ToIdx>
+			void writeTo(std::ostream& ostr, ToIdx&& toIdx) const;
+
+			/**
+			 * @brief `writeTo()`로 기록된 트라이를 읽어들인다. 노드 배치를 다시 계산하지 않고 배열을 그대로 읽는다.
+			 * 
+			 * @param fromIdx 저장된 정수 인덱스를 값으로 복원하는 함수
+			 */
+			template<class FromIdx>
+			static DoubleArrayTrie readFrom(std::istream& istr, FromIdx&& fromIdx);
+
+			/**
+			 * @brief 노드 배열, 값 배열, 코드표가 차지하는 메모리의 크기(바이트)
+			 */
+			size_t memoryUsage() const
+			{
+				return numSlots * (sizeof(Node) + sizeof(Value)) + (numSlots ? codeTableSize * sizeof(Code) : 0);
+			}
+		};
+	}
+}
@@ -145,6 +145,7 @@ namespace kiwi
 		bool complex : 1;
 		uint8_t senseId = 0;
 		uint8_t combineSocket = 0;
+		uint16_t leftCondMask = 0; /**< 이 형태소가 좌측에 올 때 만족되는 결합조건들의 비트 마스크. `FeatureTestor::leftContextMask` 참조 */
 		int32_t combined = 0;
 		FixedPairVector<const Morpheme*, std::pair<uint8_t, uint8_t>> chunks;
 		float userScore = 0;
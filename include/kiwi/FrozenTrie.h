@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include <array>
+#include <iosfwd>
 #include <vector>
 #include <deque>
 #include <memory>
@@ -8,6 +9,7 @@
 #include <numeric>
 #include <kiwi/ArchUtils.h>
 #include <kiwi/Trie.hpp>
+#include <kiwi/Mmap.h>
 
 namespace kiwi
 {
@@ -92,10 +94,23 @@ namespace kiwi
 		private:
 			size_t numNodes = 0;
 			size_t numNexts = 0;
-			std::unique_ptr<Node[]> nodes;
-			std::unique_ptr<Value[]> values;
-			std::unique_ptr<Key[]> nextKeys;
-			std::unique_ptr<Diff[]> nextDiffs;
+			const Node* nodes = nullptr;
+			const Value* values = nullptr;
+			const Key* nextKeys = nullptr;
+			const Diff* nextDiffs = nullptr;
+
+			// 트라이가 직접 소유하는 배열. 메모리 위의 뷰로 생성된 경우 값 배열만 소유하거나 아무것도 소유하지 않는다.
+			std::unique_ptr<Node[]> ownedNodes;
+			std::unique_ptr<Value[]> ownedValues;
+			std::unique_ptr<Key[]> ownedNextKeys;
+			std::unique_ptr<Diff[]> ownedNextDiffs;
+			// 뷰로 생성된 경우, 배열들이 가리키는 메모리가 트라이보다 먼저 해제되지 않도록 붙잡아둔다.
+			std::unique_ptr<MemoryObject> memory;
+
+			void allocate(size_t _numNodes, size_t _numNexts);
+
+			template<class Ty>
+			static const Ty* mapArray(imstream& istr, const MemoryObject& mem, size_t size);
 
 		public:
 
@@ -112,11 +127,68 @@ namespace kiwi
 
 			bool empty() const { return !numNodes; }
 			size_t size() const { return numNodes; }
-			const Node* root() const { return nodes.get(); }
+			const Node* root() const { return nodes; }
+
+			/**
+			 * @brief 트라이가 메모리 위의 뷰로 생성되어 노드 배열을 소유하지 않는지 여부
+			 */
+			bool isView() const { return !!memory; }
 
 			const Value& value(size_t idx) const { return values[idx]; };
 
 			bool hasMatch(_Value v) const { return !this->isNull(v) && !this->hasSubmatch(v); }
+
+			/**
+			 * @brief 노드 배열, 값 배열, 자식 키 배열이 차지하는 메모리의 크기(바이트)
+			 */
+			size_t memoryUsage() const
+			{
+				return numNodes * (sizeof(Node) + sizeof(Value)) + numNexts * (sizeof(Key) + sizeof(Diff));
+			}
+
+			/**
+			 * @brief 트라이의 내부 배열을 스트림에 기록한다.
+			 * 
+			 * @param toIdx 각 값을 정수 인덱스로 변환하는 함수. 값은 포인터 대신 인덱스로 저장된다.
+			 * @note 자식 노드의 키는 트라이 생성 당시의 아키텍처에 맞춰 재배열되어 있으므로, 
+			 * 읽어들일 때에도 같은 아키텍처를 사용해야 한다.
+			 * 각 배열은 스트림 위치 기준으로 8바이트 경계에 정렬되어 기록되므로, 
+			 * 스트림 처음부터 기록한 파일을 메모리에 매핑하면 `mapFrom()`으로 복사 없이 사용할 수 있다.
+			 */
+			template<class ToIdx>
+			void writeTo(std::ostream& ostr, ToIdx&& toIdx) const;
+
+			/**
+			 * @brief 정수 값을 갖는 트라이를 스트림에 기록한다. 값 `v`는 인덱스 `v - 1`로 저장된다.
+			 */
+			void writeTo(std::ostream& ostr) const;
+
+			/**
+			 * @brief `writeTo()`로 기록된 트라이를 읽어들인다.
+			 * 
+			 * @param fromIdx 저장된 정수 인덱스를 값으로 복원하는 함수
+			 */
+			template<class FromIdx>
+			static FrozenTrie readFrom(std::istream& istr, FromIdx&& fromIdx);
+
+			/**
+			 * @brief `writeTo()`로 기록된 트라이를 복사 없이 `mem` 위의 뷰로 생성한다.
+			 * 
+			 * @param istr `mem`을 읽고 있는 스트림. 트라이가 시작하는 위치에 있어야 하며, 트라이의 끝으로 이동한다.
+			 * @param mem 트라이가 기록된 메모리. 생성된 트라이가 이 메모리의 소유권을 공유한다.
+			 * @param fromIdx 저장된 정수 인덱스를 값으로 복원하는 함수
+			 * @note 노드 배열과 자식 키 배열은 `mem`을 직접 가리키므로 여러 프로세스가 같은 파일을 매핑하면 그 페이지를 공유한다.
+			 * 값 배열은 인덱스를 값으로 복원하여 따로 만든다.
+			 */
+			template<class FromIdx>
+			static FrozenTrie mapFrom(imstream& istr, const MemoryObject& mem, FromIdx&& fromIdx);
+
+			/**
+			 * @brief 정수 값을 갖는 트라이를 복사 없이 `mem` 위의 뷰로 생성한다. 값 배열까지 `mem`을 직접 가리키므로 O(1)에 생성된다.
+			 * 
+			 * @note `writeTo(std::ostream&)`로 기록된 트라이에만 사용할 수 있다.
+			 */
+			static FrozenTrie mapFrom(imstream& istr, const MemoryObject& mem);
 		};
 	}
 }
@@ -11,6 +11,7 @@
 
 #include <iostream>
 #include <future>
+#include <functional>
 #include <string>
 #include "Macro.h"
 #include "Types.h"
@@ -20,6 +21,7 @@
 #include "Trie.hpp"
 #include "PatternMatcher.h"
 #include "FrozenTrie.h"
+#include "DoubleArrayTrie.h"
 #include "Knlm.h"
 #include "SkipBigramModel.h"
 #include "ThreadPool.h"
@@ -28,6 +30,8 @@
 #include "LmState.h"
 #include "Joiner.h"
 #include "TypoTransformer.h"
+#include "AnalysisContext.h"
+#include "MorphemeSet.h"
 
 namespace kiwi
 {
@@ -36,6 +40,9 @@ namespace kiwi
 	struct KGraphNode;
 	struct WordInfo;
 	class HSDataset;
+	class ResultCache;
+	class ChunkMemo;
+	struct LmMemoCounters;
 
 	namespace cmb
 	{ 
@@ -63,6 +70,8 @@ namespace kiwi
 		template<template<ArchType> class LmState> friend struct NewAutoJoinerGetter;
 
 		bool integrateAllomorph = true;
+		bool parallelChunks = false;
+		bool dedicatedTop1 = true;
 		float cutOffThreshold = 8;
 		float unkFormScoreScale = 5;
 		float unkFormScoreBias = 5;
@@ -71,6 +80,7 @@ namespace kiwi
 		float continualTypoCost = INFINITY;
 		size_t maxUnkFormSize = 6;
 		size_t spaceTolerance = 0;
+		BeamOptions beamOptions;
 
 		TagSequenceScorer tagScorer;
 
@@ -80,12 +90,23 @@ namespace kiwi
 		Vector<size_t> typoPtrs;
 		Vector<TypoForm> typoForms;
 		utils::FrozenTrie<kchar_t, const Form*> formTrie;
+		utils::DoubleArrayTrie<kchar_t, const Form*> formDATrie;
 		LangModel langMdl;
 		std::shared_ptr<cmb::CompiledRule> combiningRule;
 		std::unique_ptr<utils::ThreadPool> pool;
+		std::unique_ptr<ResultCache> resultCache;
+		std::unique_ptr<ChunkMemo> chunkMemo;
+		std::unique_ptr<LmMemoCounters> lmMemoCounters;
 		
 		inline const Morpheme* getDefaultMorpheme(POSTag tag) const;
 
+		void invalidateResultCache();
+
+		/**
+		 * @brief 캐시의 키로 쓰기 위해 blocklist에 속한 형태소의 id를 오름차순으로 `out`에 채운다.
+		 */
+		void getBlocklistKey(Blocklist blocklist, std::vector<uint32_t>& out) const;
+
 		template<class LmState>
 		cmb::AutoJoiner newJoinerImpl() const
 		{
@@ -94,7 +115,12 @@ namespace kiwi
 
 		ArchType selectedArch = ArchType::none;
 		void* dfSplitByTrie = nullptr;
+		void* dfSplitByDATrie = nullptr;
 		void* dfFindForm = nullptr;
+		void* dfNormalizeHangul = nullptr;
+		void* dfGetWordPositions = nullptr;
+		void* dfNormalizeCoda = nullptr;
+		void* dfNormalizeUtf8 = nullptr;
 		void* dfFindBestPath = nullptr;
 	
 	public:
@@ -117,8 +143,46 @@ namespace kiwi
 		template<class Str, class Pretokenized, class ...Rest>
 		auto _asyncAnalyzeEcho(Str&& str, Pretokenized&& pt, Rest&&... args) const;
 
+		template<class Str>
+		void _analyzeBatch(const Str* first, const Str* last, TokenResult* out, Match matchOptions,
+			Blocklist blocklist) const;
+
 		static std::vector<PretokenizedSpan> mapPretokenizedSpansToU16(const std::vector<PretokenizedSpan>& orig, const std::vector<size_t>& bytePositions);
 
+		/**
+		 * @brief 청크 경계 단위로 분석을 이어가기 위한 상태. StreamAnalyzer에서 사용한다.
+		 */
+		struct ChunkResume
+		{
+			uint8_t spState = 0; /**< 직전에 확정된 청크가 끝난 뒤의 SpecialState */
+			size_t stableEnd = 0; /**< 이번 분석에서 확정된 마지막 청크의 끝 위치(입력 문자열 기준) */
+			bool final = false; /**< true인 경우 문자열 끝에 닿는 마지막 청크까지 모두 확정한다 */
+		};
+
+		template<class Result>
+		void analyzeNormalized(KString& normalizedStr,
+			const Vector<uint32_t>& positionTable,
+			const Vector<uint16_t>& wordPositions,
+			const std::vector<size_t>& newlines,
+			size_t topN, Match matchOptions,
+			Blocklist blocklist,
+			const std::vector<PretokenizedSpan>& pretokenized,
+			std::vector<Result>& ret,
+			ChunkResume* resume = nullptr
+		) const;
+
+		void analyzeInto(AnalysisContext& context, const std::u16string& str, size_t topN, Match matchOptions,
+			Blocklist blocklist,
+			const std::vector<PretokenizedSpan>& pretokenized,
+			std::vector<TokenResult>& ret
+		) const;
+
+		void analyzeResumable(const std::u16string& str, Match matchOptions,
+			Blocklist blocklist,
+			ChunkResume& resume,
+			std::vector<TokenResult>& ret
+		) const;
+
 	public:
 
 		/**
@@ -151,6 +215,13 @@ namespace kiwi
 
 		ArchType archType() const { return selectedArch; }
 
+		/**
+		 * @brief 입력을 형태 후보로 분할할 때 사용하는 트라이의 구현을 알려준다.
+		 * 
+		 * @note `TrieBackend::doubleArray`인 경우에도 결합 및 사전 조회에는 기본 트라이를 함께 사용한다.
+		 */
+		TrieBackend trieBackend() const { return formDATrie.empty() ? TrieBackend::frozen : TrieBackend::doubleArray; }
+
 		/**
 		 * @brief 현재 Kiwi 객체가 오타 교정 기능이 켜진 상태로 생성되었는지 알려준다.
 		 * 
@@ -158,6 +229,34 @@ namespace kiwi
 		 */
 		bool isTypoTolerant() const { return !typoForms.empty(); }
 
+		/**
+		 * @brief 현재 Kiwi 객체의 형태, 형태소, 오타 정보, 형태 트라이, 결합 규칙 및 언어 모델을 하나의 이미지로 저장한다.
+		 * 
+		 * `TrieBackend::doubleArray`로 생성된 경우 이중 배열 트라이도 함께 저장되며, 
+		 * 분석 옵션과 `setDedicatedTop1`, `setBeamOptions`, `setParallelChunks`, `setLmTransitionMemo`, 
+		 * `setResultCacheSize`, `setChunkMemo`로 설정한 값도 보존된다. 스레드 수는 `loadImage()`에서 새로 지정하며, 캐시에 쌓인 내용은 저장되지 않는다.
+		 * 
+		 * @param path 저장할 파일 경로
+		 * @sa kiwi::Kiwi::loadImage
+		 */
+		void save(const std::string& path) const;
+		void save(std::ostream& ostr) const;
+
+		/**
+		 * @brief `kiwi::Kiwi::save()`로 저장된 이미지를 mmap으로 열어 Kiwi 객체를 생성한다.
+		 * 
+		 * @param path 이미지 파일 경로
+		 * @param numThreads 형태소 분석에 사용할 스레드 개수. 0이면 스레드 풀을 생성하지 않는다.
+		 * @return 형태소 분석 준비가 완료된 Kiwi 객체
+		 * 
+		 * @note `kiwi::KiwiBuilder::build()`의 결합 형태소 생성, 오타 후보 생성, 트라이 구축 과정을 모두 생략한다.
+		 * 이미지는 저장 당시의 아키텍처에 맞춰져 있으므로, 해당 아키텍처를 지원하지 않는 환경에서는 예외가 발생한다.
+		 * 언어 모델과 형태/형태소 레코드는 이미지를 그대로 가리키지만, 형태와 형태소 객체는 서로를 포인터로 참조하므로 
+		 * 불러올 때 레코드로부터 문자열과 후보 목록을 힙에 복사하여 다시 구성한다. 따라서 생성 시간과 메모리 사용량이 형태 및 형태소 개수에 비례한다.
+		 * 레코드가 풀이나 배열의 범위를 벗어나는 손상된 이미지에 대해서는 `FormatException`이 발생한다.
+		 */
+		static Kiwi loadImage(const std::string& path, size_t numThreads = 0);
+
 		/**
 		 * @brief 
 		 * 
@@ -166,11 +265,11 @@ namespace kiwi
 		 * @return TokenResult 
 		 */
 		TokenResult analyze(const std::u16string& str, Match matchOptions, 
-			const std::unordered_set<const Morpheme*>* blocklist = nullptr,
+			Blocklist blocklist = nullptr,
 			const std::vector<PretokenizedSpan>& pretokenized = {}
 		) const
 		{
-			return analyze(str, 1, matchOptions, blocklist, pretokenized)[0];
+			return std::move(analyze(str, 1, matchOptions, blocklist, pretokenized)[0]);
 		}
 
 		/**
@@ -181,7 +280,7 @@ namespace kiwi
 		 * @return TokenResult 
 		 */
 		TokenResult analyze(const std::string& str, Match matchOptions, 
-			const std::unordered_set<const Morpheme*>* blocklist = nullptr,
+			Blocklist blocklist = nullptr,
 			const std::vector<PretokenizedSpan>& pretokenized = {}
 		) const
 		{
@@ -190,6 +289,43 @@ namespace kiwi
 			return analyze(u16str, matchOptions, blocklist, mapPretokenizedSpansToU16(pretokenized, bytePositions));
 		}
 
+		/**
+		 * @brief 분석 결과를 열 단위 구조체 `out`에 채운다.
+		 * 
+		 * 탐색된 경로에서 `out`의 각 열로 바로 옮기므로 형태소마다 `TokenInfo`나 문자열을 따로 만들지 않는다.
+		 * 단, 분석 결과 캐시가 켜져 있는 경우에는 캐시를 공유하기 위해 `TokenResult`를 거쳐서 채운다.
+		 * 
+		 * @param str 분석할 문자열
+		 * @param out 결과를 저장할 객체. 기존 내용은 지워지며, 할당된 메모리는 재사용된다.
+		 * @param matchOptions 
+		 * @param blocklist 
+		 * @param pretokenized 
+		 * @param fillUtf8 true인 경우 `out.u8StrPool`과 `out.u8StrOffsets`도 채운다.
+		 */
+		void analyze(const std::u16string& str, TokenResultColumns& out, Match matchOptions,
+			Blocklist blocklist = nullptr,
+			const std::vector<PretokenizedSpan>& pretokenized = {},
+			bool fillUtf8 = false
+		) const;
+
+		/**
+		 * @brief UTF-8 문자열을 UTF-16으로 변환하지 않고 분석하여 결과를 열 단위 구조체 `out`에 채운다.
+		 * 
+		 * 복호화와 한글 정규화를 한 번의 순회로 수행하며, `out`의 위치와 길이는 모두 바이트 단위로 채워진다.
+		 * 형태는 `out.u8StrPool`과 `out.u8StrOffsets`에만 저장되고 `out.strPool`은 비어 있다.
+		 * 단, 분석 결과 캐시가 켜져 있는 경우에는 캐시를 공유하기 위해 UTF-16으로 변환한 뒤 `TokenResult`를 거쳐서 채운다.
+		 * 
+		 * @param str 분석할 UTF-8 문자열
+		 * @param out 결과를 저장할 객체. 기존 내용은 지워지며, 할당된 메모리는 재사용된다.
+		 * @param matchOptions 
+		 * @param blocklist 
+		 * @param pretokenized 바이트 단위로 범위가 지정된 사전 분석 구간
+		 */
+		void analyze(const std::string& str, TokenResultColumns& out, Match matchOptions,
+			Blocklist blocklist = nullptr,
+			const std::vector<PretokenizedSpan>& pretokenized = {}
+		) const;
+
 		/**
 		 * @brief 
 		 * 
@@ -199,7 +335,7 @@ namespace kiwi
 		 * @return std::vector<TokenResult> 
 		 */
 		std::vector<TokenResult> analyze(const std::u16string& str, size_t topN, Match matchOptions, 
-			const std::unordered_set<const Morpheme*>* blocklist = nullptr,
+			Blocklist blocklist = nullptr,
 			const std::vector<PretokenizedSpan>& pretokenized = {}
 		) const;
 
@@ -212,7 +348,7 @@ namespace kiwi
 		 * @return std::vector<TokenResult> 
 		 */
 		std::vector<TokenResult> analyze(const std::string& str, size_t topN, Match matchOptions, 
-			const std::unordered_set<const Morpheme*>* blocklist = nullptr,
+			Blocklist blocklist = nullptr,
 			const std::vector<PretokenizedSpan>& pretokenized = {}) const
 		{
 			std::vector<size_t> bytePositions;
@@ -220,6 +356,59 @@ namespace kiwi
 			return analyze(u16str, topN, matchOptions, blocklist, mapPretokenizedSpansToU16(pretokenized, bytePositions));
 		}
 
+		/**
+		 * @brief 주어진 AnalysisContext의 버퍼를 사용하여 분석한다.
+		 * 
+		 * @param context 분석 중에 쓰일 임시 버퍼를 가진 객체. 분석이 끝난 뒤 버퍼는 다음 호출을 위해 남겨두거나,
+		 * high-water mark를 넘은 경우 해제된다.
+		 * @param str 
+		 * @param topN 
+		 * @param matchOptions 
+		 * @return std::vector<TokenResult> 
+		 * 
+		 * @sa kiwi::AnalysisContext
+		 */
+		std::vector<TokenResult> analyze(AnalysisContext& context, const std::u16string& str, size_t topN, Match matchOptions, 
+			Blocklist blocklist = nullptr,
+			const std::vector<PretokenizedSpan>& pretokenized = {}
+		) const;
+
+		std::vector<TokenResult> analyze(AnalysisContext& context, const std::string& str, size_t topN, Match matchOptions, 
+			Blocklist blocklist = nullptr,
+			const std::vector<PretokenizedSpan>& pretokenized = {}) const
+		{
+			std::vector<size_t> bytePositions;
+			auto u16str = utf8To16(str, bytePositions);
+			return analyze(context, u16str, topN, matchOptions, blocklist, mapPretokenizedSpansToU16(pretokenized, bytePositions));
+		}
+
+		TokenResult analyze(AnalysisContext& context, const std::u16string& str, Match matchOptions, 
+			Blocklist blocklist = nullptr,
+			const std::vector<PretokenizedSpan>& pretokenized = {}
+		) const
+		{
+			return std::move(analyze(context, str, 1, matchOptions, blocklist, pretokenized)[0]);
+		}
+
+		TokenResult analyze(AnalysisContext& context, const std::string& str, Match matchOptions, 
+			Blocklist blocklist = nullptr,
+			const std::vector<PretokenizedSpan>& pretokenized = {}
+		) const
+		{
+			return std::move(analyze(context, str, 1, matchOptions, blocklist, pretokenized)[0]);
+		}
+
+		void analyze(AnalysisContext& context, const std::u16string& str, TokenResultColumns& out, Match matchOptions,
+			Blocklist blocklist = nullptr,
+			const std::vector<PretokenizedSpan>& pretokenized = {},
+			bool fillUtf8 = false
+		) const;
+
+		void analyze(AnalysisContext& context, const std::string& str, TokenResultColumns& out, Match matchOptions,
+			Blocklist blocklist = nullptr,
+			const std::vector<PretokenizedSpan>& pretokenized = {}
+		) const;
+
 		/**
 		 * @brief 
 		 * 
@@ -229,49 +418,88 @@ namespace kiwi
 		 * @return std::future<std::vector<TokenResult>> 
 		 */
 		std::future<std::vector<TokenResult>> asyncAnalyze(const std::string& str, size_t topN, Match matchOptions, 
-			const std::unordered_set<const Morpheme*>* blocklist = nullptr,
+			Blocklist blocklist = nullptr,
 			const std::vector<PretokenizedSpan>& pretokenized = {}
 		) const;
 		std::future<std::vector<TokenResult>> asyncAnalyze(std::string&& str, size_t topN, Match matchOptions, 
-			const std::unordered_set<const Morpheme*>* blocklist = nullptr,
+			Blocklist blocklist = nullptr,
 			std::vector<PretokenizedSpan>&& pretokenized = {}
 		) const;
 
 		std::future<TokenResult> asyncAnalyze(const std::string& str, Match matchOptions, 
-			const std::unordered_set<const Morpheme*>* blocklist = nullptr,
+			Blocklist blocklist = nullptr,
 			const std::vector<PretokenizedSpan>& pretokenized = {}
 		) const;
 		std::future<TokenResult> asyncAnalyze(std::string&& str, Match matchOptions, 
-			const std::unordered_set<const Morpheme*>* blocklist = nullptr,
+			Blocklist blocklist = nullptr,
 			std::vector<PretokenizedSpan>&& pretokenized = {}
 		) const;
 		std::future<std::pair<TokenResult, std::string>> asyncAnalyzeEcho(std::string&& str, Match matchOptions, 
-			const std::unordered_set<const Morpheme*>* blocklist = nullptr,
+			Blocklist blocklist = nullptr,
 			std::vector<PretokenizedSpan>&& pretokenized = {}
 		) const;
 
 		std::future<std::vector<TokenResult>> asyncAnalyze(const std::u16string& str, size_t topN, Match matchOptions, 
-			const std::unordered_set<const Morpheme*>* blocklist = nullptr,
+			Blocklist blocklist = nullptr,
 			const std::vector<PretokenizedSpan>& pretokenized = {}
 		) const;
 		std::future<std::vector<TokenResult>> asyncAnalyze(std::u16string&& str, size_t topN, Match matchOptions, 
-			const std::unordered_set<const Morpheme*>* blocklist = nullptr,
+			Blocklist blocklist = nullptr,
 			std::vector<PretokenizedSpan>&& pretokenized = {}
 		) const;
 
 		std::future<TokenResult> asyncAnalyze(const std::u16string& str, Match matchOptions, 
-			const std::unordered_set<const Morpheme*>* blocklist = nullptr,
+			Blocklist blocklist = nullptr,
 			const std::vector<PretokenizedSpan>& pretokenized = {}
 		) const;
 		std::future<TokenResult> asyncAnalyze(std::u16string&& str, Match matchOptions, 
-			const std::unordered_set<const Morpheme*>* blocklist = nullptr,
+			Blocklist blocklist = nullptr,
 			std::vector<PretokenizedSpan>&& pretokenized = {}
 		) const;
 		std::future<std::pair<TokenResult, std::u16string>> asyncAnalyzeEcho(std::u16string&& str, Match matchOptions, 
-			const std::unordered_set<const Morpheme*>* blocklist = nullptr,
+			Blocklist blocklist = nullptr,
 			std::vector<PretokenizedSpan>&& pretokenized = {}
 		) const;
 
+		/**
+		 * @brief 여러 개의 문서를 한꺼번에 분석하여 미리 할당된 `out`에 결과를 채운다.
+		 * 
+		 * 스레드 풀이 있는 경우 입력을 워커 수만큼의 연속된 구간으로 나누어 각 워커가 한 구간씩 처리하므로,
+		 * 문서마다 작업과 future를 생성하는 `asyncAnalyze`에 비해 짧은 문서를 대량으로 분석할 때 부하가 적다.
+		 * 각 워커는 분석에 필요한 임시 버퍼를 문서 간에 재사용한다.
+		 * 
+		 * @param first, last 분석할 문서의 범위
+		 * @param out `last - first`개 이상의 원소를 담을 수 있는 결과 배열. i번째 문서의 결과는 `out[i]`에 저장된다.
+		 * @param matchOptions 
+		 * @param blocklist 
+		 * @note 스레드 풀의 작업 안에서 호출된 경우에는 같은 풀에 작업을 넣고 기다리지 않도록 현재 스레드에서 순서대로 분석한다.
+		 */
+		void analyzeBatch(const std::u16string* first, const std::u16string* last, TokenResult* out, Match matchOptions,
+			Blocklist blocklist = nullptr
+		) const;
+
+		void analyzeBatch(const std::string* first, const std::string* last, TokenResult* out, Match matchOptions,
+			Blocklist blocklist = nullptr
+		) const;
+
+		std::vector<TokenResult> analyzeBatch(const std::vector<std::u16string>& strs, Match matchOptions,
+			Blocklist blocklist = nullptr
+		) const
+		{
+			std::vector<TokenResult> ret(strs.size());
+			analyzeBatch(strs.data(), strs.data() + strs.size(), ret.data(), matchOptions, blocklist);
+			return ret;
+		}
+
+		std::vector<TokenResult> analyzeBatch(const std::vector<std::string>& strs, Match matchOptions,
+			Blocklist blocklist = nullptr
+		) const
+		{
+			std::vector<TokenResult> ret(strs.size());
+			analyzeBatch(strs.data(), strs.data() + strs.size(), ret.data(), matchOptions, blocklist);
+			return ret;
+		}
+
 		/**
 		 * @brief 
 		 * 
@@ -284,7 +512,7 @@ namespace kiwi
 		 */
 		template<class ReaderCallback, class ResultCallback>
 		void analyze(size_t topN, ReaderCallback&& reader, ResultCallback&& resultCallback, Match matchOptions, 
-			const std::unordered_set<const Morpheme*>* blocklist = nullptr
+			Blocklist blocklist = nullptr
 		) const
 		{
 			if (pool)
@@ -433,6 +661,7 @@ namespace kiwi
 		{
 			if (v < 0) throw std::invalid_argument{ "`v` must >= 0" };
 			cutOffThreshold = v;
+			invalidateResultCache();
 		}
 
 		float getUnkScoreBias() const
@@ -444,6 +673,7 @@ namespace kiwi
 		{
 			if (v < 0) throw std::invalid_argument{ "`v` must >= 0" };
 			unkFormScoreBias = v;
+			invalidateResultCache();
 		}
 
 		float getUnkScoreScale() const
@@ -455,6 +685,7 @@ namespace kiwi
 		{
 			if (v < 0) throw std::invalid_argument{ "`v` must >= 0" };
 			unkFormScoreScale = v;
+			invalidateResultCache();
 		}
 
 		size_t getMaxUnkFormSize() const
@@ -465,6 +696,7 @@ namespace kiwi
 		void setMaxUnkFormSize(size_t v)
 		{
 			maxUnkFormSize = v;
+			invalidateResultCache();
 		}
 
 		size_t getSpaceTolerance() const
@@ -475,6 +707,7 @@ namespace kiwi
 		void setSpaceTolerance(size_t v)
 		{
 			spaceTolerance = v;
+			invalidateResultCache();
 		}
 
 		float getSpacePenalty() const
@@ -486,6 +719,7 @@ namespace kiwi
 		{
 			if (v < 0) throw std::invalid_argument{ "`v` must >= 0" };
 			spacePenalty = v;
+			invalidateResultCache();
 		}
 
 		float getTypoCostWeight() const
@@ -497,6 +731,26 @@ namespace kiwi
 		{
 			if (v < 0) throw std::invalid_argument{ "`v` must >= 0" };
 			typoCostWeight = v;
+			invalidateResultCache();
+		}
+
+		const BeamOptions& getBeamOptions() const
+		{
+			return beamOptions;
+		}
+
+		/**
+		 * @brief 최적 경로 탐색의 빔 가지치기를 설정한다.
+		 * 
+		 * @details `adaptive`가 켜져 있으면 노드별 상한(`maxStatesPerNode`가 0이면 32)과 점수 차이를
+		 * 청크의 노드 수가 64를 넘는 만큼, 그리고 노드마다 생성된 경로 수의 평균이 상한을 넘는 만큼 제곱근 비율로 줄인다.
+		 * 점수 차이는 원래 값의 절반 아래로는 줄이지 않는다.
+		 */
+		void setBeamOptions(const BeamOptions& v)
+		{
+			if (!(v.marginRatio > 0 && v.marginRatio <= 1)) throw std::invalid_argument{ "`marginRatio` must be in (0, 1]" };
+			beamOptions = v;
+			invalidateResultCache();
 		}
 
 		bool getIntegrateAllomorph() const
@@ -507,6 +761,98 @@ namespace kiwi
 		void setIntegrateAllomorph(bool v)
 		{
 			integrateAllomorph = v;
+			invalidateResultCache();
+		}
+
+		/**
+		 * @brief 분석 결과 캐시를 설정한다.
+		 * 
+		 * @param budgetBytes 캐시가 사용할 메모리의 상한(byte). 0이면 캐시를 사용하지 않는다.
+		 * 
+		 * @note 캐시는 입력 문자열, topN, matchOptions, blocklist에 속한 형태소들을 키로 하여 `analyze`의 결과를 저장하며,
+		 * `asyncAnalyze`, `analyzeBatch` 등 모든 분석 경로와 스레드 풀의 워커들이 함께 사용한다.
+		 * 분석 결과에 영향을 주는 `set*` 옵션이 변경되면 저장된 결과는 모두 무효화된다.
+		 * pretokenized가 지정된 분석은 캐시되지 않는다. blocklist는 내용으로 비교되므로 같은 객체를 수정하거나 해제한 뒤 다시 만들어도 된다.
+		 * 
+		 * @note 기존 캐시 객체를 해제하고 새로 만들기 때문에, 다른 스레드에서 분석이 진행 중일 때
+		 * (`asyncAnalyze` 등이 반환한 future가 아직 끝나지 않은 경우 포함) 호출해서는 안 된다.
+		 */
+		void setResultCacheSize(size_t budgetBytes);
+
+		size_t getResultCacheSize() const;
+
+		void clearResultCache() { invalidateResultCache(); }
+
+		ResultCacheStats getResultCacheStats() const;
+
+		/**
+		 * @brief 청크(문장 종결 지점 등으로 나뉘는 분석 단위)별 최적 경로 탐색 결과의 재사용 방식을 설정한다.
+		 * 
+		 * @param mode 재사용 방식. `ChunkMemoMode::none`이면 사용하지 않는다.
+		 * @param budgetBytes 저장된 결과가 사용할 메모리의 상한(byte)
+		 * 
+		 * @note 같은 문장이 반복해서 나타나는 텍스트에서 경로 탐색을 생략할 수 있다. 
+		 * 분석 결과 캐시와 마찬가지로 `set*` 옵션이 변경되면 무효화되며, pretokenized가 지정된 분석에는 사용되지 않는다.
+		 * 재사용 방식이 바뀌면 분석 결과 캐시도 함께 비워진다.
+		 * 
+		 * @note `setResultCacheSize`와 마찬가지로 저장소를 새로 만들기 때문에, 다른 스레드에서 분석이 진행 중일 때 호출해서는 안 된다.
+		 */
+		void setChunkMemo(ChunkMemoMode mode, size_t budgetBytes = 64 << 20);
+
+		ChunkMemoMode getChunkMemoMode() const;
+
+		/**
+		 * @brief 청크별 탐색 결과 재사용에 설정된 메모리 상한(byte). 사용하지 않으면 0이다.
+		 */
+		size_t getChunkMemoSize() const;
+
+		ResultCacheStats getChunkMemoStats() const;
+
+		/**
+		 * @brief 경로 탐색 중 언어 모델의 전이 결과를 스레드별 캐시에 저장해 재사용할지 설정한다. 기본값은 true이다.
+		 * 
+		 * @note 캐시는 경로 탐색을 시작할 때마다 비워지며, 분석 결과에는 영향을 주지 않는다.
+		 * 분석이 진행 중일 때 호출해도 안전하며, 변경된 설정은 이후에 시작되는 경로 탐색부터 적용된다.
+		 */
+		void setLmTransitionMemo(bool enable);
+
+		bool getLmTransitionMemo() const;
+
+		/**
+		 * @brief 언어 모델 전이 캐시의 누적 적중 횟수를 반환한다. 캐시를 사용하는 동안의 분석만 집계된다.
+		 */
+		LmMemoStats getLmTransitionMemoStats() const;
+
+		bool getParallelChunks() const
+		{
+			return parallelChunks;
+		}
+
+		/**
+		 * @brief 긴 텍스트를 분석할 때 청크별 최적 경로 탐색을 스레드풀에서 병렬로 수행할지 설정한다.
+		 * 
+		 * @note 분석 결과는 순차 분석과 동일하다. 스레드풀이 없거나, 스레드풀의 작업 안에서 호출되었거나, 
+		 * AnalysisContext에 작업량 상한이 설정된 경우에는 순차적으로 분석한다.
+		 * 동시에 탐색 중인 청크는 스레드 수의 두 배로 제한되므로 추가 메모리는 문서 길이에 비례하지 않는다.
+		 */
+		void setParallelChunks(bool v)
+		{
+			parallelChunks = v;
+		}
+
+		bool getDedicatedTop1() const
+		{
+			return dedicatedTop1;
+		}
+
+		/**
+		 * @brief topN이 1인 분석에 전용 Viterbi 탐색을 사용할지 설정한다. 기본값은 true이다.
+		 * 
+		 * @note 전용 탐색은 일반 탐색과 같은 결과를 내며, 비교나 성능 측정을 위해 끌 수 있다.
+		 */
+		void setDedicatedTop1(bool v)
+		{
+			dedicatedTop1 = v;
 		}
 
 		const lm::KnLangModelBase* getKnLM() const
@@ -516,6 +862,111 @@ namespace kiwi
 
 		void findMorpheme(std::vector<const Morpheme*>& out, const std::u16string& s, POSTag tag = POSTag::unknown) const;
 		std::vector<const Morpheme*> findMorpheme(const std::u16string& s, POSTag tag = POSTag::unknown) const;
+
+		class StreamAnalyzer;
+	};
+
+	/**
+	 * @brief 끝을 알 수 없는 입력을 조금씩 받아가며 형태소 분석을 수행하는 클래스.
+	 * 
+	 * @details 입력된 텍스트는 내부 버퍼에 쌓이며, 공백이 포함된 입력이 들어올 때마다 아직 분석하지 않은 부분을
+	 * 형태소 분석과 같은 방식으로 청크로 분할한다. 뒤따르는 텍스트에 따라 달라지지 않는 청크, 
+	 * 즉 버퍼의 끝에 닿지 않는 청크들만 분석하여 확정하고, 마지막 청크는 다음 입력과 함께 분석한다.
+	 * 다음 분석은 마지막으로 확정된 청크 바로 뒤에서 그 청크가 끝난 시점의 SpecialState를 이어받아 시작하므로,
+	 * 이미 분석한 텍스트를 다시 분석하지 않는다. 확정할 청크가 없었던 경우에는 남은 텍스트의 길이가 두 배가 될 때까지
+	 * 분할을 미룬다.
+	 * 확정된 형태소 중 뒤따르는 문장이 존재하여 경계가 확정된 문장들만 receiver로 전달된다.
+	 * 버퍼의 크기가 maxBufferSize를 넘어서면 경계가 확정되지 않더라도 강제로 분석하여 내보낸다.
+	 * 
+	 * 전달되는 TokenInfo의 position, sentPosition, lineNumber는 전체 스트림 기준으로 조정되며,
+	 * pairedToken은 해당 문장 내의 인덱스로 조정된다(문장 밖의 형태소와 쌍을 이루는 경우 -1).
+	 * 각 청크의 경로는 확정되는 시점에 가장 점수가 높은 하나로 정해지므로, 
+	 * 인용부호 상태에 따라 여러 후보가 경합하는 경우 전체 텍스트를 한번에 분석한 결과와 다를 수 있다.
+	 */
+	class Kiwi::StreamAnalyzer
+	{
+	public:
+		/**
+		 * @brief 확정된 한 문장의 형태소 목록을 받는 콜백
+		 */
+		using Receiver = std::function<void(std::vector<TokenInfo>&&)>;
+
+		/**
+		 * @param kiwi 분석에 사용할 Kiwi 인스턴스. StreamAnalyzer보다 오래 유지되어야 한다.
+		 * @param receiver 확정된 문장을 받을 콜백
+		 * @param matchOptions 분석 옵션
+		 * @param blocklist 분석 시 후보로 고려하지 않을 형태소 목록
+		 * @param maxBufferSize 문장 경계가 확정되지 않더라도 분석을 강제로 수행할 버퍼의 크기(UTF16 문자 기준)
+		 */
+		StreamAnalyzer(const Kiwi& kiwi, 
+			Receiver receiver, 
+			Match matchOptions = Match::allWithNormalizing, 
+			Blocklist blocklist = nullptr,
+			size_t maxBufferSize = 65536
+		);
+
+		/**
+		 * @brief 텍스트를 입력한다. 경계가 확정된 문장이 있으면 이 함수 안에서 receiver가 호출된다.
+		 */
+		void push(const std::u16string& text);
+
+		/**
+		 * @brief UTF-8 텍스트를 입력한다. 멀티바이트 문자가 두 입력에 걸쳐 나뉘어 있어도 된다.
+		 */
+		void push(const std::string& text);
+
+		/**
+		 * @brief 빈 문자열을 반환할 때까지 reader로부터 텍스트를 읽어 입력하고, 마지막에 finish()를 호출한다.
+		 */
+		template<class Reader>
+		void feed(Reader&& reader)
+		{
+			while (1)
+			{
+				auto text = reader();
+				if (text.empty()) break;
+				push(text);
+			}
+			finish();
+		}
+
+		/**
+		 * @brief 입력이 끝났음을 알린다. 버퍼에 남은 텍스트를 모두 분석하여 내보낸다.
+		 */
+		void finish();
+
+		/**
+		 * @brief 아직 내보내지 않은 텍스트의 길이(UTF16 문자 기준)
+		 */
+		size_t bufferedSize() const { return buffer.size(); }
+
+		/**
+		 * @brief 지금까지 분석기에 넘겨진 텍스트의 누적 길이(UTF16 문자 기준). 확정되지 않은 청크를 다시 분할한 길이도 포함한다.
+		 */
+		size_t analyzedSize() const { return analyzedChars; }
+
+	private:
+		const Kiwi* kiwi = nullptr;
+		Receiver receiver;
+		Match matchOptions;
+		Blocklist blocklist = nullptr;
+		size_t maxBufferSize = 0;
+
+		std::u16string buffer;
+		std::string pendingBytes;
+		std::vector<TokenInfo> pendingTokens;
+		ChunkResume resume;
+		size_t resumeFrom = 0;
+		size_t scanFrom = 0;
+		size_t retryLength = 0;
+		size_t analyzedChars = 0;
+		uint32_t positionBase = 0;
+		uint32_t sentBase = 0;
+		uint32_t lineBase = 0;
+
+		void process(bool final);
+		bool analyzeUntil(size_t cut, bool final);
+		void emitSentences(bool emitAll);
 	};
 
 	/**
@@ -663,7 +1114,15 @@ namespace kiwi
 			return !!langMdl.knlm;
 		}
 
-		void saveModel(const std::string& modelPath) const;
+		/**
+		 * @brief 현재 형태소 사전과 언어 모델을 모델 경로에 저장한다.
+		 * 
+		 * @param modelPath 모델을 저장할 경로
+		 * @param runtimeLayout true인 경우 언어 모델을 현재 아키텍처용 런타임 레이아웃으로 저장한다.
+		 * 런타임 레이아웃 모델은 불러올 때 복원 과정 없이 mmap된 메모리를 그대로 사용하므로 
+		 * 여러 프로세스가 같은 페이지 캐시를 공유할 수 있지만, 저장한 아키텍처에서만 불러올 수 있다.
+		 */
+		void saveModel(const std::string& modelPath, bool runtimeLayout = false) const;
 
 		/**
 		 * @brief 사전에 새로운 형태소를 추가한다. 이미 동일한 형태소가 있는 경우는 무시된다.
@@ -778,13 +1237,14 @@ namespace kiwi
 		 * 
 		 * @param typos
 		 * @param typoCostThreshold
+		 * @param trieBackend 입력을 형태 후보로 분할할 때 사용할 트라이의 구현. 분석 결과는 같으며 속도와 메모리 사용량만 다르다.
 		 * @return 형태소 분석 준비가 완료된 Kiwi의 객체.
 		 */
-		Kiwi build(const TypoTransformer& typos = {}, float typoCostThreshold = 2.5f) const;
+		Kiwi build(const TypoTransformer& typos = {}, float typoCostThreshold = 2.5f, TrieBackend trieBackend = TrieBackend::frozen) const;
 
-		Kiwi build(DefaultTypoSet typos, float typoCostThreshold = 2.5f) const
+		Kiwi build(DefaultTypoSet typos, float typoCostThreshold = 2.5f, TrieBackend trieBackend = TrieBackend::frozen) const
 		{
-			return build(getDefaultTypoSet(typos), typoCostThreshold);
+			return build(getDefaultTypoSet(typos), typoCostThreshold, trieBackend);
 		}
 
 		using TokenFilter = std::function<bool(const std::u16string&, POSTag)>;
@@ -22,6 +22,23 @@ namespace kiwi
 			uint8_t order, key_size, diff_size, quantized;
 		};
 
+		/**
+		 * @brief `Header::quantized`에 이 비트가 설정된 모델은 런타임 레이아웃으로 저장된 모델이다.
+		 * 
+		 * 런타임 레이아웃 모델은 노드 정보가 미리 복원되어 있고, 키는 특정 아키텍처에 맞게 재배열되어 있으며,
+		 * ll/gamma 값이 역양자화된 상태로 저장되어 있어서 파일을 mmap한 메모리를 복사 없이 바로 사용한다.
+		 * 이 경우 `Header` 바로 뒤에 `RuntimeHeader`가 위치한다.
+		 */
+		static constexpr uint8_t runtimeLayoutFlag = 0x40;
+
+		struct RuntimeHeader
+		{
+			uint64_t num_non_leaf_nodes, htx_vocab_size, value_offset;
+			uint32_t arch_type;
+			float unk_ll;
+			int64_t bos_node_idx;
+		};
+
 		template<class KeyType, class DiffType = int32_t>
 		struct Node
 		{
@@ -49,6 +66,11 @@ namespace kiwi
 			virtual ~KnLangModelBase() {}
 			const Header& getHeader() const { return *reinterpret_cast<const Header*>(base.get()); }
 
+			/**
+			 * @brief 모델이 런타임 레이아웃으로 저장된 것인지 여부를 반환한다.
+			 */
+			bool isRuntimeLayout() const { return !!(getHeader().quantized & runtimeLayoutFlag); }
+
 			virtual ptrdiff_t getLowerNode(ptrdiff_t node_idx) const = 0;
 
 			virtual size_t nonLeafNodeSize() const = 0;
@@ -56,8 +78,20 @@ namespace kiwi
 			virtual const float* getLLBuf() const = 0;
 			virtual const float* getGammaBuf() const = 0;
 
+			/**
+			 * @brief 현재 모델을 런타임 레이아웃으로 변환한다.
+			 * 
+			 * @return 변환된 모델 데이터. 이 데이터는 현재 모델과 동일한 아키텍처에서만 불러올 수 있다.
+			 */
+			virtual utils::MemoryOwner toRuntimeLayout() const = 0;
+
 			static std::unique_ptr<KnLangModelBase> create(utils::MemoryObject&& mem, ArchType archType = ArchType::none);
 
+			/**
+			 * @brief 런타임 레이아웃 모델이 저장된 아키텍처를 반환한다. 일반 모델인 경우 ArchType::default_를 반환한다.
+			 */
+			static ArchType getRuntimeLayoutArch(const utils::MemoryObject& mem);
+
 			template<class TrieNode, class HistoryTx = std::vector<Vid>>
 			static utils::MemoryOwner build(const utils::ContinuousTrie<TrieNode>& ngram_cf,
 				size_t order, size_t min_cf, size_t last_min_cf,
@@ -203,6 +203,8 @@ namespace kiwi
 
 #include <iostream>
 #include <cstring>
+#include <memory>
+#include <stdexcept>
 
 namespace kiwi
 {
@@ -262,6 +264,23 @@ namespace kiwi
 			size_t size() const { return obj->size(); }
 		};
 
+		class MemorySlice
+		{
+			MemoryObject parent;
+			const char* ptr = nullptr;
+			size_t len = 0;
+
+		public:
+			MemorySlice(const MemoryObject& _parent, size_t offset, size_t size)
+				: parent{ _parent }, ptr{ (const char*)_parent.get() + offset }, len{ size }
+			{
+				if (offset + size > _parent.size()) throw std::out_of_range{ "slice exceeds the parent memory" };
+			}
+
+			const void* get() const { return ptr; }
+			size_t size() const { return len; }
+		};
+
 		template<bool read, bool write>
 		struct membuf : public std::streambuf
 		{
@@ -0,0 +1,142 @@
+/**
+ * @file MorphemeSet.h
+ * @author bab2min (bab2min@gmail.com)
+ * @brief 형태소 분석 시 제외할 형태소 집합을 나타내는 MorphemeSet, Blocklist 클래스를 담고 있는 헤더 파일
+ * @version 0.17.0
+ * @date 2022-09-01
+ *
+ *
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <unordered_set>
+
+namespace kiwi
+{
+	class Kiwi;
+	struct Morpheme;
+
+	/**
+	 * @brief 한 Kiwi 인스턴스의 형태소들을 형태소 id로 색인하는 비트셋.
+	 *
+	 * @details 원소 확인이 비트 하나를 읽는 것으로 끝나므로, 분석 중에 모든 후보 형태소에 대해 확인하는 blocklist로 쓰기에 알맞다.
+	 * 한 번 만들어둔 집합은 여러 분석 호출과 여러 스레드에서 함께 사용할 수 있다.
+	 * 집합을 만든 Kiwi 인스턴스가 소멸하면 더 이상 사용할 수 없다.
+	 */
+	class MorphemeSet
+	{
+		const Morpheme* base = nullptr;
+		size_t numMorphemes = 0;
+		size_t numElements = 0;
+		std::vector<uint64_t> bits;
+
+		size_t indexOf(const Morpheme* morph) const;
+
+	public:
+		MorphemeSet() = default;
+
+		/**
+		 * @brief kiwi의 형태소를 담을 수 있는 빈 집합을 만든다.
+		 */
+		explicit MorphemeSet(const Kiwi& kiwi);
+
+		MorphemeSet(const Kiwi& kiwi, const std::unordered_set<const Morpheme*>& morphs);
+
+		/**
+		 * @brief 집합을 비우고 kiwi의 형태소를 담도록 다시 설정한다. 확보한 메모리는 재사용한다.
+		 */
+		void reset(const Kiwi& kiwi);
+
+		/**
+		 * @brief 형태소를 추가한다.
+		 * @return 새로 추가되었는지 여부. 이 집합을 만든 Kiwi의 형태소가 아니면 추가하지 않고 false를 반환한다.
+		 */
+		bool insert(const Morpheme* morph);
+
+		template<class It>
+		void insert(It first, It last)
+		{
+			for (; first != last; ++first) insert(*first);
+		}
+
+		/**
+		 * @return 제거되었는지 여부
+		 */
+		bool erase(const Morpheme* morph);
+
+		bool contains(const Morpheme* morph) const
+		{
+			const size_t idx = indexOf(morph);
+			return idx < numMorphemes && ((bits[idx / 64] >> (idx % 64)) & 1);
+		}
+
+		size_t count(const Morpheme* morph) const
+		{
+			return contains(morph) ? 1 : 0;
+		}
+
+		size_t size() const { return numElements; }
+
+		bool empty() const { return numElements == 0; }
+
+		/**
+		 * @brief 집합에 속한 형태소의 id를 오름차순으로 `out` 뒤에 추가한다.
+		 */
+		void getIds(std::vector<uint32_t>& out) const;
+
+		/**
+		 * @brief 비트셋이 차지하는 메모리의 크기(바이트)
+		 */
+		size_t memoryUsage() const { return bits.capacity() * sizeof(uint64_t); }
+
+		void clear();
+	};
+
+	/**
+	 * @brief 분석 함수에 넘기는 blocklist. `MorphemeSet`이나 `std::unordered_set<const Morpheme*>`를 가리킨다.
+	 *
+	 * @details 두 타입의 포인터와 nullptr로부터 암묵적으로 생성되므로, 기존처럼 `std::unordered_set`의 포인터를 넘겨도 된다.
+	 * `std::unordered_set`이 주어지면 분석할 때마다 내부에서 `MorphemeSet`으로 변환하므로,
+	 * 같은 blocklist로 여러 번 분석한다면 `MorphemeSet`을 미리 만들어 넘기는 것이 좋다.
+	 * 분석 결과 캐시는 가리키는 객체의 주소가 아니라 집합에 속한 형태소들을 키로 사용하므로,
+	 * 같은 주소에 내용이 다른 집합이 새로 만들어지더라도 이전 결과를 잘못 재사용하지 않는다.
+	 */
+	class Blocklist
+	{
+		const MorphemeSet* morphemeSet = nullptr;
+		const std::unordered_set<const Morpheme*>* hashSet = nullptr;
+
+	public:
+		Blocklist(std::nullptr_t = nullptr)
+		{
+		}
+
+		Blocklist(const MorphemeSet* _morphemeSet) : morphemeSet{ _morphemeSet }
+		{
+		}
+
+		Blocklist(const std::unordered_set<const Morpheme*>* _hashSet) : hashSet{ _hashSet }
+		{
+		}
+
+		const MorphemeSet* getMorphemeSet() const { return morphemeSet; }
+
+		const std::unordered_set<const Morpheme*>* getHashSet() const { return hashSet; }
+
+		/**
+		 * @brief 가리키는 객체의 주소. 아무것도 가리키지 않으면 nullptr
+		 */
+		const void* id() const
+		{
+			return morphemeSet ? static_cast<const void*>(morphemeSet) : static_cast<const void*>(hashSet);
+		}
+
+		explicit operator bool() const
+		{
+			return !!id();
+		}
+	};
+}
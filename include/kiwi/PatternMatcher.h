@@ -4,6 +4,7 @@
 #include <string>
 #include <memory>
 #include "Types.h"
+#include "ArchUtils.h"
 
 namespace kiwi
 {
@@ -31,6 +32,32 @@ namespace kiwi
 	};
 
 	std::pair<size_t, kiwi::POSTag> matchPattern(char16_t left, const char16_t* first, const char16_t* last, Match matchOptions);
+
+	/**
+	 * @brief 문자열에서 패턴이 매칭된 구간
+	 */
+	struct PatternSpan
+	{
+		uint32_t begin = 0, end = 0;
+		POSTag tag = POSTag::unknown;
+
+		PatternSpan(uint32_t _begin = 0, uint32_t _end = 0, POSTag _tag = POSTag::unknown)
+			: begin{ _begin }, end{ _end }, tag{ _tag }
+		{
+		}
+	};
+
+	/**
+	 * @brief `str[from, until)`에서 시작하는 패턴 구간을 앞에서부터 모두 찾아 `out` 뒤에 추가한다.
+	 *
+	 * @details 각 위치에서 `matchPattern()`을 호출하고 매칭된 길이만큼 건너뛰는 것과 같은 결과를 한 번의 훑기로 구한다.
+	 * 어떤 패턴도 시작할 수 없는 문자들은 `arch`에 맞는 SIMD 명령어로 한꺼번에 건너뛰며,
+	 * 같은 문자열 구간에서 실패하는 패턴은 다시 검사하지 않는다.
+	 * 패턴은 `until`을 넘어 `str + len`까지 이어질 수 있다. 구간의 위치는 `str`을 기준으로 한다.
+	 * 
+	 * @return 다음 탐색을 이어서 시작할 위치. 반환값을 `from`으로 하여 다시 호출하면 `until`을 늘려 한 번에 찾은 것과 같은 결과를 얻는다.
+	 */
+	size_t findPatterns(const char16_t* str, size_t len, size_t from, size_t until, Match matchOptions, Vector<PatternSpan>& out, ArchType arch = ArchType::default_);
 }
 
 KIWI_DEFINE_ENUM_FLAG_OPERATORS(kiwi::Match);
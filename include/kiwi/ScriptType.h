@@ -239,6 +239,13 @@ namespace kiwi
 
     ScriptType chr2ScriptType(char32_t c);
 
+    /**
+     * @brief Reference implementation of chr2ScriptType which scans the block ranges one by one.
+     * 
+     * It is used to build and verify the lookup tables behind chr2ScriptType.
+     */
+    ScriptType chr2ScriptTypeByRanges(char32_t c);
+
     const char* getScriptName(ScriptType type);
 
     /**
@@ -20,6 +20,20 @@ namespace kiwi
 			uint8_t keySize, windowSize, compressed, quantize, _rsv[4];
 		};
 
+		/**
+		 * @brief `Header::quantize`에 이 비트가 설정된 모델은 런타임 레이아웃으로 저장된 모델이다.
+		 * 
+		 * 런타임 레이아웃 모델은 각 어휘별 시작 위치, 특정 아키텍처에 맞게 재배열된 키, 역양자화된 값들을 담고 있어
+		 * 파일을 mmap한 메모리를 복사 없이 바로 사용한다. 이 경우 `Header` 바로 뒤에 `RuntimeHeader`가 위치한다.
+		 */
+		static constexpr uint8_t runtimeLayoutFlag = 0x40;
+
+		struct RuntimeHeader
+		{
+			uint64_t totalVocabs, ptrOffset, keyOffset, discntOffset, compensationOffset, validnessOffset;
+			uint32_t archType, _rsv;
+		};
+
 		class SkipBigramModelBase
 		{
 		protected:
@@ -31,8 +45,26 @@ namespace kiwi
 		public:
 			virtual ~SkipBigramModelBase() {}
 			const Header& getHeader() const { return *reinterpret_cast<const Header*>(base.get()); }
+			const utils::MemoryObject& getMemory() const { return base; }
+
+			/**
+			 * @brief 모델이 런타임 레이아웃으로 저장된 것인지 여부를 반환한다.
+			 */
+			bool isRuntimeLayout() const { return !!(getHeader().quantize & runtimeLayoutFlag); }
+
+			/**
+			 * @brief 현재 모델을 런타임 레이아웃으로 변환한다.
+			 * 
+			 * @return 변환된 모델 데이터. 이 데이터는 현재 모델과 동일한 아키텍처에서만 불러올 수 있다.
+			 */
+			virtual utils::MemoryOwner toRuntimeLayout() const = 0;
 
 			static std::unique_ptr<SkipBigramModelBase> create(utils::MemoryObject&& mem, ArchType archType = ArchType::none);
+
+			/**
+			 * @brief 런타임 레이아웃 모델이 저장된 아키텍처를 반환한다. 일반 모델인 경우 ArchType::default_를 반환한다.
+			 */
+			static ArchType getRuntimeLayoutArch(const utils::MemoryObject& mem);
 		};
 	}
 }
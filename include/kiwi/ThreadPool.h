@@ -31,6 +31,15 @@ namespace kiwi
 
 			size_t size() const { return workers.size(); }
 			size_t numEnqueued() const { return tasks.size(); }
+			bool isWorkerThread() const
+			{
+				const auto id = std::this_thread::get_id();
+				for (auto& w : workers)
+				{
+					if (w.get_id() == id) return true;
+				}
+				return false;
+			}
 			void joinAll();
 		private:
 			std::vector<std::thread> workers;
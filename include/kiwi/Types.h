@@ -371,6 +371,114 @@ namespace kiwi
 	 */
 	using TokenResult = std::pair<std::vector<TokenInfo>, float>;
 
+	/**
+	 * @brief 분석 결과 캐시의 현재 상태
+	 */
+	struct ResultCacheStats
+	{
+		size_t hits = 0; /**< 캐시에서 결과를 찾은 횟수 */
+		size_t misses = 0; /**< 캐시에서 결과를 찾지 못한 횟수 */
+		size_t entries = 0; /**< 저장된 결과의 개수 */
+		size_t bytes = 0; /**< 저장된 결과가 차지하는 메모리의 추정치(byte) */
+		size_t approximateHits = 0; /**< hits 중 문맥이 달라 근사적으로 재사용된 횟수 */
+	};
+
+	/**
+	 * @brief 언어 모델 전이 캐시의 누적 사용 횟수
+	 */
+	struct LmMemoStats
+	{
+		size_t hits = 0; /**< 캐시에서 전이 결과를 찾은 횟수 */
+		size_t misses = 0; /**< 언어 모델을 직접 탐색한 횟수 */
+	};
+
+	/**
+	 * @brief 청크별 최적 경로 탐색 결과를 재사용하는 방식
+	 */
+	enum class ChunkMemoMode : uint8_t
+	{
+		none = 0, /**< 재사용하지 않음 */
+		exact, /**< 이전 청크로부터 이어지는 문맥이 같은 경우에만 재사용한다. 분석 결과는 재사용하지 않을 때와 동일하다. */
+		approximate, /**< 이전 청크로부터 이어지는 상태(인용부호 등)가 달라도 재사용한다. */
+	};
+
+	/**
+	 * @brief 입력 문자열을 형태 후보로 분할할 때 사용하는 형태 사전 트라이의 구현
+	 * 
+	 * @sa `kiwi::KiwiBuilder::build()`
+	 */
+	enum class TrieBackend : uint8_t
+	{
+		frozen = 0, /**< 노드마다 정렬된 자식 키를 이진 탐색(혹은 SIMD 탐색)하는 트라이. 기본값 */
+		doubleArray, /**< base/check 배열로 자식 노드를 바로 찾는 double-array 트라이. 전이가 빠른 대신, 결합 및 사전 조회용 기본 트라이를 함께 유지하므로 메모리를 더 사용한다. */
+	};
+
+	/**
+	 * @brief 최적 경로 탐색에서 노드마다 유지할 경로의 수를 제한하는 빔 가지치기 설정
+	 * 
+	 * 기본값은 아무것도 제한하지 않으며, 이때는 `cutOffThreshold`에 의한 가지치기만 수행된다.
+	 * 빔을 좁히면 분석 속도가 빨라지는 대신 정확도가 떨어질 수 있다.
+	 */
+	struct BeamOptions
+	{
+		size_t maxStatesPerNode = 0; /**< 노드마다 유지할 경로의 최대 개수(이전 청크의 상태별). topN보다 작으면 topN을 사용한다. 0이면 제한하지 않는다. */
+		float marginRatio = 1; /**< 노드의 최고 점수보다 `cutOffThreshold * marginRatio` 넘게 낮은 경로를 버린다. (0, 1] 범위여야 한다. */
+		size_t chunkStateBudget = 0; /**< 청크 하나에서 유지할 경로의 총 개수. 남은 예산을 남은 노드에 고르게 나누어 노드별 상한을 정한다. 0이면 제한하지 않는다. */
+		bool adaptive = false; /**< 길거나 모호한 청크에서 노드별 상한과 점수 차이를 자동으로 줄인다. */
+
+		bool unlimited() const
+		{
+			return !maxStatesPerNode && marginRatio >= 1 && !chunkStateBudget && !adaptive;
+		}
+	};
+
+	/**
+	 * @brief 분석 결과를 열(column) 단위로 저장하는 타입
+	 * 
+	 * `TokenResult`와 달리 형태소마다 문자열을 따로 할당하지 않고, 모든 형태를 하나의 문자열 풀에 이어 붙여 저장한다.
+	 * i번째 형태소의 형태는 `strPool`의 [`strOffsets[i]`, `strOffsets[i + 1]`) 구간에 위치한다.
+	 * 같은 객체를 반복해서 분석 결과로 사용하면 이전에 할당된 메모리가 재사용된다.
+	 */
+	struct TokenResultColumns
+	{
+		std::vector<POSTag> tags; /**< 품사 태그 */
+		std::vector<uint32_t> positions; /**< 시작 위치(UTF16 문자 기준, UTF-8 입력을 분석한 경우 바이트 기준) */
+		std::vector<uint32_t> lengths; /**< 길이(UTF16 문자 기준, UTF-8 입력을 분석한 경우 바이트 기준). UTF-8 바이트 길이는 UTF16 길이의 최대 3배까지 커지므로 32비트로 저장한다. */
+		std::vector<uint32_t> wordPositions; /**< 어절 번호 */
+		std::vector<uint32_t> sentPositions; /**< 문장 번호 */
+		std::vector<float> scores; /**< 형태소의 언어모델 점수 */
+		std::vector<uint32_t> morphIds; /**< 형태소 id (사전에 없는 형태소인 경우 -1) */
+		std::vector<uint32_t> strOffsets; /**< 각 형태가 `strPool` 내에서 시작하는 위치. 크기는 `size() + 1` */
+		std::u16string strPool; /**< 모든 형태를 이어붙인 UTF-16 문자열 */
+		std::vector<uint32_t> u8StrOffsets; /**< 각 형태가 `u8StrPool` 내에서 시작하는 위치. UTF-8 출력을 요청한 경우에만 채워진다. */
+		std::string u8StrPool; /**< 모든 형태를 이어붙인 UTF-8 문자열. UTF-8 출력을 요청한 경우에만 채워진다. */
+		float score = 0; /**< 분석 결과 전체의 점수 */
+
+		size_t size() const { return tags.size(); }
+
+		void clear()
+		{
+			tags.clear();
+			positions.clear();
+			lengths.clear();
+			wordPositions.clear();
+			sentPositions.clear();
+			scores.clear();
+			morphIds.clear();
+			strOffsets.clear();
+			strPool.clear();
+			u8StrOffsets.clear();
+			u8StrPool.clear();
+			score = 0;
+		}
+
+		const char16_t* strData(size_t i) const { return strPool.data() + strOffsets[i]; }
+		size_t strSize(size_t i) const { return strOffsets[i + 1] - strOffsets[i]; }
+
+		const char* u8StrData(size_t i) const { return u8StrPool.data() + u8StrOffsets[i]; }
+		size_t u8StrSize(size_t i) const { return u8StrOffsets[i + 1] - u8StrOffsets[i]; }
+	};
+
 	using U16Reader = std::function<std::u16string()>;
 	using U16MultipleReader = std::function<U16Reader()>;
 
@@ -447,6 +447,8 @@ DECL_DLL float kiwi_get_option_f(kiwi_h handle, int option);
  * 
  * @param handle Kiwi.
  * @return 새 형태소 집합의 핸들. kiwi_morphset_* 함수에 사용가능합니다. 이 핸들은 사용 후 kiwi_morphset_close를 통해 반드시 해제되어야 합니다.
+ * 
+ * @note 형태소집합은 형태소 id로 색인된 비트셋이므로, 한 번 만들어 여러 번의 분석과 여러 스레드에서 함께 사용할 수 있습니다.
  */
 DECL_DLL kiwi_morphset_h kiwi_new_morphset(kiwi_h handle);
 
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+#include <kiwi/AnalysisContext.h>
+#include <kiwi/MorphemeSet.h>
+#include <kiwi/Types.h>
+#include "Arena.hpp"
+
+namespace kiwi
+{
+	namespace detail
+	{
+		template<class Ty, class Alloc>
+		size_t scratchBytes(const std::vector<Ty, Alloc>& v)
+		{
+			return v.capacity() * sizeof(Ty);
+		}
+
+		template<class Ch, class Traits, class Alloc>
+		size_t scratchBytes(const std::basic_string<Ch, Traits, Alloc>& v)
+		{
+			return v.capacity() * sizeof(Ch);
+		}
+
+		template<class Ty, class Alloc>
+		size_t scratchBytes(const std::deque<Ty, Alloc>& v)
+		{
+			return v.size() * sizeof(Ty);
+		}
+
+		inline size_t scratchBytes(const MorphemeSet& v)
+		{
+			return v.memoryUsage();
+		}
+
+		template<class Ty>
+		auto scratchBytes(const Ty& v) -> decltype(v.capacityBytes())
+		{
+			return v.capacityBytes();
+		}
+	}
+
+	/**
+	 * @brief AnalysisContext의 실제 구현. 태그 타입별로 하나씩 임시 버퍼를 만들어 보관한다.
+	 * @details 태그는 `using type = 버퍼 타입;`을 가지는 빈 구조체이며, 같은 타입의 버퍼라도 태그가 다르면 별개로 관리된다.
+	 * 분석 함수들은 `Binding`으로 사용할 컨텍스트를 지정하고 `current()`로 이를 가져와 버퍼를 꺼내 쓴다.
+	 */
+	class AnalysisContext::Impl
+	{
+		struct BufferBase
+		{
+			virtual ~BufferBase() = default;
+			virtual size_t bytes() const = 0;
+		};
+
+		template<class Ty>
+		struct Buffer : public BufferBase
+		{
+			Ty value;
+
+			size_t bytes() const override
+			{
+				return detail::scratchBytes(value);
+			}
+		};
+
+		static size_t nextBufferId()
+		{
+			static std::atomic<size_t> counter{ 0 };
+			return counter++;
+		}
+
+		template<class Tag>
+		static size_t bufferId()
+		{
+			static const size_t id = nextBufferId();
+			return id;
+		}
+
+		static Impl*& boundContext()
+		{
+			thread_local Impl* ctx = nullptr;
+			return ctx;
+		}
+
+		std::vector<std::unique_ptr<BufferBase>> buffers;
+		utils::Arena arena;
+		size_t depth = 0;
+
+		std::chrono::steady_clock::time_point deadline;
+
+		void beginAnalysis()
+		{
+			transitions = 0;
+			degraded = false;
+			if (budget.timeLimit.count()) deadline = std::chrono::steady_clock::now() + budget.timeLimit;
+		}
+
+	public:
+		size_t highWaterMark;
+		size_t shrinks = 0;
+		AnalysisBudget budget;
+		size_t transitions = 0;
+		bool degraded = false;
+
+		/**
+		 * @brief 생성되어 있는 동안 현재 스레드의 분석 함수들이 주어진 컨텍스트를 사용하도록 한다.
+		 * @details 중첩될 수 있으며, 가장 바깥의 Binding이 소멸할 때 버퍼 크기가 high-water mark를 넘으면 버퍼를 해제한다.
+		 */
+		class Binding
+		{
+			Impl& ctx;
+			Impl* prevCtx;
+			utils::Arena* prevArena;
+		public:
+			Binding(Impl& _ctx)
+				: ctx{ _ctx }, prevCtx{ boundContext() }, prevArena{ utils::Arena::bound() }
+			{
+				boundContext() = &ctx;
+				utils::Arena::bound() = &ctx.arena;
+				if (ctx.depth++ == 0) ctx.beginAnalysis();
+			}
+
+			Binding(const Binding&) = delete;
+			Binding& operator=(const Binding&) = delete;
+
+			~Binding()
+			{
+				if (--ctx.depth == 0) ctx.trim();
+				boundContext() = prevCtx;
+				utils::Arena::bound() = prevArena;
+			}
+		};
+
+		Impl(size_t _highWaterMark)
+			: highWaterMark{ _highWaterMark }
+		{
+		}
+
+		/**
+		 * @brief 현재 스레드에 지정된 컨텍스트. 지정된 것이 없으면 스레드별 기본 컨텍스트를 반환한다.
+		 */
+		static Impl& current()
+		{
+			if (auto* ctx = boundContext()) return *ctx;
+			return threadDefault().impl();
+		}
+
+		static AnalysisContext& threadDefault()
+		{
+			thread_local AnalysisContext ctx;
+			return ctx;
+		}
+
+		/**
+		 * @brief 작업량 상한에 도달했는지 확인한다. 한 번 도달하면 현재 분석이 끝날 때까지 true를 반환한다.
+		 */
+		bool budgetExhausted()
+		{
+			if (degraded) return true;
+			if (budget.maxTransitions && transitions > budget.maxTransitions) degraded = true;
+			else if (budget.timeLimit.count() && std::chrono::steady_clock::now() >= deadline) degraded = true;
+			return degraded;
+		}
+
+		bool inUse() const
+		{
+			return depth > 0;
+		}
+
+		template<class Tag>
+		typename Tag::type& get()
+		{
+			const size_t id = bufferId<Tag>();
+			if (id >= buffers.size()) buffers.resize(id + 1);
+			auto& b = buffers[id];
+			if (!b) b.reset(new Buffer<typename Tag::type>{});
+			return static_cast<Buffer<typename Tag::type>*>(b.get())->value;
+		}
+
+		size_t memoryUsage() const
+		{
+			size_t ret = arena.reservedBytes();
+			for (auto& b : buffers)
+			{
+				if (b) ret += b->bytes();
+			}
+			return ret;
+		}
+
+		void shrink()
+		{
+			buffers.clear();
+			buffers.shrink_to_fit();
+			arena.release();
+		}
+
+		void trim()
+		{
+			if (memoryUsage() <= highWaterMark) return;
+			shrink();
+			++shrinks;
+		}
+	};
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <new>
+#include <vector>
+#include <unordered_map>
+#include <kiwi/Types.h>
+
+namespace kiwi
+{
+	namespace utils
+	{
+		/**
+		 * @brief 한 번의 분석 동안만 쓰이는 임시 메모리를 위한 단조 증가(bump) 할당기.
+		 * @details 할당은 현재 블록의 포인터를 앞으로 밀기만 하고, 개별 해제는 마지막으로 할당된 영역에 대해서만 되돌린다.
+		 * 메모리는 `Scope`가 끝날 때 한꺼번에 반환되며, 확보한 블록은 해제하지 않고 같은 스레드의 다음 분석에서 재사용한다.
+		 */
+		class Arena
+		{
+			struct Block
+			{
+				char* data;
+				size_t size;
+			};
+
+			static constexpr size_t minBlockSize = 64 * 1024;
+
+			std::vector<Block> blocks;
+			size_t usedBlocks = 0;
+			char* ptr = nullptr;
+			char* end = nullptr;
+
+			static char* alignUp(char* p, size_t align)
+			{
+				return reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(p) + align - 1) & ~(uintptr_t)(align - 1));
+			}
+
+			void* allocateSlow(size_t size, size_t align)
+			{
+				const size_t required = size + align - 1;
+				// 이미 확보해둔 다음 블록이 충분히 크면 재사용하고, 아니면 그 앞에 새 블록을 끼워 넣는다
+				if (usedBlocks >= blocks.size() || blocks[usedBlocks].size < required)
+				{
+					size_t newSize = std::max(minBlockSize, required);
+					if (usedBlocks) newSize = std::max(newSize, blocks[usedBlocks - 1].size * 2);
+					Block b{ static_cast<char*>(::operator new(newSize)), newSize };
+					blocks.insert(blocks.begin() + usedBlocks, b);
+				}
+				auto& b = blocks[usedBlocks++];
+				ptr = alignUp(b.data, align);
+				end = b.data + b.size;
+				void* ret = ptr;
+				ptr += size;
+				return ret;
+			}
+
+		public:
+			/**
+			 * @brief `rewind()`로 되돌아갈 수 있는 할당 위치
+			 */
+			struct Mark
+			{
+				size_t usedBlocks;
+				char* ptr;
+			};
+
+			/**
+			 * @brief 생성 시점의 할당 위치를 기억해두었다가 소멸 시에 그 위치로 되돌린다.
+			 * @note Scope 안에서 arena로부터 할당받은 컨테이너는 Scope보다 먼저 소멸해야 하며,
+			 * Scope 바깥에서 만든 arena 컨테이너를 Scope 안에서 키워서는 안 된다.
+			 */
+			class Scope
+			{
+				Arena& arena;
+				Mark mark;
+			public:
+				Scope(Arena& _arena = Arena::local())
+					: arena{ _arena }, mark{ _arena.getMark() }
+				{
+				}
+
+				Scope(const Scope&) = delete;
+				Scope& operator=(const Scope&) = delete;
+
+				~Scope()
+				{
+					arena.rewind(mark);
+				}
+			};
+
+			Arena() = default;
+			Arena(const Arena&) = delete;
+			Arena& operator=(const Arena&) = delete;
+
+			~Arena()
+			{
+				for (auto& b : blocks) ::operator delete(b.data);
+			}
+
+			/**
+			 * @brief 현재 스레드에 지정된 arena를 가리킨다. AnalysisContext가 자신의 arena를 지정하는 데 쓰인다.
+			 */
+			static Arena*& bound()
+			{
+				thread_local Arena* arena = nullptr;
+				return arena;
+			}
+
+			/**
+			 * @brief 현재 스레드에 지정된 arena를 반환한다. 지정된 것이 없으면 스레드별 기본 arena를 사용한다.
+			 */
+			static Arena& local()
+			{
+				if (auto* arena = bound()) return *arena;
+				thread_local Arena arena;
+				return arena;
+			}
+
+			void* allocate(size_t size, size_t align)
+			{
+				char* p = alignUp(ptr, align);
+				if (!ptr || p + size > end) return allocateSlow(size, align);
+				ptr = p + size;
+				return p;
+			}
+
+			void deallocate(void* p, size_t size)
+			{
+				// 가장 최근에 할당된 영역이라면 되돌려서 vector의 재할당 등에 다시 쓸 수 있게 한다
+				if (static_cast<char*>(p) + size == ptr) ptr = static_cast<char*>(p);
+			}
+
+			Mark getMark() const
+			{
+				return Mark{ usedBlocks, ptr };
+			}
+
+			void rewind(const Mark& mark)
+			{
+				usedBlocks = mark.usedBlocks;
+				ptr = mark.ptr;
+				end = usedBlocks ? blocks[usedBlocks - 1].data + blocks[usedBlocks - 1].size : nullptr;
+			}
+
+			/**
+			 * @brief 사용 중이지 않은 블록을 모두 해제한다.
+			 */
+			void release()
+			{
+				for (size_t i = usedBlocks; i < blocks.size(); ++i) ::operator delete(blocks[i].data);
+				blocks.erase(blocks.begin() + usedBlocks, blocks.end());
+				blocks.shrink_to_fit();
+			}
+
+			/**
+			 * @brief 확보하고 있는 블록들의 전체 크기(바이트)
+			 */
+			size_t reservedBytes() const
+			{
+				size_t ret = 0;
+				for (auto& b : blocks) ret += b.size;
+				return ret;
+			}
+		};
+
+		/**
+		 * @brief Arena로부터 메모리를 할당받는 STL 호환 할당기. 기본 생성 시에는 현재 스레드의 arena를 사용한다.
+		 */
+		template<class Ty>
+		class ArenaAllocator
+		{
+			template<class> friend class ArenaAllocator;
+			Arena* arena;
+
+		public:
+			using value_type = Ty;
+
+			ArenaAllocator() : arena{ &Arena::local() }
+			{
+			}
+
+			explicit ArenaAllocator(Arena& _arena) : arena{ &_arena }
+			{
+			}
+
+			template<class Other>
+			ArenaAllocator(const ArenaAllocator<Other>& o) : arena{ o.arena }
+			{
+			}
+
+			Ty* allocate(size_t n)
+			{
+				return static_cast<Ty*>(arena->allocate(n * sizeof(Ty), alignof(Ty)));
+			}
+
+			void deallocate(Ty* p, size_t n)
+			{
+				arena->deallocate(p, n * sizeof(Ty));
+			}
+
+			template<class Other>
+			bool operator==(const ArenaAllocator<Other>& o) const
+			{
+				return arena == o.arena;
+			}
+
+			template<class Other>
+			bool operator!=(const ArenaAllocator<Other>& o) const
+			{
+				return arena != o.arena;
+			}
+		};
+
+		template<class Ty>
+		using ArenaVector = std::vector<Ty, ArenaAllocator<Ty>>;
+
+		template<class Key, class Value, class Hasher = Hash<Key>>
+		using ArenaUnorderedMap = std::unordered_map<Key, Value, Hasher, std::equal_to<Key>, ArenaAllocator<std::pair<const Key, Value>>>;
+	}
+}
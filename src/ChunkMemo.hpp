@@ -0,0 +1,156 @@
+#pragma once
+
+#include "ResultCache.hpp"
+#include "PathEvaluator.hpp"
+
+namespace kiwi
+{
+	struct ChunkMemoKey
+	{
+		KString text;
+		size_t topN = 0;
+		Match matchOptions = Match::none;
+		std::vector<uint32_t> blocklist; /**< blocklist에 속한 형태소 id(오름차순) */
+		bool atStart = false, atEnd = false;
+		std::string prevSpStates;
+
+		size_t hash() const
+		{
+			size_t h = 14695981039346656037ull & (size_t)-1;
+			for (auto c : text) h = (h ^ c) * (1099511628211ull & (size_t)-1);
+			h = hashCombine(h, topN);
+			h = hashCombine(h, (size_t)matchOptions);
+			for (auto id : blocklist) h = hashCombine(h, id);
+			h = hashCombine(h, std::hash<std::string>{}(prevSpStates) + atStart * 2 + atEnd);
+			return h;
+		}
+
+		size_t bytes() const
+		{
+			return text.size() * sizeof(kchar_t) + prevSpStates.size() + blocklist.size() * sizeof(uint32_t);
+		}
+
+		bool operator==(const ChunkMemoKey& o) const
+		{
+			return topN == o.topN && matchOptions == o.matchOptions && blocklist == o.blocklist
+				&& atStart == o.atStart && atEnd == o.atEnd && prevSpStates == o.prevSpStates && text == o.text;
+		}
+	};
+
+	struct ChunkMemoValue
+	{
+		Vector<PathEvaluator::ChunkResult> results;
+		SpecialState prevSpState;
+	};
+
+	/**
+	* @brief 청크(splitByTrie가 나누는 분석 단위)별 최적 경로 탐색 결과를 저장하는 캐시.
+	* @details 청크의 탐색은 항상 문장 시작 상태의 언어 모델에서 출발하므로, 청크의 결과는 정규화된 텍스트와
+	* 텍스트 양 끝에 위치하는지 여부, 이전 청크로부터 전달되는 SpecialState의 집합에 의해서만 결정된다.
+	* exact 모드에서는 이 집합까지 일치하는 경우에만 결과를 재사용하므로 결과가 탐색한 것과 동일하다.
+	* approximate 모드에서는 이전 상태가 하나뿐인 경우 그 값이 달라도 결과를 재사용하며,
+	* 청크 안에서 바뀌지 않은 상태 필드만 새 이전 상태를 따르도록 고친다.
+	* 결과의 위치는 청크 시작 지점 기준으로 저장된다.
+	*/
+	class ChunkMemo : public ShardedLruCache<ChunkMemoKey, ChunkMemoValue>
+	{
+		ChunkMemoMode mode = ChunkMemoMode::none;
+		std::atomic<size_t> approximateHits{ 0 };
+
+		static void shiftPositions(Vector<PathEvaluator::ChunkResult>& results, int64_t delta)
+		{
+			for (auto& r : results)
+			{
+				for (auto& s : r.path)
+				{
+					s.begin = (uint32_t)(s.begin + delta);
+					s.end = (uint32_t)(s.end + delta);
+				}
+			}
+		}
+
+		static size_t estimateBytes(const Vector<PathEvaluator::ChunkResult>& results)
+		{
+			size_t bytes = 0;
+			for (auto& r : results)
+			{
+				bytes += sizeof(PathEvaluator::ChunkResult) + r.path.size() * sizeof(PathEvaluator::Result);
+				for (auto& s : r.path) bytes += s.str.size() * sizeof(kchar_t);
+			}
+			return bytes;
+		}
+
+	public:
+		ChunkMemo(ChunkMemoMode _mode, size_t _budget)
+			: ShardedLruCache{ _budget }, mode{ _mode }
+		{
+		}
+
+		ChunkMemoMode getMode() const { return mode; }
+
+		/**
+		* @brief 청크 [chunkBegin, chunkEnd)의 결과를 캐시에서 찾고, 없으면 fn을 호출하여 탐색한 뒤 저장한다.
+		* @details fn은 `bool& cacheable`을 인자로 받으며, 이를 false로 설정하면 탐색 결과를 저장하지 않는다.
+		*/
+		template<class Fn>
+		Vector<PathEvaluator::ChunkResult> findOrEval(const KString& normalizedStr, size_t chunkBegin, size_t chunkEnd,
+			size_t topN, Match matchOptions, const std::vector<uint32_t>& blocklist, const Vector<SpecialState>& prevSpStates, Fn&& fn)
+		{
+			// findBestPath에서 빈 상태 목록은 초기 상태 하나만 있는 것과 같다
+			Vector<SpecialState> uniqStates = prevSpStates;
+			if (uniqStates.empty()) uniqStates.emplace_back();
+			sort(uniqStates.begin(), uniqStates.end());
+			uniqStates.erase(unique(uniqStates.begin(), uniqStates.end()), uniqStates.end());
+
+			ChunkMemoKey key;
+			key.text.assign(normalizedStr.begin() + chunkBegin, normalizedStr.begin() + chunkEnd);
+			key.topN = topN;
+			key.matchOptions = matchOptions;
+			key.blocklist = blocklist;
+			// 텍스트의 처음과 끝에 위치한 청크는 그래프와 경계 처리가 달라질 수 있으므로 구분한다
+			key.atStart = chunkBegin == 0;
+			key.atEnd = chunkEnd == normalizedStr.size();
+			const bool anyState = mode == ChunkMemoMode::approximate && uniqStates.size() == 1;
+			if (!anyState)
+			{
+				for (auto s : uniqStates) key.prevSpStates.push_back((char)(uint8_t)s);
+			}
+
+			ChunkMemoValue value;
+			size_t gen;
+			if (find(key, value, gen))
+			{
+				if (anyState && !(value.prevSpState == uniqStates[0]))
+				{
+					const SpecialState from = value.prevSpState, to = uniqStates[0];
+					for (auto& r : value.results)
+					{
+						if (r.curState.singleQuote == from.singleQuote) r.curState.singleQuote = to.singleQuote;
+						if (r.curState.doubleQuote == from.doubleQuote) r.curState.doubleQuote = to.doubleQuote;
+						if (r.curState.bulletHash == from.bulletHash) r.curState.bulletHash = to.bulletHash;
+						r.prevState = to;
+					}
+					++approximateHits;
+				}
+				shiftPositions(value.results, (int64_t)chunkBegin);
+				return move(value.results);
+			}
+
+			bool cacheable = true;
+			auto ret = fn(cacheable);
+			if (!cacheable) return ret;
+			value.results = ret;
+			value.prevSpState = uniqStates[0];
+			shiftPositions(value.results, -(int64_t)chunkBegin);
+			insert(key, value, estimateBytes(value.results), gen);
+			return ret;
+		}
+
+		ResultCacheStats getStats() const
+		{
+			auto ret = ShardedLruCache::getStats();
+			ret.approximateHits = approximateHits.load();
+			return ret;
+		}
+	};
+}
@@ -9,6 +9,7 @@
 #include "FeatureTestor.h"
 #include "StrUtils.h"
 #include "RaggedVector.hpp"
+#include "serializer.hpp"
 
 using namespace std;
 using namespace kiwi;
@@ -1061,6 +1062,114 @@ namespace kiwi
 	};
 }
 
+namespace kiwi
+{
+	namespace serializer
+	{
+		template<>
+		struct Serializer<utils::Bitset>
+		{
+			void write(std::ostream& ostr, const utils::Bitset& v)
+			{
+				Vector<uint8_t> packed((v.size() + 7) / 8);
+				for (size_t i = 0; i < v.size(); ++i)
+				{
+					if (v.get(i)) packed[i / 8] |= 1 << (i % 8);
+				}
+				writeMany(ostr, (uint32_t)v.size(), packed);
+			}
+
+			void read(std::istream& istr, utils::Bitset& v)
+			{
+				uint32_t size;
+				Vector<uint8_t> packed;
+				readMany(istr, size, packed);
+				if (packed.size() != (size + 7) / 8) throw SerializationException{ "invalid size of Bitset" };
+				v = utils::Bitset{ size };
+				for (size_t i = 0; i < size; ++i)
+				{
+					if (packed[i / 8] & (1 << (i % 8))) v.set(i);
+				}
+			}
+		};
+
+		template<>
+		struct Serializer<MultiRuleDFAErased>
+		{
+			struct WriteVisitor
+			{
+				std::ostream& ostr;
+
+				template<class NodeSizeTy, class GroupSizeTy>
+				void operator()(const MultiRuleDFA<NodeSizeTy, GroupSizeTy>& e) const
+				{
+					writeMany(ostr, (uint8_t)sizeof(NodeSizeTy), (uint8_t)sizeof(GroupSizeTy), e);
+				}
+			};
+
+			template<class NodeSizeTy, class GroupSizeTy>
+			static void readAs(std::istream& istr, MultiRuleDFAErased& v)
+			{
+				MultiRuleDFA<NodeSizeTy, GroupSizeTy> dfa;
+				readFromStream(istr, dfa);
+				v = std::move(dfa);
+			}
+
+			template<class NodeSizeTy>
+			static void readAs(std::istream& istr, MultiRuleDFAErased& v, uint8_t groupSize)
+			{
+				switch (groupSize)
+				{
+				case 1: return readAs<NodeSizeTy, uint8_t>(istr, v);
+				case 2: return readAs<NodeSizeTy, uint16_t>(istr, v);
+				case 4: return readAs<NodeSizeTy, uint32_t>(istr, v);
+				case 8: return readAs<NodeSizeTy, uint64_t>(istr, v);
+				}
+				throw SerializationException{ "invalid group size of MultiRuleDFA" };
+			}
+
+			void write(std::ostream& ostr, const MultiRuleDFAErased& v)
+			{
+				mapbox::util::apply_visitor(WriteVisitor{ ostr }, v);
+			}
+
+			void read(std::istream& istr, MultiRuleDFAErased& v)
+			{
+				uint8_t nodeSize, groupSize;
+				readMany(istr, nodeSize, groupSize);
+				switch (nodeSize)
+				{
+				case 1: return readAs<uint8_t>(istr, v, groupSize);
+				case 2: return readAs<uint16_t>(istr, v, groupSize);
+				case 4: return readAs<uint32_t>(istr, v, groupSize);
+				case 8: return readAs<uint64_t>(istr, v, groupSize);
+				}
+				throw SerializationException{ "invalid node size of MultiRuleDFA" };
+			}
+		};
+	}
+}
+
+DEFINE_SERIALIZER_OUTSIDE(ReplString, str, leftEnd, rightBegin, score);
+
+DEFINE_SERIALIZER_OUTSIDE(Replacement, repl, leftVowel, leftPolarity, ignoreRCond);
+
+template<class NodeSizeTy, class GroupSizeTy>
+void MultiRuleDFA<NodeSizeTy, GroupSizeTy>::serializerRead(std::istream& istr)
+{
+	serializer::readMany(istr, vocabs, transition, finishGroup, sepGroupFlatten, sepGroupPtrs, groupInfo, finish);
+}
+
+template<class NodeSizeTy, class GroupSizeTy>
+void MultiRuleDFA<NodeSizeTy, GroupSizeTy>::serializerWrite(std::ostream& ostr) const
+{
+	serializer::writeMany(ostr, vocabs, transition, finishGroup, sepGroupFlatten, sepGroupPtrs, groupInfo, finish);
+}
+
+DEFINE_SERIALIZER_OUTSIDE(CompiledRule::Allomorph, form, cvowel, priority);
+
+DEFINE_SERIALIZER_OUTSIDE(CompiledRule, serializer::toKey("KCRL"), dfa, dfaRight, map, allomorphData, allomorphPtrMap);
+
 uint8_t CompiledRule::toFeature(CondVowel cv, CondPolarity cp)
 {
 	uint8_t feat = 0;
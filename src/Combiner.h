@@ -26,6 +26,9 @@ namespace kiwi
 				: str{ _str }, leftEnd{ std::min(_leftEnd, str.size()) }, rightBegin{ _rightBegin }, score{ _score }
 			{
 			}
+
+			void serializerRead(std::istream& istr);
+			void serializerWrite(std::ostream& ostr) const;
 		};
 
 		struct Replacement
@@ -41,6 +44,9 @@ namespace kiwi
 				bool _ignoreRCond = false
 			) : repl{ _repl }, leftVowel{ _leftVowel }, leftPolarity{ _leftPolar }, ignoreRCond{ _ignoreRCond }
 			{}
+
+			void serializerRead(std::istream& istr);
+			void serializerWrite(std::ostream& ostr) const;
 		};
 
 		struct Result
@@ -87,6 +93,9 @@ namespace kiwi
 		public:
 			Vector<Result> combine(U16StringView left, U16StringView right) const;
 			Vector<std::tuple<size_t, size_t, CondPolarity>> searchLeftPat(U16StringView left, bool matchRuleSep = true) const;
+
+			void serializerRead(std::istream& istr);
+			void serializerWrite(std::ostream& ostr) const;
 		};
 
 		namespace detail
@@ -198,6 +207,9 @@ namespace kiwi
 					: form{ _form }, cvowel{ _cvowel }, priority{ _priority }
 				{
 				}
+
+				void serializerRead(std::istream& istr);
+				void serializerWrite(std::ostream& ostr) const;
 			};
 
 			Vector<MultiRuleDFAErased> dfa, dfaRight;
@@ -259,6 +271,9 @@ namespace kiwi
 
 			bool isReady() const { return !dfa.empty(); }
 
+			void serializerRead(std::istream& istr);
+			void serializerWrite(std::ostream& ostr) const;
+
 			std::vector<std::u16string> combine(
 				U16StringView leftForm, POSTag leftTag,
 				U16StringView rightForm, POSTag rightTag,
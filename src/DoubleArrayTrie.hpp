@@ -0,0 +1,301 @@
+#pragma once
+
+#include <stdexcept>
+#include <kiwi/DoubleArrayTrie.h>
+#include <kiwi/Utils.h>
+#include "FrozenTrie.hpp"
+
+namespace kiwi
+{
+	namespace utils
+	{
+		template<class _Key, class _Value, class _HasSubmatch>
+		template<ArchType arch>
+		auto DoubleArrayTrie<_Key, _Value, _HasSubmatch>::Node::nextOpt(const DoubleArrayTrie& dat, Key c) const -> const Node*
+		{
+			const Code code = dat.codes[(size_t)(typename std::make_unsigned<Key>::type)c];
+			if (!code) return nullptr;
+			const Node* child = dat.nodes.get() + base + code;
+			if (child->check != (uint32_t)(this - dat.nodes.get())) return nullptr;
+			return child;
+		}
+
+		template<class _Key, class _Value, class _HasSubmatch>
+		auto DoubleArrayTrie<_Key, _Value, _HasSubmatch>::Node::fail() const -> const Node*
+		{
+			if (!lower) return nullptr;
+			return this + lower;
+		}
+
+		template<class _Key, class _Value, class _HasSubmatch>
+		template<ArchType arch>
+		auto DoubleArrayTrie<_Key, _Value, _HasSubmatch>::Node::findFail(const DoubleArrayTrie& dat, Key c) const -> const Node*
+		{
+			if (!lower) return this;
+			auto* lowerNode = this + lower;
+			if (auto* next = lowerNode->template nextOpt<arch>(dat, c)) return next;
+			// `c` node doesn't exist
+			return lowerNode->template findFail<arch>(dat, c);
+		}
+
+		template<class _Key, class _Value, class _HasSubmatch>
+		auto DoubleArrayTrie<_Key, _Value, _HasSubmatch>::Node::val(const DoubleArrayTrie& dat) const -> const Value&
+		{
+			return dat.values[this - dat.nodes.get()];
+		}
+
+		template<class _Key, class _Value, class _HasSubmatch>
+		DoubleArrayTrie<_Key, _Value, _HasSubmatch>::DoubleArrayTrie(const DoubleArrayTrie& o)
+			: numSlots{ o.numSlots }, numCodes{ o.numCodes }
+		{
+			if (!numSlots) return;
+			nodes = make_unique<Node[]>(numSlots);
+			values = make_unique<Value[]>(numSlots);
+			codes = make_unique<Code[]>(codeTableSize);
+
+			std::copy(o.nodes.get(), o.nodes.get() + numSlots, nodes.get());
+			std::copy(o.values.get(), o.values.get() + numSlots, values.get());
+			std::copy(o.codes.get(), o.codes.get() + codeTableSize, codes.get());
+		}
+
+		template<class _Key, class _Value, class _HasSubmatch>
+		auto DoubleArrayTrie<_Key, _Value, _HasSubmatch>::operator=(const DoubleArrayTrie& o) -> DoubleArrayTrie&
+		{
+			DoubleArrayTrie copied{ o };
+			return *this = std::move(copied);
+		}
+
+		template<class _Key, class _Value, class _HasSubmatch>
+		template<class ToIdx>
+		void DoubleArrayTrie<_Key, _Value, _HasSubmatch>::writeTo(std::ostream& ostr, ToIdx&& toIdx) const
+		{
+			static_assert(std::is_trivially_copyable<Node>::value, "Node must be trivially copyable.");
+
+			// FrozenTrie와 마찬가지로 0은 null, -1은 submatch를 나타내므로 실제 인덱스는 1씩 밀려 저장된다.
+			Vector<uint32_t> valueIdx(numSlots);
+			for (size_t i = 0; i < numSlots; ++i)
+			{
+				if (this->isNull(values[i])) valueIdx[i] = 0;
+				else if (this->hasSubmatch(values[i])) valueIdx[i] = (uint32_t)-1;
+				else valueIdx[i] = (uint32_t)toIdx(values[i]) + 1;
+			}
+
+			serializer::writeMany(ostr, serializer::toKey("DATR"), (uint32_t)sizeof(Key), (uint64_t)numSlots, (uint64_t)numCodes);
+			if (!numSlots) return;
+			detail::writeFrozenTrieArray(ostr, nodes.get(), numSlots);
+			detail::writeFrozenTrieArray(ostr, valueIdx.data(), numSlots);
+			detail::writeFrozenTrieArray(ostr, codes.get(), codeTableSize);
+		}
+
+		template<class _Key, class _Value, class _HasSubmatch>
+		template<class FromIdx>
+		auto DoubleArrayTrie<_Key, _Value, _HasSubmatch>::readFrom(std::istream& istr, FromIdx&& fromIdx) -> DoubleArrayTrie
+		{
+			uint32_t keySize;
+			uint64_t numSlots, numCodes;
+			serializer::readMany(istr, serializer::toKey("DATR"), keySize, numSlots, numCodes);
+			if (keySize != sizeof(Key))
+			{
+				throw serializer::SerializationException{ "DoubleArrayTrie has incompatible key type" };
+			}
+
+			DoubleArrayTrie ret;
+			if (!numSlots) return ret;
+			if (numCodes >= codeTableSize || numSlots >= npos) throw serializer::SerializationException{ "reading DoubleArrayTrie failed" };
+			ret.numSlots = numSlots;
+			ret.numCodes = numCodes;
+			ret.nodes = make_unique<Node[]>(numSlots);
+			ret.values = make_unique<Value[]>(numSlots);
+			ret.codes = make_unique<Code[]>(codeTableSize);
+
+			Vector<uint32_t> valueIdx(numSlots);
+			detail::readFrozenTrieArray(istr, ret.nodes.get(), numSlots);
+			detail::readFrozenTrieArray(istr, valueIdx.data(), numSlots);
+			detail::readFrozenTrieArray(istr, ret.codes.get(), codeTableSize);
+
+			// nextOpt()와 fail()은 범위를 확인하지 않으므로 읽어들인 배열이 노드 배열 밖을 가리키지 않는지 미리 확인한다
+			for (size_t i = 0; i < codeTableSize; ++i)
+			{
+				if (ret.codes[i] > numCodes) throw serializer::SerializationException{ "reading DoubleArrayTrie failed" };
+			}
+			for (size_t i = 0; i < numSlots; ++i)
+			{
+				auto& n = ret.nodes[i];
+				const int64_t lowerIdx = (int64_t)i + n.lower;
+				if ((size_t)n.base + numCodes >= numSlots || lowerIdx < 0 || lowerIdx >= (int64_t)numSlots)
+				{
+					throw serializer::SerializationException{ "reading DoubleArrayTrie failed" };
+				}
+
+				if (valueIdx[i] == 0) ret.values[i] = Value{};
+				else if (valueIdx[i] == (uint32_t)-1) ret.setHasSubmatch(ret.values[i]);
+				else ret.values[i] = fromIdx((size_t)valueIdx[i] - 1);
+			}
+			return ret;
+		}
+
+		template<class _Key, class _Value, class _HasSubmatch>
+		template<class TrieNode, class Xform>
+		DoubleArrayTrie<_Key, _Value, _HasSubmatch>::DoubleArrayTrie(const ContinuousTrie<TrieNode>& trie, Xform xform)
+		{
+			const size_t numNodes = trie.size();
+			if (!numNodes) return;
+
+			// 자주 쓰이는 키일수록 작은 코드를 받도록 하여 자식 노드들이 좁은 범위에 모이게 한다
+			Vector<size_t> freqs(codeTableSize);
+			Vector<uint8_t> hasParent(numNodes);
+			for (size_t i = 0; i < numNodes; ++i)
+			{
+				for (auto& p : trie[i].next)
+				{
+					if (p.second <= 0) throw std::invalid_argument{ "DoubleArrayTrie can be built only from a tree-shaped trie" };
+					hasParent[i + p.second] = 1;
+					++freqs[(size_t)(typename std::make_unsigned<Key>::type)p.first];
+				}
+			}
+			if (hasParent[0]) throw std::invalid_argument{ "the root node must not have a parent" };
+
+			Vector<uint32_t> sortedKeys;
+			for (size_t k = 0; k < codeTableSize; ++k)
+			{
+				if (freqs[k]) sortedKeys.emplace_back((uint32_t)k);
+			}
+			std::stable_sort(sortedKeys.begin(), sortedKeys.end(), [&](uint32_t a, uint32_t b)
+			{
+				return freqs[a] > freqs[b];
+			});
+			if (sortedKeys.size() >= (1 << (sizeof(Code) * 8))) throw std::invalid_argument{ "too many distinct keys" };
+
+			codes = make_unique<Code[]>(codeTableSize);
+			std::fill(codes.get(), codes.get() + codeTableSize, 0);
+			for (size_t i = 0; i < sortedKeys.size(); ++i)
+			{
+				codes[sortedKeys[i]] = (Code)(i + 1);
+			}
+			numCodes = sortedKeys.size();
+
+			// 루트를 포함하여 부모가 없는 앞쪽 노드들은 원래 인덱스에 고정한다
+			size_t numPinned = 1;
+			while (numPinned < numNodes && !hasParent[numPinned]) ++numPinned;
+
+			Vector<Node> slots(numPinned);
+			Vector<uint32_t> slotOf(numNodes, npos);
+			// skipTo[i]는 i 이상인 빈 칸 중 후보로 살펴볼 가장 앞의 위치를 가리킨다(경로 압축).
+			Vector<uint32_t> skipTo(numPinned), numTries(numPinned);
+			for (size_t i = 0; i < numPinned; ++i)
+			{
+				slotOf[i] = i;
+				skipTo[i] = i + 1;
+			}
+
+			auto grow = [&](size_t size)
+			{
+				while (slots.size() < size)
+				{
+					skipTo.emplace_back((uint32_t)slots.size());
+					numTries.emplace_back(0);
+					slots.emplace_back();
+				}
+			};
+
+			auto findFree = [&](size_t from) -> size_t
+			{
+				size_t i = from;
+				while (i < skipTo.size() && skipTo[i] != i) i = skipTo[i];
+				for (size_t j = from; j < skipTo.size() && skipTo[j] != j;)
+				{
+					const size_t next = skipTo[j];
+					skipTo[j] = (uint32_t)i;
+					j = next;
+				}
+				return i;
+			};
+
+			auto isFree = [&](size_t i)
+			{
+				return i >= slots.size() || (slots[i].check == npos && i >= numPinned);
+			};
+
+			Vector<uint32_t> order;
+			Vector<std::pair<Code, uint32_t>> children;
+			order.emplace_back(0);
+			size_t maxBase = 0;
+			for (size_t q = 0; q < order.size(); ++q)
+			{
+				const size_t idx = order[q];
+				const size_t s = slotOf[idx];
+				children.clear();
+				for (auto& p : trie[idx].next)
+				{
+					children.emplace_back(codes[(size_t)(typename std::make_unsigned<Key>::type)p.first], (uint32_t)(idx + p.second));
+				}
+				if (children.empty()) continue;
+				std::sort(children.begin(), children.end());
+
+				const size_t firstCode = children[0].first;
+				size_t base = 0;
+				for (size_t f = findFree(std::max(firstCode, numPinned));; f = findFree(f + 1))
+				{
+					base = f - firstCode;
+					bool fits = true;
+					for (size_t i = 1; i < children.size(); ++i)
+					{
+						if (!isFree(base + children[i].first))
+						{
+							fits = false;
+							break;
+						}
+					}
+					if (fits) break;
+
+					// 여러 번 실패한 빈 칸은 이후 탐색에서 건너뛰어 배치 시간이 길어지지 않도록 한다
+					if (f < numTries.size() && ++numTries[f] >= 16) skipTo[f] = (uint32_t)(f + 1);
+				}
+
+				grow(base + children.back().first + 1);
+				slots[s].base = (uint32_t)base;
+				maxBase = std::max(maxBase, base);
+				for (auto& c : children)
+				{
+					const size_t cs = base + c.first;
+					slots[cs].check = (uint32_t)s;
+					skipTo[cs] = (uint32_t)(cs + 1);
+					slotOf[c.second] = (uint32_t)cs;
+					order.emplace_back(c.second);
+				}
+			}
+
+			// 자식이 없는 노드의 base는 0이므로, 어떤 노드에서 어떤 코드로 전이하더라도 배열 범위 안을 읽도록 뒤에 빈 칸을 덧붙인다
+			grow(maxBase + numCodes + 1);
+			numSlots = slots.size();
+			nodes = make_unique<Node[]>(numSlots);
+			values = make_unique<Value[]>(numSlots);
+			std::copy(slots.begin(), slots.end(), nodes.get());
+			std::fill(values.get(), values.get() + numSlots, Value{});
+			for (size_t i = 0; i < numNodes; ++i)
+			{
+				if (slotOf[i] != npos) values[slotOf[i]] = xform(trie[i]);
+			}
+
+			for (auto idx : order)
+			{
+				auto* p = &nodes[slotOf[idx]];
+				for (auto& c : trie[idx].next)
+				{
+					auto* child = &nodes[slotOf[idx + c.second]];
+					child->lower = (int32_t)(p->template findFail<ArchType::none>(*this, c.first) - child);
+				}
+
+				if (this->isNull(p->val(*this)))
+				{
+					for (auto n = p; n->lower; n = const_cast<Node*>(n->fail()))
+					{
+						if (this->isNull(n->val(*this))) continue;
+						this->setHasSubmatch(values[p - nodes.get()]);
+						break;
+					}
+				}
+			}
+		}
+	}
+}
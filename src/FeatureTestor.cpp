@@ -112,3 +112,22 @@ bool FeatureTestor::isMatchedApprox(const kchar_t* begin, const kchar_t* end, Co
 {
 	return isMatched(begin, end, vowel) && isMatchedApprox(begin, end, polar);
 }
+
+uint16_t FeatureTestor::leftContextMask(const kchar_t* begin, const kchar_t* end)
+{
+	uint16_t ret = 0;
+	for (size_t v = 0; v <= (size_t)CondVowel::applosive; ++v)
+	{
+		if (isMatched(begin, end, (CondVowel)v)) ret |= 1 << v;
+	}
+	for (size_t p = 0; p <= (size_t)CondPolarity::non_adj; ++p)
+	{
+		if (isMatched(begin, end, (CondPolarity)p)) ret |= 1 << (polarityShift + p);
+	}
+	return ret;
+}
+
+uint16_t FeatureTestor::leftContextMask(const KString* form)
+{
+	return leftContextMask(form ? &(*form)[0] : nullptr, form ? &(*form)[0] + form->size() : nullptr);
+}
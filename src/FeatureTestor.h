@@ -17,6 +17,34 @@ namespace kiwi
 		static bool isMatched(const KString* form, CondVowel vowel, CondPolarity polar);
 
 		static bool isMatchedApprox(const kchar_t* begin, const kchar_t* end, CondVowel vowel, CondPolarity polar);
+
+		/** `condMask`에서 CondPolarity 비트가 시작하는 위치 */
+		static constexpr size_t polarityShift = 9;
+
+		/** 모든 결합조건을 만족하는 마스크. 좌측 결합조건을 적용하지 않을 때 사용한다. */
+		static constexpr uint16_t anyCondMask = (1 << (polarityShift + 4)) - 1;
+
+		/**
+		 * @brief 형태소의 좌측 결합조건을 비트 마스크로 변환한다.
+		 * @details CondVowel 값 v에 대해 (1 << v), CondPolarity 값 p에 대해 (1 << (polarityShift + p)) 비트가 설정된다.
+		 */
+		static constexpr uint16_t condMask(CondVowel vowel, CondPolarity polar)
+		{
+			return (uint16_t)((1 << (size_t)vowel) | (1 << (polarityShift + (size_t)polar)));
+		}
+
+		/**
+		 * @brief [begin, end) 형태가 좌측에 올 때 만족되는 모든 결합조건을 `condMask`와 같은 배치의 비트 마스크로 반환한다.
+		 * @details 한 번 계산해두면 `isMatched(leftMask, vowel, polar)`로 각 조건을 AND 연산 한 번에 확인할 수 있다.
+		 */
+		static uint16_t leftContextMask(const kchar_t* begin, const kchar_t* end);
+		static uint16_t leftContextMask(const KString* form);
+
+		static bool isMatched(uint16_t leftMask, CondVowel vowel, CondPolarity polar)
+		{
+			const uint16_t required = condMask(vowel, polar);
+			return (leftMask & required) == required;
+		}
 	};
 
 	inline bool hasNoOnset(const KString& form)
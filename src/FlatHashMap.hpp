@@ -0,0 +1,207 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <kiwi/Types.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define KIWI_FLAT_HASH_MAP_SSE2
+#endif
+
+namespace kiwi
+{
+	namespace utils
+	{
+		/**
+		 * @brief 64bit 정수의 비트를 고르게 섞는다. (splitmix64의 마무리 단계)
+		 */
+		inline uint64_t mixHash(uint64_t h)
+		{
+			h ^= h >> 30;
+			h *= 0xbf58476d1ce4e5b9ull;
+			h ^= h >> 27;
+			h *= 0x94d049bb133111ebull;
+			h ^= h >> 31;
+			return h;
+		}
+
+		/**
+		 * @brief 삽입과 탐색만 지원하는 open addressing 해시 맵.
+		 * @details 슬롯마다 16bit 제어값(상위 8bit: 세대 번호, 하위 7bit: 해시의 일부)을 두고,
+		 * 8개 슬롯으로 이루어진 그룹 단위로 선형 탐사하며 제어값을 한 번에 비교한다.
+		 * `clear()`는 세대 번호만 올리므로 크기와 상관없이 상수 시간에 끝난다.
+		 * 원소는 삭제할 수 없으며, `forEach()`는 삽입된 순서대로 원소를 방문한다.
+		 */
+		template<class Key, class Value, class Hasher = Hash<Key>, class KeyEqual = std::equal_to<Key>>
+		class FlatHashMap
+		{
+			static constexpr size_t groupSize = 8;
+			static constexpr size_t initialCapacity = 64;
+
+			Vector<uint16_t> ctrls;
+			Vector<Key> keys;
+			Vector<Value> values;
+			Vector<uint32_t> order;
+			size_t mask = 0;
+			uint16_t gen = 1;
+
+			uint16_t makeCtrl(size_t h) const
+			{
+				return (uint16_t)((gen << 8) | 0x80 | (h & 0x7F));
+			}
+
+			/**
+			 * @brief 그룹 g 안에서 제어값이 ctrl과 같은 슬롯과 비어 있는 슬롯의 비트마스크를 구한다.
+			 */
+			void matchGroup(size_t g, uint16_t ctrl, uint32_t& matched, uint32_t& empty) const
+			{
+				const uint16_t* p = &ctrls[g * groupSize];
+#ifdef KIWI_FLAT_HASH_MAP_SSE2
+				const __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+				const __m128i eq = _mm_cmpeq_epi16(group, _mm_set1_epi16((short)ctrl));
+				const __m128i live = _mm_cmpeq_epi16(_mm_and_si128(group, _mm_set1_epi16((short)0xFF00)), _mm_set1_epi16((short)(gen << 8)));
+				// movemask는 lane마다 2bit를 내므로 짝수 bit만 남긴다
+				matched = (uint32_t)_mm_movemask_epi8(eq) & 0x5555;
+				empty = ~(uint32_t)_mm_movemask_epi8(live) & 0x5555;
+#else
+				matched = 0;
+				empty = 0;
+				for (size_t i = 0; i < groupSize; ++i)
+				{
+					if (p[i] == ctrl) matched |= 1u << (i * 2);
+					if ((p[i] >> 8) != gen) empty |= 1u << (i * 2);
+				}
+#endif
+			}
+
+			static size_t lowestLane(uint32_t bits)
+			{
+				size_t i = 0;
+				while (!(bits & 1))
+				{
+					bits >>= 2;
+					++i;
+				}
+				return i;
+			}
+
+			/**
+			 * @brief key가 있는 슬롯을 찾는다. 없는 경우 key가 들어갈 빈 슬롯을 반환하고 found를 false로 설정한다.
+			 */
+			size_t findSlot(const Key& key, size_t h, bool& found) const
+			{
+				const uint16_t ctrl = makeCtrl(h >> 57);
+				const size_t numGroups = (mask + 1) / groupSize;
+				for (size_t g = h & (numGroups - 1);; g = (g + 1) & (numGroups - 1))
+				{
+					uint32_t matched, empty;
+					matchGroup(g, ctrl, matched, empty);
+					while (matched)
+					{
+						const size_t slot = g * groupSize + lowestLane(matched);
+						if (KeyEqual{}(keys[slot], key))
+						{
+							found = true;
+							return slot;
+						}
+						matched &= matched - 1;
+					}
+					if (empty)
+					{
+						found = false;
+						return g * groupSize + lowestLane(empty);
+					}
+				}
+			}
+
+			void rehash(size_t newCapacity)
+			{
+				Vector<Key> oldKeys;
+				Vector<Value> oldValues;
+				oldKeys.reserve(order.size());
+				oldValues.reserve(order.size());
+				for (auto slot : order)
+				{
+					oldKeys.emplace_back(std::move(keys[slot]));
+					oldValues.emplace_back(std::move(values[slot]));
+				}
+
+				ctrls.assign(newCapacity, 0);
+				keys.resize(newCapacity);
+				values.resize(newCapacity);
+				mask = newCapacity - 1;
+				order.clear();
+				for (size_t i = 0; i < oldKeys.size(); ++i)
+				{
+					const size_t h = Hasher{}(oldKeys[i]);
+					bool found;
+					const size_t slot = findSlot(oldKeys[i], h, found);
+					ctrls[slot] = makeCtrl(h >> 57);
+					keys[slot] = std::move(oldKeys[i]);
+					values[slot] = std::move(oldValues[i]);
+					order.emplace_back(slot);
+				}
+			}
+
+		public:
+			size_t size() const
+			{
+				return order.size();
+			}
+
+			bool empty() const
+			{
+				return order.empty();
+			}
+
+			size_t capacityBytes() const
+			{
+				return ctrls.capacity() * sizeof(uint16_t)
+					+ keys.capacity() * sizeof(Key)
+					+ values.capacity() * sizeof(Value)
+					+ order.capacity() * sizeof(uint32_t);
+			}
+
+			void clear()
+			{
+				order.clear();
+				if (++gen > 0xFF)
+				{
+					std::fill(ctrls.begin(), ctrls.end(), 0);
+					gen = 1;
+				}
+			}
+
+			/**
+			 * @brief key가 없으면 value와 함께 삽입한다.
+			 * @return 맵 안의 값을 가리키는 포인터와 새로 삽입되었는지 여부. 포인터는 다음 삽입 전까지만 유효하다.
+			 */
+			std::pair<Value*, bool> emplace(const Key& key, const Value& value)
+			{
+				if (ctrls.empty()) rehash(initialCapacity);
+				else if ((order.size() + 1) * 8 > (mask + 1) * 7) rehash((mask + 1) * 2);
+
+				const size_t h = Hasher{}(key);
+				bool found;
+				const size_t slot = findSlot(key, h, found);
+				if (found) return std::make_pair(&values[slot], false);
+
+				ctrls[slot] = makeCtrl(h >> 57);
+				keys[slot] = key;
+				values[slot] = value;
+				order.emplace_back(slot);
+				return std::make_pair(&values[slot], true);
+			}
+
+			/**
+			 * @brief 삽입된 순서대로 fn(key, value)를 호출한다.
+			 */
+			template<class Fn>
+			void forEach(Fn&& fn)
+			{
+				for (auto slot : order) fn(keys[slot], values[slot]);
+			}
+		};
+	}
+}
@@ -3,6 +3,7 @@
 #include <kiwi/Utils.h>
 #include <kiwi/Form.h>
 #include "serializer.hpp"
+#include "FeatureTestor.h"
 
 using namespace std;
 
@@ -114,6 +115,7 @@ namespace kiwi
 		ret.polar = o.polar();
 		ret.complex = o.complex();
 		ret.combineSocket = o.combineSocket;
+		ret.leftCondMask = FeatureTestor::leftContextMask(ret.kform);
 		ret.combined = o.combined;
 		ret.userScore = o.userScore;
 		ret.lmMorphemeId = o.lmMorphemeId;
@@ -3,6 +3,7 @@
 #include <kiwi/FrozenTrie.h>
 #include <kiwi/Utils.h>
 #include "search.h"
+#include "serializer.hpp"
 #include "ArchAvailable.h"
 
 namespace kiwi
@@ -54,39 +55,66 @@ namespace kiwi
 		template<class _Key, class _Value, class _Diff, class _HasSubmatch>
 		auto FrozenTrie<_Key, _Value, _Diff, _HasSubmatch>::Node::val(const FrozenTrie& ft) const -> const Value&
 		{
-			return ft.values[this - ft.nodes.get()];
+			return ft.values[this - ft.nodes];
 		}
 
 		template<class _Key, class _Value, class _Diff, class _HasSubmatch>
-		FrozenTrie<_Key, _Value, _Diff, _HasSubmatch>::FrozenTrie(const FrozenTrie& o)
-			: numNodes{ o.numNodes }, numNexts{ o.numNexts }
+		void FrozenTrie<_Key, _Value, _Diff, _HasSubmatch>::allocate(size_t _numNodes, size_t _numNexts)
 		{
-			nodes = make_unique<Node[]>(numNodes);
-			values = make_unique<Value[]>(numNodes);
-			nextKeys = make_unique<Key[]>(numNexts);
-			nextDiffs = make_unique<Diff[]>(numNexts);
+			numNodes = _numNodes;
+			numNexts = _numNexts;
+			ownedNodes = make_unique<Node[]>(numNodes);
+			ownedValues = make_unique<Value[]>(numNodes);
+			ownedNextKeys = make_unique<Key[]>(numNexts);
+			ownedNextDiffs = make_unique<Diff[]>(numNexts);
+			nodes = ownedNodes.get();
+			values = ownedValues.get();
+			nextKeys = ownedNextKeys.get();
+			nextDiffs = ownedNextDiffs.get();
+		}
 
-			std::copy(o.nodes.get(), o.nodes.get() + numNodes, nodes.get());
-			std::copy(o.values.get(), o.values.get() + numNodes, values.get());
-			std::copy(o.nextKeys.get(), o.nextKeys.get() + numNexts, nextKeys.get());
-			std::copy(o.nextDiffs.get(), o.nextDiffs.get() + numNexts, nextDiffs.get());
+		template<class _Key, class _Value, class _Diff, class _HasSubmatch>
+		FrozenTrie<_Key, _Value, _Diff, _HasSubmatch>::FrozenTrie(const FrozenTrie& o)
+		{
+			*this = o;
 		}
 
 		template<class _Key, class _Value, class _Diff, class _HasSubmatch>
 		auto FrozenTrie<_Key, _Value, _Diff, _HasSubmatch>::operator=(const FrozenTrie& o) -> FrozenTrie&
 		{
-			numNodes = o.numNodes;
-			numNexts = o.numNexts;
-
-			nodes = make_unique<Node[]>(numNodes);
-			values = make_unique<Value[]>(numNodes);
-			nextKeys = make_unique<Key[]>(numNexts);
-			nextDiffs = make_unique<Diff[]>(numNexts);
+			if (this == &o) return *this;
+			if (o.memory)
+			{
+				// 뷰는 메모리를 공유하고, 따로 만든 값 배열만 복사한다
+				numNodes = o.numNodes;
+				numNexts = o.numNexts;
+				memory = make_unique<MemoryObject>(*o.memory);
+				ownedNodes.reset();
+				ownedNextKeys.reset();
+				ownedNextDiffs.reset();
+				nodes = o.nodes;
+				nextKeys = o.nextKeys;
+				nextDiffs = o.nextDiffs;
+				if (o.ownedValues)
+				{
+					ownedValues = make_unique<Value[]>(numNodes);
+					std::copy(o.values, o.values + numNodes, ownedValues.get());
+					values = ownedValues.get();
+				}
+				else
+				{
+					ownedValues.reset();
+					values = o.values;
+				}
+				return *this;
+			}
 
-			std::copy(o.nodes.get(), o.nodes.get() + numNodes, nodes.get());
-			std::copy(o.values.get(), o.values.get() + numNodes, values.get());
-			std::copy(o.nextKeys.get(), o.nextKeys.get() + numNexts, nextKeys.get());
-			std::copy(o.nextDiffs.get(), o.nextDiffs.get() + numNexts, nextDiffs.get());
+			memory.reset();
+			allocate(o.numNodes, o.numNexts);
+			std::copy(o.nodes, o.nodes + numNodes, ownedNodes.get());
+			std::copy(o.values, o.values + numNodes, ownedValues.get());
+			std::copy(o.nextKeys, o.nextKeys + numNexts, ownedNextKeys.get());
+			std::copy(o.nextDiffs, o.nextDiffs + numNexts, ownedNextDiffs.get());
 			return *this;
 		}
 
@@ -94,40 +122,35 @@ namespace kiwi
 		template<class TrieNode, ArchType archType, class Xform>
 		FrozenTrie<_Key, _Value, _Diff, _HasSubmatch>::FrozenTrie(const ContinuousTrie<TrieNode>& trie, ArchTypeHolder<archType>, Xform xform)
 		{
-			numNodes = trie.size();
-			nodes = make_unique<Node[]>(numNodes);
-			values = make_unique<Value[]>(numNodes);
-
+			size_t totalNexts = 0;
 			for (size_t i = 0; i < trie.size(); ++i)
 			{
-				numNexts += trie[i].next.size();
+				totalNexts += trie[i].next.size();
 			}
-
-			nextKeys = make_unique<Key[]>(numNexts);
-			nextDiffs = make_unique<Diff[]>(numNexts);
+			allocate(trie.size(), totalNexts);
 
 			size_t ptr = 0;
 			Vector<uint8_t> tempBuf;
 			for (size_t i = 0; i < trie.size(); ++i)
 			{
 				auto& o = trie[i];
-				nodes[i].numNexts = o.next.size();
-				values[i] = xform(o);
-				nodes[i].nextOffset = ptr;
+				ownedNodes[i].numNexts = o.next.size();
+				ownedValues[i] = xform(o);
+				ownedNodes[i].nextOffset = ptr;
 
 				std::vector<std::pair<Key, Diff>> pairs{ o.next.begin(), o.next.end() };
 				std::sort(pairs.begin(), pairs.end());
 				for (auto& p : pairs)
 				{
-					nextKeys[ptr] = p.first;
-					nextDiffs[ptr] = p.second;
+					ownedNextKeys[ptr] = p.first;
+					ownedNextDiffs[ptr] = p.second;
 					++ptr;
 				}
-				nst::prepare<archType>(&nextKeys[nodes[i].nextOffset], &nextDiffs[nodes[i].nextOffset], pairs.size(), tempBuf);
+				nst::prepare<archType>(&ownedNextKeys[ownedNodes[i].nextOffset], &ownedNextDiffs[ownedNodes[i].nextOffset], pairs.size(), tempBuf);
 			}
 
 			Deque<Node*> dq;
-			for (dq.emplace_back(&nodes[0]); !dq.empty(); dq.pop_front())
+			for (dq.emplace_back(&ownedNodes[0]); !dq.empty(); dq.pop_front())
 			{
 				auto p = dq.front();
 				for (size_t i = 0; i < p->numNexts; ++i)
@@ -145,13 +168,181 @@ namespace kiwi
 					for (auto n = p; n->lower; n = const_cast<Node*>(n->fail()))
 					{
 						if (this->isNull(n->val(*this))) continue;
-						this->setHasSubmatch(values[p - nodes.get()]);
+						this->setHasSubmatch(ownedValues[p - nodes]);
 						break;
 					}
 				}
 			}
 		}
 
+		namespace detail
+		{
+			// 배열을 메모리에 그대로 매핑할 수 있도록 스트림 위치를 기준으로 정렬한다
+			static constexpr size_t frozenTrieAlignment = 8;
+
+			inline void writeFrozenTriePadding(std::ostream& ostr)
+			{
+				static const char zeros[frozenTrieAlignment] = { 0, };
+				const size_t pos = (size_t)ostr.tellp();
+				if (!ostr.write(zeros, (frozenTrieAlignment - pos % frozenTrieAlignment) % frozenTrieAlignment))
+				{
+					throw serializer::SerializationException{ "writing FrozenTrie failed" };
+				}
+			}
+
+			inline void skipFrozenTriePadding(std::istream& istr)
+			{
+				const size_t pos = (size_t)istr.tellg();
+				istr.seekg((frozenTrieAlignment - pos % frozenTrieAlignment) % frozenTrieAlignment, std::ios_base::cur);
+			}
+
+			template<class Ty>
+			void writeFrozenTrieArray(std::ostream& ostr, const Ty* data, size_t size)
+			{
+				writeFrozenTriePadding(ostr);
+				if (!ostr.write((const char*)data, sizeof(Ty) * size))
+				{
+					throw serializer::SerializationException{ "writing FrozenTrie failed" };
+				}
+			}
+
+			template<class Ty>
+			void readFrozenTrieArray(std::istream& istr, Ty* data, size_t size)
+			{
+				skipFrozenTriePadding(istr);
+				if (!istr.read((char*)data, sizeof(Ty) * size))
+				{
+					throw serializer::SerializationException{ "reading FrozenTrie failed" };
+				}
+			}
+
+			template<class Key, class Diff>
+			std::pair<size_t, size_t> readFrozenTrieHeader(std::istream& istr)
+			{
+				uint32_t keySize, diffSize;
+				uint64_t numNodes, numNexts;
+				serializer::readMany(istr, serializer::toKey("FTRI"), keySize, diffSize, numNodes, numNexts);
+				if (keySize != sizeof(Key) || diffSize != sizeof(Diff))
+				{
+					throw serializer::SerializationException{ "FrozenTrie has incompatible key or diff type" };
+				}
+				return std::make_pair((size_t)numNodes, (size_t)numNexts);
+			}
+		}
+
+		template<class _Key, class _Value, class _Diff, class _HasSubmatch>
+		template<class ToIdx>
+		void FrozenTrie<_Key, _Value, _Diff, _HasSubmatch>::writeTo(std::ostream& ostr, ToIdx&& toIdx) const
+		{
+			static_assert(std::is_trivially_copyable<Node>::value, "Node must be trivially copyable.");
+
+			// 0 is reserved for null and -1 for submatch, so actual indices are shifted by 1.
+			Vector<uint32_t> valueIdx(numNodes);
+			for (size_t i = 0; i < numNodes; ++i)
+			{
+				if (this->isNull(values[i])) valueIdx[i] = 0;
+				else if (this->hasSubmatch(values[i])) valueIdx[i] = (uint32_t)-1;
+				else valueIdx[i] = (uint32_t)toIdx(values[i]) + 1;
+			}
+
+			serializer::writeMany(ostr, serializer::toKey("FTRI"), (uint32_t)sizeof(Key), (uint32_t)sizeof(Diff), (uint64_t)numNodes, (uint64_t)numNexts);
+			detail::writeFrozenTrieArray(ostr, nodes, numNodes);
+			detail::writeFrozenTrieArray(ostr, valueIdx.data(), numNodes);
+			detail::writeFrozenTrieArray(ostr, nextKeys, numNexts);
+			detail::writeFrozenTrieArray(ostr, nextDiffs, numNexts);
+		}
+
+		template<class _Key, class _Value, class _Diff, class _HasSubmatch>
+		void FrozenTrie<_Key, _Value, _Diff, _HasSubmatch>::writeTo(std::ostream& ostr) const
+		{
+			static_assert(std::is_integral<Value>::value, "writeTo() without `toIdx` requires integral values.");
+			writeTo(ostr, [](Value v) { return (size_t)v - 1; });
+		}
+
+		template<class _Key, class _Value, class _Diff, class _HasSubmatch>
+		template<class FromIdx>
+		auto FrozenTrie<_Key, _Value, _Diff, _HasSubmatch>::readFrom(std::istream& istr, FromIdx&& fromIdx) -> FrozenTrie
+		{
+			auto sizes = detail::readFrozenTrieHeader<Key, Diff>(istr);
+			FrozenTrie ret;
+			ret.allocate(sizes.first, sizes.second);
+
+			Vector<uint32_t> valueIdx(ret.numNodes);
+			detail::readFrozenTrieArray(istr, ret.ownedNodes.get(), ret.numNodes);
+			detail::readFrozenTrieArray(istr, valueIdx.data(), ret.numNodes);
+			detail::readFrozenTrieArray(istr, ret.ownedNextKeys.get(), ret.numNexts);
+			detail::readFrozenTrieArray(istr, ret.ownedNextDiffs.get(), ret.numNexts);
+
+			for (size_t i = 0; i < ret.numNodes; ++i)
+			{
+				if (valueIdx[i] == 0) ret.ownedValues[i] = Value{};
+				else if (valueIdx[i] == (uint32_t)-1) ret.setHasSubmatch(ret.ownedValues[i]);
+				else ret.ownedValues[i] = fromIdx((size_t)valueIdx[i] - 1);
+			}
+			return ret;
+		}
+
+		template<class _Key, class _Value, class _Diff, class _HasSubmatch>
+		template<class Ty>
+		const Ty* FrozenTrie<_Key, _Value, _Diff, _HasSubmatch>::mapArray(imstream& istr, const MemoryObject& mem, size_t size)
+		{
+			detail::skipFrozenTriePadding(istr);
+			auto* ptr = reinterpret_cast<const Ty*>(istr.curptr());
+			if ((size_t)ptr % alignof(Ty))
+			{
+				throw serializer::SerializationException{ "FrozenTrie is not aligned in memory" };
+			}
+			if (istr.curptr() + sizeof(Ty) * size > (const char*)mem.get() + mem.size())
+			{
+				throw serializer::SerializationException{ "reading FrozenTrie failed" };
+			}
+			istr.seekg(sizeof(Ty) * size, std::ios_base::cur);
+			return ptr;
+		}
+
+		template<class _Key, class _Value, class _Diff, class _HasSubmatch>
+		template<class FromIdx>
+		auto FrozenTrie<_Key, _Value, _Diff, _HasSubmatch>::mapFrom(imstream& istr, const MemoryObject& mem, FromIdx&& fromIdx) -> FrozenTrie
+		{
+			auto sizes = detail::readFrozenTrieHeader<Key, Diff>(istr);
+			FrozenTrie ret;
+			ret.numNodes = sizes.first;
+			ret.numNexts = sizes.second;
+			ret.memory = make_unique<MemoryObject>(mem);
+			ret.nodes = mapArray<Node>(istr, mem, ret.numNodes);
+			auto* valueIdx = mapArray<uint32_t>(istr, mem, ret.numNodes);
+			ret.nextKeys = mapArray<Key>(istr, mem, ret.numNexts);
+			ret.nextDiffs = mapArray<Diff>(istr, mem, ret.numNexts);
+
+			ret.ownedValues = make_unique<Value[]>(ret.numNodes);
+			for (size_t i = 0; i < ret.numNodes; ++i)
+			{
+				if (valueIdx[i] == 0) ret.ownedValues[i] = Value{};
+				else if (valueIdx[i] == (uint32_t)-1) ret.setHasSubmatch(ret.ownedValues[i]);
+				else ret.ownedValues[i] = fromIdx((size_t)valueIdx[i] - 1);
+			}
+			ret.values = ret.ownedValues.get();
+			return ret;
+		}
+
+		template<class _Key, class _Value, class _Diff, class _HasSubmatch>
+		auto FrozenTrie<_Key, _Value, _Diff, _HasSubmatch>::mapFrom(imstream& istr, const MemoryObject& mem) -> FrozenTrie
+		{
+			static_assert(std::is_integral<Value>::value && sizeof(Value) == sizeof(uint32_t), 
+				"mapFrom() without `fromIdx` requires 32-bit integral values.");
+			auto sizes = detail::readFrozenTrieHeader<Key, Diff>(istr);
+			FrozenTrie ret;
+			ret.numNodes = sizes.first;
+			ret.numNexts = sizes.second;
+			ret.memory = make_unique<MemoryObject>(mem);
+			ret.nodes = mapArray<Node>(istr, mem, ret.numNodes);
+			// 정수 값 `v`는 인덱스 `v - 1`에 1을 더해 저장되었으므로, 저장된 배열이 곧 값 배열이다.
+			ret.values = mapArray<Value>(istr, mem, ret.numNodes);
+			ret.nextKeys = mapArray<Key>(istr, mem, ret.numNexts);
+			ret.nextDiffs = mapArray<Diff>(istr, mem, ret.numNexts);
+			return ret;
+		}
+
 		namespace detail
 		{
 			template<ArchType archType, class Ty>
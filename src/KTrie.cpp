@@ -6,6 +6,9 @@
 #include "KTrie.h"
 #include "FeatureTestor.h"
 #include "FrozenTrie.hpp"
+#include "DoubleArrayTrie.hpp"
+#include "Arena.hpp"
+#include "AnalysisContext.hpp"
 
 using namespace std;
 using namespace kiwi;
@@ -145,7 +148,7 @@ namespace kiwi
 
 	template<bool typoTolerant, bool continualTypoTolerant>
 	bool insertCandidates(
-		Vector<FormCandidate<typoTolerant, continualTypoTolerant>>& candidates,
+		utils::ArenaVector<FormCandidate<typoTolerant, continualTypoTolerant>>& candidates,
 		const Form* foundCand,
 		const Form* formBase,
 		const size_t* typoPtrs,
@@ -209,11 +212,26 @@ namespace kiwi
 		}
 	}
 
+	/**
+	* @brief 형태 그래프 생성에 쓰이는 AnalysisContext 버퍼의 태그들
+	*/
+	namespace scratch
+	{
+		struct ConnectedList { using type = Vector<uint8_t>; };
+		struct NewIndexDiff { using type = Vector<uint16_t>; };
+		struct UpdateList { using type = Deque<uint32_t>; };
+		struct EndPosMap { using type = Vector<pair<uint32_t, uint32_t>>; };
+		struct NonSpaces { using type = Vector<uint32_t>; };
+		struct RawGraph { using type = Vector<KGraphNode>; };
+		struct PatternSpans { using type = Vector<PatternSpan>; };
+	}
+
 	inline void removeUnconnected(Vector<KGraphNode>& ret, const Vector<KGraphNode>& graph, const Vector<std::pair<uint32_t, uint32_t>>& endPosMap)
 	{
-		thread_local Vector<uint8_t> connectedList;
-		thread_local Vector<uint16_t> newIndexDiff;		
-		thread_local Deque<uint32_t> updateList;
+		auto& ctx = AnalysisContext::Impl::current();
+		auto& connectedList = ctx.get<scratch::ConnectedList>();
+		auto& newIndexDiff = ctx.get<scratch::NewIndexDiff>();
+		auto& updateList = ctx.get<scratch::UpdateList>();
 		connectedList.clear();
 		connectedList.resize(graph.size());
 		newIndexDiff.clear();
@@ -472,19 +490,19 @@ namespace kiwi
 		}
 	};
 
-	template<ArchType arch, class Decomposer, bool typoTolerant, bool continualTypoTolerant>
+	template<ArchType arch, class Decomposer, bool typoTolerant, bool continualTypoTolerant, class Trie>
 	inline void insertContinualTypoNode(
-		Vector<FormCandidate<typoTolerant, continualTypoTolerant>>& candidates,
-		Vector<pair<size_t, const utils::FrozenTrie<kchar_t, const Form*>::Node*>>& continualTypoRightNodes,
+		utils::ArenaVector<FormCandidate<typoTolerant, continualTypoTolerant>>& candidates,
+		utils::ArenaVector<pair<size_t, const typename Trie::Node*>>& continualTypoRightNodes,
 		Decomposer decomposer,
 		float continualTypoCost,
 		char16_t c,
 		const Form* formBase,
 		const size_t* typoPtrs,
-		const utils::FrozenTrie<kchar_t, const Form*>& trie,
+		const Trie& trie,
 		U16StringView str,
 		const Vector<uint32_t>& nonSpaces,
-		const utils::FrozenTrie<kchar_t, const Form*>::Node* curNode
+		const typename Trie::Node* curNode
 	)
 	{
 		if (!continualTypoTolerant) return;
@@ -537,12 +555,12 @@ inline bool isDiscontinuous(POSTag prevTag, POSTag curTag, ScriptType prevScript
 	return prevTag != curTag;
 }
 
-template<ArchType arch, bool typoTolerant, bool continualTypoTolerant>
+template<ArchType arch, bool typoTolerant, bool continualTypoTolerant, class Trie>
 size_t kiwi::splitByTrie(
 	Vector<KGraphNode>& ret,
 	const Form* formBase,
 	const size_t* typoPtrs,
-	const utils::FrozenTrie<kchar_t, const Form*>& trie, 
+	const Trie& trie, 
 	U16StringView str,
 	size_t startOffset,
 	Match matchOptions, 
@@ -569,29 +587,44 @@ size_t kiwi::splitByTrie(
 	*/
 	static constexpr size_t posMultiplier = continualTypoTolerant ? 4 : 1;
 
+	AnalysisContext::Impl::Binding contextBinding{ AnalysisContext::Impl::current() };
+	auto& ctx = AnalysisContext::Impl::current();
+	// 후보 목록 등 이 함수 안에서만 쓰이는 임시 메모리는 arena에서 할당받는다
+	utils::Arena::Scope arenaScope;
+
 	/*
 	* endPosMap[i]에는 out[x].endPos == i를 만족하는 첫번째 x(first)와 마지막 x + 1(second)가 들어 있다.
 	* first == second인 경우 endPos가 i인 노드가 없다는 것을 의미한다.
 	* first <= x && x < second인 out[x] 중에는 endPos가 i가 아닌 것도 있을 수 있으므로 주의해야 한다.
 	*/
-	thread_local Vector<pair<uint32_t, uint32_t>> endPosMap;
+	auto& endPosMap = ctx.get<scratch::EndPosMap>();
 	endPosMap.clear();
 	endPosMap.resize(str.size() * posMultiplier + 1, make_pair<uint32_t, uint32_t>(-1, -1));
 	endPosMap[0] = make_pair(0, 1);
 	
-	thread_local Vector<uint32_t> nonSpaces;
+	auto& nonSpaces = ctx.get<scratch::NonSpaces>();
 	nonSpaces.clear();
 	nonSpaces.reserve(str.size() * posMultiplier);
 
-	thread_local Vector<KGraphNode> out;
+	auto& out = ctx.get<scratch::RawGraph>();
 	out.clear();
 	out.emplace_back();
+
+	/*
+	* str은 청크가 아니라 남은 문서 전체이므로, 패턴 매칭 구간은 현재 위치에서 patternScanWindow만큼씩만 앞서 찾아두고
+	* 앞에서부터 차례로 소비한다. 청크가 끝나는 지점 너머로는 최대 한 구간만 더 훑게 된다.
+	*/
+	static constexpr size_t patternScanWindow = 256;
+	auto& patterns = ctx.get<scratch::PatternSpans>();
+	patterns.clear();
+	size_t nextPattern = 0, patternScanned = 0;
+
 	size_t n = 0;
-	Vector<FormCandidate<typoTolerant, continualTypoTolerant>> candidates;
+	utils::ArenaVector<FormCandidate<typoTolerant, continualTypoTolerant>> candidates;
 	auto* curNode = trie.root();
 	auto* curNodeForContinualTypo = trie.root();
 	auto* nextNode = trie.root();
-	Vector<pair<size_t, decltype(curNode)>> continualTypoRightNodes;
+	utils::ArenaVector<pair<size_t, decltype(curNode)>> continualTypoRightNodes;
 
 	size_t lastSpecialEndPos = 0, specialStartPos = 0;
 	POSTag chrType, lastChrType = POSTag::unknown, lastMatchedPattern = POSTag::unknown;
@@ -763,7 +796,26 @@ size_t kiwi::splitByTrie(
 
 		// 패턴 매칭
 		{
-			auto m = matchPattern(n ? str[n - 1] : u' ', str.data() + n, str.data() + str.size(), matchOptions);
+			// Pretokenized 구간을 건너뛰면서 지나친 패턴 구간이 있다면 현재 위치부터 다시 찾는다
+			if (nextPattern < patterns.size() && patterns[nextPattern].begin < n)
+			{
+				patterns.resize(nextPattern);
+				patternScanned = n;
+			}
+			// 찾아둔 구간을 모두 소비했다면 다음 구간을 찾는다
+			if (nextPattern == patterns.size() && patternScanned <= n)
+			{
+				patterns.clear();
+				nextPattern = 0;
+				patternScanned = findPatterns(str.data(), str.size(), n, n + patternScanWindow, matchOptions, patterns, arch);
+			}
+
+			pair<size_t, POSTag> m{ 0, POSTag::unknown };
+			if (nextPattern < patterns.size() && patterns[nextPattern].begin == n)
+			{
+				m = make_pair(patterns[nextPattern].end - patterns[nextPattern].begin, patterns[nextPattern].tag);
+				++nextPattern;
+			}
 			chrType = m.second;
 			if (chrType != POSTag::unknown)
 			{
@@ -1143,6 +1195,35 @@ FnSplitByTrie kiwi::getSplitByTrieFn(ArchType arch, bool typoTolerant, bool cont
 	return table[idx][static_cast<std::ptrdiff_t>(arch)];
 }
 
+namespace kiwi
+{
+	template<bool typoTolerant, bool continualTypoTolerant>
+	struct SplitByDATrieGetter
+	{
+		template<std::ptrdiff_t i>
+		struct Wrapper
+		{
+			static constexpr FnSplitByDATrie value = &splitByTrie<static_cast<ArchType>(i), typoTolerant, continualTypoTolerant, utils::DoubleArrayTrie<kchar_t, const Form*>>;
+		};
+	};
+}
+
+FnSplitByDATrie kiwi::getSplitByDATrieFn(ArchType arch, bool typoTolerant, bool continualTypoTolerant)
+{
+	// double-array 트라이의 전이는 아키텍처와 무관하지만, 패턴 후보 탐색이 SIMD 명령어를 쓸 수 있도록 아키텍처별로 인스턴스화한다
+	static std::array<tp::Table<FnSplitByDATrie, AvailableArch>, 4> table{
+		SplitByDATrieGetter<false, false>{},
+		SplitByDATrieGetter<true, false>{},
+		SplitByDATrieGetter<false, true>{},
+		SplitByDATrieGetter<true, true>{}
+	};
+
+	size_t idx = 0;
+	if (typoTolerant) idx += 1;
+	if (continualTypoTolerant) idx += 2;
+	return table[idx][static_cast<std::ptrdiff_t>(arch)];
+}
+
 namespace kiwi
 {
 	struct FindFormGetter
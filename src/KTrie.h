@@ -5,6 +5,7 @@
 #include <kiwi/Form.h>
 #include <kiwi/PatternMatcher.h>
 #include <kiwi/FrozenTrie.h>
+#include <kiwi/DoubleArrayTrie.h>
 
 #include "StrUtils.h"
 
@@ -51,6 +52,14 @@ namespace kiwi
 			forms.clear();
 			morphemes.clear();
 		}
+
+		size_t capacityBytes() const
+		{
+			return spans.capacity() * sizeof(Span)
+				+ formStrs.capacity() * sizeof(KString)
+				+ forms.capacity() * sizeof(Form)
+				+ morphemes.capacity() * sizeof(Morpheme);
+		}
 	};
 
 	struct KGraphNode
@@ -80,13 +89,14 @@ namespace kiwi
 	* @tparam arch Trie탐색에 사용할 CPU 아키텍처 타입
 	* @tparam typoTolerant 오타가 포함된 형태를 탐색할지 여부
 	* @tparam continualTypoTolerant 연철된 오타를 탐색할지 여부
+	* @tparam Trie 형태 사전 트라이의 타입. `utils::FrozenTrie` 혹은 `utils::DoubleArrayTrie`
 	*/
-	template<ArchType arch, bool typoTolerant = false, bool continualTypoTolerant = false>
+	template<ArchType arch, bool typoTolerant = false, bool continualTypoTolerant = false, class Trie = utils::FrozenTrie<kchar_t, const Form*>>
 	size_t splitByTrie(
 		Vector<KGraphNode>& out,
 		const Form* formBase,
 		const size_t* typoPtrs,
-		const utils::FrozenTrie<kchar_t, const Form*>& trie, 
+		const Trie& trie, 
 		U16StringView str, 
 		size_t startOffset,
 		Match matchOptions, 
@@ -106,6 +116,9 @@ namespace kiwi
 	using FnSplitByTrie = decltype(&splitByTrie<ArchType::default_>);
 	FnSplitByTrie getSplitByTrieFn(ArchType arch, bool typoTolerant, bool continualTypoTolerant);
 
+	using FnSplitByDATrie = decltype(&splitByTrie<ArchType::none, false, false, utils::DoubleArrayTrie<kchar_t, const Form*>>);
+	FnSplitByDATrie getSplitByDATrieFn(ArchType arch, bool typoTolerant, bool continualTypoTolerant);
+
 	using FnFindForm = decltype(&findForm<ArchType::default_>);
 	FnFindForm getFindFormFn(ArchType arch);
 
@@ -4,16 +4,22 @@
 #include <kiwi/Utils.h>
 #include <kiwi/TemplateUtils.hpp>
 #include <kiwi/Form.h>
+#include <kiwi/BitUtils.h>
 #include "ArchAvailable.h"
 #include "KTrie.h"
 #include "FeatureTestor.h"
 #include "FrozenTrie.hpp"
 #include "LmState.hpp"
 #include "StrUtils.h"
+#include "TextKernels.h"
 #include "SortUtils.hpp"
 #include "serializer.hpp"
 #include "Joiner.hpp"
 #include "PathEvaluator.hpp"
+#include "ResultCache.hpp"
+#include "ChunkMemo.hpp"
+#include "Arena.hpp"
+#include "AnalysisContext.hpp"
 
 using namespace std;
 
@@ -45,8 +51,14 @@ namespace kiwi
 		: langMdl(_langMdl)
 	{
 		selectedArch = arch;
+		lmMemoCounters = make_unique<LmMemoCounters>();
 		dfSplitByTrie = (void*)getSplitByTrieFn(selectedArch, typoTolerant, continualTypoTolerant);
+		dfSplitByDATrie = (void*)getSplitByDATrieFn(selectedArch, typoTolerant, continualTypoTolerant);
 		dfFindForm = (void*)getFindFormFn(selectedArch);
+		dfNormalizeHangul = (void*)text::getNormalizeHangulWithPositionFn(selectedArch);
+		dfGetWordPositions = (void*)text::getGetWordPositionsFn(selectedArch);
+		dfNormalizeCoda = (void*)text::getNormalizeCodaFn(selectedArch);
+		dfNormalizeUtf8 = (void*)text::getNormalizeUtf8WithPositionFn(selectedArch);
 
 		static tp::Table<FnFindBestPath, AvailableArch> lmKnLM_8{ FindBestPathGetter<WrappedKnLM<uint8_t>::type>{} };
 		static tp::Table<FnFindBestPath, AvailableArch> lmKnLM_16{ FindBestPathGetter<WrappedKnLM<uint16_t>::type>{} };
@@ -105,36 +117,293 @@ namespace kiwi
 
 	Kiwi& Kiwi::operator=(Kiwi&&) = default;
 
+	void Kiwi::invalidateResultCache()
+	{
+		if (resultCache) resultCache->clear();
+		if (chunkMemo) chunkMemo->clear();
+	}
+
+	void Kiwi::getBlocklistKey(Blocklist blocklist, std::vector<uint32_t>& out) const
+	{
+		out.clear();
+		if (auto* morphemeSet = blocklist.getMorphemeSet())
+		{
+			morphemeSet->getIds(out);
+		}
+		else if (auto* hashSet = blocklist.getHashSet())
+		{
+			// MorphemeSet으로 변환할 때와 마찬가지로 이 Kiwi의 형태소가 아닌 것은 무시한다
+			for (auto* m : *hashSet)
+			{
+				const size_t id = morphToId(m);
+				if (id < morphemes.size()) out.emplace_back((uint32_t)id);
+			}
+			sort(out.begin(), out.end());
+			out.erase(unique(out.begin(), out.end()), out.end());
+		}
+	}
+
+	void Kiwi::setResultCacheSize(size_t budgetBytes)
+	{
+		if (budgetBytes) resultCache = make_unique<ResultCache>(budgetBytes);
+		else resultCache.reset();
+	}
+
+	size_t Kiwi::getResultCacheSize() const
+	{
+		return resultCache ? resultCache->getBudget() : 0;
+	}
+
+	ResultCacheStats Kiwi::getResultCacheStats() const
+	{
+		return resultCache ? resultCache->getStats() : ResultCacheStats{};
+	}
+
+	void Kiwi::setChunkMemo(ChunkMemoMode mode, size_t budgetBytes)
+	{
+		// 근사적으로 재사용된 청크가 포함된 결과가 남지 않도록 방식이 바뀌면 분석 결과 캐시도 비운다
+		if (getChunkMemoMode() != (budgetBytes ? mode : ChunkMemoMode::none)) invalidateResultCache();
+		if (mode != ChunkMemoMode::none && budgetBytes) chunkMemo = make_unique<ChunkMemo>(mode, budgetBytes);
+		else chunkMemo.reset();
+	}
+
+	ChunkMemoMode Kiwi::getChunkMemoMode() const
+	{
+		return chunkMemo ? chunkMemo->getMode() : ChunkMemoMode::none;
+	}
+
+	size_t Kiwi::getChunkMemoSize() const
+	{
+		return chunkMemo ? chunkMemo->getBudget() : 0;
+	}
+
+	ResultCacheStats Kiwi::getChunkMemoStats() const
+	{
+		return chunkMemo ? chunkMemo->getStats() : ResultCacheStats{};
+	}
+
+	void Kiwi::setLmTransitionMemo(bool enable)
+	{
+		if (!lmMemoCounters) return;
+		lmMemoCounters->enabled.store(enable);
+		if (!enable)
+		{
+			lmMemoCounters->hits.store(0);
+			lmMemoCounters->misses.store(0);
+		}
+	}
+
+	bool Kiwi::getLmTransitionMemo() const
+	{
+		return lmMemoCounters && lmMemoCounters->enabled.load();
+	}
+
+	LmMemoStats Kiwi::getLmTransitionMemoStats() const
+	{
+		LmMemoStats ret;
+		if (lmMemoCounters)
+		{
+			ret.hits = lmMemoCounters->hits.load();
+			ret.misses = lmMemoCounters->misses.load();
+		}
+		return ret;
+	}
+
+	AnalysisContext::AnalysisContext(size_t highWaterMark)
+		: pimpl{ make_unique<Impl>(highWaterMark) }
+	{
+	}
+
+	AnalysisContext::~AnalysisContext() = default;
+
+	AnalysisContext::AnalysisContext(AnalysisContext&&) noexcept = default;
+
+	AnalysisContext& AnalysisContext::operator=(AnalysisContext&&) noexcept = default;
+
+	size_t AnalysisContext::getHighWaterMark() const
+	{
+		return pimpl->highWaterMark;
+	}
+
+	void AnalysisContext::setHighWaterMark(size_t highWaterMark)
+	{
+		pimpl->highWaterMark = highWaterMark;
+	}
+
+	size_t AnalysisContext::memoryUsage() const
+	{
+		return pimpl->memoryUsage();
+	}
+
+	size_t AnalysisContext::shrinkCount() const
+	{
+		return pimpl->shrinks;
+	}
+
+	void AnalysisContext::shrink()
+	{
+		if (pimpl->inUse()) throw std::runtime_error{ "cannot shrink an AnalysisContext while it is in use" };
+		pimpl->shrink();
+	}
+
+	const AnalysisBudget& AnalysisContext::getBudget() const
+	{
+		return pimpl->budget;
+	}
+
+	void AnalysisContext::setBudget(const AnalysisBudget& budget)
+	{
+		pimpl->budget = budget;
+	}
+
+	bool AnalysisContext::isDegraded() const
+	{
+		return pimpl->degraded;
+	}
+
+	size_t AnalysisContext::usedTransitions() const
+	{
+		return pimpl->transitions;
+	}
+
+	MorphemeSet::MorphemeSet(const Kiwi& kiwi)
+	{
+		reset(kiwi);
+	}
+
+	MorphemeSet::MorphemeSet(const Kiwi& kiwi, const std::unordered_set<const Morpheme*>& morphs)
+	{
+		reset(kiwi);
+		insert(morphs.begin(), morphs.end());
+	}
+
+	size_t MorphemeSet::indexOf(const Morpheme* morph) const
+	{
+		// 다른 배열을 가리키는 포인터끼리 빼지 않도록 주소값으로 비교한다
+		const auto p = reinterpret_cast<uintptr_t>(morph), b = reinterpret_cast<uintptr_t>(base);
+		if (!base || p < b) return -1;
+		const size_t offset = p - b;
+		if (offset % sizeof(Morpheme)) return -1;
+		return offset / sizeof(Morpheme);
+	}
+
+	void MorphemeSet::reset(const Kiwi& kiwi)
+	{
+		base = kiwi.idToMorph(0);
+		numMorphemes = kiwi.getMorphemeSize();
+		numElements = 0;
+		bits.assign((numMorphemes + 63) / 64, 0);
+	}
+
+	bool MorphemeSet::insert(const Morpheme* morph)
+	{
+		const size_t idx = indexOf(morph);
+		if (idx >= numMorphemes) return false;
+		auto& word = bits[idx / 64];
+		const uint64_t mask = (uint64_t)1 << (idx % 64);
+		if (word & mask) return false;
+		word |= mask;
+		++numElements;
+		return true;
+	}
+
+	bool MorphemeSet::erase(const Morpheme* morph)
+	{
+		const size_t idx = indexOf(morph);
+		if (idx >= numMorphemes) return false;
+		auto& word = bits[idx / 64];
+		const uint64_t mask = (uint64_t)1 << (idx % 64);
+		if (!(word & mask)) return false;
+		word &= ~mask;
+		--numElements;
+		return true;
+	}
+
+	void MorphemeSet::getIds(std::vector<uint32_t>& out) const
+	{
+		for (size_t i = 0; i < bits.size(); ++i)
+		{
+			for (uint64_t word = bits[i]; word; word &= word - 1)
+			{
+				out.emplace_back((uint32_t)(i * 64 + utils::countTrailingZeroes(word)));
+			}
+		}
+	}
+
+	void MorphemeSet::clear()
+	{
+		fill(bits.begin(), bits.end(), 0);
+		numElements = 0;
+	}
+
 	inline vector<size_t> allNewLinePositions(const u16string& str)
 	{
 		vector<size_t> ret;
 		bool isCR = false;
 		for (size_t i = 0; i < str.size(); ++i)
 		{
-			switch (str[i])
-			{
-			case 0x0D:
-				isCR = true;
-				ret.emplace_back(i);
-				break;
-			case 0x0A:
-				if (!isCR) ret.emplace_back(i);
-				isCR = false;
-				break;
-			case 0x0B:
-			case 0x0C:
-			case 0x85:
-			case 0x2028:
-			case 0x2029:
-				isCR = false;
-				ret.emplace_back(i);
-				break;
-			}
+			if (isNewLine(str[i], isCR)) ret.emplace_back(i);
 		}
 		return ret;
 	}
 
-	inline void fillPairedTokenInfo(vector<TokenInfo>& tokens)
+	/**
+	* @brief 결과를 열 단위 구조체로 채울 때 경로를 결과로 옮기는 동안 사용하는 토큰.
+	* @details `TokenInfo`와 달리 형태 문자열을 직접 갖지 않고 `ColumnTokens::pool` 내의 범위만 가리킨다.
+	*/
+	struct ColumnToken
+	{
+		uint32_t strBegin = 0, strEnd = 0;
+		uint32_t position = 0;
+		uint32_t wordPosition = 0;
+		uint32_t sentPosition = 0;
+		uint32_t lineNumber = 0;
+		uint16_t length = 0;
+		POSTag tag = POSTag::unknown;
+		ScriptType script = ScriptType::unknown;
+		float score = 0;
+		uint32_t pairedToken = -1;
+		uint32_t subSentPosition = 0;
+		const Morpheme* morph = nullptr;
+
+		uint32_t endPos() const { return position + length; }
+	};
+
+	/**
+	* @brief 토큰들의 형태를 하나의 문자열 풀에 이어서 저장하는 분석 결과.
+	* @details 토큰은 순서대로 풀에 추가되고 접사 결합은 인접한 토큰끼리만 일어나므로,
+	* 각 토큰의 범위는 항상 이전 토큰의 범위 바로 뒤에서 시작한다.
+	*/
+	struct ColumnTokens
+	{
+		Vector<ColumnToken> tokens;
+		u16string pool;
+
+		size_t size() const { return tokens.size(); }
+		ColumnToken* data() { return tokens.data(); }
+		ColumnToken& operator[](size_t i) { return tokens[i]; }
+		const ColumnToken& operator[](size_t i) const { return tokens[i]; }
+		Vector<ColumnToken>::iterator begin() { return tokens.begin(); }
+		Vector<ColumnToken>::iterator end() { return tokens.end(); }
+		Vector<ColumnToken>::const_iterator begin() const { return tokens.begin(); }
+		Vector<ColumnToken>::const_iterator end() const { return tokens.end(); }
+		void erase(Vector<ColumnToken>::iterator first, Vector<ColumnToken>::iterator last) { tokens.erase(first, last); }
+	};
+
+	using ColumnResult = pair<ColumnTokens, float>;
+
+	inline U16StringView tokenStr(const vector<TokenInfo>&, const TokenInfo& t)
+	{
+		return t.str;
+	}
+
+	inline U16StringView tokenStr(const ColumnTokens& tokens, const ColumnToken& t)
+	{
+		return U16StringView{ tokens.pool.data() + t.strBegin, t.strEnd - t.strBegin };
+	}
+
+	template<class Tokens>
+	inline void fillPairedTokenInfo(Tokens& tokens)
 	{
 		Vector<pair<uint32_t, uint32_t>> pStack;
 		Vector<pair<uint32_t, uint32_t>> bStack;
@@ -143,13 +412,13 @@ namespace kiwi
 			const uint32_t i = &t - tokens.data();
 			if (t.tag == POSTag::sso)
 			{
-				uint32_t type = getSSType(t.str[0]);
+				uint32_t type = getSSType(tokenStr(tokens, t)[0]);
 				if (!type) continue;
 				pStack.emplace_back(i, type);
 			}
 			else if (t.tag == POSTag::ssc)
 			{
-				uint32_t type = getSSType(t.str[0]);
+				uint32_t type = getSSType(tokenStr(tokens, t)[0]);
 				if (!type) continue;
 				for (auto j = pStack.rbegin(); j != pStack.rend(); ++j)
 				{
@@ -162,7 +431,7 @@ namespace kiwi
 			}
 			else if (t.tag == POSTag::sb)
 			{
-				uint32_t type = getSBType(t.str);
+				uint32_t type = getSBType(tokenStr(tokens, t));
 				if (!type) continue;
 				
 				for (auto j = bStack.rbegin(); j != bStack.rend(); ++j)
@@ -201,7 +470,8 @@ namespace kiwi
 		size_t lastLineNumber = 0;
 	public:
 
-		bool next(const TokenInfo& t, size_t lineNumber, bool forceNewSent = false)
+		template<class Token>
+		bool next(const Token& t, size_t lineNumber, bool forceNewSent = false)
 		{
 			bool ret = false;
 			if (forceNewSent)
@@ -338,30 +608,34 @@ namespace kiwi
 		}
 	};
 
-	inline bool hasSentences(const TokenInfo* first, const TokenInfo* last)
+	template<class Token>
+	inline bool hasSentences(const Token* first, const Token* last)
 	{
 		SentenceParser sp;
 		for (; first != last; ++first)
 		{
 			if (sp.next(*first, 0)) return true;
 		}
-		return sp.next({}, 0);
+		return sp.next(Token{}, 0);
 	}
 
-	inline bool isNestedLeft(const TokenInfo& t)
+	template<class Token>
+	inline bool isNestedLeft(const Token& t)
 	{
 		return isJClass(t.tag) || (isEClass(t.tag) && t.tag != POSTag::ef) || t.tag == POSTag::sp;
 	}
 
-	inline bool isNestedRight(const TokenInfo& t)
+	template<class Tokens, class Token>
+	inline bool isNestedRight(const Tokens& tokens, const Token& t)
 	{
-		return isJClass(t.tag) || isEClass(t.tag) || (isVerbClass(t.tag) && t.str == u"하") || t.tag == POSTag::vcp || t.tag == POSTag::sp;
+		return isJClass(t.tag) || isEClass(t.tag) || (isVerbClass(t.tag) && tokenStr(tokens, t) == u"하") || t.tag == POSTag::vcp || t.tag == POSTag::sp;
 	}
 
 	/**
 	* @brief tokens에 문장 번호 및 줄 번호를 채워넣는다.
 	*/
-	inline void fillSentLineInfo(vector<TokenInfo>& tokens, const vector<size_t>& newlines)
+	template<class Tokens>
+	inline void fillSentLineInfo(Tokens& tokens, const vector<size_t>& newlines)
 	{
 		SentenceParser sp;
 		uint32_t sentPos = 0, lastSentPos = 0, subSentPos = 0, accumSubSent = 1, accumWordPos = 0, lastWordPos = 0;
@@ -407,7 +681,7 @@ namespace kiwi
 					nestedEnd = t.pairedToken;
 					subSentPos = 0;
 				}
-				else if ((t.pairedToken + 1 < tokens.size() && isNestedRight(tokens[t.pairedToken + 1]))
+				else if ((t.pairedToken + 1 < tokens.size() && isNestedRight(tokens, tokens[t.pairedToken + 1]))
 						|| (i > 0 && isNestedLeft(tokens[i - 1])))
 				{
 					nestedSentEnd = t.pairedToken;
@@ -487,47 +761,21 @@ namespace kiwi
 		return ret;
 	}
 
-	/**
-	* @brief 주어진 문자열에 나타난 개별 문자들에 대해 어절번호(wordPosition) 생성하여 반환한다.
-	* @details 문자열의 길이와 동일한 크기의 std::vector<uint16_t>를 생성한 뒤, 문자열 내 개별 문자가
-	* 나타난 인덱스와 동일한 위치에 각 문자에 대한 어절번호(wordPosition)를 기록한다.
-	* 어절번호는 단순히 각 어절의 등장순서로부터 얻어진다.
-	* 예를 들어, '나는 학교에 간다'라는 문자열의 경우 '나는'이 첫 번째 어절이므로 여기에포함된
-	* 개별 문자인 '나'와 '는'의 어절번호는 0이다. 마찬가지로 '학교에'에 포함된 문자들의 어절번호는 1, 
-	* '간다'에 포함된 문자들의 어절번호는 2이다.
-	* 따라서 최종적으로 문자열 '나는 학교에 간다'로부터 {0, 0, 0, 1, 1, 1, 1, 2, 2}의 어절번호가
-	* 생성된다.
-	*
-	*/
-	template<class It>
-	void getWordPositions(Vector<uint16_t>& out, It first, It last)
+	inline void concatTokens(TokenInfo& dest, const TokenInfo& src, POSTag tag)
 	{
-		out.resize(distance(first, last));
-		uint32_t position = 0;
-		bool continuousSpace = false;
-
-		for (size_t i = 0; first != last; ++first, ++i)
-		{
-			out[i] = position;
-
-			if (isSpace(*first))
-			{
-				if (!continuousSpace) ++position;
-				continuousSpace = true;
-			}
-			else
-			{
-				continuousSpace = false;
-			}
-		}
+		dest.tag = tag;
+		dest.morph = nullptr;
+		dest.length = (uint16_t)(src.position + src.length - dest.position);
+		dest.str += src.str;
 	}
 
-	inline void concatTokens(TokenInfo& dest, const TokenInfo& src, POSTag tag)
+	inline void concatTokens(ColumnToken& dest, const ColumnToken& src, POSTag tag)
 	{
 		dest.tag = tag;
 		dest.morph = nullptr;
 		dest.length = (uint16_t)(src.position + src.length - dest.position);
-		dest.str += src.str;
+		// 결합되는 두 토큰의 형태는 풀에서 서로 인접해 있다
+		dest.strEnd = src.strEnd;
 	}
 
 	template<class TokenInfoIt>
@@ -540,8 +788,8 @@ namespace kiwi
 		++next;
 		while (next != last)
 		{
-			TokenInfo& current = *first;
-			TokenInfo& nextToken = *next;
+			auto& current = *first;
+			auto& nextToken = *next;
 
 			// XPN + (NN. | SN) => (NN. | SN)
 			if (!!(matchOptions & Match::joinNounPrefix) 
@@ -598,15 +846,17 @@ namespace kiwi
 		return ++first;
 	}
 
-	inline void updateTokenInfoScript(TokenInfo& info)
+	template<class Tokens, class Token>
+	inline void updateTokenInfoScript(const Tokens& tokens, Token& info)
 	{
 		if (!(info.tag == POSTag::sl || info.tag == POSTag::sh || info.tag == POSTag::sw || info.tag == POSTag::w_emoji)) return;
 		if ((info.morph && info.morph->kform && !info.morph->kform->empty())) return;
-		if (info.str.empty()) return;
-		char32_t c = info.str[0];
+		const auto str = tokenStr(tokens, info);
+		if (str.empty()) return;
+		char32_t c = str[0];
 		if (isHighSurrogate(c))
 		{
-			c = mergeSurrogate(c, info.str[1]);
+			c = mergeSurrogate(c, str[1]);
 		}
 		info.script = chr2ScriptType(c);
 		if (info.script == ScriptType::latin)
@@ -615,8 +865,106 @@ namespace kiwi
 		}
 	}
 
+	/**
+	* @brief 경로 상의 형태소 하나의 형태를 한글 자모를 결합하여 out 뒤에 덧붙인다.
+	* @details 자모 결합은 덧붙이는 형태 내에서만 일어나며, out에 이미 있는 문자와는 결합하지 않는다.
+	*/
+	inline void appendJoinedForm(u16string& out, const PathEvaluator::Result& s, const KString* prevMorph, bool integrateAllomorph)
+	{
+		const size_t begin = out.size();
+		auto append = [&](const kchar_t* first, const kchar_t* last)
+		{
+			for (; first != last; ++first)
+			{
+				auto c = *first;
+				if (isHangulCoda(c) && out.size() > begin && isHangulSyllable(out.back()))
+				{
+					if ((out.back() - 0xAC00) % 28) out.push_back(c);
+					else out.back() += c - 0x11A7;
+				}
+				else
+				{
+					out.push_back(c);
+				}
+			}
+		};
+
+		const KString& kform = *s.morph->kform;
+		if (!integrateAllomorph)
+		{
+			if (POSTag::ep <= s.morph->tag && s.morph->tag <= POSTag::etm)
+			{
+				if (kform[0] == u'\uC5B4') // 어
+				{
+					if (prevMorph && prevMorph[0].back() == u'\uD558') // 하
+					{
+						out.push_back(u'\uC5EC'); // 여
+						append(kform.data() + 1, kform.data() + kform.size());
+						return;
+					}
+					else if (FeatureTestor::isMatched(prevMorph, CondPolarity::positive))
+					{
+						out.push_back(u'\uC544'); // 아
+						append(kform.data() + 1, kform.data() + kform.size());
+						return;
+					}
+				}
+			}
+		}
+		const KString& form = s.str.empty() ? kform : s.str;
+		append(form.data(), form.data() + form.size());
+	}
+
+	inline TokenInfo& appendPathToken(vector<TokenInfo>& tokens, const PathEvaluator::Result& s, const KString* prevMorph, bool integrateAllomorph)
+	{
+		u16string joined;
+		joined.reserve(s.str.empty() ? s.morph->kform->size() : s.str.size());
+		appendJoinedForm(joined, s, prevMorph, integrateAllomorph);
+		tokens.emplace_back(joined, s.morph->tag);
+		return tokens.back();
+	}
+
+	inline ColumnToken& appendPathToken(ColumnTokens& tokens, const PathEvaluator::Result& s, const KString* prevMorph, bool integrateAllomorph)
+	{
+		tokens.tokens.emplace_back();
+		auto& token = tokens.tokens.back();
+		token.strBegin = (uint32_t)tokens.pool.size();
+		appendJoinedForm(tokens.pool, s, prevMorph, integrateAllomorph);
+		token.strEnd = (uint32_t)tokens.pool.size();
+		token.tag = s.morph->tag;
+		return token;
+	}
+
+	/**
+	* @brief 오타 교정 및 사전 분석 구간에 대한 정보를 채운다. 열 단위 결과에는 해당 정보가 없으므로 아무 일도 하지 않는다.
+	*/
+	inline void fillTypoInfo(TokenInfo& token, const PathEvaluator::Result& s, uint32_t pretokenizedId)
+	{
+		token.typoCost = s.typoCost;
+		token.typoFormId = pretokenizedId ? pretokenizedId : s.typoFormId;
+		token.senseId = s.morph->senseId;
+	}
+
+	inline void fillTypoInfo(ColumnToken&, const PathEvaluator::Result&, uint32_t)
+	{
+	}
+
+	inline void reserveTokens(TokenResult&, size_t)
+	{
+	}
+
+	/**
+	* @brief 분석할 문자열의 길이로부터 토큰 수와 형태 문자열의 길이를 짐작하여 미리 공간을 확보한다.
+	*/
+	inline void reserveTokens(ColumnResult& res, size_t length)
+	{
+		res.first.tokens.reserve(length / 2 + 16);
+		res.first.pool.reserve(length * 3 / 2 + 16);
+	}
+
+	template<class Result>
 	inline void insertPathIntoResults(
-		vector<TokenResult>& ret, 
+		vector<Result>& ret, 
 		Vector<SpecialState>& spStatesByRet,
 		const Vector<PathEvaluator::ChunkResult>& pathes,
 		size_t topN, 
@@ -628,20 +976,22 @@ namespace kiwi
 		const Vector<uint32_t>& nodeInWhichPretokenized
 	)
 	{
-		Vector<size_t> parentMap;
+		utils::Arena::Scope arenaScope;
+		utils::ArenaVector<size_t> parentMap;
 
 		if (ret.empty())
 		{
 			const size_t n = min(pathes.size(), topN * 2);
 			ret.resize(n);
+			for (auto& r : ret) reserveTokens(r, positionTable.size());
 			spStatesByRet.resize(n);
 			parentMap.resize(n);
 			iota(parentMap.begin(), parentMap.end(), 0);
 		}
 		else
 		{
-			UnorderedMap<uint8_t, uint32_t> prevParents;
-			Vector<uint8_t> selectedPathes(pathes.size());
+			utils::ArenaUnorderedMap<uint8_t, uint32_t> prevParents;
+			utils::ArenaVector<uint8_t> selectedPathes(pathes.size());
 			for (size_t i = 0; i < ret.size(); ++i)
 			{
 				auto pred = [&](const PathEvaluator::ChunkResult& p)
@@ -670,6 +1020,7 @@ namespace kiwi
 				if (parent < ret.size())
 				{
 					ret.push_back(ret[parent]);
+					reserveTokens(ret.back(), positionTable.size());
 					spStatesByRet.push_back(spStatesByRet[parent]);
 					parentMap.emplace_back(i);
 				}
@@ -681,7 +1032,7 @@ namespace kiwi
 			}
 		}
 
-		UnorderedMap<uint8_t, uint32_t> spStateCnt;
+		utils::ArenaUnorderedMap<uint8_t, uint32_t> spStateCnt;
 		size_t validTarget = 0;
 		for (size_t i = 0; i < ret.size(); ++i)
 		{
@@ -701,47 +1052,15 @@ namespace kiwi
 			for (auto& s : r.path)
 			{
 				if (!s.str.empty() && s.str[0] == ' ') continue;
-				u16string joined;
-				do
-				{
-					if (!integrateAllomorph)
-					{
-						if (POSTag::ep <= s.morph->tag && s.morph->tag <= POSTag::etm)
-						{
-							if ((*s.morph->kform)[0] == u'\uC5B4') // 어
-							{
-								if (prevMorph && prevMorph[0].back() == u'\uD558') // 하
-								{
-									joined = joinHangul(u"\uC5EC" + s.morph->kform->substr(1)); // 여
-									break;
-								}
-								else if (FeatureTestor::isMatched(prevMorph, CondPolarity::positive))
-								{
-									joined = joinHangul(u"\uC544" + s.morph->kform->substr(1)); // 아
-									break;
-								}
-							}
-						}
-					}
-					joined = joinHangul(s.str.empty() ? *s.morph->kform : s.str);
-				} while (0);
-				rarr.emplace_back(joined, s.morph->tag);
-				auto& token = rarr.back();
+				auto& token = appendPathToken(rarr, s, prevMorph, integrateAllomorph);
 				token.morph = within(s.morph, pretokenizedGroup.morphemes) ? nullptr : s.morph;
 				size_t beginPos = (upper_bound(positionTable.begin(), positionTable.end(), s.begin) - positionTable.begin()) - 1;
 				size_t endPos = lower_bound(positionTable.begin(), positionTable.end(), s.end) - positionTable.begin();
 				token.position = (uint32_t)beginPos;
 				token.length = (uint16_t)(endPos - beginPos);
 				token.score = s.wordScore;
-				token.typoCost = s.typoCost;
-				token.typoFormId = s.typoFormId;
-				token.senseId = s.morph->senseId;
-				updateTokenInfoScript(token);
-				auto ptId = nodeInWhichPretokenized[s.nodeId] + 1;
-				if (ptId)
-				{
-					token.typoFormId = ptId;
-				}
+				fillTypoInfo(token, s, nodeInWhichPretokenized[s.nodeId] + 1);
+				updateTokenInfoScript(rarr, token);
 
 				// Token의 시작위치(position)을 이용해 Token이 포함된 어절번호(wordPosition)를 얻음
 				token.wordPosition = wordPositions[token.position];
@@ -843,6 +1162,7 @@ namespace kiwi
 						morph.tag = s.tokenization[0].tag;
 						morph.vowel = CondVowel::none;
 						morph.polar = CondPolarity::none;
+						morph.leftCondMask = FeatureTestor::leftContextMask(morph.kform);
 						morph.lmMorphemeId = getDefaultMorphemeId(s.tokenization[0].tag);
 						form.candidate[0] = &morph;
 					}
@@ -859,6 +1179,7 @@ namespace kiwi
 				morph.vowel = CondVowel::none;
 				morph.polar = CondPolarity::none;
 				morph.complex = 0;
+				morph.leftCondMask = FeatureTestor::leftContextMask(morph.kform);
 				morph.chunks = FixedPairVector<const Morpheme*, std::pair<uint8_t, uint8_t>>{ s.tokenization.size() };
 				for (size_t i = 0; i < s.tokenization.size(); ++i)
 				{
@@ -887,6 +1208,7 @@ namespace kiwi
 						cmorph.vowel = CondVowel::none;
 						cmorph.polar = CondPolarity::none;
 						cmorph.complex = 0;
+						cmorph.leftCondMask = FeatureTestor::leftContextMask(cmorph.kform);
 						cmorph.tag = t.tag;
 						cmorph.lmMorphemeId = getDefaultMorphemeId(t.tag);
 						foundMorph = &cmorph;
@@ -934,20 +1256,242 @@ namespace kiwi
 		ret.resize(nodes.size(), -1);
 	}
 
+	/**
+	* @brief 분석 전처리에 쓰이는 AnalysisContext 버퍼의 태그들
+	*/
+	namespace scratch
+	{
+		struct NormalizedStr { using type = KString; };
+		struct PositionTable { using type = Vector<uint32_t>; };
+		struct WordPositions { using type = Vector<uint16_t>; };
+		struct BytePositions { using type = vector<size_t>; };
+		struct PretokenizedGroup { using type = PretokenizedSpanGroup; };
+		struct ChunkGraph { using type = Vector<KGraphNode>; };
+		struct NodeInWhichPretokenized { using type = Vector<uint32_t>; };
+		struct BlocklistBits { using type = MorphemeSet; };
+	}
+
+	/**
+	* @brief UTF-16 문자열을 한글 정규화하여 위치 테이블과 함께 생성하고, 개별 문자에 대한 어절 번호를 생성한다.
+	*/
+	inline void normalizeUtf16WithPosition(const u16string& str, 
+		KString& normalizedStr, 
+		Vector<uint32_t>& positionTable, 
+		Vector<uint16_t>& wordPositions,
+		text::FnNormalizeHangulWithPosition normalizeHangul,
+		text::FnGetWordPositions getWordPositions
+	)
+	{
+		normalizedStr.resize(str.size() * 2);
+		positionTable.resize(str.size() + 1);
+		normalizedStr.resize(normalizeHangul(str.data(), str.size(), &normalizedStr[0], positionTable.data()));
+
+		wordPositions.resize(str.size());
+		getWordPositions(str.data(), str.size(), wordPositions.data());
+	}
+
 	vector<TokenResult> Kiwi::analyze(const u16string& str, size_t topN, Match matchOptions, 
-		const std::unordered_set<const Morpheme*>* blocklist,
+		Blocklist blocklist,
+		const std::vector<PretokenizedSpan>& pretokenized
+	) const
+	{
+		return analyze(AnalysisContext::Impl::threadDefault(), str, topN, matchOptions, blocklist, pretokenized);
+	}
+
+	vector<TokenResult> Kiwi::analyze(AnalysisContext& context, const u16string& str, size_t topN, Match matchOptions, 
+		Blocklist blocklist,
+		const std::vector<PretokenizedSpan>& pretokenized
+	) const
+	{
+		vector<TokenResult> ret;
+		analyzeInto(context, str, topN, matchOptions, blocklist, pretokenized, ret);
+		return ret;
+	}
+
+	/**
+	* @brief `analyze`와 같지만 결과를 `ret`에 채운다. 여러 문서를 분석할 때 `ret`을 재사용하여 결과 배열의 할당을 줄인다.
+	*/
+	void Kiwi::analyzeInto(AnalysisContext& context, const u16string& str, size_t topN, Match matchOptions, 
+		Blocklist blocklist,
+		const std::vector<PretokenizedSpan>& pretokenized,
+		vector<TokenResult>& ret
+	) const
+	{
+		AnalysisContext::Impl::Binding contextBinding{ context.impl() };
+		auto& ctx = context.impl();
+		const bool useCache = resultCache && pretokenized.empty();
+		size_t cacheGen = 0;
+		ResultCacheKey cacheKey;
+		if (useCache)
+		{
+			cacheKey.str = str;
+			cacheKey.topN = topN;
+			cacheKey.matchOptions = matchOptions;
+			getBlocklistKey(blocklist, cacheKey.blocklist);
+			if (resultCache->find(cacheKey, ret, cacheGen)) return;
+		}
+
+		auto& normalizedStr = ctx.get<scratch::NormalizedStr>();
+		auto& positionTable = ctx.get<scratch::PositionTable>();
+		auto& wordPositions = ctx.get<scratch::WordPositions>();
+		normalizeUtf16WithPosition(str, normalizedStr, positionTable, wordPositions,
+			reinterpret_cast<text::FnNormalizeHangulWithPosition>(dfNormalizeHangul),
+			reinterpret_cast<text::FnGetWordPositions>(dfGetWordPositions)
+		);
+
+		analyzeNormalized(normalizedStr, positionTable, wordPositions, allNewLinePositions(str), 
+			topN, matchOptions, blocklist, pretokenized, ret);
+		if (useCache && !ctx.degraded) resultCache->insert(cacheKey, ret, ResultCache::estimateBytes(ret), cacheGen);
+	}
+
+	/**
+	* @brief `resume`의 상태에서 이어서 `str` 중 확정 가능한 청크까지만 분석한다.
+	* @details 결과 토큰에는 문장 번호, 줄 번호, 쌍 정보가 채워지지 않으며 어절 번호는 `str` 내의 번호 그대로 남는다.
+	*/
+	void Kiwi::analyzeResumable(const u16string& str, Match matchOptions,
+		Blocklist blocklist,
+		ChunkResume& resume,
+		vector<TokenResult>& ret
+	) const
+	{
+		AnalysisContext::Impl::Binding contextBinding{ AnalysisContext::Impl::threadDefault().impl() };
+		auto& ctx = AnalysisContext::Impl::current();
+		auto& normalizedStr = ctx.get<scratch::NormalizedStr>();
+		auto& positionTable = ctx.get<scratch::PositionTable>();
+		auto& wordPositions = ctx.get<scratch::WordPositions>();
+		normalizeUtf16WithPosition(str, normalizedStr, positionTable, wordPositions,
+			reinterpret_cast<text::FnNormalizeHangulWithPosition>(dfNormalizeHangul),
+			reinterpret_cast<text::FnGetWordPositions>(dfGetWordPositions)
+		);
+
+		analyzeNormalized(normalizedStr, positionTable, wordPositions, {},
+			1, matchOptions, blocklist, {}, ret, &resume);
+	}
+
+	/**
+	* @brief UTF-8 문자열을 복호화하면서 한글 정규화와 함께 위치 테이블, 바이트 위치, 어절 번호, 줄바꿈 위치를 생성한다.
+	* @details 위치 정보는 모두 UTF-16 코드 유닛 단위로 생성되므로 UTF-16 입력을 분석한 것과 동일한 결과를 얻는다.
+	* `bytePositions`는 각 코드 유닛이 시작하는 바이트 위치이며, 마지막에 문자열의 전체 바이트 길이가 추가된다.
+	*/
+	inline void normalizeUtf8WithPosition(nonstd::string_view str, 
+		KString& normalizedStr, 
+		Vector<uint32_t>& positionTable, 
+		vector<size_t>& bytePositions, 
+		Vector<uint16_t>& wordPositions, 
+		vector<size_t>& newlines,
+		text::FnNormalizeUtf8WithPosition normalizeUtf8
+	)
+	{
+		// 코드 유닛의 개수와 분해된 문자열의 길이는 모두 바이트 수를 넘지 않는다
+		normalizedStr.resize(str.size());
+		positionTable.resize(str.size() + 1);
+		bytePositions.resize(str.size() + 1);
+		wordPositions.resize(str.size());
+		const size_t len = normalizeUtf8(str.data(), str.size(), &normalizedStr[0], positionTable.data(), bytePositions.data(), wordPositions.data(), newlines);
+		normalizedStr.resize(positionTable[len]);
+		positionTable.resize(len + 1);
+		bytePositions.resize(len + 1);
+		bytePositions[len] = str.size();
+		wordPositions.resize(len);
+	}
+
+	void Kiwi::analyze(const string& str, TokenResultColumns& out, Match matchOptions,
+		Blocklist blocklist,
 		const std::vector<PretokenizedSpan>& pretokenized
 	) const
 	{
-		thread_local KString normalizedStr;
-		thread_local Vector<uint32_t> positionTable;
-		thread_local PretokenizedSpanGroup pretokenizedGroup;
-		normalizedStr.clear();
-		positionTable.clear();
+		analyze(AnalysisContext::Impl::threadDefault(), str, out, matchOptions, blocklist, pretokenized);
+	}
+
+	/**
+	* @brief UTF-16 기준의 분석 결과 하나를 위치와 길이를 바이트 단위로 바꾸어 열 단위 구조체 `out`에 채운다.
+	*/
+	template<class Result, class BytePositions>
+	inline void fillU8Columns(const Kiwi& kiwi, const Result& res, const BytePositions& bytePositions, TokenResultColumns& out)
+	{
+		auto& tokens = res.first;
+		out.clear();
+		out.tags.reserve(tokens.size());
+		out.positions.reserve(tokens.size());
+		out.lengths.reserve(tokens.size());
+		out.wordPositions.reserve(tokens.size());
+		out.sentPositions.reserve(tokens.size());
+		out.scores.reserve(tokens.size());
+		out.morphIds.reserve(tokens.size());
+		out.u8StrOffsets.reserve(tokens.size() + 1);
+		for (auto& t : tokens)
+		{
+			const size_t begin = bytePositions[t.position], end = bytePositions[t.position + t.length];
+			out.tags.emplace_back(t.tag);
+			out.positions.emplace_back((uint32_t)begin);
+			out.lengths.emplace_back((uint32_t)(end - begin));
+			out.wordPositions.emplace_back(t.wordPosition);
+			out.sentPositions.emplace_back(t.sentPosition);
+			out.scores.emplace_back(t.score);
+			out.morphIds.emplace_back((uint32_t)kiwi.morphToId(t.morph));
+			out.u8StrOffsets.emplace_back((uint32_t)out.u8StrPool.size());
+			appendUtf16To8(tokenStr(tokens, t), out.u8StrPool);
+		}
+		out.u8StrOffsets.emplace_back((uint32_t)out.u8StrPool.size());
+		out.score = res.second;
+	}
+
+	void Kiwi::analyze(AnalysisContext& context, const string& str, TokenResultColumns& out, Match matchOptions,
+		Blocklist blocklist,
+		const std::vector<PretokenizedSpan>& pretokenized
+	) const
+	{
+		if (resultCache && pretokenized.empty())
+		{
+			// 캐시에는 UTF-16 기준의 TokenResult로 저장되므로, 캐시를 사용하는 경우에는 UTF-16으로 변환하여 캐시를 거친 뒤
+			// 위치와 길이를 바이트 단위로 바꾸어 채운다
+			vector<size_t> bytePositions;
+			const auto u16str = utf8To16(str, bytePositions);
+			bytePositions.emplace_back(str.size());
+			auto res = analyze(context, u16str, 1, matchOptions, blocklist, pretokenized);
+			fillU8Columns(*this, res[0], bytePositions, out);
+			return;
+		}
+
+		AnalysisContext::Impl::Binding contextBinding{ context.impl() };
+		auto& ctx = context.impl();
+		auto& normalizedStr = ctx.get<scratch::NormalizedStr>();
+		auto& positionTable = ctx.get<scratch::PositionTable>();
+		auto& bytePositions = ctx.get<scratch::BytePositions>();
+		auto& wordPositions = ctx.get<scratch::WordPositions>();
+		vector<size_t> newlines;
+		normalizeUtf8WithPosition(str, normalizedStr, positionTable, bytePositions, wordPositions, newlines,
+			reinterpret_cast<text::FnNormalizeUtf8WithPosition>(dfNormalizeUtf8)
+		);
+
+		vector<ColumnResult> res;
+		analyzeNormalized(normalizedStr, positionTable, wordPositions, newlines,
+			1, matchOptions, blocklist, pretokenized.empty() ? pretokenized : mapPretokenizedSpansToU16(pretokenized, bytePositions), res);
+		fillU8Columns(*this, res[0], bytePositions, out);
+	}
+
+	template<class Result>
+	void Kiwi::analyzeNormalized(KString& normalizedStr, 
+		const Vector<uint32_t>& positionTable,
+		const Vector<uint16_t>& wordPositions,
+		const vector<size_t>& newlines,
+		size_t topN, Match matchOptions,
+		Blocklist blocklist,
+		const std::vector<PretokenizedSpan>& pretokenized,
+		vector<Result>& ret,
+		ChunkResume* resume
+	) const
+	{
+		auto& ctx = AnalysisContext::Impl::current();
+		// 분석 중에 arena에서 할당된 임시 메모리는 분석이 끝날 때 모두 반환된다
+		utils::Arena::Scope arenaScope;
+		auto& pretokenizedGroup = ctx.get<scratch::PretokenizedGroup>();
 		pretokenizedGroup.clear();
-		normalizeHangulWithPosition(str.begin(), str.end(), back_inserter(normalizedStr), back_inserter(positionTable));
 
-		if (!!(matchOptions & Match::normalizeCoda)) normalizeCoda(normalizedStr.begin(), normalizedStr.end());
+		if (!!(matchOptions & Match::normalizeCoda))
+		{
+			(*reinterpret_cast<text::FnNormalizeCoda>(dfNormalizeCoda))(&normalizedStr[0], normalizedStr.size());
+		}
 
 		makePretokenizedSpanGroup(
 			pretokenizedGroup, 
@@ -958,60 +1502,209 @@ namespace kiwi
 			formTrie
 		);
 
-		// 분석할 문장에 포함된 개별 문자에 대해 어절번호를 생성한다
-		thread_local Vector<uint16_t> wordPositions;
-		wordPositions.clear();
-		getWordPositions(wordPositions, str.begin(), str.end());
-		
-		vector<TokenResult> ret;
+		// 경로 탐색에서는 후보 형태소마다 blocklist를 확인하므로 unordered_set으로 주어진 경우 비트셋으로 바꿔둔다
+		const MorphemeSet* blocklistBits = blocklist.getMorphemeSet();
+		if (!blocklistBits && blocklist.getHashSet())
+		{
+			auto& bits = ctx.get<scratch::BlocklistBits>();
+			bits.reset(*this);
+			bits.insert(blocklist.getHashSet()->begin(), blocklist.getHashSet()->end());
+			blocklistBits = &bits;
+		}
+
+		ret.clear();
 		Vector<SpecialState> spStatesByRet;
-		thread_local Vector<KGraphNode> nodes;
-		thread_local Vector<uint32_t> nodeInWhichPretokenized;
+		if (resume)
+		{
+			// 이전 분석에서 확정된 마지막 청크의 상태를 이어받아 첫 청크를 탐색한다
+			spStatesByRet.emplace_back();
+			reinterpret_cast<uint8_t&>(spStatesByRet[0]) = resume->spState;
+		}
+		auto& nodes = ctx.get<scratch::ChunkGraph>();
+		auto& nodeInWhichPretokenized = ctx.get<scratch::NodeInWhichPretokenized>();
 		const auto* pretokenizedFirst = pretokenizedGroup.spans.data();
 		const auto* pretokenizedLast = pretokenizedFirst + pretokenizedGroup.spans.size();
 		size_t splitEnd = 0;
+
+		// splitEnd부터 다음 청크 하나를 형태 후보 그래프로 분할하고, 그 청크의 끝 위치를 반환한다
+		auto splitNextChunk = [&](Vector<KGraphNode>& out)
+		{
+			const U16StringView rest{ normalizedStr.data() + splitEnd, normalizedStr.size() - splitEnd };
+			if (!formDATrie.empty())
+			{
+				return (*reinterpret_cast<FnSplitByDATrie>(dfSplitByDATrie))(
+					out, forms.data(), typoPtrs.data(), formDATrie, rest, splitEnd,
+					matchOptions, maxUnkFormSize, spaceTolerance, continualTypoCost,
+					pretokenizedFirst, pretokenizedLast
+				);
+			}
+			return (*reinterpret_cast<FnSplitByTrie>(dfSplitByTrie))(
+				out, forms.data(), typoPtrs.data(), formTrie, rest, splitEnd,
+				matchOptions, maxUnkFormSize, spaceTolerance, continualTypoCost,
+				pretokenizedFirst, pretokenizedLast
+			);
+		};
+
+		const bool useChunkMemo = chunkMemo && pretokenizedGroup.spans.empty();
+		std::vector<uint32_t> blocklistKey;
+		if (useChunkMemo) getBlocklistKey(blocklist, blocklistKey);
+		auto findChunkPath = [&](const Vector<KGraphNode>& graph, size_t chunkBegin, size_t chunkEnd, const Vector<SpecialState>& prevSpStates)
+		{
+			auto search = [&](bool& cacheable)
+			{
+				auto ret = (*reinterpret_cast<FnFindBestPath>(dfFindBestPath))(
+					this,
+					prevSpStates,
+					graph.data(),
+					graph.size(),
+					topN,
+					false,
+					!!(matchOptions & Match::splitComplex),
+					blocklistBits
+				);
+				// 작업량 상한 때문에 탐욕적으로 탐색한 결과는 캐시에 남기지 않는다.
+				// 병렬 탐색에서는 워커 스레드가 실행하므로 호출한 스레드의 컨텍스트가 아닌 현재 스레드의 컨텍스트를 확인한다.
+				cacheable = !AnalysisContext::Impl::current().degraded;
+				return ret;
+			};
+			if (!useChunkMemo)
+			{
+				bool cacheable;
+				return search(cacheable);
+			}
+			return chunkMemo->findOrEval(normalizedStr, chunkBegin, chunkEnd, topN, matchOptions, blocklistKey, prevSpStates, search);
+		};
+
+		// 작업량 상한은 한 스레드에서 누적된 전이 횟수와 마감 시각으로 판단하므로, 상한이 설정된 분석은 병렬로 탐색하지 않는다
+		if (parallelChunks && pool && !pool->isWorkerThread() && ctx.budget.unlimited() && !resume)
+		{
+			// 청크 경계를 찾는 대로 각 청크의 최적 경로를 스레드풀에서 미리 탐색해둔다.
+			// 청크 간에 전달되는 SpecialState는 대부분 초기 상태이므로 이를 가정하여 미리 탐색해두고,
+			// 실제 이전 상태가 다를 경우에만 해당 청크를 다시 탐색한다.
+			// 문서 전체의 그래프를 한꺼번에 들고 있지 않도록 동시에 진행 중인 청크는 스레드 수의 두 배로 제한한다.
+			struct PendingChunk
+			{
+				Vector<KGraphNode> nodes;
+				Vector<uint32_t> pretokenized;
+				size_t begin = 0, end = 0;
+				future<Vector<PathEvaluator::ChunkResult>> result;
+			};
+
+			const Vector<SpecialState> initialSpStates(1);
+			const size_t maxPending = pool->size() * 2;
+			Deque<PendingChunk> pending;
+			bool firstChunk = true;
+			try
+			{
+				while (true)
+				{
+					while (pending.size() < maxPending && splitEnd < normalizedStr.size())
+					{
+						Vector<KGraphNode> cnodes;
+						auto* pretokenizedPrev = pretokenizedFirst;
+						const size_t chunkBegin = splitEnd;
+						splitEnd = splitNextChunk(cnodes);
+
+						if (cnodes.size() <= 2) continue;
+						pending.emplace_back();
+						auto& chunk = pending.back();
+						findPretokenizedGroupOfNode(chunk.pretokenized, cnodes, pretokenizedPrev, pretokenizedFirst);
+						chunk.nodes = move(cnodes);
+						chunk.begin = chunkBegin;
+						chunk.end = splitEnd;
+
+						// 첫 청크는 실제 이전 상태를 알고 있으므로 호출한 스레드에서 바로 탐색한다
+						if (firstChunk)
+						{
+							firstChunk = false;
+							continue;
+						}
+						chunk.result = pool->enqueue([&, c = &chunk](size_t)
+						{
+							// 워커의 기본 컨텍스트를 지정해 두어야 분석마다 상태가 초기화되고, 끝난 뒤 high-water mark에 따라 버퍼가 정리된다
+							AnalysisContext::Impl::Binding workerBinding{ AnalysisContext::Impl::threadDefault().impl() };
+							return findChunkPath(c->nodes, c->begin, c->end, initialSpStates);
+						});
+					}
+					if (pending.empty()) break;
+
+					auto& chunk = pending.front();
+					Vector<PathEvaluator::ChunkResult> res;
+					if (chunk.result.valid())
+					{
+						res = chunk.result.get();
+						if (!all_of(spStatesByRet.begin(), spStatesByRet.end(), [](SpecialState s) { return s == SpecialState{}; }))
+						{
+							res = findChunkPath(chunk.nodes, chunk.begin, chunk.end, spStatesByRet);
+						}
+					}
+					else
+					{
+						res = findChunkPath(chunk.nodes, chunk.begin, chunk.end, spStatesByRet);
+					}
+					insertPathIntoResults(ret, spStatesByRet, res, topN, matchOptions, integrateAllomorph, positionTable, wordPositions, pretokenizedGroup, chunk.pretokenized);
+					pending.pop_front();
+				}
+			}
+			catch (...)
+			{
+				// 작업들이 지역 변수를 참조하고 있으므로 모두 끝날 때까지 기다린다
+				for (auto& chunk : pending)
+				{
+					if (chunk.result.valid()) chunk.result.wait();
+				}
+				throw;
+			}
+		}
+
 		while (splitEnd < normalizedStr.size())
 		{
 			nodes.clear();
 			auto* pretokenizedPrev = pretokenizedFirst;
-			splitEnd = (*reinterpret_cast<FnSplitByTrie>(dfSplitByTrie))(
-				nodes,
-				forms.data(),
-				typoPtrs.data(),
-				formTrie,
-				U16StringView{ normalizedStr.data() + splitEnd, normalizedStr.size() - splitEnd },
-				splitEnd,
-				matchOptions,
-				maxUnkFormSize,
-				spaceTolerance,
-				continualTypoCost,
-				pretokenizedFirst,
-				pretokenizedLast
-			);
+			const size_t chunkBegin = splitEnd;
+			splitEnd = splitNextChunk(nodes);
+
+			// 문자열 끝에 닿는 청크는 뒤따르는 텍스트에 따라 경계가 달라질 수 있으므로 확정하지 않는다
+			if (resume && !resume->final && splitEnd >= normalizedStr.size())
+			{
+				splitEnd = chunkBegin;
+				break;
+			}
 
 			if (nodes.size() <= 2) continue;
 			findPretokenizedGroupOfNode(nodeInWhichPretokenized, nodes, pretokenizedPrev, pretokenizedFirst);
 
-			Vector<PathEvaluator::ChunkResult> res = (*reinterpret_cast<FnFindBestPath>(dfFindBestPath))(
-				this,
-				spStatesByRet,
-				nodes.data(),
-				nodes.size(),
-				topN,
-				false,
-				!!(matchOptions & Match::splitComplex),
-				blocklist
-			);
+			Vector<PathEvaluator::ChunkResult> res = findChunkPath(nodes, chunkBegin, splitEnd, spStatesByRet);
 			insertPathIntoResults(ret, spStatesByRet, res, topN, matchOptions, integrateAllomorph, positionTable, wordPositions, pretokenizedGroup, nodeInWhichPretokenized);
 		}
 
-		sort(ret.begin(), ret.end(), [](const TokenResult& a, const TokenResult& b)
+		if (resume)
+		{
+			// 다음 분석이 이어받을 수 있도록 가장 점수가 높은 경로 하나로 확정하고, 문장 및 쌍 정보는 호출자가 채운다
+			resume->stableEnd = lower_bound(positionTable.begin(), positionTable.end(), (uint32_t)splitEnd) - positionTable.begin();
+			if (!ret.empty())
+			{
+				const size_t best = max_element(ret.begin(), ret.end(), [](const Result& a, const Result& b)
+				{
+					return a.second < b.second;
+				}) - ret.begin();
+				resume->spState = spStatesByRet[best];
+				if (best) ret[0] = move(ret[best]);
+				ret.erase(ret.begin() + 1, ret.end());
+			}
+			else
+			{
+				ret.emplace_back();
+			}
+			return;
+		}
+
+		sort(ret.begin(), ret.end(), [](const Result& a, const Result& b)
 		{
 			return a.second > b.second;
 		});
 		if (ret.size() > topN) ret.erase(ret.begin() + topN, ret.end());
 		
-		auto newlines = allNewLinePositions(str);
 		for (auto& r : ret)
 		{
 			fillPairedTokenInfo(r.first);
@@ -1019,7 +1712,86 @@ namespace kiwi
 		}
 
 		if (ret.empty()) ret.emplace_back();
-		return ret;
+	}
+
+	/**
+	* @brief 분석 결과 하나를 열 단위 구조체 `out`에 채운다.
+	*/
+	template<class Result>
+	inline void fillColumns(const Kiwi& kiwi, const Result& res, TokenResultColumns& out, bool fillUtf8)
+	{
+		auto& tokens = res.first;
+		out.clear();
+		out.tags.reserve(tokens.size());
+		out.positions.reserve(tokens.size());
+		out.lengths.reserve(tokens.size());
+		out.wordPositions.reserve(tokens.size());
+		out.sentPositions.reserve(tokens.size());
+		out.scores.reserve(tokens.size());
+		out.morphIds.reserve(tokens.size());
+		out.strOffsets.reserve(tokens.size() + 1);
+		if (fillUtf8) out.u8StrOffsets.reserve(tokens.size() + 1);
+
+		for (auto& t : tokens)
+		{
+			out.tags.emplace_back(t.tag);
+			out.positions.emplace_back(t.position);
+			out.lengths.emplace_back(t.length);
+			out.wordPositions.emplace_back(t.wordPosition);
+			out.sentPositions.emplace_back(t.sentPosition);
+			out.scores.emplace_back(t.score);
+			out.morphIds.emplace_back((uint32_t)kiwi.morphToId(t.morph));
+			const auto str = tokenStr(tokens, t);
+			out.strOffsets.emplace_back((uint32_t)out.strPool.size());
+			out.strPool.append(str.data(), str.size());
+			if (fillUtf8)
+			{
+				out.u8StrOffsets.emplace_back((uint32_t)out.u8StrPool.size());
+				appendUtf16To8(str, out.u8StrPool);
+			}
+		}
+		out.strOffsets.emplace_back((uint32_t)out.strPool.size());
+		if (fillUtf8) out.u8StrOffsets.emplace_back((uint32_t)out.u8StrPool.size());
+		out.score = res.second;
+	}
+
+	void Kiwi::analyze(const u16string& str, TokenResultColumns& out, Match matchOptions,
+		Blocklist blocklist,
+		const std::vector<PretokenizedSpan>& pretokenized,
+		bool fillUtf8
+	) const
+	{
+		analyze(AnalysisContext::Impl::threadDefault(), str, out, matchOptions, blocklist, pretokenized, fillUtf8);
+	}
+
+	void Kiwi::analyze(AnalysisContext& context, const u16string& str, TokenResultColumns& out, Match matchOptions,
+		Blocklist blocklist,
+		const std::vector<PretokenizedSpan>& pretokenized,
+		bool fillUtf8
+	) const
+	{
+		if (resultCache && pretokenized.empty())
+		{
+			// 캐시에는 TokenResult 형태로 저장되므로 캐시를 사용하는 경우에는 TokenResult를 거쳐 채운다
+			auto res = analyze(context, str, 1, matchOptions, blocklist, pretokenized);
+			fillColumns(*this, res[0], out, fillUtf8);
+			return;
+		}
+
+		AnalysisContext::Impl::Binding contextBinding{ context.impl() };
+		auto& ctx = context.impl();
+		auto& normalizedStr = ctx.get<scratch::NormalizedStr>();
+		auto& positionTable = ctx.get<scratch::PositionTable>();
+		auto& wordPositions = ctx.get<scratch::WordPositions>();
+		normalizeUtf16WithPosition(str, normalizedStr, positionTable, wordPositions,
+			reinterpret_cast<text::FnNormalizeHangulWithPosition>(dfNormalizeHangul),
+			reinterpret_cast<text::FnGetWordPositions>(dfGetWordPositions)
+		);
+
+		vector<ColumnResult> res;
+		analyzeNormalized(normalizedStr, positionTable, wordPositions, allNewLinePositions(str),
+			1, matchOptions, blocklist, pretokenized, res);
+		fillColumns(*this, res[0], out, fillUtf8);
 	}
 
 	const Morpheme* Kiwi::getDefaultMorpheme(POSTag tag) const
@@ -1048,8 +1820,81 @@ namespace kiwi
 		}, forward<Rest>(args)...);
 	}
 
+	inline const u16string& toU16Scratch(const u16string& str, u16string& buf)
+	{
+		return str;
+	}
+
+	inline const u16string& toU16Scratch(const string& str, u16string& buf)
+	{
+		utf8To16(nonstd::string_view{ str }, buf);
+		return buf;
+	}
+
+	template<class Str>
+	void Kiwi::_analyzeBatch(const Str* first, const Str* last, TokenResult* out, Match matchOptions,
+		Blocklist blocklist) const
+	{
+		auto analyzeShard = [&](size_t b, size_t e)
+		{
+			// 한 샤드 안에서는 변환 버퍼와 바깥 결과 배열을 재사용한다. 토큰 배열은 out[i]와 맞바꾸어 호출자에게 넘긴다
+			u16string buf;
+			vector<TokenResult> ret;
+			auto& context = AnalysisContext::Impl::threadDefault();
+			for (size_t i = b; i < e; ++i)
+			{
+				analyzeInto(context, toU16Scratch(first[i], buf), 1, matchOptions, blocklist, {}, ret);
+				swap(out[i], ret[0]);
+			}
+		};
+
+		const size_t numItems = last - first;
+		// 풀의 워커 안에서 같은 풀의 작업을 기다리면 교착 상태에 빠질 수 있으므로 그대로 순서대로 처리한다
+		if (!pool || numItems <= 1 || pool->isWorkerThread())
+		{
+			analyzeShard(0, numItems);
+			return;
+		}
+
+		const size_t numShards = std::min(pool->size(), numItems);
+		vector<future<void>> futures;
+		futures.reserve(numShards);
+		try
+		{
+			for (size_t i = 0; i < numShards; ++i)
+			{
+				futures.emplace_back(pool->enqueue([&, b = numItems * i / numShards, e = numItems * (i + 1) / numShards](size_t)
+				{
+					analyzeShard(b, e);
+				}));
+			}
+			for (auto& f : futures) f.get();
+		}
+		catch (...)
+		{
+			// 작업들이 지역 변수와 out을 참조하고 있으므로 모두 끝날 때까지 기다린다
+			for (auto& f : futures)
+			{
+				if (f.valid()) f.wait();
+			}
+			throw;
+		}
+	}
+
+	void Kiwi::analyzeBatch(const u16string* first, const u16string* last, TokenResult* out, Match matchOptions,
+		Blocklist blocklist) const
+	{
+		return _analyzeBatch(first, last, out, matchOptions, blocklist);
+	}
+
+	void Kiwi::analyzeBatch(const string* first, const string* last, TokenResult* out, Match matchOptions,
+		Blocklist blocklist) const
+	{
+		return _analyzeBatch(first, last, out, matchOptions, blocklist);
+	}
+
 	future<vector<TokenResult>> Kiwi::asyncAnalyze(const string& str, size_t topN, Match matchOptions, 
-		const unordered_set<const Morpheme*>* blocklist,
+		Blocklist blocklist,
 		const vector<PretokenizedSpan>& pretokenized
 	) const
 	{
@@ -1057,7 +1902,7 @@ namespace kiwi
 	}
 
 	future<vector<TokenResult>> Kiwi::asyncAnalyze(string&& str, size_t topN, Match matchOptions, 
-		const unordered_set<const Morpheme*>* blocklist,
+		Blocklist blocklist,
 		vector<PretokenizedSpan>&& pretokenized
 	) const
 	{
@@ -1065,7 +1910,7 @@ namespace kiwi
 	}
 
 	future<TokenResult> Kiwi::asyncAnalyze(const string& str, Match matchOptions, 
-		const unordered_set<const Morpheme*>* blocklist,
+		Blocklist blocklist,
 		const vector<PretokenizedSpan>& pretokenized
 	) const
 	{
@@ -1073,7 +1918,7 @@ namespace kiwi
 	}
 
 	future<TokenResult> Kiwi::asyncAnalyze(string&& str, Match matchOptions, 
-		const unordered_set<const Morpheme*>* blocklist,
+		Blocklist blocklist,
 		vector<PretokenizedSpan>&& pretokenized
 	) const
 	{
@@ -1081,7 +1926,7 @@ namespace kiwi
 	}
 
 	future<pair<TokenResult, string>> Kiwi::asyncAnalyzeEcho(string&& str, Match matchOptions, 
-		const unordered_set<const Morpheme*>* blocklist,
+		Blocklist blocklist,
 		vector<PretokenizedSpan>&& pretokenized
 	) const
 	{
@@ -1089,7 +1934,7 @@ namespace kiwi
 	}
 
 	future<vector<TokenResult>> Kiwi::asyncAnalyze(const u16string& str, size_t topN, Match matchOptions, 
-		const unordered_set<const Morpheme*>* blocklist,
+		Blocklist blocklist,
 		const vector<PretokenizedSpan>& pretokenized
 	) const
 	{
@@ -1097,7 +1942,7 @@ namespace kiwi
 	}
 
 	future<vector<TokenResult>> Kiwi::asyncAnalyze(u16string&& str, size_t topN, Match matchOptions, 
-		const unordered_set<const Morpheme*>* blocklist,
+		Blocklist blocklist,
 		vector<PretokenizedSpan>&& pretokenized
 	) const
 	{
@@ -1105,7 +1950,7 @@ namespace kiwi
 	}
 
 	future<TokenResult> Kiwi::asyncAnalyze(const u16string& str, Match matchOptions, 
-		const unordered_set<const Morpheme*>* blocklist,
+		Blocklist blocklist,
 		const vector<PretokenizedSpan>& pretokenized
 	) const
 	{
@@ -1113,7 +1958,7 @@ namespace kiwi
 	}
 
 	future<TokenResult> Kiwi::asyncAnalyze(u16string&& str, Match matchOptions, 
-		const unordered_set<const Morpheme*>* blocklist,
+		Blocklist blocklist,
 		vector<PretokenizedSpan>&& pretokenized
 	) const
 	{
@@ -1121,7 +1966,7 @@ namespace kiwi
 	}
 
 	future<pair<TokenResult, u16string>> Kiwi::asyncAnalyzeEcho(u16string&& str, Match matchOptions, 
-		const unordered_set<const Morpheme*>* blocklist,
+		Blocklist blocklist,
 		vector<PretokenizedSpan>&& pretokenized
 	) const
 	{
@@ -1291,4 +2136,179 @@ namespace kiwi
 		findMorpheme(ret, s, tag);
 		return ret;
 	}
+
+	Kiwi::StreamAnalyzer::StreamAnalyzer(const Kiwi& _kiwi,
+		Receiver _receiver,
+		Match _matchOptions,
+		Blocklist _blocklist,
+		size_t _maxBufferSize
+	)
+		: kiwi{ &_kiwi }, receiver{ move(_receiver) }, matchOptions{ _matchOptions }, 
+		blocklist{ _blocklist }, maxBufferSize{ _maxBufferSize }
+	{
+		if (!maxBufferSize) throw std::invalid_argument{ "`maxBufferSize` must > 0" };
+	}
+
+	void Kiwi::StreamAnalyzer::push(const u16string& text)
+	{
+		buffer += text;
+		process(false);
+	}
+
+	void Kiwi::StreamAnalyzer::push(const string& text)
+	{
+		pendingBytes += text;
+		// 마지막 문자가 잘려 있는 경우 다음 입력이 올 때까지 남겨둔다
+		size_t complete = pendingBytes.size();
+		for (size_t k = 1; k <= 3 && k <= pendingBytes.size(); ++k)
+		{
+			const uint8_t b = pendingBytes[pendingBytes.size() - k];
+			if ((b & 0xC0) == 0x80) continue;
+			const size_t need = b >= 0xF0 ? 4 : (b >= 0xE0 ? 3 : (b >= 0xC0 ? 2 : 1));
+			if (need > k) complete -= k;
+			break;
+		}
+		buffer += utf8To16(nonstd::string_view{ pendingBytes.data(), complete });
+		pendingBytes.erase(0, complete);
+		process(false);
+	}
+
+	void Kiwi::StreamAnalyzer::finish()
+	{
+		if (!pendingBytes.empty())
+		{
+			// 끝까지 완성되지 않은 바이트열은 utf8To16이 예외를 던지도록 그대로 넘긴다
+			buffer += utf8To16(nonstd::string_view{ pendingBytes });
+			pendingBytes.clear();
+		}
+		process(true);
+	}
+
+	void Kiwi::StreamAnalyzer::process(bool final)
+	{
+		if (final)
+		{
+			if (resumeFrom < buffer.size()) analyzeUntil(buffer.size(), true);
+			emitSentences(true);
+			return;
+		}
+
+		// 청크는 공백에서만 나뉘므로, 새로 들어온 텍스트에 공백이 있을 때만 확정할 수 있는 청크가 생긴다
+		const bool hasSpace = any_of(buffer.begin() + min(scanFrom, buffer.size()), buffer.end(), [](char16_t c)
+		{
+			return isSpace(c);
+		});
+		scanFrom = buffer.size();
+		// 확정된 청크가 없었다면 남은 텍스트가 두 배로 늘어날 때까지 다시 분할하지 않는다.
+		// 긴 청크가 조금씩 입력되더라도 같은 텍스트를 반복해서 분할하는 비용이 입력 길이에 비례하도록 하기 위함이다.
+		if (hasSpace && buffer.size() - resumeFrom >= retryLength)
+		{
+			if (analyzeUntil(buffer.size(), false))
+			{
+				retryLength = 0;
+				emitSentences(false);
+			}
+			else
+			{
+				retryLength = (buffer.size() - resumeFrom) * 2;
+			}
+		}
+
+		if (buffer.size() > maxBufferSize)
+		{
+			size_t cut = buffer.size();
+			for (size_t i = buffer.size(); i > resumeFrom + 1; --i)
+			{
+				const char16_t c = buffer[i - 1];
+				if (isSpace(c) && c != u'\r')
+				{
+					cut = i;
+					break;
+				}
+			}
+			if (cut == buffer.size() && isHighSurrogate(buffer.back())) --cut;
+			if (cut > resumeFrom) analyzeUntil(cut, true);
+			emitSentences(true);
+			retryLength = 0;
+		}
+	}
+
+	bool Kiwi::StreamAnalyzer::analyzeUntil(size_t cut, bool final)
+	{
+		// 마지막으로 확정된 청크 뒤부터 이어서 분석하므로 이미 분석한 텍스트는 다시 분석하지 않는다
+		resume.final = final;
+		analyzedChars += cut - resumeFrom;
+		vector<TokenResult> res;
+		kiwi->analyzeResumable(buffer.substr(resumeFrom, cut - resumeFrom), matchOptions, blocklist, resume, res);
+
+		// 어절 번호는 문장 번호를 채울 때 어절이 바뀌었는지만 확인하므로 앞서 확정된 형태소와 겹치지 않게만 해둔다
+		const uint32_t wordBase = pendingTokens.empty() ? 0 : pendingTokens.back().wordPosition + 1;
+		for (auto& t : res[0].first)
+		{
+			t.position += (uint32_t)resumeFrom;
+			t.wordPosition += wordBase;
+			pendingTokens.emplace_back(move(t));
+		}
+		resumeFrom += resume.stableEnd;
+		return resume.stableEnd > 0;
+	}
+
+	void Kiwi::StreamAnalyzer::emitSentences(bool emitAll)
+	{
+		// 확정된 형태소들에 대해서만 문장 및 쌍 정보를 채우고, 원본은 다음 청크와 함께 다시 채울 수 있도록 그대로 둔다
+		vector<TokenInfo> tokens = pendingTokens;
+		fillPairedTokenInfo(tokens);
+		fillSentLineInfo(tokens, allNewLinePositions(buffer));
+
+		size_t keepFrom = tokens.size();
+		if (!emitAll)
+		{
+			if (tokens.empty()) return;
+			// 마지막 문장은 뒤따르는 형태소에 따라 달라질 수 있으므로 남겨둔다
+			const uint32_t lastSent = tokens.back().sentPosition;
+			keepFrom = find_if(tokens.begin(), tokens.end(), [&](const TokenInfo& t)
+			{
+				return t.sentPosition == lastSent;
+			}) - tokens.begin();
+
+			if (keepFrom == 0) return;
+		}
+		const size_t consumed = keepFrom < tokens.size() ? tokens[keepFrom].position : resumeFrom;
+
+		uint32_t numSents = 0;
+		for (size_t b = 0; b < keepFrom; )
+		{
+			size_t e = b + 1;
+			while (e < keepFrom && tokens[e].sentPosition == tokens[b].sentPosition) ++e;
+
+			vector<TokenInfo> sent{ make_move_iterator(tokens.begin() + b), make_move_iterator(tokens.begin() + e) };
+			for (auto& t : sent)
+			{
+				t.position += positionBase;
+				t.sentPosition = sentBase + numSents;
+				t.lineNumber += lineBase;
+				if (t.pairedToken != (uint32_t)-1)
+				{
+					t.pairedToken = (b <= t.pairedToken && t.pairedToken < e) ? (uint32_t)(t.pairedToken - b) : (uint32_t)-1;
+				}
+			}
+			++numSents;
+			receiver(move(sent));
+			b = e;
+		}
+
+		pendingTokens.erase(pendingTokens.begin(), pendingTokens.begin() + keepFrom);
+		for (auto& t : pendingTokens) t.position -= (uint32_t)consumed;
+
+		bool isCR = false;
+		for (size_t i = 0; i < consumed; ++i)
+		{
+			if (isNewLine(buffer[i], isCR)) ++lineBase;
+		}
+		sentBase += numSents;
+		positionBase += (uint32_t)consumed;
+		buffer.erase(0, consumed);
+		resumeFrom -= consumed;
+		scanFrom = scanFrom > consumed ? scanFrom - consumed : 0;
+	}
 }
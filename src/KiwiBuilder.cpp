@@ -8,6 +8,7 @@
 #include "KTrie.h"
 #include "StrUtils.h"
 #include "FrozenTrie.hpp"
+#include "DoubleArrayTrie.hpp"
 #include "Knlm.hpp"
 #include "serializer.hpp"
 #include "count.hpp"
@@ -616,10 +617,20 @@ KiwiBuilder::KiwiBuilder(const string& modelPath, size_t _numThreads, BuildOptio
 		utils::imstream iss{ mm };
 		loadMorphBin(iss);
 	}
-	langMdl.knlm = lm::KnLangModelBase::create(utils::MMap(modelPath + string{ "/sj.knlm" }), archType);
-	if (useSBG)
 	{
-		langMdl.sbg = sb::SkipBigramModelBase::create(utils::MMap(modelPath + string{ "/skipbigram.mdl" }), archType);
+		utils::MemoryObject knlmMem = utils::MMap(modelPath + string{ "/sj.knlm" });
+		utils::MemoryObject sbgMem = useSBG ? utils::MemoryObject{ utils::MMap(modelPath + string{ "/skipbigram.mdl" }) } : utils::MemoryObject{ utils::MemoryOwner{} };
+
+		// 런타임 레이아웃으로 저장된 모델은 저장 당시의 아키텍처로만 불러올 수 있으므로, 가능하면 그 아키텍처를 따른다.
+		auto lmArch = lm::KnLangModelBase::getRuntimeLayoutArch(knlmMem);
+		if (lmArch == ArchType::default_) lmArch = sb::SkipBigramModelBase::getRuntimeLayoutArch(sbgMem);
+		if (lmArch != ArchType::default_ && getSelectedArch(lmArch) == lmArch) archType = lmArch;
+
+		langMdl.knlm = lm::KnLangModelBase::create(move(knlmMem), archType);
+		if (useSBG)
+		{
+			langMdl.sbg = sb::SkipBigramModelBase::create(move(sbgMem), archType);
+		}
 	}
 
 	if (!!(options & BuildOption::loadDefaultDict))
@@ -954,17 +965,23 @@ KiwiBuilder::KiwiBuilder(const string& modelPath, const ModelBuildArgs& args)
 	}
 }
 
-void KiwiBuilder::saveModel(const string& modelPath) const
+void KiwiBuilder::saveModel(const string& modelPath, bool runtimeLayout) const
 {
 	{
 		ofstream ofs{ modelPath + "/sj.morph", ios_base::binary };
 		saveMorphBin(ofs);
 	}
 	{
-		auto mem = langMdl.knlm->getMemory();
+		utils::MemoryObject mem = runtimeLayout ? utils::MemoryObject{ langMdl.knlm->toRuntimeLayout() } : langMdl.knlm->getMemory();
 		ofstream ofs{ modelPath + "/sj.knlm", ios_base::binary };
 		ofs.write((const char*)mem.get(), mem.size());
 	}
+	if (langMdl.sbg)
+	{
+		utils::MemoryObject mem = runtimeLayout ? utils::MemoryObject{ langMdl.sbg->toRuntimeLayout() } : langMdl.sbg->getMemory();
+		ofstream ofs{ modelPath + "/skipbigram.mdl", ios_base::binary };
+		ofs.write((const char*)mem.get(), mem.size());
+	}
 }
 
 void KiwiBuilder::addAllomorphsToRule()
@@ -1680,7 +1697,7 @@ namespace kiwi
 	}
 }
 
-Kiwi KiwiBuilder::build(const TypoTransformer& typos, float typoCostThreshold) const
+Kiwi KiwiBuilder::build(const TypoTransformer& typos, float typoCostThreshold, TrieBackend trieBackend) const
 {
 	Kiwi ret{ archType, langMdl, !typos.empty(), typos.isContinualTypoEnabled() };
 
@@ -1894,6 +1911,10 @@ Kiwi KiwiBuilder::build(const TypoTransformer& typos, float typoCostThreshold) c
 		}
 	}
 
+	if (trieBackend == TrieBackend::doubleArray)
+	{
+		ret.formDATrie = utils::DoubleArrayTrie<kchar_t, const Form*>{ formTrie };
+	}
 	ret.formTrie = freezeTrie(move(formTrie), archType);
 
 	for (auto& m : ret.morphemes)
@@ -0,0 +1,469 @@
+#include <fstream>
+#include <cmath>
+
+#include <kiwi/Kiwi.h>
+#include <kiwi/Utils.h>
+#include <kiwi/Mmap.h>
+#include "FrozenTrie.hpp"
+#include "DoubleArrayTrie.hpp"
+#include "Knlm.hpp"
+#include "SkipBigramModel.hpp"
+#include "Combiner.h"
+#include "serializer.hpp"
+
+using namespace std;
+
+namespace kiwi
+{
+	namespace detail
+	{
+		/*
+		* Kiwi image layout (all sections are written sequentially):
+		*   "KIWIIMG", version, archType, flags, analysis parameters, runtime options (search, beam, caches)
+		*   knlm blob, sbg blob (runtime layouts, 64-byte aligned so that the models can be used in place)
+		*   forms: string pool + FormRecord[] + candidate pool
+		*   morphemes: MorphemeRecord[] + chunk pool
+		*   (form/morpheme sections are 64-byte aligned and read in place; only Form and Morpheme objects are built from them,
+		*    copying strings and pointer lists but nothing that has to be recomputed, such as leftCondMask)
+		*   typoPool, typoPtrs, typoForms
+		*   formTrie (8-byte aligned arrays mapped in place; values are stored as indices into forms, 
+		*             followed by indices into typoForms offset by forms.size())
+		*   formDATrie (only if built with TrieBackend::doubleArray; same value indices, arrays are copied)
+		*   specialMorphIds, combiningRule
+		*/
+		static constexpr uint32_t imageVersion = 4;
+		static constexpr size_t imageBlobAlignment = 64;
+
+		enum class ImageFlag : uint8_t
+		{
+			none = 0,
+			integrateAllomorph = 1 << 0,
+			typoTolerant = 1 << 1,
+			continualTypoTolerant = 1 << 2,
+			hasCombiningRule = 1 << 3,
+			doubleArrayTrie = 1 << 4,
+			parallelChunks = 1 << 5,
+			dedicatedTop1 = 1 << 6,
+			lmTransitionMemo = 1 << 7,
+		};
+
+		KIWI_DEFINE_ENUM_FLAG_OPERATORS(ImageFlag);
+
+		struct FormRecord
+		{
+			uint32_t formBegin = 0;
+			uint32_t candBegin = 0;
+			uint32_t numSpaces = 0;
+			CondVowel vowel = CondVowel::none;
+			CondPolarity polar = CondPolarity::none;
+			uint8_t formHash = 0;
+			uint8_t zCodaAppendable = 0;
+		};
+
+		struct MorphemeRecord
+		{
+			uint32_t formId = 0;
+			POSTag tag = POSTag::unknown;
+			CondVowel vowel = CondVowel::none;
+			CondPolarity polar = CondPolarity::none;
+			uint8_t complex = 0;
+			uint8_t senseId = 0;
+			uint8_t combineSocket = 0;
+			uint16_t leftCondMask = 0;
+			int32_t combined = 0;
+			float userScore = 0;
+			uint32_t lmMorphemeId = 0;
+			uint32_t origMorphemeId = 0;
+			uint32_t chunkBegin = 0;
+		};
+
+		template<class Ty>
+		void writePod(ostream& ostr, const Vector<Ty>& v)
+		{
+			static_assert(is_trivially_copyable<Ty>::value, "Ty must be trivially copyable.");
+			serializer::writeToStream(ostr, (uint64_t)v.size());
+			if (!ostr.write((const char*)v.data(), sizeof(Ty) * v.size()))
+				throw serializer::SerializationException{ "writing Kiwi image failed" };
+		}
+
+		template<class Ty>
+		void readPod(istream& istr, Vector<Ty>& v)
+		{
+			static_assert(is_trivially_copyable<Ty>::value, "Ty must be trivially copyable.");
+			auto size = serializer::readFromStream<uint64_t>(istr);
+			v.resize(size);
+			if (!istr.read((char*)v.data(), sizeof(Ty) * size))
+				throw serializer::SerializationException{ "reading Kiwi image failed" };
+		}
+
+		inline void writeAligned(ostream& ostr, const void* data, uint64_t size)
+		{
+			serializer::writeToStream(ostr, size);
+			if (!size) return;
+			const size_t pos = (size_t)ostr.tellp();
+			static const char zeros[imageBlobAlignment] = { 0, };
+			ostr.write(zeros, (imageBlobAlignment - pos % imageBlobAlignment) % imageBlobAlignment);
+			if (!ostr.write((const char*)data, size))
+				throw serializer::SerializationException{ "writing Kiwi image failed" };
+		}
+
+		inline size_t readAligned(utils::imstream& istr, const utils::MemoryObject& image, uint64_t& size)
+		{
+			size = serializer::readFromStream<uint64_t>(istr);
+			if (!size) return 0;
+			size_t pos = istr.curptr() - (const char*)image.get();
+			pos += (imageBlobAlignment - pos % imageBlobAlignment) % imageBlobAlignment;
+			if (pos + size > image.size()) throw serializer::SerializationException{ "reading Kiwi image failed" };
+			istr.seekg(pos + size);
+			return pos;
+		}
+
+		inline void writeBlob(ostream& ostr, const utils::MemoryObject* mem)
+		{
+			writeAligned(ostr, mem ? mem->get() : nullptr, mem ? mem->size() : 0);
+		}
+
+		inline unique_ptr<utils::MemorySlice> readBlob(utils::imstream& istr, const utils::MemoryObject& image)
+		{
+			uint64_t size;
+			const size_t pos = readAligned(istr, image, size);
+			if (!size) return {};
+			return make_unique<utils::MemorySlice>(image, pos, size);
+		}
+
+		template<class Ty, class Alloc>
+		void writeArray(ostream& ostr, const vector<Ty, Alloc>& v)
+		{
+			static_assert(is_trivially_copyable<Ty>::value, "Ty must be trivially copyable.");
+			writeAligned(ostr, v.data(), sizeof(Ty) * v.size());
+		}
+
+		template<class Ty, class Traits, class Alloc>
+		void writeArray(ostream& ostr, const basic_string<Ty, Traits, Alloc>& v)
+		{
+			writeAligned(ostr, v.data(), sizeof(Ty) * v.size());
+		}
+
+		/**
+		* @brief `writeArray()`로 기록된 배열을 복사 없이 이미지 위에서 가리킨다.
+		*/
+		template<class Ty>
+		struct ArrayView
+		{
+			const Ty* data = nullptr;
+			size_t size = 0;
+
+			const Ty& operator[](size_t i) const { return data[i]; }
+		};
+
+		template<class Ty>
+		ArrayView<Ty> readArray(utils::imstream& istr, const utils::MemoryObject& image)
+		{
+			static_assert(is_trivially_copyable<Ty>::value, "Ty must be trivially copyable.");
+			static_assert(imageBlobAlignment % alignof(Ty) == 0, "Ty is over-aligned for Kiwi image.");
+			uint64_t size;
+			const size_t pos = readAligned(istr, image, size);
+			if (size % sizeof(Ty)) throw serializer::SerializationException{ "reading Kiwi image failed" };
+			ArrayView<Ty> ret;
+			if (size) ret.data = reinterpret_cast<const Ty*>((const char*)image.get() + pos);
+			ret.size = size / sizeof(Ty);
+			return ret;
+		}
+	}
+
+	void Kiwi::save(ostream& ostr) const
+	{
+		using namespace detail;
+		if (!ready()) throw Exception{ "Cannot save an empty Kiwi instance." };
+
+		ImageFlag flags = ImageFlag::none;
+		if (integrateAllomorph) flags |= ImageFlag::integrateAllomorph;
+		if (isTypoTolerant()) flags |= ImageFlag::typoTolerant;
+		if (isfinite(continualTypoCost)) flags |= ImageFlag::continualTypoTolerant;
+		if (combiningRule) flags |= ImageFlag::hasCombiningRule;
+		if (!formDATrie.empty()) flags |= ImageFlag::doubleArrayTrie;
+		if (parallelChunks) flags |= ImageFlag::parallelChunks;
+		if (dedicatedTop1) flags |= ImageFlag::dedicatedTop1;
+		if (getLmTransitionMemo()) flags |= ImageFlag::lmTransitionMemo;
+
+		serializer::writeMany(ostr, serializer::toKey("KIWIIMG"), imageVersion, (uint32_t)selectedArch, flags,
+			cutOffThreshold, unkFormScoreScale, unkFormScoreBias, spacePenalty, typoCostWeight, continualTypoCost,
+			(uint64_t)maxUnkFormSize, (uint64_t)spaceTolerance,
+			(uint64_t)beamOptions.maxStatesPerNode, beamOptions.marginRatio, (uint64_t)beamOptions.chunkStateBudget, (uint8_t)beamOptions.adaptive,
+			(uint64_t)getResultCacheSize(), (uint32_t)getChunkMemoMode(), (uint64_t)getChunkMemoSize()
+		);
+
+		// 언어 모델은 런타임 레이아웃으로 변환하여 저장해 불러올 때 복사 없이 바로 사용할 수 있게 한다.
+		unique_ptr<utils::MemoryObject> knlmLayout, sbgLayout;
+		if (langMdl.knlm) knlmLayout = make_unique<utils::MemoryObject>(langMdl.knlm->toRuntimeLayout());
+		if (langMdl.sbg) sbgLayout = make_unique<utils::MemoryObject>(langMdl.sbg->toRuntimeLayout());
+		writeBlob(ostr, knlmLayout.get());
+		writeBlob(ostr, sbgLayout.get());
+
+		UnorderedMap<const KString*, uint32_t> formIdMap;
+		KString formPool;
+		Vector<FormRecord> formRecords;
+		Vector<uint32_t> candPool;
+		formRecords.reserve(forms.size() + 1);
+		for (auto& f : forms)
+		{
+			formIdMap.emplace(&f.form, (uint32_t)formRecords.size());
+			formRecords.emplace_back();
+			auto& r = formRecords.back();
+			r.formBegin = formPool.size();
+			r.candBegin = candPool.size();
+			r.numSpaces = f.numSpaces;
+			r.vowel = f.vowel;
+			r.polar = f.polar;
+			r.formHash = f.formHash;
+			r.zCodaAppendable = f.zCodaAppendable;
+			formPool += f.form;
+			for (auto m : f.candidate) candPool.emplace_back(m - morphemes.data());
+		}
+		formRecords.emplace_back();
+		formRecords.back().formBegin = formPool.size();
+		formRecords.back().candBegin = candPool.size();
+
+		Vector<MorphemeRecord> morphRecords;
+		Vector<uint32_t> chunkPool;
+		Vector<uint8_t> chunkPositionPool;
+		morphRecords.reserve(morphemes.size() + 1);
+		for (auto& m : morphemes)
+		{
+			morphRecords.emplace_back();
+			auto& r = morphRecords.back();
+			r.formId = m.kform ? formIdMap.at(m.kform) : (uint32_t)-1;
+			r.tag = m.tag;
+			r.vowel = m.vowel;
+			r.polar = m.polar;
+			r.complex = m.complex ? 1 : 0;
+			r.senseId = m.senseId;
+			r.combineSocket = m.combineSocket;
+			r.leftCondMask = m.leftCondMask;
+			r.combined = m.combined;
+			r.userScore = m.userScore;
+			r.lmMorphemeId = m.lmMorphemeId;
+			r.origMorphemeId = m.origMorphemeId;
+			r.chunkBegin = chunkPool.size();
+			for (size_t i = 0; i < m.chunks.size(); ++i)
+			{
+				chunkPool.emplace_back(m.chunks[i] - morphemes.data());
+				chunkPositionPool.emplace_back(m.chunks.getSecond(i).first);
+				chunkPositionPool.emplace_back(m.chunks.getSecond(i).second);
+			}
+		}
+		morphRecords.emplace_back();
+		morphRecords.back().chunkBegin = chunkPool.size();
+
+		writeArray(ostr, formPool);
+		writeArray(ostr, formRecords);
+		writeArray(ostr, candPool);
+		writeArray(ostr, morphRecords);
+		writeArray(ostr, chunkPool);
+		writeArray(ostr, chunkPositionPool);
+
+		Vector<uint64_t> typoPtrs64{ typoPtrs.begin(), typoPtrs.end() };
+		serializer::writeMany(ostr, typoPool);
+		writePod(ostr, typoPtrs64);
+		writePod(ostr, typoForms);
+
+		// 오타 교정이 켜진 경우에도 기본 태그 형태들은 forms를 직접 가리키므로 두 범위를 모두 고려해야 한다.
+		auto formToIdx = [&](const Form* v) -> size_t
+		{
+			if (forms.data() <= v && v < forms.data() + forms.size()) return v - forms.data();
+			return forms.size() + (reinterpret_cast<const TypoForm*>(v) - typoForms.data());
+		};
+		formTrie.writeTo(ostr, formToIdx);
+		if (!formDATrie.empty()) formDATrie.writeTo(ostr, formToIdx);
+
+		serializer::writeMany(ostr, specialMorphIds);
+		if (combiningRule) serializer::writeMany(ostr, *combiningRule);
+	}
+
+	void Kiwi::save(const string& path) const
+	{
+		ofstream ofs;
+		save(openFile(ofs, path, ios_base::binary));
+	}
+
+	Kiwi Kiwi::loadImage(const string& path, size_t numThreads)
+	{
+		using namespace detail;
+		utils::MemoryObject image{ utils::MMap(path) };
+		utils::imstream istr{ (const char*)image.get(), (ptrdiff_t)image.size() };
+
+		uint32_t version, arch;
+		ImageFlag flags;
+		float cutOffThreshold, unkFormScoreScale, unkFormScoreBias, spacePenalty, typoCostWeight, continualTypoCost;
+		uint64_t maxUnkFormSize, spaceTolerance;
+		uint64_t beamMaxStatesPerNode, beamChunkStateBudget, resultCacheSize, chunkMemoSize;
+		float beamMarginRatio;
+		uint8_t beamAdaptive;
+		uint32_t chunkMemoMode;
+		serializer::readMany(istr, serializer::toKey("KIWIIMG"), version);
+		if (version != imageVersion)
+		{
+			throw FormatException{ "Unsupported version of Kiwi image: " + to_string(version) };
+		}
+		serializer::readMany(istr, arch, flags,
+			cutOffThreshold, unkFormScoreScale, unkFormScoreBias, spacePenalty, typoCostWeight, continualTypoCost,
+			maxUnkFormSize, spaceTolerance,
+			beamMaxStatesPerNode, beamMarginRatio, beamChunkStateBudget, beamAdaptive,
+			resultCacheSize, chunkMemoMode, chunkMemoSize
+		);
+
+		const auto archType = static_cast<ArchType>(arch);
+		if (getSelectedArch(archType) != archType)
+		{
+			throw runtime_error{ string{ "The image was saved for an unsupported architecture : " } + archToStr(archType) };
+		}
+
+		LangModel langMdl;
+		if (auto knlm = readBlob(istr, image)) langMdl.knlm = lm::KnLangModelBase::create(move(*knlm), archType);
+		if (auto sbg = readBlob(istr, image)) langMdl.sbg = sb::SkipBigramModelBase::create(move(*sbg), archType);
+
+		Kiwi ret{ archType, langMdl, !!(flags & ImageFlag::typoTolerant), !!(flags & ImageFlag::continualTypoTolerant) };
+		ret.integrateAllomorph = !!(flags & ImageFlag::integrateAllomorph);
+		ret.cutOffThreshold = cutOffThreshold;
+		ret.unkFormScoreScale = unkFormScoreScale;
+		ret.unkFormScoreBias = unkFormScoreBias;
+		ret.spacePenalty = spacePenalty;
+		ret.typoCostWeight = typoCostWeight;
+		ret.continualTypoCost = continualTypoCost;
+		ret.maxUnkFormSize = maxUnkFormSize;
+		ret.spaceTolerance = spaceTolerance;
+		ret.parallelChunks = !!(flags & ImageFlag::parallelChunks);
+		ret.dedicatedTop1 = !!(flags & ImageFlag::dedicatedTop1);
+		ret.beamOptions.maxStatesPerNode = beamMaxStatesPerNode;
+		ret.beamOptions.marginRatio = beamMarginRatio;
+		ret.beamOptions.chunkStateBudget = beamChunkStateBudget;
+		ret.beamOptions.adaptive = !!beamAdaptive;
+		ret.setLmTransitionMemo(!!(flags & ImageFlag::lmTransitionMemo));
+		ret.setResultCacheSize(resultCacheSize);
+		if (chunkMemoMode > (uint32_t)ChunkMemoMode::approximate) throw FormatException{ "Invalid Kiwi image: " + path };
+		ret.setChunkMemo((ChunkMemoMode)chunkMemoMode, chunkMemoSize);
+
+		// 레코드와 풀은 이미지를 직접 가리키고, 이를 바탕으로 Form과 Morpheme 객체만 새로 만든다.
+		const auto formPool = readArray<char16_t>(istr, image);
+		const auto formRecords = readArray<FormRecord>(istr, image);
+		const auto candPool = readArray<uint32_t>(istr, image);
+		const auto morphRecords = readArray<MorphemeRecord>(istr, image);
+		const auto chunkPool = readArray<uint32_t>(istr, image);
+		const auto chunkPositionPool = readArray<uint8_t>(istr, image);
+		if (!formRecords.size || !morphRecords.size) throw FormatException{ "Invalid Kiwi image: " + path };
+		if (chunkPositionPool.size != chunkPool.size * 2) throw FormatException{ "Invalid Kiwi image: " + path };
+
+		// forms and morphemes refer to each other by pointers, so both arrays must be allocated before filling.
+		ret.forms.resize(formRecords.size - 1);
+		ret.morphemes.resize(morphRecords.size - 1);
+		const size_t numMorphemes = ret.morphemes.size();
+
+		// 레코드는 이미지를 그대로 믿지 않고, 풀과 배열 밖을 가리키지 않는지 확인한 뒤에 사용한다
+		for (size_t i = 0; i < ret.forms.size(); ++i)
+		{
+			auto& r = formRecords[i];
+			auto& n = formRecords[i + 1];
+			if (r.formBegin > n.formBegin || n.formBegin > formPool.size
+				|| r.candBegin > n.candBegin || n.candBegin > candPool.size)
+			{
+				throw FormatException{ "Invalid Kiwi image: " + path };
+			}
+		}
+		for (size_t i = 0; i < candPool.size; ++i)
+		{
+			if (candPool[i] >= numMorphemes) throw FormatException{ "Invalid Kiwi image: " + path };
+		}
+		for (size_t i = 0; i < numMorphemes; ++i)
+		{
+			auto& r = morphRecords[i];
+			auto& n = morphRecords[i + 1];
+			if ((r.formId != (uint32_t)-1 && r.formId >= ret.forms.size())
+				|| r.chunkBegin > n.chunkBegin || n.chunkBegin > chunkPool.size
+				|| (int64_t)i + r.combined < 0 || (int64_t)i + r.combined >= (int64_t)numMorphemes
+				|| r.lmMorphemeId >= numMorphemes || r.origMorphemeId >= numMorphemes)
+			{
+				throw FormatException{ "Invalid Kiwi image: " + path };
+			}
+		}
+		for (size_t i = 0; i < chunkPool.size; ++i)
+		{
+			if (chunkPool[i] >= numMorphemes) throw FormatException{ "Invalid Kiwi image: " + path };
+		}
+
+		for (size_t i = 0; i < ret.forms.size(); ++i)
+		{
+			auto& r = formRecords[i];
+			auto& f = ret.forms[i];
+			f.form.assign(formPool.data + r.formBegin, formRecords[i + 1].formBegin - r.formBegin);
+			f.candidate = FixedVector<const Morpheme*>{ formRecords[i + 1].candBegin - r.candBegin };
+			for (size_t j = 0; j < f.candidate.size(); ++j)
+			{
+				f.candidate[j] = ret.morphemes.data() + candPool[r.candBegin + j];
+			}
+			f.numSpaces = r.numSpaces;
+			f.vowel = r.vowel;
+			f.polar = r.polar;
+			f.formHash = r.formHash;
+			f.zCodaAppendable = r.zCodaAppendable;
+		}
+
+		for (size_t i = 0; i < ret.morphemes.size(); ++i)
+		{
+			auto& r = morphRecords[i];
+			auto& m = ret.morphemes[i];
+			m.kform = r.formId == (uint32_t)-1 ? nullptr : &ret.forms[r.formId].form;
+			m.tag = r.tag;
+			m.vowel = r.vowel;
+			m.polar = r.polar;
+			m.complex = !!r.complex;
+			m.senseId = r.senseId;
+			m.combineSocket = r.combineSocket;
+			m.leftCondMask = r.leftCondMask;
+			m.combined = r.combined;
+			m.userScore = r.userScore;
+			m.lmMorphemeId = r.lmMorphemeId;
+			m.origMorphemeId = r.origMorphemeId;
+			m.chunks = FixedPairVector<const Morpheme*, pair<uint8_t, uint8_t>>{ morphRecords[i + 1].chunkBegin - r.chunkBegin };
+			for (size_t j = 0; j < m.chunks.size(); ++j)
+			{
+				m.chunks[j] = ret.morphemes.data() + chunkPool[r.chunkBegin + j];
+				m.chunks.getSecond(j) = make_pair(chunkPositionPool[(r.chunkBegin + j) * 2], chunkPositionPool[(r.chunkBegin + j) * 2 + 1]);
+			}
+		}
+
+		Vector<uint64_t> typoPtrs64;
+		serializer::readMany(istr, ret.typoPool);
+		readPod(istr, typoPtrs64);
+		readPod(istr, ret.typoForms);
+		ret.typoPtrs.assign(typoPtrs64.begin(), typoPtrs64.end());
+
+		// 트라이의 노드 배열은 이미지를 직접 가리키고, 형태에 대한 포인터인 값 배열만 새로 만든다.
+		// 이중 배열 트라이는 배치를 다시 계산하지 않도록 저장된 배열을 그대로 읽는다.
+		auto idxToForm = [&](size_t idx) -> const Form*
+		{
+			if (idx < ret.forms.size()) return &ret.forms[idx];
+			idx -= ret.forms.size();
+			if (idx >= ret.typoForms.size()) throw FormatException{ "Invalid Kiwi image: " + path };
+			return reinterpret_cast<const Form*>(&ret.typoForms[idx]);
+		};
+		ret.formTrie = decltype(ret.formTrie)::mapFrom(istr, image, idxToForm);
+		if (!!(flags & ImageFlag::doubleArrayTrie))
+		{
+			ret.formDATrie = decltype(ret.formDATrie)::readFrom(istr, idxToForm);
+		}
+
+		serializer::readMany(istr, ret.specialMorphIds);
+		if (!!(flags & ImageFlag::hasCombiningRule))
+		{
+			auto rule = make_shared<cmb::CompiledRule>();
+			serializer::readMany(istr, *rule);
+			ret.combiningRule = move(rule);
+		}
+
+		if (numThreads >= 1)
+		{
+			ret.pool = make_unique<utils::ThreadPool>(numThreads);
+		}
+		return ret;
+	}
+}
@@ -84,11 +84,15 @@ namespace kiwi
 		{
 			using MyNode = Node<KeyType, DiffType>;
 
-			std::unique_ptr<MyNode[]> node_data;
-			std::unique_ptr<KeyType[]> key_data;
-			std::unique_ptr<DiffType[]> all_value_data;
+			std::unique_ptr<MyNode[]> owned_node_data;
+			std::unique_ptr<KeyType[]> owned_key_data;
+			std::unique_ptr<DiffType[]> owned_value_data;
+			const MyNode* node_data = nullptr;
+			const KeyType* key_data = nullptr;
+			const DiffType* all_value_data = nullptr;
 			size_t num_non_leaf_nodes = 0;
-			DiffType* value_data = nullptr;
+			size_t htx_vocab_size = 0;
+			const DiffType* value_data = nullptr;
 			const float* ll_data = nullptr;
 			const float* gamma_data = nullptr;
 			const KeyType* htx_data = nullptr;
@@ -96,7 +100,7 @@ namespace kiwi
 			float unk_ll = 0;
 			ptrdiff_t bos_node_idx = 0;
 
-			MyNode* findLowerNode(MyNode* node, KeyType k)
+			const MyNode* findLowerNode(const MyNode* node, KeyType k) const
 			{
 				while (node->lower)
 				{
@@ -154,9 +158,55 @@ namespace kiwi
 				);
 			}
 
+			void loadRuntimeLayout()
+			{
+				auto* ptr = reinterpret_cast<const char*>(base.get());
+				auto& header = getHeader();
+				if (base.size() < sizeof(Header) + sizeof(RuntimeHeader))
+				{
+					throw std::runtime_error{ "Invalid runtime layout of the language model." };
+				}
+				auto& rheader = *reinterpret_cast<const RuntimeHeader*>(ptr + sizeof(Header));
+				if (rheader.arch_type != static_cast<uint32_t>(arch))
+				{
+					throw std::runtime_error{ std::string{ "The language model was laid out for " } 
+						+ archToStr(static_cast<ArchType>(rheader.arch_type)) 
+						+ ", but " + archToStr(arch) + " is required." };
+				}
+				if (header.key_size != sizeof(KeyType) || header.diff_size != sizeof(DiffType))
+				{
+					throw std::runtime_error{ "Invalid runtime layout of the language model." };
+				}
+
+				num_non_leaf_nodes = rheader.num_non_leaf_nodes;
+				htx_vocab_size = rheader.htx_vocab_size;
+				const size_t end = header.htx_offset ? (header.htx_offset + header.vocab_size * sizeof(KeyType))
+					: (header.gamma_offset + num_non_leaf_nodes * sizeof(float));
+				if (base.size() < end)
+				{
+					throw std::runtime_error{ "Invalid runtime layout of the language model." };
+				}
+
+				node_data = reinterpret_cast<const MyNode*>(ptr + header.node_offset);
+				key_data = reinterpret_cast<const KeyType*>(ptr + header.key_offset);
+				all_value_data = reinterpret_cast<const DiffType*>(ptr + rheader.value_offset);
+				value_data = all_value_data + htx_vocab_size;
+				ll_data = reinterpret_cast<const float*>(ptr + header.ll_offset);
+				gamma_data = reinterpret_cast<const float*>(ptr + header.gamma_offset);
+				if (header.htx_offset) htx_data = reinterpret_cast<const KeyType*>(ptr + header.htx_offset);
+				unk_ll = rheader.unk_ll;
+				bos_node_idx = rheader.bos_node_idx;
+			}
+
 		public:
 			KnLangModel(utils::MemoryObject&& mem) : KnLangModelBase{ std::move(mem) }
 			{
+				if (isRuntimeLayout())
+				{
+					loadRuntimeLayout();
+					return;
+				}
+
 				auto* ptr = reinterpret_cast<const char*>(base.get());
 				auto& header = getHeader();
 				size_t quantized = header.quantized & 0x1F;
@@ -164,8 +214,9 @@ namespace kiwi
 
 				Vector<KeyType> d_node_size;
 				auto* node_sizes = reinterpret_cast<const KeyType*>(ptr + header.node_offset);
-				key_data = make_unique<KeyType[]>((header.ll_offset - header.key_offset) / sizeof(KeyType));
-				std::memcpy(&key_data[0], ptr + header.key_offset, header.ll_offset - header.key_offset);
+				owned_key_data = make_unique<KeyType[]>((header.ll_offset - header.key_offset) / sizeof(KeyType));
+				std::memcpy(&owned_key_data[0], ptr + header.key_offset, header.ll_offset - header.key_offset);
+				key_data = owned_key_data.get();
 				size_t num_leaf_nodes = 0;
 				if (compressed)
 				{
@@ -217,7 +268,7 @@ namespace kiwi
 					leaf_ll_data = ll_data + num_non_leaf_nodes;
 				}
 
-				size_t htx_vocab_size = header.vocab_size;
+				htx_vocab_size = header.vocab_size;
 				if (header.htx_offset)
 				{
 					htx_data = reinterpret_cast<const KeyType*>(ptr + header.htx_offset);
@@ -225,10 +276,13 @@ namespace kiwi
 				}
 
 				// restore node's data
-				node_data = make_unique<MyNode[]>(num_non_leaf_nodes);
-				all_value_data = make_unique<DiffType[]>(header.num_nodes - 1 + htx_vocab_size);
-				value_data = &all_value_data[htx_vocab_size];
-				std::fill(&all_value_data[0], value_data, 0);
+				owned_node_data = make_unique<MyNode[]>(num_non_leaf_nodes);
+				owned_value_data = make_unique<DiffType[]>(header.num_nodes - 1 + htx_vocab_size);
+				node_data = owned_node_data.get();
+				all_value_data = owned_value_data.get();
+				DiffType* mut_value_data = &owned_value_data[htx_vocab_size];
+				value_data = mut_value_data;
+				std::fill(&owned_value_data[0], mut_value_data, 0);
 
 				size_t non_leaf_idx = 0, leaf_idx = 0, next_offset = 0;
 				Vector<std::array<size_t, 3>> key_ranges;
@@ -236,11 +290,11 @@ namespace kiwi
 				{
 					if (node_sizes[i])
 					{
-						auto& node = node_data[non_leaf_idx];
+						auto& node = owned_node_data[non_leaf_idx];
 						if (!key_ranges.empty())
 						{
 							auto& back = key_ranges.back();
-							value_data[back[1]] = non_leaf_idx - back[0];
+							mut_value_data[back[1]] = non_leaf_idx - back[0];
 						}
 						node.num_nexts = node_sizes[i];
 						node.next_offset = next_offset;
@@ -251,7 +305,7 @@ namespace kiwi
 					else
 					{
 						auto& back = key_ranges.back();
-						reinterpret_cast<float&>(value_data[back[1]]) = leaf_ll_data[leaf_idx];
+						reinterpret_cast<float&>(mut_value_data[back[1]]) = leaf_ll_data[leaf_idx];
 						back[1]++;
 						while (key_ranges.back()[1] == key_ranges.back()[2])
 						{
@@ -267,14 +321,14 @@ namespace kiwi
 				{
 					auto k = key_data[i];
 					auto v = value_data[i];
-					all_value_data[k] = v;
+					owned_value_data[k] = v;
 				}
 
 				Vector<uint8_t> tempBuf;
 				for (size_t i = 0; i < non_leaf_idx; ++i)
 				{
 					auto& node = node_data[i];
-					nst::prepare<arch>(&key_data[node.next_offset], &value_data[node.next_offset], node.num_nexts, tempBuf);
+					nst::prepare<arch>(&owned_key_data[node.next_offset], &mut_value_data[node.next_offset], node.num_nexts, tempBuf);
 				}
 
 				if (htx_data)
@@ -293,7 +347,7 @@ namespace kiwi
 				}
 				
 				Deque<MyNode*> dq;
-				for (dq.emplace_back(&node_data[0]); !dq.empty(); dq.pop_front())
+				for (dq.emplace_back(&owned_node_data[0]); !dq.empty(); dq.pop_front())
 				{
 					auto p = dq.front();
 					for (size_t i = 0; i < p->num_nexts; ++i)
@@ -341,89 +395,135 @@ namespace kiwi
 				}
 			}
 
+			/**
+			* @brief node_idx 노드에서 next를 한 번 탐색한다.
+			* @return 탐색이 끝났으면 true. 하위 노드로 후퇴(back-off)해야 하는 경우 node_idx를 옮기고 false를 반환한다.
+			*/
 			template<class IdxType>
-			float progress(IdxType& node_idx, KeyType next) const
+			bool progressStep(IdxType& node_idx, KeyType next, float& acc) const
 			{
-				float acc = 0;
-				while (1)
+				DiffType v;
+				auto* node = &node_data[node_idx];
+				auto* keys = &key_data[node->next_offset];
+				auto* values = &value_data[node->next_offset];
+				PREFETCH_T0(node + node->lower);
+				if (node_idx == 0)
 				{
-					DiffType v;
-					auto* node = &node_data[node_idx];
-					auto* keys = &key_data[node->next_offset];
-					auto* values = &value_data[node->next_offset];
-					PREFETCH_T0(node + node->lower);
-					if (node_idx == 0)
+					v = all_value_data[next];
+					if (v == 0)
 					{
-						v = all_value_data[next];
-						if (v == 0)
+						if (htx_data)
 						{
-							if (htx_data)
-							{
-								IdxType lv;
-								if (nst::search<arch>(
-									&key_data[0],
-									value_data,
-									node_data[0].num_nexts, htx_data[next], lv
-								)) node_idx = lv;
-								else node_idx = 0;
-							}
-							return acc + unk_ll;
+							IdxType lv;
+							if (nst::search<arch>(
+								&key_data[0],
+								value_data,
+								node_data[0].num_nexts, htx_data[next], lv
+							)) node_idx = lv;
+							else node_idx = 0;
 						}
+						acc += unk_ll;
+						return true;
 					}
-					else
+				}
+				else
+				{
+					if (!nst::search<arch>(
+						keys,
+						values,
+						node->num_nexts, next, v
+						))
+					{
+						acc += gamma_data[node_idx];
+						node_idx += node->lower;
+						PREFETCH_T0(&key_data[node_data[node_idx].next_offset]);
+						return false;
+					}
+				}
+
+				// non-leaf node
+				if (v > 0)
+				{
+					node_idx += v;
+					acc += ll_data[node_idx];
+					return true;
+				}
+				// leaf node
+				else
+				{
+					while (node->lower)
 					{
-						if (!nst::search<arch>(
-							keys,
-							values,
-							node->num_nexts, next, v
+						node += node->lower;
+						DiffType lv;
+						if (nst::search<arch>(
+							&key_data[node->next_offset],
+							&value_data[node->next_offset],
+							node->num_nexts, next, lv
 							))
 						{
-							acc += gamma_data[node_idx];
-							node_idx += node->lower;
-							PREFETCH_T0(&key_data[node_data[node_idx].next_offset]);
-							continue;
+							if (lv > 0)
+							{
+								node += lv;
+								node_idx = node - &node_data[0];
+								acc += reinterpret_cast<const float&>(v);
+								return true;
+							}
 						}
 					}
+					if (htx_data)
+					{
+						IdxType lv;
+						if (nst::search<arch>(
+							&key_data[0],
+							value_data,
+							node_data[0].num_nexts, htx_data[next], lv
+						)) node_idx = lv;
+						else node_idx = 0;
+					}
+					else node_idx = 0;
+					acc += reinterpret_cast<const float&>(v);
+					return true;
+				}
+			}
 
-					// non-leaf node
-					if (v > 0)
+			template<class IdxType>
+			float progress(IdxType& node_idx, KeyType next) const
+			{
+				float acc = 0;
+				while (!progressStep(node_idx, next, acc));
+				return acc;
+			}
+
+			static constexpr size_t batchLanes = 8;
+
+			/**
+			* @brief 서로 독립인 n개의 상태에 대해 `progress`를 수행한다.
+			* @details 한 상태의 탐색이 후퇴할 때마다 다음 노드의 키를 prefetch해두고 다른 상태의 탐색으로 넘어가므로,
+			* 여러 상태의 메모리 접근 지연이 서로 겹쳐진다. 결과는 각 상태에 `progress`를 호출한 것과 같다.
+			* @param node_idx 각 상태의 노드 번호. 탐색 후의 노드 번호로 갱신된다.
+			* @param out_ll 각 상태의 로그 확률이 저장될 배열
+			*/
+			template<class IdxType>
+			void progressBatch(IdxType* node_idx, const KeyType* next, float* out_ll, size_t n) const
+			{
+				for (size_t b = 0; b < n; b += batchLanes)
+				{
+					const size_t m = std::min(batchLanes, n - b);
+					uint32_t active = (1u << m) - 1;
+					for (size_t i = 0; i < m; ++i)
 					{
-						node_idx += v;
-						return acc + ll_data[node_idx];
+						out_ll[b + i] = 0;
+						if (node_idx[b + i]) PREFETCH_T0(&key_data[node_data[node_idx[b + i]].next_offset]);
+						else PREFETCH_T0(&all_value_data[next[b + i]]);
 					}
-					// leaf node
-					else
+
+					while (active)
 					{
-						while (node->lower)
-						{
-							node += node->lower;
-							DiffType lv;
-							if (nst::search<arch>(
-								&key_data[node->next_offset],
-								&value_data[node->next_offset],
-								node->num_nexts, next, lv
-								))
-							{
-								if (lv > 0)
-								{
-									node += lv;
-									node_idx = node - &node_data[0];
-									return acc + reinterpret_cast<const float&>(v);
-								}
-							}
-						}
-						if (htx_data)
+						for (size_t i = 0; i < m; ++i)
 						{
-							IdxType lv;
-							if (nst::search<arch>(
-								&key_data[0],
-								value_data,
-								node_data[0].num_nexts, htx_data[next], lv
-							)) node_idx = lv;
-							else node_idx = 0;
+							if (!(active & (1u << i))) continue;
+							if (progressStep(node_idx[b + i], next[b + i], out_ll[b + i])) active &= ~(1u << i);
 						}
-						else node_idx = 0;
-						return acc + reinterpret_cast<const float&>(v);
 					}
 				}
 			}
@@ -463,6 +563,53 @@ namespace kiwi
 				return gamma_data - ll_data;
 			}
 
+			utils::MemoryOwner toRuntimeLayout() const final
+			{
+				static constexpr size_t alignment = 64;
+				auto align = [](size_t offset) { return (offset + alignment - 1) & ~(alignment - 1); };
+
+				const auto& header = getHeader();
+				const size_t num_keys = header.num_nodes - 1;
+				Header new_header = header;
+				RuntimeHeader rheader;
+				rheader.num_non_leaf_nodes = num_non_leaf_nodes;
+				rheader.htx_vocab_size = htx_vocab_size;
+				rheader.arch_type = static_cast<uint32_t>(arch);
+				rheader.unk_ll = unk_ll;
+				rheader.bos_node_idx = bos_node_idx;
+
+				new_header.quantized = runtimeLayoutFlag;
+				new_header.qtable_offset = 0;
+				new_header.node_offset = align(sizeof(Header) + sizeof(RuntimeHeader));
+				new_header.key_offset = align(new_header.node_offset + num_non_leaf_nodes * sizeof(MyNode));
+				rheader.value_offset = align(new_header.key_offset + num_keys * sizeof(KeyType));
+				new_header.ll_offset = align(rheader.value_offset + (num_keys + htx_vocab_size) * sizeof(DiffType));
+				new_header.gamma_offset = new_header.ll_offset + num_non_leaf_nodes * sizeof(float);
+				size_t total_size = new_header.gamma_offset + num_non_leaf_nodes * sizeof(float);
+				if (htx_data)
+				{
+					new_header.htx_offset = align(total_size);
+					total_size = new_header.htx_offset + header.vocab_size * sizeof(KeyType);
+				}
+				else
+				{
+					new_header.htx_offset = 0;
+				}
+
+				utils::MemoryOwner ret{ total_size };
+				auto* ptr = reinterpret_cast<char*>(ret.get());
+				std::fill(ptr, ptr + total_size, 0);
+				std::memcpy(ptr, &new_header, sizeof(Header));
+				std::memcpy(ptr + sizeof(Header), &rheader, sizeof(RuntimeHeader));
+				std::memcpy(ptr + new_header.node_offset, node_data, num_non_leaf_nodes * sizeof(MyNode));
+				std::memcpy(ptr + new_header.key_offset, key_data, num_keys * sizeof(KeyType));
+				std::memcpy(ptr + rheader.value_offset, all_value_data, (num_keys + htx_vocab_size) * sizeof(DiffType));
+				std::memcpy(ptr + new_header.ll_offset, ll_data, num_non_leaf_nodes * sizeof(float));
+				std::memcpy(ptr + new_header.gamma_offset, gamma_data, num_non_leaf_nodes * sizeof(float));
+				if (htx_data) std::memcpy(ptr + new_header.htx_offset, htx_data, header.vocab_size * sizeof(KeyType));
+				return ret;
+			}
+
 			std::vector<float> allNextLL(ptrdiff_t node_idx) const final
 			{
 				std::vector<float> ret(getHeader().vocab_size, -INFINITY);
@@ -660,6 +807,15 @@ namespace kiwi
 			};
 		};
 
+		inline ArchType KnLangModelBase::getRuntimeLayoutArch(const utils::MemoryObject& mem)
+		{
+			if (mem.size() < sizeof(Header) + sizeof(RuntimeHeader)) return ArchType::default_;
+			auto* ptr = reinterpret_cast<const char*>(mem.get());
+			auto& header = *reinterpret_cast<const Header*>(ptr);
+			if (!(header.quantized & runtimeLayoutFlag)) return ArchType::default_;
+			return static_cast<ArchType>(reinterpret_cast<const RuntimeHeader*>(ptr + sizeof(Header))->arch_type);
+		}
+
 		inline std::unique_ptr<KnLangModelBase> KnLangModelBase::create(utils::MemoryObject&& mem, ArchType archType)
 		{
 			static tp::Table<FnCreateOptimizedModel, AvailableArch> table{ CreateOptimizedModelGetter{} };
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <kiwi/Kiwi.h>
 #include <kiwi/ArchUtils.h>
 #include "Knlm.hpp"
@@ -7,6 +8,137 @@
 
 namespace kiwi
 {
+	/**
+	 * @brief 언어 모델 전이 캐시의 사용 여부와 누적 적중 횟수.
+	 * @details 분석 중인 스레드가 참조하고 있을 수 있으므로 `Kiwi`가 살아 있는 동안 해제하지 않고 `enabled`만 바꾼다.
+	 */
+	struct LmMemoCounters
+	{
+		std::atomic<bool> enabled{ true };
+		std::atomic<size_t> hits{ 0 }, misses{ 0 };
+	};
+
+	/**
+	 * @brief 한 번의 경로 탐색 동안 KnLM의 전이 결과 (노드, 다음 형태소) -> (로그 확률, 다음 노드)를 저장하는 스레드별 캐시.
+	 * @details 고정 크기의 open addressing 테이블이며, 가득 찬 경우 기존 항목을 덮어쓴다.
+	 * `Scope`가 살아 있는 동안 지정된 모델에 대해서만 사용되며, `Scope`를 새로 만들 때마다 세대 번호를 올려 비운다.
+	 */
+	class LmTransitionMemo
+	{
+		struct Entry
+		{
+			uint32_t epoch;
+			int32_t node;
+			uint32_t next;
+			int32_t nextNode;
+			float ll;
+		};
+
+		static constexpr size_t numBits = 12;
+		static constexpr size_t numEntries = (size_t)1 << numBits;
+		static constexpr size_t maxProbes = 4;
+
+		Vector<Entry> entries;
+		const void* owner = nullptr;
+		uint32_t epoch = 0;
+		size_t hits = 0, misses = 0;
+
+		static size_t hash(int32_t node, uint32_t next)
+		{
+			return (((uint32_t)node * 0x9E3779B1u) ^ (next * 0x85EBCA77u)) >> (32 - numBits);
+		}
+
+	public:
+		static LmTransitionMemo& local()
+		{
+			thread_local LmTransitionMemo memo;
+			return memo;
+		}
+
+		/**
+		 * @brief 현재 스레드에서 model에 대해 활성화된 캐시를 반환한다. 없으면 nullptr.
+		 */
+		static LmTransitionMemo* active(const void* model)
+		{
+			auto& memo = local();
+			return memo.owner == model ? &memo : nullptr;
+		}
+
+		bool find(int32_t node, uint32_t next, float& ll, int32_t& nextNode)
+		{
+			const size_t h = hash(node, next);
+			for (size_t i = 0; i < maxProbes; ++i)
+			{
+				auto& e = entries[(h + i) & (numEntries - 1)];
+				if (e.epoch != epoch) break;
+				if (e.node == node && e.next == next)
+				{
+					ll = e.ll;
+					nextNode = e.nextNode;
+					++hits;
+					return true;
+				}
+			}
+			++misses;
+			return false;
+		}
+
+		void insert(int32_t node, uint32_t next, float ll, int32_t nextNode)
+		{
+			const size_t h = hash(node, next);
+			Entry* target = &entries[h & (numEntries - 1)];
+			for (size_t i = 0; i < maxProbes; ++i)
+			{
+				auto& e = entries[(h + i) & (numEntries - 1)];
+				if (e.epoch != epoch)
+				{
+					target = &e;
+					break;
+				}
+			}
+			*target = Entry{ epoch, node, next, nextNode, ll };
+		}
+
+		/**
+		 * @brief 생성부터 소멸까지 현재 스레드의 캐시를 model에 대해 활성화한다.
+		 * model이 nullptr이면 캐시를 사용하지 않는다. 소멸 시 적중 횟수를 counters에 더한다.
+		 */
+		class Scope
+		{
+			LmTransitionMemo& memo;
+			const void* prevOwner;
+			LmMemoCounters* counters;
+		public:
+			Scope(const void* model, LmMemoCounters* _counters = nullptr)
+				: memo{ local() }, prevOwner{ memo.owner }, counters{ _counters }
+			{
+				memo.owner = model;
+				if (!model) return;
+				if (memo.entries.empty()) memo.entries.resize(numEntries, Entry{ 0, });
+				if (++memo.epoch == 0)
+				{
+					std::fill(memo.entries.begin(), memo.entries.end(), Entry{ 0, });
+					memo.epoch = 1;
+				}
+				memo.hits = 0;
+				memo.misses = 0;
+			}
+
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+
+			~Scope()
+			{
+				if (memo.owner && counters)
+				{
+					counters->hits += memo.hits;
+					counters->misses += memo.misses;
+				}
+				memo.owner = prevOwner;
+			}
+		};
+	};
+
 	template<ArchType _arch>
 	class VoidState
 	{
@@ -25,6 +157,12 @@ namespace kiwi
 		{
 			return 0;
 		}
+
+		template<class StateTy>
+		static void nextBatch(const LangModel& lm, StateTy* states, const uint32_t* next, float* outLL, size_t n)
+		{
+			std::fill(outLL, outLL + n, 0.f);
+		}
 	};
 
 	template<ArchType _arch, class VocabTy>
@@ -45,7 +183,54 @@ namespace kiwi
 
 		float next(const LangModel& lm, VocabTy next)
 		{
-			return static_cast<const lm::KnLangModel<arch, VocabTy>&>(*lm.knlm).progress(node, next);
+			auto& knlm = static_cast<const lm::KnLangModel<arch, VocabTy>&>(*lm.knlm);
+			auto* memo = LmTransitionMemo::active(lm.knlm.get());
+			if (!memo) return knlm.progress(node, next);
+
+			float ll;
+			if (memo->find(node, next, ll, node)) return ll;
+			const int32_t prevNode = node;
+			ll = knlm.progress(node, next);
+			memo->insert(prevNode, next, ll, node);
+			return ll;
+		}
+
+		/**
+		 * @brief states[i]에 next[i]를 입력한 결과를 outLL[i]에 저장한다. `next`를 각각 호출한 것과 같다.
+		 */
+		template<class StateTy>
+		static void nextBatch(const LangModel& lm, StateTy* states, const uint32_t* next, float* outLL, size_t n)
+		{
+			using Model = lm::KnLangModel<arch, VocabTy>;
+			auto& knlm = static_cast<const Model&>(*lm.knlm);
+			auto* memo = LmTransitionMemo::active(lm.knlm.get());
+			int32_t nodes[Model::batchLanes], prevNodes[Model::batchLanes];
+			VocabTy keys[Model::batchLanes];
+			float lls[Model::batchLanes];
+			size_t lanes[Model::batchLanes];
+			size_t m = 0;
+			const auto flush = [&]()
+			{
+				knlm.progressBatch(nodes, keys, lls, m);
+				for (size_t i = 0; i < m; ++i)
+				{
+					static_cast<KnLMState&>(states[lanes[i]]).node = nodes[i];
+					outLL[lanes[i]] = lls[i];
+					if (memo) memo->insert(prevNodes[i], keys[i], lls[i], nodes[i]);
+				}
+				m = 0;
+			};
+
+			for (size_t i = 0; i < n; ++i)
+			{
+				auto& state = static_cast<KnLMState&>(states[i]);
+				if (memo && memo->find(state.node, (VocabTy)next[i], outLL[i], state.node)) continue;
+				lanes[m] = i;
+				prevNodes[m] = nodes[m] = state.node;
+				keys[m] = (VocabTy)next[i];
+				if (++m == Model::batchLanes) flush();
+			}
+			if (m) flush();
 		}
 
 		void predict(const LangModel& lm, float* out) const
@@ -95,6 +280,26 @@ namespace kiwi
 			return ll;
 		}
 
+		static void nextBatch(const LangModel& lm, SbgState* states, const uint32_t* next, float* outLL, size_t n)
+		{
+			auto& sbg = static_cast<const sb::SkipBigramModel<arch, VocabTy, 8>&>(*lm.sbg);
+			KnLMState<arch, VocabTy>::nextBatch(lm, states, next, outLL, n);
+			for (size_t i = 0; i < n; ++i)
+			{
+				auto& state = states[i];
+				const VocabTy k = (VocabTy)next[i];
+				if (sbg.isValidVocab(k))
+				{
+					if (outLL[i] > -13)
+					{
+						outLL[i] = sbg.evaluate(state.history.data(), windowSize, k, outLL[i]);
+					}
+					state.history[state.historyPos] = k;
+					state.historyPos = (state.historyPos + 1) % windowSize;
+				}
+			}
+		}
+
 		void predict(const LangModel& lm, float* out) const
 		{
 
@@ -1,4 +1,6 @@
-﻿#include <fstream>
+﻿#pragma once
+
+#include <fstream>
 
 #include <kiwi/Kiwi.h>
 #include <kiwi/Utils.h>
@@ -12,6 +14,9 @@
 #include "StrUtils.h"
 #include "SortUtils.hpp"
 #include "LimitedVector.hpp"
+#include "FlatHashMap.hpp"
+#include "Arena.hpp"
+#include "AnalysisContext.hpp"
 
 using namespace std;
 
@@ -46,8 +51,85 @@ namespace kiwi
 	template<class LmState>
 	struct WordLL;
 
+	template<class LmState>
+	struct Top1LL;
+
+	struct RuleBasedScorer;
+
+	template<class LmState, class PrevPath>
+	struct TransitionBatch;
+
 	using Wid = uint32_t;
 
+	/**
+	* @brief 청크 하나를 탐색하는 동안 `BeamOptions`에 따라 노드별 가지치기 기준을 정한다.
+	*/
+	class BeamController
+	{
+		static constexpr size_t adaptiveBaseStates = 32;
+		static constexpr size_t adaptiveBaseNodes = 64;
+
+		BeamOptions opts;
+		float cutOffThreshold;
+		size_t topN, graphSize, numRoots;
+		size_t usedStates = 0, generatedStates = 0, evaluatedNodes = 0;
+		bool enabled;
+
+	public:
+		struct Limit
+		{
+			size_t maxStates; /**< 루트별로 남길 경로의 최대 개수. 0이면 제한하지 않는다. */
+			float cutOff; /**< 최고 점수와의 차이가 이보다 큰 경로는 버린다. */
+		};
+
+		BeamController(const Kiwi* kw, size_t _graphSize, size_t _topN, size_t _numRoots)
+			: opts{ kw->getBeamOptions() }, cutOffThreshold{ kw->getCutOffThreshold() },
+			topN{ _topN }, graphSize{ _graphSize }, numRoots{ max(_numRoots, (size_t)1) },
+			enabled{ !opts.unlimited() }
+		{
+		}
+
+		/**
+		* @brief nodeId번째 노드에서 generated개의 경로가 생성되었을 때 적용할 가지치기 기준
+		*/
+		Limit limit(size_t nodeId, size_t generated) const
+		{
+			if (!enabled) return Limit{ 0, cutOffThreshold };
+
+			size_t maxStates = opts.maxStatesPerNode;
+			float margin = opts.marginRatio;
+			if (opts.adaptive)
+			{
+				const size_t base = maxStates ? maxStates : adaptiveBaseStates;
+				float scale = 1;
+				if (graphSize > adaptiveBaseNodes) scale *= sqrt((float)adaptiveBaseNodes / graphSize);
+				const float avgStates = (generatedStates + generated) / (float)((evaluatedNodes + 1) * numRoots);
+				if (avgStates > base) scale *= sqrt(base / avgStates);
+				maxStates = max((size_t)(base * scale), (size_t)1);
+				margin *= max(scale, 0.5f);
+			}
+
+			if (opts.chunkStateBudget)
+			{
+				// 남은 예산을 아직 탐색하지 않은 노드들에 고르게 나눈다
+				const size_t nodesLeft = graphSize > nodeId + 1 ? graphSize - nodeId - 1 : 1;
+				const size_t remaining = opts.chunkStateBudget > usedStates ? opts.chunkStateBudget - usedStates : 0;
+				const size_t share = max(remaining / (nodesLeft * numRoots), (size_t)1);
+				maxStates = maxStates ? min(maxStates, share) : share;
+			}
+
+			if (maxStates) maxStates = max(maxStates, topN);
+			return Limit{ maxStates, cutOffThreshold * margin };
+		}
+
+		void record(size_t generated, size_t kept)
+		{
+			generatedStates += generated;
+			usedStates += kept;
+			++evaluatedNodes;
+		}
+	};
+
 	class PathEvaluator
 	{
 	public:
@@ -111,7 +193,7 @@ namespace kiwi
 			const size_t topN,
 			bool openEnd,
 			bool splitComplex = false,
-			const std::unordered_set<const Morpheme*>* blocklist = nullptr
+			const MorphemeSet* blocklist = nullptr
 		);
 
 		template<class LmState, class CandTy>
@@ -119,22 +201,115 @@ namespace kiwi
 			const KGraphNode* startNode,
 			const KGraphNode* node,
 			const size_t topN,
-			Vector<Vector<WordLL<LmState>>>& cache,
+			utils::ArenaVector<utils::ArenaVector<WordLL<LmState>>>& cache,
 			const Vector<U16StringView>& ownFormList,
 			size_t i,
 			size_t ownFormId,
 			CandTy&& cands,
 			bool unknownForm,
+			BeamController& beam,
+			bool splitComplex = false,
+			const MorphemeSet* blocklist = nullptr
+		);
+
+		template<class LmState>
+		static Vector<ChunkResult> findBestPathTop1(const Kiwi* kw,
+			const Vector<SpecialState>& prevSpStates,
+			const KGraphNode* graph,
+			const size_t graphSize,
+			bool openEnd,
+			bool splitComplex = false,
+			const MorphemeSet* blocklist = nullptr
+		);
+
+		template<class LmState, class CandTy>
+		static void evalPathTop1(const Kiwi* kw,
+			const KGraphNode* startNode,
+			const KGraphNode* node,
+			Vector<Top1LL<LmState>>& states,
+			const Vector<uint32_t>& nodeBegin,
+			const Vector<U16StringView>& ownFormList,
+			size_t ownFormId,
+			CandTy&& cands,
+			bool unknownForm,
+			BeamController& beam,
 			bool splitComplex = false,
-			const std::unordered_set<const Morpheme*>* blocklist = nullptr
+			const MorphemeSet* blocklist = nullptr
+		);
+
+		template<class LmState>
+		static void evalSingleMorphemeTop1(
+			Vector<Top1LL<LmState>>& states,
+			const Vector<uint32_t>& nodeBegin,
+			const Kiwi* kw,
+			const Vector<U16StringView>& ownForms,
+			array<Wid, 4> seq,
+			array<Wid, 4> oseq,
+			size_t chSize,
+			uint8_t combSocket,
+			size_t ownFormId,
+			const Morpheme* curMorph,
+			const KGraphNode* node,
+			const KGraphNode* startNode,
+			const float ignoreCondScore,
+			const float nodeLevelDiscount
+		);
+
+		static float getNodeLevelDiscount(const Kiwi* kw, const KGraphNode* node, bool unknownForm);
+
+		static bool makeMorphemeSeq(const Kiwi* kw,
+			const Morpheme* curMorph,
+			const KGraphNode* node,
+			size_t langVocabSize,
+			array<Wid, 4>& seq,
+			array<Wid, 4>& oseq,
+			uint8_t& combSocket,
+			size_t& chSize
+		);
+
+		template<class PrevPath>
+		static bool evalTransitionPrefix(
+			float& candScore,
+			const Kiwi* kw,
+			const PrevPath& prevPath,
+			const KGraphNode* prev,
+			const KGraphNode* node,
+			array<Wid, 4>& seq,
+			size_t chSize,
+			const Morpheme* curMorph,
+			const float additionalScore,
+			const float ignoreCondScore
+		);
+
+		template<class LmState, class PrevPath, class RangeFn>
+		static void collectTransitions(
+			TransitionBatch<LmState, PrevPath>& batch,
+			const Kiwi* kw,
+			const KGraphNode* node,
+			array<Wid, 4> seq,
+			size_t chSize,
+			const Morpheme* curMorph,
+			const float additionalScore,
+			const float ignoreCondScore,
+			RangeFn&& prevPathRange
+		);
+
+		static float evalTransitionSuffix(
+			SpecialState& spState,
+			const Kiwi* kw,
+			Wid prevWid,
+			const RuleBasedScorer& ruleBasedScorer
 		);
 
+		template<class LmState, class PrevPath>
+		static bool evalEndPath(float& score, const Kiwi* kw, const PrevPath& p, bool openEnd);
+
 		template<bool top1, class LmState>
 		static void evalSingleMorpheme(
-			Vector<WordLL<LmState>>& resultOut,
+			utils::ArenaVector<WordLL<LmState>>& resultOut,
 			const Kiwi* kw,
 			const Vector<U16StringView>& ownForms,
-			const Vector<Vector<WordLL<LmState>>>& cache,
+			const utils::ArenaVector<utils::ArenaVector<WordLL<LmState>>>& cache,
 			array<Wid, 4> seq,
 			array<Wid, 4> oseq,
 			size_t chSize,
@@ -170,6 +345,7 @@ namespace kiwi
 		LmState lmState;
 		Wid wid = 0;
 		uint16_t ownFormId = 0;
+		uint16_t leftCondMask = 0;
 		uint8_t combineSocket = 0;
 		uint8_t rootId = 0;
 		SpecialState spState;
@@ -194,6 +370,58 @@ namespace kiwi
 		}
 	};
 
+	/**
+	* @brief top-1 탐색에서 사용하는 경로 상태. 모든 노드의 상태가 하나의 배열에 저장되며, 부모는 그 배열 내의 인덱스로 가리킨다.
+	*/
+	template<class LmState>
+	struct Top1LL
+	{
+		static constexpr uint32_t npos = (uint32_t)-1;
+
+		const Morpheme* morpheme = nullptr;
+		float accScore = 0, accTypoCost = 0;
+		uint32_t parent = npos;
+		uint32_t nodeId = 0;
+		LmState lmState;
+		Wid wid = 0;
+		uint16_t ownFormId = 0;
+		uint16_t leftCondMask = 0;
+		uint8_t combineSocket = 0;
+		uint8_t rootId = 0;
+		SpecialState spState;
+
+		Top1LL() = default;
+
+		Top1LL(const Morpheme* _morph, float _accScore, float _accTypoCost, uint32_t _parent, uint32_t _nodeId, LmState _lmState, uint8_t _rootId, SpecialState _spState)
+			: morpheme{ _morph },
+			accScore{ _accScore },
+			accTypoCost{ _accTypoCost },
+			parent{ _parent },
+			nodeId{ _nodeId },
+			lmState{ _lmState },
+			rootId{ _rootId },
+			spState{ _spState }
+		{
+		}
+	};
+
+	/**
+	* @brief 경로의 마지막 형태가 좌측에 올 때 만족되는 결합조건 마스크를 계산한다.
+	* @details 이전 형태소가 닫는 괄호인 경우 좌측 결합조건을 적용하지 않으므로 모든 비트를 설정한다.
+	* 경로의 wid, ownFormId, morpheme이 모두 정해진 뒤에 호출해야 한다.
+	*/
+	template<class Path>
+	inline uint16_t leftCondMaskOf(const Morpheme* morphBase, const Vector<U16StringView>& ownForms, const Path& path)
+	{
+		if (path.morpheme->tag == POSTag::ssc) return FeatureTestor::anyCondMask;
+		if (path.ownFormId)
+		{
+			const auto* first = ownForms[path.ownFormId - 1].data();
+			return FeatureTestor::leftContextMask(first, first + ownForms[0].size());
+		}
+		return morphBase[path.wid].leftCondMask;
+	}
+
 	template<class LmState>
 	struct PathHash
 	{
@@ -212,7 +440,7 @@ namespace kiwi
 
 		bool operator==(const PathHash& o) const
 		{
-			return lmState == o.lmState && spState == o.spState;
+			return lmState == o.lmState && rootId == o.rootId && spState == o.spState;
 		}
 	};
 
@@ -239,7 +467,7 @@ namespace kiwi
 
 		bool operator==(const PathHash& o) const
 		{
-			return lmState == o.lmState && lastMorphemes == o.lastMorphemes && spState == o.spState;
+			return lmState == o.lmState && lastMorphemes == o.lastMorphemes && rootId == o.rootId && spState == o.spState;
 		}
 	};
 
@@ -248,24 +476,24 @@ namespace kiwi
 	{
 		size_t operator()(const PathHash<LmState>& p) const
 		{
-			size_t ret = 0;
-			if (sizeof(PathHash<LmState>) % sizeof(size_t))
-			{
-				auto ptr = reinterpret_cast<const uint32_t*>(&p);
-				for (size_t i = 0; i < sizeof(PathHash<LmState>) / sizeof(uint32_t); ++i)
-				{
-					ret ^= ptr[i];
-				}
-			}
-			else
+			uint64_t h = Hash<LmState>{}(p.lmState);
+			h ^= ((uint64_t)p.rootId << 40) | ((uint64_t)p.spState << 48);
+			return (size_t)utils::mixHash(h);
+		}
+	};
+
+	template<size_t windowSize, ArchType _arch, class VocabTy>
+	struct Hash<PathHash<SbgState<windowSize, _arch, VocabTy>>>
+	{
+		size_t operator()(const PathHash<SbgState<windowSize, _arch, VocabTy>>& p) const
+		{
+			uint64_t h = Hash<KnLMState<_arch, VocabTy>>{}(p.lmState);
+			for (auto m : p.lastMorphemes)
 			{
-				auto ptr = reinterpret_cast<const size_t*>(&p);
-				for (size_t i = 0; i < sizeof(PathHash<LmState>) / sizeof(size_t); ++i)
-				{
-					ret ^= ptr[i];
-				}
+				h = (h ^ m) * 0x9e3779b97f4a7c15ull;
 			}
-			return ret;
+			h ^= ((uint64_t)p.rootId << 40) | ((uint64_t)p.spState << 48);
+			return (size_t)utils::mixHash(h);
 		}
 	};
 
@@ -433,278 +661,562 @@ namespace kiwi
 		}
 	};
 
-	template<bool top1, class LmState>
-	void PathEvaluator::evalSingleMorpheme(
-		Vector<WordLL<LmState>>& resultOut,
-		const Kiwi* kw,
-		const Vector<U16StringView>& ownForms,
-		const Vector<Vector<WordLL<LmState>>>& cache,
-		array<Wid, 4> seq,
-		array<Wid, 4> oseq,
-		size_t chSize,
-		uint8_t combSocket,
-		size_t ownFormId,
-		const Morpheme* curMorph,
-		const KGraphNode* node,
-		const KGraphNode* startNode,
-		const size_t topN,
-		const float ignoreCondScore,
-		const float nodeLevelDiscount
-	)
+	inline float PathEvaluator::getNodeLevelDiscount(const Kiwi* kw, const KGraphNode* node, bool unknownForm)
 	{
-		thread_local UnorderedMap<PathHash<LmState>, WordLL<LmState>> bestPathes;
-		// pair: [index, size]
-		thread_local UnorderedMap<PathHash<LmState>, pair<uint32_t, uint32_t>> bestPathIndex;
-		thread_local Vector<WordLL<LmState>> bestPathValues;
-		if (top1)
+		float whitespaceDiscount = 0;
+		if (node->uform.empty() && !node->form->form.empty() && node->spaceErrors)
 		{
-			bestPathes.clear();
+			whitespaceDiscount = -kw->spacePenalty * node->spaceErrors;
 		}
-		else
+		const float typoDiscount = -node->typoCost * kw->typoCostWeight;
+		float unknownFormDiscount = 0;
+		if (unknownForm)
 		{
-			bestPathIndex.clear();
-			bestPathValues.clear();
+			size_t unknownLen = node->uform.empty() ? node->form->form.size() : node->uform.size();
+			unknownFormDiscount = -(unknownLen * kw->unkFormScoreScale + kw->unkFormScoreBias);
 		}
+		return whitespaceDiscount + typoDiscount + unknownFormDiscount;
+	}
 
-		const LangModel& langMdl = kw->langMdl;
-		const Morpheme* morphBase = kw->morphemes.data();
-		const auto spacePenalty = kw->spacePenalty;
-		const bool allowedSpaceBetweenChunk = kw->spaceTolerance > 0;
-
-		float additionalScore = curMorph->userScore + nodeLevelDiscount;
-		additionalScore += kw->tagScorer.evalLeftBoundary(hasLeftBoundary(node), curMorph->tag);
-
-		RuleBasedScorer ruleBasedScorer{ kw, curMorph, node };
-
-		float discountForCombining = curMorph->combineSocket ? -15 : 0;
-
-		const size_t vocabSize = langMdl.knlm->getHeader().vocab_size;
-		for (auto* prev = node->getPrev(); prev; prev = prev->getSibling())
+	/**
+	* @brief curMorph를 언어 모델에 입력할 형태소 열(seq)과 결과에 기록할 형태소 열(oseq)로 변환한다.
+	* @return 탐색 후보에서 제외해야 하는 경우 false
+	*/
+	inline bool PathEvaluator::makeMorphemeSeq(const Kiwi* kw,
+		const Morpheme* curMorph,
+		const KGraphNode* node,
+		size_t langVocabSize,
+		array<Wid, 4>& seq,
+		array<Wid, 4>& oseq,
+		uint8_t& combSocket,
+		size_t& chSize
+	)
+	{
+		seq = { 0, };
+		oseq = { 0, };
+		combSocket = 0;
+		chSize = 1;
+		// if the morpheme has chunk set
+		if (!curMorph->chunks.empty() && !curMorph->complex)
 		{
-			assert(prev != node);
-			for (auto& prevPath : cache[prev - startNode])
+			chSize = curMorph->chunks.size();
+			// '하다/하게/하지'가 '다/게/지'로 축약된 경우인데 앞에 공백이 있는 경우는 탐색후보에서 제외
+			if (node->prev && node[-(int)node->prev].endPos < node->startPos
+				&& curMorph->kform
+				&& curMorph->kform->size() == 1
+				&& ((*curMorph->kform)[0] == u'다' || (*curMorph->kform)[0] == u'게' || (*curMorph->kform)[0] == u'지')
+				&& curMorph->chunks[0]->kform
+				&& curMorph->chunks[0]->kform->size() == 1
+				&& (*curMorph->chunks[0]->kform)[0] == u'하')
 			{
-				float candScore = prevPath.accScore + additionalScore;
-				if (prevPath.combineSocket)
-				{
-					// merge <v> <chunk> with only the same socket
-					if (prevPath.combineSocket != curMorph->combineSocket || (curMorph->chunks.empty() || curMorph->complex))
-					{
-						continue;
-					}
-					if (prev->endPos < node->startPos)
-					{
-						if (allowedSpaceBetweenChunk) candScore -= spacePenalty;
-						else continue;
-					}
-					seq[0] = morphBase[prevPath.wid].getCombined()->lmMorphemeId;
-				}
-
-				const kchar_t* leftFormFirst, * leftFormLast;
-				if (prevPath.ownFormId)
-				{
-					leftFormFirst = ownForms[prevPath.ownFormId - 1].data();
-					leftFormLast = ownForms[prevPath.ownFormId - 1].data() + ownForms[0].size();
-				}
-				else if (morphBase[prevPath.wid].kform)
-				{
-					leftFormFirst = morphBase[prevPath.wid].kform->data();
-					leftFormLast = morphBase[prevPath.wid].kform->data() + morphBase[prevPath.wid].kform->size();
-				}
-				else
-				{
-					leftFormFirst = nullptr;
-					leftFormLast = nullptr;
-				}
-
-				CondVowel cvowel = curMorph->vowel;
-				CondPolarity cpolar = curMorph->polar;
-				if (prevPath.morpheme->tag == POSTag::ssc)
-				{
-					// 이전 형태소가 닫는 괄호인 경우 좌측 결합조건을 적용하지 않음
-				}
-				else if (ignoreCondScore)
-				{
-					candScore += FeatureTestor::isMatched(leftFormFirst, leftFormLast, cvowel, cpolar) ? 0 : ignoreCondScore;
-				}
-				else
-				{
-					if (!FeatureTestor::isMatched(leftFormFirst, leftFormLast, cvowel, cpolar)) continue;
-				}
-
-				auto cLmState = prevPath.lmState;
-				Wid lSeq = 0;
-				if (curMorph->combineSocket && (curMorph->chunks.empty() || curMorph->complex))
-				{
-					lSeq = prevPath.wid;
-				}
-				else
-				{
-					lSeq = seq[chSize - 1];
-					for (size_t i = 0; i < chSize; ++i)
-					{
-						if (morphBase[seq[i]].tag == POSTag::p)
-						{
-							// prohibit <v> without <chunk>
-							goto continueFor;
-						}
-						float ll = cLmState.next(langMdl, seq[i]);
-						candScore += ll;
-					}
-				}
-
-				{
-					const auto* prevMorpheme = &morphBase[prevPath.wid];
-					auto spState = prevPath.spState;
-					candScore += ruleBasedScorer(prevMorpheme, spState);
-
-					// update special state
-					if (ruleBasedScorer.curMorphSpecialType == Kiwi::SpecialMorph::singleQuoteOpen) spState.singleQuote = 1;
-					else if (ruleBasedScorer.curMorphSpecialType == Kiwi::SpecialMorph::singleQuoteClose) spState.singleQuote = 0;
-					else if (ruleBasedScorer.curMorphSpecialType == Kiwi::SpecialMorph::doubleQuoteOpen) spState.doubleQuote = 1;
-					else if (ruleBasedScorer.curMorphSpecialType == Kiwi::SpecialMorph::doubleQuoteClose) spState.doubleQuote = 0;
-					if (ruleBasedScorer.curMorphSbType)
-					{
-						spState.bulletHash = hashSbTypeOrder(ruleBasedScorer.curMorphSbType, ruleBasedScorer.curMorphSbOrder + 1);
-					}
-
-					PathHash<LmState> ph{ cLmState, prevPath.rootId, spState };
-					if (top1)
-					{
-						WordLL<LmState> newPath{ curMorph, candScore, prevPath.accTypoCost + node->typoCost, &prevPath, move(cLmState), spState };
-						auto inserted = bestPathes.emplace(ph, newPath);
-						if (!inserted.second)
-						{
-							auto& target = inserted.first->second;
-							if (candScore > target.accScore)
-							{
-								target = newPath;
-							}
-						}
-					}
-					else
-					{
-						auto inserted = bestPathIndex.emplace(ph, make_pair(bestPathValues.size(), 1));
-						if (inserted.second)
-						{
-							bestPathValues.emplace_back(curMorph, candScore, prevPath.accTypoCost + node->typoCost, &prevPath, move(cLmState), spState);
-							bestPathValues.resize(bestPathValues.size() + topN - 1);
-						}
-						else
-						{
-							auto bestPathFirst = bestPathValues.begin() + inserted.first->second.first;
-							auto bestPathLast = bestPathValues.begin() + inserted.first->second.first + inserted.first->second.second;
-							if (distance(bestPathFirst, bestPathLast) < topN)
-							{
-								*bestPathLast = WordLL<LmState>{ curMorph, candScore, prevPath.accTypoCost + node->typoCost, &prevPath, move(cLmState), spState };
-								push_heap(bestPathFirst, bestPathLast + 1, WordLLGreater{});
-								++inserted.first->second.second;
-							}
-							else
-							{
-								if (candScore > bestPathFirst->accScore)
-								{
-									pop_heap(bestPathFirst, bestPathLast, WordLLGreater{});
-									*(bestPathLast - 1) = WordLL<LmState>{ curMorph, candScore, prevPath.accTypoCost + node->typoCost, &prevPath, move(cLmState), spState };
-									push_heap(bestPathFirst, bestPathLast, WordLLGreater{});
-								}
-							}
-						}
-					}
-				}
-
-			continueFor:;
+				return false;
 			}
-		}
 
-		if (top1)
-		{
-			for (auto& p : bestPathes)
+			for (size_t i = 0; i < chSize; ++i)
 			{
-				resultOut.emplace_back(move(p.second));
-				auto& newPath = resultOut.back();
-
-				// fill the rest information of resultOut
-				if (curMorph->chunks.empty() || curMorph->complex)
+				seq[i] = curMorph->chunks[i]->lmMorphemeId;
+				if (within(curMorph->chunks[i], kw->morphemes.data() + langVocabSize, kw->morphemes.data() + kw->morphemes.size()))
 				{
-					newPath.wid = oseq[0];
-					newPath.combineSocket = combSocket;
-					newPath.ownFormId = ownFormId;
+					oseq[i] = curMorph->chunks[i] - kw->morphemes.data();
 				}
 				else
 				{
-					newPath.wid = oseq[chSize - 1];
+					oseq[i] = seq[i];
 				}
 			}
 		}
 		else
 		{
-			for (auto& p : bestPathIndex)
+			seq[0] = curMorph->lmMorphemeId;
+			if (within(curMorph->getCombined() ? curMorph->getCombined() : curMorph, kw->morphemes.data() + langVocabSize, kw->morphemes.data() + kw->morphemes.size()))
 			{
-				const auto index = p.second.first;
-				const auto size = p.second.second;
-				for (size_t i = 0; i < size; ++i)
-				{
-					resultOut.emplace_back(move(bestPathValues[index + i]));
-					auto& newPath = resultOut.back();
-
-					// fill the rest information of resultOut
-					if (curMorph->chunks.empty() || curMorph->complex)
-					{
-						newPath.wid = oseq[0];
-						newPath.combineSocket = combSocket;
-						newPath.ownFormId = ownFormId;
-					}
-					else
-					{
-						newPath.wid = oseq[chSize - 1];
-					}
-				}
+				oseq[0] = curMorph - kw->morphemes.data();
 			}
+			else
+			{
+				oseq[0] = seq[0];
+			}
+			combSocket = curMorph->combineSocket;
 		}
-		return;
+		return true;
 	}
 
-	template<class LmState, class CandTy>
-	void PathEvaluator::evalPath(const Kiwi* kw,
-		const KGraphNode* startNode,
-		const KGraphNode* node,
+	/**
+	* @brief 한 형태소에 대해 이전 경로들로부터 이어지는 전이를 모아 두는 배열.
+	* @details 언어 모델 점수는 모든 전이를 모은 뒤 `LmState::nextBatch`로 한꺼번에 계산한다.
+	*/
+	template<class LmState, class PrevPath>
+	struct TransitionBatch
+	{
+		Vector<const PrevPath*> prevPaths;
+		Vector<float> scores;
+		Vector<LmState> lmStates;
+		Vector<array<Wid, 4>> seqs;
+		Vector<uint32_t> nexts;
+		Vector<float> lls;
+
+		void clear()
+		{
+			prevPaths.clear();
+			scores.clear();
+			lmStates.clear();
+			seqs.clear();
+		}
+
+		size_t size() const
+		{
+			return prevPaths.size();
+		}
+
+		size_t capacityBytes() const
+		{
+			return prevPaths.capacity() * sizeof(const PrevPath*)
+				+ scores.capacity() * sizeof(float)
+				+ lmStates.capacity() * sizeof(LmState)
+				+ seqs.capacity() * sizeof(array<Wid, 4>)
+				+ nexts.capacity() * sizeof(uint32_t)
+				+ lls.capacity() * sizeof(float);
+		}
+	};
+
+	/**
+	* @brief prevPath 뒤에 curMorph가 올 때 언어 모델을 제외한 점수를 계산한다.
+	* @details 결합 소켓이 맞지 않거나 좌측 결합조건을 만족하지 않는 등 연결될 수 없는 경우 false를 반환한다.
+	* 결합 소켓이 있는 경우 seq[0]이 결합된 형태소로 바뀌며, 이 값은 이후의 prevPath에도 그대로 유지된다.
+	*/
+	template<class PrevPath>
+	inline bool PathEvaluator::evalTransitionPrefix(
+		float& candScore,
+		const Kiwi* kw,
+		const PrevPath& prevPath,
+		const KGraphNode* prev,
+		const KGraphNode* node,
+		array<Wid, 4>& seq,
+		size_t chSize,
+		const Morpheme* curMorph,
+		const float additionalScore,
+		const float ignoreCondScore
+	)
+	{
+		const Morpheme* morphBase = kw->morphemes.data();
+
+		candScore = prevPath.accScore + additionalScore;
+		if (prevPath.combineSocket)
+		{
+			// merge <v> <chunk> with only the same socket
+			if (prevPath.combineSocket != curMorph->combineSocket || (curMorph->chunks.empty() || curMorph->complex))
+			{
+				return false;
+			}
+			if (prev->endPos < node->startPos)
+			{
+				if (kw->spaceTolerance > 0) candScore -= kw->spacePenalty;
+				else return false;
+			}
+			seq[0] = morphBase[prevPath.wid].getCombined()->lmMorphemeId;
+		}
+
+		// 좌측 결합조건은 경로마다 미리 계산해둔 마스크와의 AND 연산 한 번으로 확인한다.
+		// 결합 소켓에 의한 seq[0] 변경이 이후의 prevPath에도 유지되어야 하므로 반드시 그 뒤에 확인한다
+		if (!FeatureTestor::isMatched(prevPath.leftCondMask, curMorph->vowel, curMorph->polar))
+		{
+			if (!ignoreCondScore) return false;
+			candScore += ignoreCondScore;
+		}
+
+		if (!(curMorph->combineSocket && (curMorph->chunks.empty() || curMorph->complex)))
+		{
+			for (size_t i = 0; i < chSize; ++i)
+			{
+				// prohibit <v> without <chunk>
+				if (morphBase[seq[i]].tag == POSTag::p) return false;
+			}
+		}
+		return true;
+	}
+
+	/**
+	* @brief node로 들어오는 모든 이전 경로에 대해 curMorph로의 전이를 batch에 모은 뒤 언어 모델 점수를 한꺼번에 더한다.
+	* @param prevPathRange 이전 노드를 받아 그 노드의 경로 범위 [first, last)를 pair로 반환하는 함수
+	*/
+	template<class LmState, class PrevPath, class RangeFn>
+	inline void PathEvaluator::collectTransitions(
+		TransitionBatch<LmState, PrevPath>& batch,
+		const Kiwi* kw,
+		const KGraphNode* node,
+		array<Wid, 4> seq,
+		size_t chSize,
+		const Morpheme* curMorph,
+		const float additionalScore,
+		const float ignoreCondScore,
+		RangeFn&& prevPathRange
+	)
+	{
+		batch.clear();
+		for (auto* prev = node->getPrev(); prev; prev = prev->getSibling())
+		{
+			assert(prev != node);
+			auto range = prevPathRange(prev);
+			for (auto it = range.first; it != range.second; ++it)
+			{
+				float candScore;
+				if (!evalTransitionPrefix(candScore, kw, *it, prev, node, seq, chSize, curMorph, additionalScore, ignoreCondScore)) continue;
+				batch.prevPaths.emplace_back(&*it);
+				batch.scores.emplace_back(candScore);
+				batch.lmStates.emplace_back(it->lmState);
+				batch.seqs.emplace_back(seq);
+			}
+		}
+
+		if (curMorph->combineSocket && (curMorph->chunks.empty() || curMorph->complex)) return;
+
+		const size_t n = batch.size();
+		batch.nexts.resize(n);
+		batch.lls.resize(n);
+		for (size_t i = 0; i < chSize; ++i)
+		{
+			for (size_t j = 0; j < n; ++j) batch.nexts[j] = batch.seqs[j][i];
+			LmState::nextBatch(kw->langMdl, batch.lmStates.data(), batch.nexts.data(), batch.lls.data(), n);
+			for (size_t j = 0; j < n; ++j) batch.scores[j] += batch.lls[j];
+		}
+	}
+
+	/**
+	* @brief 규칙 기반 점수를 계산하고 특수 상태(spState)를 curMorph 뒤의 상태로 갱신한다.
+	*/
+	inline float PathEvaluator::evalTransitionSuffix(
+		SpecialState& spState,
+		const Kiwi* kw,
+		Wid prevWid,
+		const RuleBasedScorer& ruleBasedScorer
+	)
+	{
+		const float score = ruleBasedScorer(&kw->morphemes[prevWid], spState);
+
+		// update special state
+		if (ruleBasedScorer.curMorphSpecialType == Kiwi::SpecialMorph::singleQuoteOpen) spState.singleQuote = 1;
+		else if (ruleBasedScorer.curMorphSpecialType == Kiwi::SpecialMorph::singleQuoteClose) spState.singleQuote = 0;
+		else if (ruleBasedScorer.curMorphSpecialType == Kiwi::SpecialMorph::doubleQuoteOpen) spState.doubleQuote = 1;
+		else if (ruleBasedScorer.curMorphSpecialType == Kiwi::SpecialMorph::doubleQuoteClose) spState.doubleQuote = 0;
+		if (ruleBasedScorer.curMorphSbType)
+		{
+			spState.bulletHash = hashSbTypeOrder(ruleBasedScorer.curMorphSbType, ruleBasedScorer.curMorphSbOrder + 1);
+		}
+		return score;
+	}
+
+	/**
+	* @brief 경로 p가 끝 노드로 이어질 때의 최종 점수를 계산한다. 끝날 수 없는 경로면 false를 반환한다.
+	*/
+	template<class LmState, class PrevPath>
+	inline bool PathEvaluator::evalEndPath(float& score, const Kiwi* kw, const PrevPath& p, bool openEnd)
+	{
+		static constexpr size_t eosId = 1;
+
+		if (p.combineSocket) return false;
+		if (!p.morpheme->chunks.empty() && !p.morpheme->complex)
+		{
+			if (p.morpheme->chunks.size() <= (p.morpheme->combineSocket ? 2 : 1))
+			{
+				if (!FeatureTestor::isMatched(nullptr, p.morpheme->vowel)) return false;
+			}
+		}
+
+		score = p.accScore;
+		if (!openEnd)
+		{
+			auto lmState = p.lmState;
+			score += lmState.next(kw->langMdl, eosId);
+		}
+		if (p.spState.singleQuote) score -= 2;
+		if (p.spState.doubleQuote) score -= 2;
+		return true;
+	}
+
+	/**
+	* @brief 경로 탐색에 쓰이는 AnalysisContext 버퍼의 태그들
+	*/
+	namespace scratch
+	{
+		template<class LmState>
+		struct BestPathes { using type = utils::FlatHashMap<PathHash<LmState>, WordLL<LmState>>; };
+
+		// pair: [index, size]
+		template<class LmState>
+		struct BestPathIndex { using type = utils::FlatHashMap<PathHash<LmState>, pair<uint32_t, uint32_t>>; };
+
+		template<class LmState>
+		struct BestPathValues { using type = Vector<WordLL<LmState>>; };
+
+		template<class LmState, class PrevPath>
+		struct Transitions { using type = TransitionBatch<LmState, PrevPath>; };
+
+		struct MaxScores { using type = Vector<float>; };
+
+		template<class LmState>
+		struct Top1PathIndex { using type = utils::FlatHashMap<PathHash<LmState>, uint32_t>; };
+
+		template<class LmState>
+		struct Top1PathValues { using type = Vector<Top1LL<LmState>>; };
+
+		template<class LmState>
+		struct Top1States { using type = Vector<Top1LL<LmState>>; };
+
+		struct RootScores { using type = Vector<float>; };
+
+		// pair: [최소 점수, 남긴 개수]
+		struct RootLimits { using type = Vector<pair<float, uint32_t>>; };
+	}
+
+	/**
+	* @brief 한 노드에서 생성된 경로들 [first, last)를 가지치기하고 남은 구간의 끝을 반환한다.
+	* @details 루트별로 topN번째로 좋은 점수보다 cutOff 넘게 낮은 경로를 버리고,
+	* maxStates가 0이 아니면 루트별로 점수가 가장 높은 maxStates개까지만 남긴다. 결합용 형태소(combineSocket)의 경로는 세지 않는다.
+	*/
+	template<class It>
+	It pruneNodeStates(It first, It last, size_t numRoots, size_t topN, size_t maxStates, float cutOff)
+	{
+		auto& ctx = AnalysisContext::Impl::current();
+		const size_t heapSize = maxStates == 1 ? 1 : topN;
+		auto& maxScores = ctx.get<scratch::MaxScores>();
+		maxScores.clear();
+		maxScores.resize(numRoots * heapSize, -INFINITY);
+
+		if (heapSize == 1)
+		{
+			for (auto it = first; it != last; ++it)
+			{
+				if (it->morpheme->combineSocket) continue;
+				maxScores[it->rootId] = max(maxScores[it->rootId], it->accScore);
+			}
+		}
+		else
+		{
+			for (auto it = first; it != last; ++it)
+			{
+				if (it->morpheme->combineSocket) continue;
+				auto heapBegin = maxScores.begin() + it->rootId * heapSize;
+				if (it->accScore > *heapBegin)
+				{
+					pop_heap(heapBegin, heapBegin + heapSize, greater<float>{});
+					heapBegin[heapSize - 1] = it->accScore;
+					push_heap(heapBegin, heapBegin + heapSize, greater<float>{});
+				}
+			}
+		}
+
+		auto& limits = ctx.get<scratch::RootLimits>();
+		if (maxStates)
+		{
+			auto& scores = ctx.get<scratch::RootScores>();
+			limits.assign(numRoots, make_pair(-INFINITY, 0));
+			for (size_t r = 0; r < numRoots; ++r)
+			{
+				scores.clear();
+				for (auto it = first; it != last; ++it)
+				{
+					if (it->morpheme->combineSocket || it->rootId != r) continue;
+					scores.emplace_back(it->accScore);
+				}
+				if (scores.size() <= maxStates) continue;
+				nth_element(scores.begin(), scores.begin() + maxStates - 1, scores.end(), greater<float>{});
+				limits[r].first = scores[maxStates - 1];
+			}
+		}
+
+		auto out = first;
+		for (auto it = first; it != last; ++it)
+		{
+			if (it->accScore + cutOff < maxScores[it->rootId * heapSize]) continue;
+			if (maxStates && !it->morpheme->combineSocket)
+			{
+				// 같은 점수의 경로가 여럿이어도 maxStates개까지만 남긴다
+				auto& l = limits[it->rootId];
+				if (it->accScore < l.first || l.second >= maxStates) continue;
+				++l.second;
+			}
+			if (out != it) *out = move(*it);
+			++out;
+		}
+		return out;
+	}
+
+	template<bool top1, class LmState>
+	void PathEvaluator::evalSingleMorpheme(
+		utils::ArenaVector<WordLL<LmState>>& resultOut,
+		const Kiwi* kw,
+		const Vector<U16StringView>& ownForms,
+		const utils::ArenaVector<utils::ArenaVector<WordLL<LmState>>>& cache,
+		array<Wid, 4> seq,
+		array<Wid, 4> oseq,
+		size_t chSize,
+		uint8_t combSocket,
+		size_t ownFormId,
+		const Morpheme* curMorph,
+		const KGraphNode* node,
+		const KGraphNode* startNode,
 		const size_t topN,
-		Vector<Vector<WordLL<LmState>>>& cache,
+		const float ignoreCondScore,
+		const float nodeLevelDiscount
+	)
+	{
+		auto& ctx = AnalysisContext::Impl::current();
+		auto& bestPathes = ctx.get<scratch::BestPathes<LmState>>();
+		auto& bestPathIndex = ctx.get<scratch::BestPathIndex<LmState>>();
+		auto& bestPathValues = ctx.get<scratch::BestPathValues<LmState>>();
+		if (top1)
+		{
+			bestPathes.clear();
+		}
+		else
+		{
+			bestPathIndex.clear();
+			bestPathValues.clear();
+		}
+
+		float additionalScore = curMorph->userScore + nodeLevelDiscount;
+		additionalScore += kw->tagScorer.evalLeftBoundary(hasLeftBoundary(node), curMorph->tag);
+
+		RuleBasedScorer ruleBasedScorer{ kw, curMorph, node };
+
+		auto& batch = ctx.get<scratch::Transitions<LmState, WordLL<LmState>>>();
+		collectTransitions(batch, kw, node, seq, chSize, curMorph, additionalScore, ignoreCondScore, [&](const KGraphNode* prev)
+		{
+			auto& c = cache[prev - startNode];
+			return make_pair(c.data(), c.data() + c.size());
+		});
+		ctx.transitions += batch.size();
+
+		for (size_t b = 0; b < batch.size(); ++b)
+		{
+			auto& prevPath = *batch.prevPaths[b];
+			auto spState = prevPath.spState;
+			float candScore = batch.scores[b] + evalTransitionSuffix(spState, kw, prevPath.wid, ruleBasedScorer);
+			auto& cLmState = batch.lmStates[b];
+
+			PathHash<LmState> ph{ cLmState, prevPath.rootId, spState };
+			if (top1)
+			{
+				WordLL<LmState> newPath{ curMorph, candScore, prevPath.accTypoCost + node->typoCost, &prevPath, move(cLmState), spState };
+				auto inserted = bestPathes.emplace(ph, newPath);
+				if (!inserted.second)
+				{
+					auto& target = *inserted.first;
+					if (candScore > target.accScore)
+					{
+						target = newPath;
+					}
+				}
+			}
+			else
+			{
+				auto inserted = bestPathIndex.emplace(ph, make_pair(bestPathValues.size(), 1));
+				if (inserted.second)
+				{
+					bestPathValues.emplace_back(curMorph, candScore, prevPath.accTypoCost + node->typoCost, &prevPath, move(cLmState), spState);
+					bestPathValues.resize(bestPathValues.size() + topN - 1);
+				}
+				else
+				{
+					auto bestPathFirst = bestPathValues.begin() + inserted.first->first;
+					auto bestPathLast = bestPathValues.begin() + inserted.first->first + inserted.first->second;
+					if (distance(bestPathFirst, bestPathLast) < topN)
+					{
+						*bestPathLast = WordLL<LmState>{ curMorph, candScore, prevPath.accTypoCost + node->typoCost, &prevPath, move(cLmState), spState };
+						push_heap(bestPathFirst, bestPathLast + 1, WordLLGreater{});
+						++inserted.first->second;
+					}
+					else
+					{
+						if (candScore > bestPathFirst->accScore)
+						{
+							pop_heap(bestPathFirst, bestPathLast, WordLLGreater{});
+							*(bestPathLast - 1) = WordLL<LmState>{ curMorph, candScore, prevPath.accTypoCost + node->typoCost, &prevPath, move(cLmState), spState };
+							push_heap(bestPathFirst, bestPathLast, WordLLGreater{});
+						}
+					}
+				}
+			}
+		}
+
+		if (top1)
+		{
+			bestPathes.forEach([&](const PathHash<LmState>&, WordLL<LmState>& p)
+			{
+				resultOut.emplace_back(move(p));
+				auto& newPath = resultOut.back();
+
+				// fill the rest information of resultOut
+				if (curMorph->chunks.empty() || curMorph->complex)
+				{
+					newPath.wid = oseq[0];
+					newPath.combineSocket = combSocket;
+					newPath.ownFormId = ownFormId;
+				}
+				else
+				{
+					newPath.wid = oseq[chSize - 1];
+				}
+				newPath.leftCondMask = leftCondMaskOf(kw->morphemes.data(), ownForms, newPath);
+			});
+		}
+		else
+		{
+			bestPathIndex.forEach([&](const PathHash<LmState>&, const pair<uint32_t, uint32_t>& p)
+			{
+				const auto index = p.first;
+				const auto size = p.second;
+				for (size_t i = 0; i < size; ++i)
+				{
+					resultOut.emplace_back(move(bestPathValues[index + i]));
+					auto& newPath = resultOut.back();
+
+					// fill the rest information of resultOut
+					if (curMorph->chunks.empty() || curMorph->complex)
+					{
+						newPath.wid = oseq[0];
+						newPath.combineSocket = combSocket;
+						newPath.ownFormId = ownFormId;
+					}
+					else
+					{
+						newPath.wid = oseq[chSize - 1];
+					}
+					newPath.leftCondMask = leftCondMaskOf(kw->morphemes.data(), ownForms, newPath);
+				}
+			});
+		}
+		return;
+	}
+
+	template<class LmState, class CandTy>
+	void PathEvaluator::evalPath(const Kiwi* kw,
+		const KGraphNode* startNode,
+		const KGraphNode* node,
+		const size_t topN,
+		utils::ArenaVector<utils::ArenaVector<WordLL<LmState>>>& cache,
 		const Vector<U16StringView>& ownFormList,
 		size_t i,
 		size_t ownFormId,
 		CandTy&& cands,
 		bool unknownForm,
+		BeamController& beam,
 		bool splitComplex,
-		const std::unordered_set<const Morpheme*>* blocklist
+		const MorphemeSet* blocklist
 	)
 	{
 		const size_t langVocabSize = kw->langMdl.knlm->getHeader().vocab_size;
 		auto& nCache = cache[i];
 		Vector<WordLL<LmState>> refCache;
 
-		float whitespaceDiscount = 0;
-		if (node->uform.empty() && !node->form->form.empty() && node->spaceErrors)
-		{
-			whitespaceDiscount = -kw->spacePenalty * node->spaceErrors;
-		}
-		const float typoDiscount = -node->typoCost * kw->typoCostWeight;
-		float unknownFormDiscount = 0;
-		if (unknownForm)
-		{
-			size_t unknownLen = node->uform.empty() ? node->form->form.size() : node->uform.size();
-			unknownFormDiscount = -(unknownLen * kw->unkFormScoreScale + kw->unkFormScoreBias);
-		}
-
-		const float nodeLevelDiscount = whitespaceDiscount + typoDiscount + unknownFormDiscount;
+		const float nodeLevelDiscount = getNodeLevelDiscount(kw, node, unknownForm);
 
 		for (bool ignoreCond : {false, true})
 		{
 			for (auto& curMorph : cands)
 			{
 				if (splitComplex && curMorph->getCombined()->complex) continue;
-				if (blocklist && blocklist->count(curMorph->getCombined())) continue;
+				if (blocklist && blocklist->contains(curMorph->getCombined())) continue;
 
 				// 덧붙은 받침(zCoda)을 위한 지름길
 				if (curMorph->tag == POSTag::z_coda)
@@ -722,59 +1234,16 @@ namespace kiwi
 							newPath.parent = &p;
 							newPath.morpheme = &kw->morphemes[curMorph->lmMorphemeId];
 							newPath.wid = curMorph->lmMorphemeId;
+							newPath.leftCondMask = leftCondMaskOf(kw->morphemes.data(), ownFormList, newPath);
 						}
 					}
 					continue;
 				}
 
-				array<Wid, 4> seq = { 0, };
-				array<Wid, 4> oseq = { 0, };
-				uint8_t combSocket = 0;
-				CondVowel condV = curMorph->vowel;
-				CondPolarity condP = curMorph->polar;
-				size_t chSize = 1;
-				// if the morpheme has chunk set
-				if (!curMorph->chunks.empty() && !curMorph->complex)
-				{
-					chSize = curMorph->chunks.size();
-					// '하다/하게/하지'가 '다/게/지'로 축약된 경우인데 앞에 공백이 있는 경우는 탐색후보에서 제외
-					if (node->prev && node[-(int)node->prev].endPos < node->startPos
-						&& curMorph->kform
-						&& curMorph->kform->size() == 1
-						&& ((*curMorph->kform)[0] == u'다' || (*curMorph->kform)[0] == u'게' || (*curMorph->kform)[0] == u'지')
-						&& curMorph->chunks[0]->kform
-						&& curMorph->chunks[0]->kform->size() == 1
-						&& (*curMorph->chunks[0]->kform)[0] == u'하')
-					{
-						continue;
-					}
-
-					for (size_t i = 0; i < chSize; ++i)
-					{
-						seq[i] = curMorph->chunks[i]->lmMorphemeId;
-						if (within(curMorph->chunks[i], kw->morphemes.data() + langVocabSize, kw->morphemes.data() + kw->morphemes.size()))
-						{
-							oseq[i] = curMorph->chunks[i] - kw->morphemes.data();
-						}
-						else
-						{
-							oseq[i] = seq[i];
-						}
-					}
-				}
-				else
-				{
-					seq[0] = curMorph->lmMorphemeId;
-					if (within(curMorph->getCombined() ? curMorph->getCombined() : curMorph, kw->morphemes.data() + langVocabSize, kw->morphemes.data() + kw->morphemes.size()))
-					{
-						oseq[0] = curMorph - kw->morphemes.data();
-					}
-					else
-					{
-						oseq[0] = seq[0];
-					}
-					combSocket = curMorph->combineSocket;
-				}
+				array<Wid, 4> seq, oseq;
+				uint8_t combSocket;
+				size_t chSize;
+				if (!makeMorphemeSeq(kw, curMorph, node, langVocabSize, seq, oseq, combSocket, chSize)) continue;
 
 				if (topN == 1)
 				{
@@ -789,43 +1258,97 @@ namespace kiwi
 			if (!nCache.empty()) break;
 		}
 
-		thread_local Vector<float> maxScores;
-		maxScores.clear();
-		maxScores.resize(cache[0].size() * topN, -INFINITY);
+		const size_t generated = nCache.size();
+		auto limit = beam.limit(i, generated);
+		// 작업량 상한에 도달한 뒤에는 루트마다 가장 좋은 경로 하나만 남기는 탐욕적 탐색으로 전환한다
+		if (AnalysisContext::Impl::current().budgetExhausted()) limit.maxStates = 1;
+		nCache.erase(pruneNodeStates(nCache.begin(), nCache.end(), cache[0].size(), topN, limit.maxStates, limit.cutOff), nCache.end());
+		beam.record(generated, nCache.size());
+	}
+
 
-		if (topN == 1)
+	inline const Morpheme* unifyMorpheme(const Morpheme* morph, const Morpheme* morphFirst, size_t langVocabSize)
+	{
+		if (!within(morph, morphFirst, morphFirst + langVocabSize) || morph->combined) return morph;
+		return morphFirst + morph->lmMorphemeId;
+	}
+
+	/**
+	* @brief 경로의 한 단계(cur)에 해당하는 토큰들을 ret 뒤에 추가한다.
+	*/
+	template<class Step>
+	inline void appendStepTokens(PathEvaluator::Path& ret,
+		const Step* cur,
+		const Step* prev,
+		const KGraphNode& gNode,
+		const KGraphNode* graph,
+		const Vector<U16StringView>& ownFormList,
+		float typoCostWeight,
+		const Morpheme* morphFirst,
+		size_t langVocabSize)
+	{
+		float scoreDiff = cur->accScore - prev->accScore;
+		float typoCostDiff = cur->accTypoCost - prev->accTypoCost;
+		auto morpheme = cur->morpheme;
+		size_t numNewTokens = (morpheme->chunks.empty() || morpheme->complex) ? 1 : morpheme->chunks.size();
+		scoreDiff += typoCostDiff * typoCostWeight;
+		scoreDiff /= numNewTokens;
+		typoCostDiff /= numNewTokens;
+
+		if (morpheme->chunks.empty() || morpheme->complex)
 		{
-			for (auto& c : nCache)
+			ret.emplace_back(
+				unifyMorpheme(morpheme, morphFirst, langVocabSize),
+				cur->ownFormId ? KString{ ownFormList[cur->ownFormId - 1].data(), ownFormList[cur->ownFormId - 1].size() } : KString{},
+				gNode.startPos,
+				gNode.endPos,
+				scoreDiff,
+				typoCostDiff,
+				typoCostDiff ? gNode.typoFormId : 0,
+				&gNode - graph
+			);
+		}
+		else if (morpheme->combineSocket)
+		{
+			ret.back().morph = ret.back().morph->getCombined();
+			ret.back().end = gNode.startPos + morpheme->chunks.getSecond(0).second;
+			ret.back().wordScore = scoreDiff;
+			ret.back().typoCost = typoCostDiff;
+			ret.back().typoFormId = typoCostDiff ? gNode.typoFormId : 0;
+			for (size_t ch = 1; ch < numNewTokens; ++ch)
 			{
-				if (c.morpheme->combineSocket) continue;
-				maxScores[c.rootId] = max(maxScores[c.rootId], c.accScore);
+				auto& p = morpheme->chunks.getSecond(ch);
+				ret.emplace_back(
+					unifyMorpheme(morpheme->chunks[ch], morphFirst, langVocabSize),
+					KString{},
+					gNode.startPos + p.first,
+					gNode.startPos + p.second,
+					scoreDiff,
+					typoCostDiff,
+					typoCostDiff ? gNode.typoFormId : 0,
+					&gNode - graph
+				);
 			}
 		}
 		else
 		{
-			for (auto& c : nCache)
+			for (size_t ch = 0; ch < numNewTokens; ++ch)
 			{
-				if (c.morpheme->combineSocket) continue;
-				if (c.accScore > maxScores[c.rootId * topN])
-				{
-					pop_heap(maxScores.begin() + c.rootId * topN, maxScores.begin() + (c.rootId + 1) * topN, greater<float>{});
-					maxScores[c.rootId * topN + topN - 1] = c.accScore;
-					push_heap(maxScores.begin() + c.rootId * topN, maxScores.begin() + (c.rootId + 1) * topN, greater<float>{});
-				}
+				auto& p = morpheme->chunks.getSecond(ch);
+				ret.emplace_back(
+					unifyMorpheme(morpheme->chunks[ch], morphFirst, langVocabSize),
+					KString{},
+					gNode.startPos + p.first,
+					gNode.startPos + p.second,
+					scoreDiff,
+					typoCostDiff,
+					typoCostDiff ? gNode.typoFormId : 0,
+					&gNode - graph
+				);
 			}
 		}
-
-		size_t validCount = 0;
-		for (size_t i = 0; i < nCache.size(); ++i)
-		{
-			if (nCache[i].accScore + kw->cutOffThreshold < maxScores[nCache[i].rootId * topN]) continue;
-			if (validCount != i) nCache[validCount] = move(nCache[i]);
-			validCount++;
-		}
-		nCache.resize(validCount);
 	}
 
-
 	template<class LmState>
 	inline pair<PathEvaluator::Path, const WordLL<LmState>*> generateTokenList(const WordLL<LmState>* result,
 		const utils::ContainerSearcher<WordLL<LmState>>& csearcher,
@@ -841,78 +1364,12 @@ namespace kiwi
 			steps.emplace_back(s);
 		}
 
-		const auto unifyMorpheme = [&](const Morpheme* morph)
-		{
-			if (!within(morph, morphFirst, morphFirst + langVocabSize) || morph->combined) return morph;
-			return morphFirst + morph->lmMorphemeId;
-		};
-
 		PathEvaluator::Path ret;
 		const WordLL<LmState>* prev = steps.back()->parent;
 		for (auto it = steps.rbegin(); it != steps.rend(); ++it)
 		{
 			auto cur = *it;
-			float scoreDiff = cur->accScore - prev->accScore;
-			float typoCostDiff = cur->accTypoCost - prev->accTypoCost;
-			auto morpheme = cur->morpheme;
-			size_t numNewTokens = (morpheme->chunks.empty() || morpheme->complex) ? 1 : morpheme->chunks.size();
-			auto& gNode = graph[csearcher(cur)];
-			scoreDiff += typoCostDiff * typoCostWeight;
-			scoreDiff /= numNewTokens;
-			typoCostDiff /= numNewTokens;
-
-			if (morpheme->chunks.empty() || morpheme->complex)
-			{
-				ret.emplace_back(
-					unifyMorpheme(morpheme),
-					cur->ownFormId ? KString{ ownFormList[cur->ownFormId - 1].data(), ownFormList[cur->ownFormId - 1].size() } : KString{},
-					gNode.startPos,
-					gNode.endPos,
-					scoreDiff,
-					typoCostDiff,
-					typoCostDiff ? gNode.typoFormId : 0,
-					&gNode - graph
-				);
-			}
-			else if (morpheme->combineSocket)
-			{
-				ret.back().morph = ret.back().morph->getCombined();
-				ret.back().end = gNode.startPos + morpheme->chunks.getSecond(0).second;
-				ret.back().wordScore = scoreDiff;
-				ret.back().typoCost = typoCostDiff;
-				ret.back().typoFormId = typoCostDiff ? gNode.typoFormId : 0;
-				for (size_t ch = 1; ch < numNewTokens; ++ch)
-				{
-					auto& p = morpheme->chunks.getSecond(ch);
-					ret.emplace_back(
-						unifyMorpheme(morpheme->chunks[ch]),
-						KString{},
-						gNode.startPos + p.first,
-						gNode.startPos + p.second,
-						scoreDiff,
-						typoCostDiff,
-						typoCostDiff ? gNode.typoFormId : 0,
-						&gNode - graph
-					);
-				}
-			}
-			else
-			{
-				for (size_t ch = 0; ch < numNewTokens; ++ch)
-				{
-					auto& p = morpheme->chunks.getSecond(ch);
-					ret.emplace_back(
-						unifyMorpheme(morpheme->chunks[ch]),
-						KString{},
-						gNode.startPos + p.first,
-						gNode.startPos + p.second,
-						scoreDiff,
-						typoCostDiff,
-						typoCostDiff ? gNode.typoFormId : 0,
-						&gNode - graph
-					);
-				}
-			}
+			appendStepTokens(ret, cur, prev, graph[csearcher(cur)], graph, ownFormList, typoCostWeight, morphFirst, langVocabSize);
 			prev = cur;
 		}
 		return make_pair(ret, steps.back()->parent);
@@ -926,12 +1383,22 @@ namespace kiwi
 		const size_t topN,
 		bool openEnd,
 		bool splitComplex,
-		const std::unordered_set<const Morpheme*>* blocklist
+		const MorphemeSet* blocklist
 	)
 	{
-		static constexpr size_t eosId = 1;
+		AnalysisContext::Impl::Binding contextBinding{ AnalysisContext::Impl::current() };
+		const bool useLmMemo = kw->lmMemoCounters && kw->lmMemoCounters->enabled.load(std::memory_order_relaxed);
+		LmTransitionMemo::Scope memoScope{ useLmMemo ? kw->langMdl.knlm.get() : nullptr, kw->lmMemoCounters.get() };
+
+		if (topN == 1 && kw->dedicatedTop1)
+		{
+			return findBestPathTop1<LmState>(kw, prevSpStates, graph, graphSize, openEnd, splitComplex, blocklist);
+		}
+
+		// 탐색 중에 쓰이는 경로 캐시는 arena에서 할당받고 탐색이 끝나면 한꺼번에 반환한다
+		utils::Arena::Scope arenaScope;
 
-		Vector<Vector<WordLL<LmState>>> cache(graphSize);
+		utils::ArenaVector<utils::ArenaVector<WordLL<LmState>>> cache(graphSize);
 		Vector<U16StringView> ownFormList;
 		Vector<const Morpheme*> unknownNodeCands, unknownNodeLCands;
 
@@ -961,6 +1428,8 @@ namespace kiwi
 				cache[0].back().rootId = rootId;
 			}
 		}
+		for (auto& p : cache[0]) p.leftCondMask = leftCondMaskOf(kw->morphemes.data(), ownFormList, p);
+		BeamController beam{ kw, graphSize, topN, cache[0].size() };
 
 		// middle nodes
 		for (size_t i = 1; i < graphSize - 1; ++i)
@@ -975,7 +1444,7 @@ namespace kiwi
 
 			if (node->form)
 			{
-				evalPath<LmState>(kw, startNode, node, topN, cache, ownFormList, i, ownFormId, node->form->candidate, false, splitComplex, blocklist);
+				evalPath<LmState>(kw, startNode, node, topN, cache, ownFormList, i, ownFormId, node->form->candidate, false, beam, splitComplex, blocklist);
 				if (all_of(node->form->candidate.begin(), node->form->candidate.end(), [](const Morpheme* m)
 				{
 					return m->combineSocket || (!m->chunks.empty() && !m->complex);
@@ -983,12 +1452,12 @@ namespace kiwi
 				{
 					ownFormList.emplace_back(node->form->form);
 					ownFormId = ownFormList.size();
-					evalPath<LmState>(kw, startNode, node, topN, cache, ownFormList, i, ownFormId, unknownNodeLCands, true, splitComplex, blocklist);
+					evalPath<LmState>(kw, startNode, node, topN, cache, ownFormList, i, ownFormId, unknownNodeLCands, true, beam, splitComplex, blocklist);
 				};
 			}
 			else
 			{
-				evalPath<LmState>(kw, startNode, node, topN, cache, ownFormList, i, ownFormId, unknownNodeCands, true, splitComplex, blocklist);
+				evalPath<LmState>(kw, startNode, node, topN, cache, ownFormList, i, ownFormId, unknownNodeCands, true, beam, splitComplex, blocklist);
 			}
 
 #ifdef DEBUG_PRINT
@@ -1011,18 +1480,8 @@ namespace kiwi
 		{
 			for (auto& p : cache[prev - startNode])
 			{
-				if (p.combineSocket) continue;
-				if (!p.morpheme->chunks.empty() && !p.morpheme->complex)
-				{
-					if (p.morpheme->chunks.size() <= (p.morpheme->combineSocket ? 2 : 1))
-					{
-						if (!FeatureTestor::isMatched(nullptr, p.morpheme->vowel)) continue;
-					}
-				}
-
-				float c = p.accScore + (openEnd ? 0 : p.lmState.next(kw->langMdl, eosId));
-				if (p.spState.singleQuote) c -= 2;
-				if (p.spState.doubleQuote) c -= 2;
+				float c;
+				if (!evalEndPath<LmState>(c, kw, p, openEnd)) continue;
 				cache.back().emplace_back(nullptr, c, p.accTypoCost, &p, p.lmState, p.spState);
 			}
 		}
@@ -1084,4 +1543,301 @@ namespace kiwi
 		if (ret.size() > topN * 2) ret.erase(ret.begin() + topN * 2, ret.end());
 		return ret;
 	}
+
+	template<class LmState>
+	void PathEvaluator::evalSingleMorphemeTop1(
+		Vector<Top1LL<LmState>>& states,
+		const Vector<uint32_t>& nodeBegin,
+		const Kiwi* kw,
+		const Vector<U16StringView>& ownForms,
+		array<Wid, 4> seq,
+		array<Wid, 4> oseq,
+		size_t chSize,
+		uint8_t combSocket,
+		size_t ownFormId,
+		const Morpheme* curMorph,
+		const KGraphNode* node,
+		const KGraphNode* startNode,
+		const float ignoreCondScore,
+		const float nodeLevelDiscount
+	)
+	{
+		auto& ctx = AnalysisContext::Impl::current();
+		auto& bestPathIndex = ctx.get<scratch::Top1PathIndex<LmState>>();
+		auto& bestPathValues = ctx.get<scratch::Top1PathValues<LmState>>();
+		bestPathIndex.clear();
+		bestPathValues.clear();
+
+		float additionalScore = curMorph->userScore + nodeLevelDiscount;
+		additionalScore += kw->tagScorer.evalLeftBoundary(hasLeftBoundary(node), curMorph->tag);
+
+		RuleBasedScorer ruleBasedScorer{ kw, curMorph, node };
+		const uint32_t nodeId = node - startNode;
+
+		auto& batch = ctx.get<scratch::Transitions<LmState, Top1LL<LmState>>>();
+		collectTransitions(batch, kw, node, seq, chSize, curMorph, additionalScore, ignoreCondScore, [&](const KGraphNode* prev)
+		{
+			const size_t prevId = prev - startNode;
+			return make_pair(states.data() + nodeBegin[prevId], states.data() + nodeBegin[prevId + 1]);
+		});
+		ctx.transitions += batch.size();
+
+		for (size_t b = 0; b < batch.size(); ++b)
+		{
+			const auto& prevPath = *batch.prevPaths[b];
+			const uint32_t j = batch.prevPaths[b] - states.data();
+			auto spState = prevPath.spState;
+			float candScore = batch.scores[b] + evalTransitionSuffix(spState, kw, prevPath.wid, ruleBasedScorer);
+			auto& cLmState = batch.lmStates[b];
+
+			PathHash<LmState> ph{ cLmState, prevPath.rootId, spState };
+			auto inserted = bestPathIndex.emplace(ph, (uint32_t)bestPathValues.size());
+			if (inserted.second)
+			{
+				bestPathValues.emplace_back(curMorph, candScore, prevPath.accTypoCost + node->typoCost, j, nodeId, move(cLmState), prevPath.rootId, spState);
+			}
+			else
+			{
+				auto& target = bestPathValues[*inserted.first];
+				if (candScore > target.accScore)
+				{
+					target = Top1LL<LmState>{ curMorph, candScore, prevPath.accTypoCost + node->typoCost, j, nodeId, move(cLmState), prevPath.rootId, spState };
+				}
+			}
+		}
+
+		for (auto& p : bestPathValues)
+		{
+			// fill the rest information of states
+			if (curMorph->chunks.empty() || curMorph->complex)
+			{
+				p.wid = oseq[0];
+				p.combineSocket = combSocket;
+				p.ownFormId = ownFormId;
+			}
+			else
+			{
+				p.wid = oseq[chSize - 1];
+			}
+			p.leftCondMask = leftCondMaskOf(kw->morphemes.data(), ownForms, p);
+			states.emplace_back(move(p));
+		}
+	}
+
+	template<class LmState, class CandTy>
+	void PathEvaluator::evalPathTop1(const Kiwi* kw,
+		const KGraphNode* startNode,
+		const KGraphNode* node,
+		Vector<Top1LL<LmState>>& states,
+		const Vector<uint32_t>& nodeBegin,
+		const Vector<U16StringView>& ownFormList,
+		size_t ownFormId,
+		CandTy&& cands,
+		bool unknownForm,
+		BeamController& beam,
+		bool splitComplex,
+		const MorphemeSet* blocklist
+	)
+	{
+		const size_t langVocabSize = kw->langMdl.knlm->getHeader().vocab_size;
+		const uint32_t nodeId = node - startNode;
+		// 같은 노드에 대해 여러 번 호출될 수 있으므로, 일반 탐색과 마찬가지로 이전 호출에서 남은 상태까지 포함하여 다룬다
+		const size_t first = nodeBegin[nodeId];
+
+		const float nodeLevelDiscount = getNodeLevelDiscount(kw, node, unknownForm);
+
+		for (bool ignoreCond : {false, true})
+		{
+			for (auto& curMorph : cands)
+			{
+				if (splitComplex && curMorph->getCombined()->complex) continue;
+				if (blocklist && blocklist->contains(curMorph->getCombined())) continue;
+
+				// 덧붙은 받침(zCoda)을 위한 지름길
+				if (curMorph->tag == POSTag::z_coda)
+				{
+					for (auto* prev = node->getPrev(); prev; prev = prev->getSibling())
+					{
+						const size_t prevId = prev - startNode;
+						for (size_t j = nodeBegin[prevId]; j < nodeBegin[prevId + 1]; ++j)
+						{
+							auto lastTag = kw->morphemes[states[j].wid].tag;
+							if (!isJClass(lastTag) && !isEClass(lastTag)) continue;
+							states.emplace_back(states[j]);
+							auto& newPath = states.back();
+							newPath.accScore += curMorph->userScore * kw->typoCostWeight;
+							newPath.accTypoCost -= curMorph->userScore;
+							newPath.parent = j;
+							newPath.nodeId = nodeId;
+							newPath.morpheme = &kw->morphemes[curMorph->lmMorphemeId];
+							newPath.wid = curMorph->lmMorphemeId;
+							newPath.leftCondMask = leftCondMaskOf(kw->morphemes.data(), ownFormList, newPath);
+						}
+					}
+					continue;
+				}
+
+				array<Wid, 4> seq, oseq;
+				uint8_t combSocket;
+				size_t chSize;
+				if (!makeMorphemeSeq(kw, curMorph, node, langVocabSize, seq, oseq, combSocket, chSize)) continue;
+
+				evalSingleMorphemeTop1(states, nodeBegin, kw, ownFormList, seq, oseq, chSize, combSocket, ownFormId, curMorph, node, startNode, ignoreCond ? -10 : 0, nodeLevelDiscount);
+			}
+			if (states.size() > first) break;
+		}
+
+		const size_t generated = states.size() - first;
+		auto limit = beam.limit(nodeId, generated);
+		// 작업량 상한에 도달한 뒤에는 루트마다 가장 좋은 경로 하나만 남기는 탐욕적 탐색으로 전환한다
+		if (AnalysisContext::Impl::current().budgetExhausted()) limit.maxStates = 1;
+		states.erase(pruneNodeStates(states.begin() + first, states.end(), nodeBegin[1] - nodeBegin[0], 1, limit.maxStates, limit.cutOff), states.end());
+		beam.record(generated, states.size() - first);
+	}
+
+	/**
+	* @brief topN이 1일 때 사용하는 전용 탐색 함수.
+	* @details 각 노드에서 (언어 모델 상태, 특수 상태)별로 최고 점수의 경로 하나만 유지하는 Viterbi 탐색을 수행한다.
+	* 모든 노드의 경로 상태는 하나의 배열에 연속하여 저장되고 부모는 인덱스로 가리키므로,
+	* 노드별 벡터를 할당하거나 결과 생성 시 포인터로부터 노드를 역으로 찾을 필요가 없다.
+	* 결과는 `findBestPath`에 topN = 1을 넘겨 일반 탐색을 수행한 것과 같다.
+	*/
+	template<class LmState>
+	Vector<PathEvaluator::ChunkResult> PathEvaluator::findBestPathTop1(const Kiwi* kw,
+		const Vector<SpecialState>& prevSpStates,
+		const KGraphNode* graph,
+		const size_t graphSize,
+		bool openEnd,
+		bool splitComplex,
+		const MorphemeSet* blocklist
+	)
+	{
+		using State = Top1LL<LmState>;
+		auto& states = AnalysisContext::Impl::current().get<scratch::Top1States<LmState>>();
+		states.clear();
+		Vector<uint32_t> nodeBegin(graphSize + 1);
+		Vector<U16StringView> ownFormList;
+		Vector<const Morpheme*> unknownNodeCands, unknownNodeLCands;
+
+		const size_t langVocabSize = kw->langMdl.knlm->getHeader().vocab_size;
+
+		const KGraphNode* startNode = graph;
+		const KGraphNode* endNode = graph + graphSize - 1;
+
+		unknownNodeCands.emplace_back(kw->getDefaultMorpheme(POSTag::nng));
+		unknownNodeCands.emplace_back(kw->getDefaultMorpheme(POSTag::nnp));
+		unknownNodeLCands.emplace_back(kw->getDefaultMorpheme(POSTag::nnp));
+
+		// start node
+		if (prevSpStates.empty())
+		{
+			states.emplace_back(&kw->morphemes[0], 0.f, 0.f, State::npos, 0, LmState{ kw->langMdl }, 0, SpecialState{});
+		}
+		else
+		{
+			auto uniqStates = prevSpStates;
+			sort(uniqStates.begin(), uniqStates.end());
+			uniqStates.erase(unique(uniqStates.begin(), uniqStates.end()), uniqStates.end());
+			for (auto& spState : uniqStates)
+			{
+				states.emplace_back(&kw->morphemes[0], 0.f, 0.f, State::npos, 0, LmState{ kw->langMdl }, (uint8_t)states.size(), spState);
+			}
+		}
+		for (auto& p : states) p.leftCondMask = leftCondMaskOf(kw->morphemes.data(), ownFormList, p);
+		nodeBegin[1] = states.size();
+		BeamController beam{ kw, graphSize, 1, nodeBegin[1] };
+
+		// middle nodes
+		for (size_t i = 1; i < graphSize - 1; ++i)
+		{
+			auto* node = &graph[i];
+			size_t ownFormId = 0;
+			if (!node->uform.empty())
+			{
+				ownFormList.emplace_back(node->uform);
+				ownFormId = ownFormList.size();
+			}
+
+			if (node->form)
+			{
+				evalPathTop1<LmState>(kw, startNode, node, states, nodeBegin, ownFormList, ownFormId, node->form->candidate, false, beam, splitComplex, blocklist);
+				if (all_of(node->form->candidate.begin(), node->form->candidate.end(), [](const Morpheme* m)
+				{
+					return m->combineSocket || (!m->chunks.empty() && !m->complex);
+				}))
+				{
+					ownFormList.emplace_back(node->form->form);
+					ownFormId = ownFormList.size();
+					evalPathTop1<LmState>(kw, startNode, node, states, nodeBegin, ownFormList, ownFormId, unknownNodeLCands, true, beam, splitComplex, blocklist);
+				};
+			}
+			else
+			{
+				evalPathTop1<LmState>(kw, startNode, node, states, nodeBegin, ownFormList, ownFormId, unknownNodeCands, true, beam, splitComplex, blocklist);
+			}
+			nodeBegin[i + 1] = states.size();
+		}
+
+		// end node: (rootId, spState)별로 최고 점수의 경로 하나씩만 남긴다
+		struct EndCand
+		{
+			uint8_t rootId, spState;
+			float score;
+			uint32_t index;
+		};
+		Vector<EndCand> ends;
+		for (auto prev = endNode->getPrev(); prev; prev = prev->getSibling())
+		{
+			const size_t prevId = prev - startNode;
+			for (size_t j = nodeBegin[prevId]; j < nodeBegin[prevId + 1]; ++j)
+			{
+				auto& p = states[j];
+				float c;
+				if (!evalEndPath<LmState>(c, kw, p, openEnd)) continue;
+				auto it = find_if(ends.begin(), ends.end(), [&](const EndCand& e)
+				{
+					return e.rootId == p.rootId && e.spState == (uint8_t)p.spState;
+				});
+				if (it == ends.end()) ends.emplace_back(EndCand{ p.rootId, (uint8_t)p.spState, c, (uint32_t)j });
+				else if (c > it->score)
+				{
+					it->score = c;
+					it->index = j;
+				}
+			}
+		}
+		sort(ends.begin(), ends.end(), [](const EndCand& a, const EndCand& b)
+		{
+			if (a.rootId != b.rootId) return a.rootId < b.rootId;
+			return a.spState < b.spState;
+		});
+
+		Vector<ChunkResult> ret;
+		Vector<uint32_t> steps;
+		for (auto& e : ends)
+		{
+			steps.clear();
+			uint32_t root = e.index;
+			for (; states[root].parent != State::npos; root = states[root].parent)
+			{
+				steps.emplace_back(root);
+			}
+
+			Path path;
+			const State* prev = &states[root];
+			for (auto it = steps.rbegin(); it != steps.rend(); ++it)
+			{
+				const State* cur = &states[*it];
+				appendStepTokens(path, cur, prev, graph[cur->nodeId], graph, ownFormList, kw->typoCostWeight, kw->morphemes.data(), langVocabSize);
+				prev = cur;
+			}
+			ret.emplace_back(move(path), e.score, states[root].spState, states[e.index].spState);
+		}
+		sort(ret.begin(), ret.end(), [](const ChunkResult& a, const ChunkResult& b)
+		{
+			return a.score > b.score;
+		});
+		if (ret.size() > 2) ret.erase(ret.begin() + 2, ret.end());
+		return ret;
+	}
 }
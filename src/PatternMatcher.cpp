@@ -3,6 +3,7 @@
 #include <kiwi/ScriptType.h>
 #include "pattern.hpp"
 #include "StrUtils.h"
+#include "TextKernels.h"
 
 using namespace std;
 using namespace kiwi;
@@ -21,7 +22,40 @@ namespace kiwi
 			pattern::CutSZCharSetParser<PP_GET_64(" \t\n\r\v\f", 0)>::type space;
 		} md;
 
+		/**
+		 * @brief ASCII 문자가 시작할 수 있는 패턴의 종류
+		 */
+		enum StartClass : uint8_t
+		{
+			startDigit = 1 << 0,
+			startAlpha = 1 << 1,
+			startEmail = 1 << 2,
+			startHashtag = 1 << 3,
+			startMention = 1 << 4,
+			startUrl = 1 << 5,
+		};
+		std::array<uint8_t, 128> startClasses = { { 0, } };
+
+		/**
+		 * @brief 같은 문자 구간 안에서 시작하는 패턴들이 공유하는 검사 결과를 기억해두는 캐시
+		 *
+		 * @details 구간 [begin, end)는 패턴의 첫 부분을 이루는 문자들의 최대 구간이다.
+		 * `matched`가 nullptr이면 구간 안의 어느 위치에서 시작하든 매칭에 실패한다.
+		 */
+		struct RunCache
+		{
+			const char16_t* begin = nullptr;
+			const char16_t* end = nullptr;
+			const char16_t* matched = nullptr;
+
+			bool contains(const char16_t* p) const
+			{
+				return begin <= p && p < end;
+			}
+		};
+
 		size_t testUrl(const char16_t* first, const char16_t* last) const;
+		const char16_t* testEmailDomain(const char16_t* b, const char16_t* last) const;
 		size_t testEmail(const char16_t* first, const char16_t* last) const;
 		size_t testHashtag(const char16_t* first, const char16_t* last) const;
 		size_t testMention(const char16_t* first, const char16_t* last) const;
@@ -30,8 +64,14 @@ namespace kiwi
 		size_t testAbbr(const char16_t* first, const char16_t* last) const;
 		size_t testEmoji(const char16_t* first, const char16_t* last) const;
 
+		size_t testEmailCached(const char16_t* first, const char16_t* last, RunCache& cache) const;
+		size_t testAbbrCached(const char16_t* first, const char16_t* last, RunCache& cache) const;
+
 	public:
+		PatternMatcherImpl();
+
 		std::pair<size_t, POSTag> match(char16_t left, const char16_t* first, const char16_t* last, Match matchOptions) const;
+		size_t findAll(const char16_t* str, size_t len, size_t from, size_t until, Match matchOptions, Vector<PatternSpan>& out, text::FnFindPatternCandidate findCandidate) const;
 	};
 
 	inline bool isAlpha(char16_t c)
@@ -50,6 +90,21 @@ namespace kiwi
 	}
 }
 
+PatternMatcherImpl::PatternMatcherImpl()
+{
+	for (char16_t c = 0; c < 128; ++c)
+	{
+		uint8_t cls = 0;
+		if (isDigit(c)) cls |= startDigit;
+		if (isAlpha(c)) cls |= startAlpha;
+		if (md.emailAccount.test(c)) cls |= startEmail;
+		if (c == '#') cls |= startHashtag;
+		if (c == '@') cls |= startMention;
+		if (c == 'h') cls |= startUrl;
+		startClasses[c] = cls;
+	}
+}
+
 size_t PatternMatcherImpl::testUrl(const char16_t * first, const char16_t * last) const
 {
 	// Pattern: https?://[-a-zA-Z0-9@:%._+~#=]{1,256}\.[a-zA-Z]{2,6}(:[0-9]+)?\b(/[-a-zA-Z0-9()@:%_+.~#!?&/=]*)?
@@ -115,25 +170,12 @@ size_t PatternMatcherImpl::testUrl(const char16_t * first, const char16_t * last
 	return b - first;
 }
 
-size_t PatternMatcherImpl::testEmail(const char16_t * first, const char16_t * last) const
+const char16_t* PatternMatcherImpl::testEmailDomain(const char16_t* b, const char16_t* last) const
 {
-	// Pattern: [A-Za-z0-9._%+-]+@[A-Za-z0-9.-]+\.[A-Za-z]{2,6}
-	
-	const char16_t* b = first;
-
-	// [A-Za-z0-9._%+-]+
-	if (b == last || !md.emailAccount.test(*b)) return 0;
-	++b;
-	while (b != last && md.emailAccount.test(*b)) ++b;
-	
-	// @
-	if (b == last || *b != '@') return 0;
-	++b;
-
 	// [A-Za-z0-9.-]+\.[A-Za-z]{2,6}
 	int state = 0;
-	const char16_t* lastMatched = first;
-	if (b == last || !md.alphaNumDotDash.test(*b)) return 0;
+	const char16_t* lastMatched = nullptr;
+	if (b == last || !md.alphaNumDotDash.test(*b)) return nullptr;
 	++b;
 	for (; b != last && md.alphaNumDotDash.test(*b); ++b)
 	{
@@ -145,8 +187,26 @@ size_t PatternMatcherImpl::testEmail(const char16_t * first, const char16_t * la
 		}
 		else state = 0;
 	}
+	return lastMatched;
+}
+
+size_t PatternMatcherImpl::testEmail(const char16_t * first, const char16_t * last) const
+{
+	// Pattern: [A-Za-z0-9._%+-]+@[A-Za-z0-9.-]+\.[A-Za-z]{2,6}
+	
+	const char16_t* b = first;
+
+	// [A-Za-z0-9._%+-]+
+	if (b == last || !md.emailAccount.test(*b)) return 0;
+	++b;
+	while (b != last && md.emailAccount.test(*b)) ++b;
+	
+	// @
+	if (b == last || *b != '@') return 0;
+	++b;
 
-	return lastMatched - first;
+	const char16_t* lastMatched = testEmailDomain(b, last);
+	return lastMatched ? lastMatched - first : 0;
 }
 
 size_t PatternMatcherImpl::testMention(const char16_t* first, const char16_t* last) const
@@ -378,8 +438,105 @@ pair<size_t, POSTag> PatternMatcherImpl::match(char16_t left, const char16_t * f
 	return make_pair(0, POSTag::unknown);
 }
 
+size_t PatternMatcherImpl::testEmailCached(const char16_t* first, const char16_t* last, RunCache& cache) const
+{
+	// 계정 부분이 같은 구간에서 시작하면 '@' 이후의 도메인 부분이 같으므로 매칭이 끝나는 위치도 같다
+	if (!cache.contains(first))
+	{
+		const char16_t* b = first + 1;
+		while (b != last && md.emailAccount.test(*b)) ++b;
+		cache.begin = first;
+		cache.end = b;
+		cache.matched = (b != last && *b == '@') ? testEmailDomain(b + 1, last) : nullptr;
+	}
+	return cache.matched ? cache.matched - first : 0;
+}
+
+size_t PatternMatcherImpl::testAbbrCached(const char16_t* first, const char16_t* last, RunCache& cache) const
+{
+	// 알파벳 구간 뒤에 '.'이 오지 않으면 구간 안의 어느 위치에서 시작하든 약어가 아니다
+	if (!cache.contains(first))
+	{
+		const char16_t* b = first + 1;
+		while (b != last && isAlpha(*b)) ++b;
+		cache.begin = first;
+		cache.end = b;
+		cache.matched = (b != last && *b == '.') ? b : nullptr;
+	}
+	return cache.matched ? testAbbr(first, last) : 0;
+}
+
+size_t PatternMatcherImpl::findAll(const char16_t* str, size_t len, size_t from, size_t until, Match matchOptions, Vector<PatternSpan>& out, text::FnFindPatternCandidate findCandidate) const
+{
+	const char16_t* const last = str + len;
+	const bool matchSerial = !!(matchOptions & Match::serial),
+		matchHashtag = !!(matchOptions & Match::hashtag),
+		matchEmail = !!(matchOptions & Match::email),
+		matchMention = !!(matchOptions & Match::mention),
+		matchUrl = !!(matchOptions & Match::url),
+		matchEmoji = !!(matchOptions & Match::emoji);
+	RunCache emailCache, abbrCache;
+
+	size_t n = from;
+	while (n < until)
+	{
+		n += findCandidate(str + n, until - n);
+		if (n >= until) break;
+
+		const char16_t* const first = str + n;
+		const char16_t c = *first;
+		size_t size = 0;
+		POSTag tag = POSTag::unknown;
+		// match()와 같은 우선순위로 검사하되, 첫 문자로 시작할 수 없는 패턴은 건너뛴다
+		if (c < 128)
+		{
+			const uint8_t cls = startClasses[c];
+			if ((cls & startDigit) && matchSerial && (size = testSerial(first, last))) tag = POSTag::w_serial;
+			else if ((cls & startDigit) && (size = testNumeric(n ? str[n - 1] : u' ', first, last))) tag = POSTag::sn;
+			else if ((cls & startHashtag) && matchHashtag && (size = testHashtag(first, last))) tag = POSTag::w_hashtag;
+			else if ((cls & startEmail) && matchEmail && (size = testEmailCached(first, last, emailCache))) tag = POSTag::w_email;
+			else if ((cls & startMention) && matchMention && (size = testMention(first, last))) tag = POSTag::w_mention;
+			else if ((cls & startUrl) && matchUrl && (size = testUrl(first, last))) tag = POSTag::w_url;
+			else if ((cls & startAlpha) && (size = testAbbrCached(first, last, abbrCache))) tag = POSTag::sl;
+		}
+		else if (isDigit(c))
+		{
+			if (matchSerial && (size = testSerial(first, last))) tag = POSTag::w_serial;
+			else if ((size = testNumeric(n ? str[n - 1] : u' ', first, last))) tag = POSTag::sn;
+		}
+		else if (matchEmoji && (size = testEmoji(first, last)))
+		{
+			tag = POSTag::w_emoji;
+		}
+
+		if (size)
+		{
+			out.emplace_back((uint32_t)n, (uint32_t)(n + size), tag);
+			n += size;
+		}
+		else
+		{
+			++n;
+		}
+	}
+	return n;
+}
+
+namespace kiwi
+{
+	inline const PatternMatcherImpl& getPatternMatcher()
+	{
+		static PatternMatcherImpl matcher;
+		return matcher;
+	}
+}
+
 pair<size_t, POSTag> kiwi::matchPattern(char16_t left, const char16_t* first, const char16_t* last, Match matchOptions)
 {
-	static PatternMatcherImpl matcher;
-	return matcher.match(left, first, last, matchOptions);
+	return getPatternMatcher().match(left, first, last, matchOptions);
+}
+
+size_t kiwi::findPatterns(const char16_t* str, size_t len, size_t from, size_t until, Match matchOptions, Vector<PatternSpan>& out, ArchType arch)
+{
+	return getPatternMatcher().findAll(str, len, from, min(until, len), matchOptions, out, text::getFindPatternCandidateFn(getSelectedArch(arch)));
 }
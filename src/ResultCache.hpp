@@ -0,0 +1,214 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <kiwi/Types.h>
+
+namespace kiwi
+{
+	inline size_t hashCombine(size_t h, size_t v)
+	{
+		return h ^ (v + 0x9e3779b9 + (h << 6) + (h >> 2));
+	}
+
+	/**
+	* @brief 키의 해시값에 따라 여러 샤드로 나뉘어 있는 LRU 캐시.
+	* @details 각 샤드는 별도의 mutex로 보호되므로 여러 스레드에서 동시에 접근할 수 있다.
+	* 메모리 예산은 샤드별로 균등하게 나누어 적용된다.
+	* `clear()`가 호출되면 세대 번호가 증가하며, 이전 세대에 조회를 시작한 값은 저장되지 않는다.
+	* Key는 `size_t hash() const`, `size_t bytes() const`와 `operator==`를 제공해야 한다.
+	*/
+	template<class Key, class Value>
+	class ShardedLruCache
+	{
+		struct Entry
+		{
+			size_t hash = 0;
+			Key key;
+			Value value;
+			size_t bytes = 0;
+		};
+
+		using EntryList = std::list<Entry>;
+
+		struct Shard
+		{
+			std::mutex mtx;
+			EntryList lru;
+			std::unordered_multimap<size_t, typename EntryList::iterator> index;
+			size_t bytes = 0;
+		};
+
+		static constexpr size_t numShards = 16;
+
+		std::unique_ptr<Shard[]> shards;
+		size_t budget = 0;
+		std::atomic<size_t> generation{ 0 };
+		std::atomic<size_t> hits{ 0 }, misses{ 0 };
+
+		Shard& shardOf(size_t hash) const
+		{
+			return shards[(hash >> 7) % numShards];
+		}
+
+		static typename EntryList::iterator findIn(Shard& shard, size_t hash, const Key& key)
+		{
+			auto range = shard.index.equal_range(hash);
+			for (auto it = range.first; it != range.second; ++it)
+			{
+				if (it->second->key == key) return it->second;
+			}
+			return shard.lru.end();
+		}
+
+		static void evictBack(Shard& shard)
+		{
+			auto last = std::prev(shard.lru.end());
+			auto range = shard.index.equal_range(last->hash);
+			for (auto it = range.first; it != range.second; ++it)
+			{
+				if (it->second == last)
+				{
+					shard.index.erase(it);
+					break;
+				}
+			}
+			shard.bytes -= last->bytes;
+			shard.lru.erase(last);
+		}
+
+	public:
+		ShardedLruCache(size_t _budget)
+			: shards{ new Shard[numShards] }, budget{ _budget }
+		{
+		}
+
+		size_t getBudget() const { return budget; }
+
+		/**
+		* @brief 캐시에서 값을 찾아 out에 복사한다.
+		* @param gen 조회 시점의 세대 번호. 이후 `insert()`에 그대로 전달해야 한다.
+		*/
+		bool find(const Key& key, Value& out, size_t& gen)
+		{
+			gen = generation.load();
+			const size_t hash = key.hash();
+			auto& shard = shardOf(hash);
+			{
+				std::lock_guard<std::mutex> lock{ shard.mtx };
+				auto it = findIn(shard, hash, key);
+				if (it != shard.lru.end())
+				{
+					shard.lru.splice(shard.lru.begin(), shard.lru, it);
+					out = it->value;
+					++hits;
+					return true;
+				}
+			}
+			++misses;
+			return false;
+		}
+
+		/**
+		* @param bytes 값이 차지하는 메모리의 추정치. 키와 항목 자체의 크기는 이 함수가 더한다.
+		*/
+		void insert(const Key& key, const Value& value, size_t bytes, size_t gen)
+		{
+			bytes += sizeof(Entry) + sizeof(void*) * 6 + key.bytes();
+			const size_t shardBudget = budget / numShards;
+			if (bytes > shardBudget) return;
+
+			const size_t hash = key.hash();
+			auto& shard = shardOf(hash);
+			std::lock_guard<std::mutex> lock{ shard.mtx };
+			if (gen != generation.load()) return;
+			if (findIn(shard, hash, key) != shard.lru.end()) return;
+
+			shard.lru.emplace_front();
+			auto& e = shard.lru.front();
+			e.hash = hash;
+			e.key = key;
+			e.value = value;
+			e.bytes = bytes;
+			shard.bytes += bytes;
+			shard.index.emplace(hash, shard.lru.begin());
+			while (shard.bytes > shardBudget) evictBack(shard);
+		}
+
+		void clear()
+		{
+			++generation;
+			for (size_t i = 0; i < numShards; ++i)
+			{
+				std::lock_guard<std::mutex> lock{ shards[i].mtx };
+				shards[i].lru.clear();
+				shards[i].index.clear();
+				shards[i].bytes = 0;
+			}
+		}
+
+		ResultCacheStats getStats() const
+		{
+			ResultCacheStats ret;
+			ret.hits = hits.load();
+			ret.misses = misses.load();
+			for (size_t i = 0; i < numShards; ++i)
+			{
+				std::lock_guard<std::mutex> lock{ shards[i].mtx };
+				ret.entries += shards[i].lru.size();
+				ret.bytes += shards[i].bytes;
+			}
+			return ret;
+		}
+	};
+
+	struct ResultCacheKey
+	{
+		std::u16string str;
+		size_t topN = 0;
+		Match matchOptions = Match::none;
+		std::vector<uint32_t> blocklist; /**< blocklist에 속한 형태소 id(오름차순) */
+
+		size_t hash() const
+		{
+			size_t h = std::hash<std::u16string>{}(str);
+			h = hashCombine(h, topN);
+			h = hashCombine(h, (size_t)matchOptions);
+			for (auto id : blocklist) h = hashCombine(h, id);
+			return h;
+		}
+
+		size_t bytes() const
+		{
+			return str.size() * sizeof(char16_t) + blocklist.size() * sizeof(uint32_t);
+		}
+
+		bool operator==(const ResultCacheKey& o) const
+		{
+			return topN == o.topN && matchOptions == o.matchOptions && blocklist == o.blocklist && str == o.str;
+		}
+	};
+
+	/**
+	* @brief `Kiwi::analyze`의 결과를 입력 문자열 및 분석 옵션별로 저장하는 캐시.
+	*/
+	class ResultCache : public ShardedLruCache<ResultCacheKey, std::vector<TokenResult>>
+	{
+	public:
+		using ShardedLruCache::ShardedLruCache;
+
+		static size_t estimateBytes(const std::vector<TokenResult>& result)
+		{
+			size_t bytes = 0;
+			for (auto& r : result)
+			{
+				bytes += sizeof(TokenResult) + r.first.size() * sizeof(TokenInfo);
+				for (auto& t : r.first) bytes += t.str.size() * sizeof(char16_t);
+			}
+			return bytes;
+		}
+	};
+}
@@ -1,337 +1,445 @@
+#include <algorithm>
+#include <array>
+#include <vector>
 #include <kiwi/ScriptType.h>
 
 namespace kiwi
 {
-    ScriptType chr2ScriptType(char32_t c) 
+    namespace detail
     {
-        if (('A' <= c && c <= 'Z') || ('a' <= c && c <= 'z')) return ScriptType::latin;
-        if (0x80 <= c && c <= 0xff) return ScriptType::latin;
-        if (0x100 <= c && c <= 0x17f) return ScriptType::latin;
-        if (0x180 <= c && c <= 0x24f) return ScriptType::latin;
-        if (0x1e00 <= c && c <= 0x1eff) return ScriptType::latin;
-        if (0x2c60 <= c && c <= 0x2c7f) return ScriptType::latin;
-        if (0xa720 <= c && c <= 0xa7ff) return ScriptType::latin;
-        if (0xab30 <= c && c <= 0xab6f) return ScriptType::latin;
-        if (0x10780 <= c && c <= 0x107bf) return ScriptType::latin;
-        if (0x1df00 <= c && c <= 0x1dfff) return ScriptType::latin;
-        if (0x250 <= c && c <= 0x2af) return ScriptType::ipa_extensions;
-        if (0x2b0 <= c && c <= 0x2ff) return ScriptType::spacing_modifier_letters;
-        if (0x300 <= c && c <= 0x36f) return ScriptType::combining_diacritical_marks;
-        if (0x1ab0 <= c && c <= 0x1aff) return ScriptType::combining_diacritical_marks;
-        if (0x1dc0 <= c && c <= 0x1dff) return ScriptType::combining_diacritical_marks;
-        if (0x370 <= c && c <= 0x3ff) return ScriptType::greek_and_coptic;
-        if (0x1f00 <= c && c <= 0x1fff) return ScriptType::greek_and_coptic;
-        if (0x2c80 <= c && c <= 0x2cff) return ScriptType::greek_and_coptic;
-        if (0x400 <= c && c <= 0x4ff) return ScriptType::cyrillic;
-        if (0x500 <= c && c <= 0x52f) return ScriptType::cyrillic;
-        if (0x1c80 <= c && c <= 0x1c8f) return ScriptType::cyrillic;
-        if (0x2de0 <= c && c <= 0x2dff) return ScriptType::cyrillic;
-        if (0xa640 <= c && c <= 0xa69f) return ScriptType::cyrillic;
-        if (0x1e030 <= c && c <= 0x1e08f) return ScriptType::cyrillic;
-        if (0x530 <= c && c <= 0x58f) return ScriptType::armenian;
-        if (0x590 <= c && c <= 0x5ff) return ScriptType::hebrew;
-        if (0x600 <= c && c <= 0x6ff) return ScriptType::arabic;
-        if (0x750 <= c && c <= 0x77f) return ScriptType::arabic;
-        if (0x870 <= c && c <= 0x89f) return ScriptType::arabic;
-        if (0x8a0 <= c && c <= 0x8ff) return ScriptType::arabic;
-        if (0x10ec0 <= c && c <= 0x10eff) return ScriptType::arabic;
-        if (0x700 <= c && c <= 0x74f) return ScriptType::syriac;
-        if (0x860 <= c && c <= 0x86f) return ScriptType::syriac;
-        if (0x780 <= c && c <= 0x7bf) return ScriptType::thaana;
-        if (0x7c0 <= c && c <= 0x7ff) return ScriptType::nko;
-        if (0x800 <= c && c <= 0x83f) return ScriptType::samaritan;
-        if (0x840 <= c && c <= 0x85f) return ScriptType::mandaic;
-        if (0x900 <= c && c <= 0x97f) return ScriptType::devanagari;
-        if (0x1cd0 <= c && c <= 0x1cff) return ScriptType::devanagari;
-        if (0xa8e0 <= c && c <= 0xa8ff) return ScriptType::devanagari;
-        if (0x11b00 <= c && c <= 0x11b5f) return ScriptType::devanagari;
-        if (0x980 <= c && c <= 0x9ff) return ScriptType::bengali;
-        if (0xa00 <= c && c <= 0xa7f) return ScriptType::gurmukhi;
-        if (0xa80 <= c && c <= 0xaff) return ScriptType::gujarati;
-        if (0xb00 <= c && c <= 0xb7f) return ScriptType::oriya;
-        if (0xb80 <= c && c <= 0xbff) return ScriptType::tamil;
-        if (0x11fc0 <= c && c <= 0x11fff) return ScriptType::tamil;
-        if (0xc00 <= c && c <= 0xc7f) return ScriptType::telugu;
-        if (0xc80 <= c && c <= 0xcff) return ScriptType::kannada;
-        if (0xd00 <= c && c <= 0xd7f) return ScriptType::malayalam;
-        if (0xd80 <= c && c <= 0xdff) return ScriptType::sinhala;
-        if (0xe00 <= c && c <= 0xe7f) return ScriptType::thai;
-        if (0xe80 <= c && c <= 0xeff) return ScriptType::lao;
-        if (0xf00 <= c && c <= 0xfff) return ScriptType::tibetan;
-        if (0x1000 <= c && c <= 0x109f) return ScriptType::myanmar;
-        if (0xa9e0 <= c && c <= 0xa9ff) return ScriptType::myanmar;
-        if (0xaa60 <= c && c <= 0xaa7f) return ScriptType::myanmar;
-        if (0x10a0 <= c && c <= 0x10ff) return ScriptType::georgian;
-        if (0x1c90 <= c && c <= 0x1cbf) return ScriptType::georgian;
-        if (0x2d00 <= c && c <= 0x2d2f) return ScriptType::georgian;
-        if (0x1100 <= c && c <= 0x11ff) return ScriptType::hangul;
-        if (0x3130 <= c && c <= 0x318f) return ScriptType::hangul;
-        if (0xa960 <= c && c <= 0xa97f) return ScriptType::hangul;
-        if (0xac00 <= c && c <= 0xd7af) return ScriptType::hangul;
-        if (0xd7b0 <= c && c <= 0xd7ff) return ScriptType::hangul;
-        if (0x1200 <= c && c <= 0x137f) return ScriptType::ethiopic;
-        if (0x1380 <= c && c <= 0x139f) return ScriptType::ethiopic;
-        if (0x2d80 <= c && c <= 0x2ddf) return ScriptType::ethiopic;
-        if (0xab00 <= c && c <= 0xab2f) return ScriptType::ethiopic;
-        if (0x1e7e0 <= c && c <= 0x1e7ff) return ScriptType::ethiopic;
-        if (0x13a0 <= c && c <= 0x13ff) return ScriptType::cherokee;
-        if (0xab70 <= c && c <= 0xabbf) return ScriptType::cherokee;
-        if (0x1400 <= c && c <= 0x167f) return ScriptType::unified_canadian_aboriginal_syllabics;
-        if (0x18b0 <= c && c <= 0x18ff) return ScriptType::unified_canadian_aboriginal_syllabics;
-        if (0x11ab0 <= c && c <= 0x11abf) return ScriptType::unified_canadian_aboriginal_syllabics;
-        if (0x1680 <= c && c <= 0x169f) return ScriptType::ogham;
-        if (0x16a0 <= c && c <= 0x16ff) return ScriptType::runic;
-        if (0x1700 <= c && c <= 0x171f) return ScriptType::tagalog;
-        if (0x1720 <= c && c <= 0x173f) return ScriptType::hanunoo;
-        if (0x1740 <= c && c <= 0x175f) return ScriptType::buhid;
-        if (0x1760 <= c && c <= 0x177f) return ScriptType::tagbanwa;
-        if (0x1780 <= c && c <= 0x17ff) return ScriptType::khmer;
-        if (0x1800 <= c && c <= 0x18af) return ScriptType::mongolian;
-        if (0x11660 <= c && c <= 0x1167f) return ScriptType::mongolian;
-        if (0x1900 <= c && c <= 0x194f) return ScriptType::limbu;
-        if (0x1950 <= c && c <= 0x197f) return ScriptType::tai_le;
-        if (0x1980 <= c && c <= 0x19df) return ScriptType::new_tai_lue;
-        if (0x19e0 <= c && c <= 0x19ff) return ScriptType::khmer_symbols;
-        if (0x1a00 <= c && c <= 0x1a1f) return ScriptType::buginese;
-        if (0x1a20 <= c && c <= 0x1aaf) return ScriptType::tai_tham;
-        if (0x1b00 <= c && c <= 0x1b7f) return ScriptType::balinese;
-        if (0x1b80 <= c && c <= 0x1bbf) return ScriptType::sundanese;
-        if (0x1cc0 <= c && c <= 0x1ccf) return ScriptType::sundanese;
-        if (0x1bc0 <= c && c <= 0x1bff) return ScriptType::batak;
-        if (0x1c00 <= c && c <= 0x1c4f) return ScriptType::lepcha;
-        if (0x1c50 <= c && c <= 0x1c7f) return ScriptType::ol_chiki;
-        if (0x1d00 <= c && c <= 0x1d7f) return ScriptType::phonetic_extensions;
-        if (0x1d80 <= c && c <= 0x1dbf) return ScriptType::phonetic_extensions;
-        if (0x2000 <= c && c <= 0x206f) return ScriptType::punctuation;
-        if (0x2e00 <= c && c <= 0x2e7f) return ScriptType::punctuation;
-        if (0x2070 <= c && c <= 0x209f) return ScriptType::superscripts_and_subscripts;
-        if (0x20a0 <= c && c <= 0x20cf) return ScriptType::currency_symbols;
-        if (0x20d0 <= c && c <= 0x20ff) return ScriptType::combining_diacritical_marks_for_symbols;
-        if (0x2100 <= c && c <= 0x214f) return ScriptType::letterlike_symbols;
-        if (0x2150 <= c && c <= 0x218f) return ScriptType::number_forms;
-        if (0x2190 <= c && c <= 0x21ff) return ScriptType::arrows;
-        if (0x27f0 <= c && c <= 0x27ff) return ScriptType::arrows;
-        if (0x2900 <= c && c <= 0x297f) return ScriptType::arrows;
-        if (0x2b00 <= c && c <= 0x2bff) return ScriptType::arrows;
-        if (0x1f800 <= c && c <= 0x1f8ff) return ScriptType::arrows;
-        if (0x2200 <= c && c <= 0x22ff) return ScriptType::mathematical;
-        if (0x27c0 <= c && c <= 0x27ef) return ScriptType::mathematical;
-        if (0x2980 <= c && c <= 0x29ff) return ScriptType::mathematical;
-        if (0x2a00 <= c && c <= 0x2aff) return ScriptType::mathematical;
-        if (0x2300 <= c && c <= 0x23ff) return ScriptType::miscellaneous_technical;
-        if (0x2400 <= c && c <= 0x243f) return ScriptType::control_pictures;
-        if (0x2440 <= c && c <= 0x245f) return ScriptType::optical_character_recognition;
-        if (0x2460 <= c && c <= 0x24ff) return ScriptType::enclosed_alphanumerics;
-        if (0x1f100 <= c && c <= 0x1f1ff) return ScriptType::enclosed_alphanumerics;
-        if (0x2500 <= c && c <= 0x257f) return ScriptType::box_drawing;
-        if (0x2580 <= c && c <= 0x259f) return ScriptType::block_elements;
-        if (0x25a0 <= c && c <= 0x25ff) return ScriptType::geometric_shapes;
-        if (0x1f780 <= c && c <= 0x1f7ff) return ScriptType::geometric_shapes;
-        if (0x2600 <= c && c <= 0x26ff) return ScriptType::miscellaneous_symbols;
-        if (0x2700 <= c && c <= 0x27bf) return ScriptType::dingbats;
-        if (0x1f650 <= c && c <= 0x1f67f) return ScriptType::dingbats;
-        if (0x2800 <= c && c <= 0x28ff) return ScriptType::braille_patterns;
-        if (0x2c00 <= c && c <= 0x2c5f) return ScriptType::glagolitic;
-        if (0x1e000 <= c && c <= 0x1e02f) return ScriptType::glagolitic;
-        if (0x2d30 <= c && c <= 0x2d7f) return ScriptType::tifinagh;
-        if (0x2e80 <= c && c <= 0x2eff) return ScriptType::hanja;
-        if (0x2f00 <= c && c <= 0x2fdf) return ScriptType::hanja;
-        if (0x3000 <= c && c <= 0x303f) return ScriptType::hanja;
-        if (0x31c0 <= c && c <= 0x31ef) return ScriptType::hanja;
-        if (0x3200 <= c && c <= 0x32ff) return ScriptType::hanja;
-        if (0x3300 <= c && c <= 0x33ff) return ScriptType::hanja;
-        if (0x3400 <= c && c <= 0x4dbf) return ScriptType::hanja;
-        if (0x4e00 <= c && c <= 0x9fff) return ScriptType::hanja;
-        if (0xf900 <= c && c <= 0xfaff) return ScriptType::hanja;
-        if (0xfe30 <= c && c <= 0xfe4f) return ScriptType::hanja;
-        if (0x20000 <= c && c <= 0x2a6df) return ScriptType::hanja;
-        if (0x2a700 <= c && c <= 0x2b73f) return ScriptType::hanja;
-        if (0x2b740 <= c && c <= 0x2b81f) return ScriptType::hanja;
-        if (0x2b820 <= c && c <= 0x2ceaf) return ScriptType::hanja;
-        if (0x2ceb0 <= c && c <= 0x2ebef) return ScriptType::hanja;
-        if (0x2ebf0 <= c && c <= 0x2ee5f) return ScriptType::hanja;
-        if (0x2f800 <= c && c <= 0x2fa1f) return ScriptType::hanja;
-        if (0x30000 <= c && c <= 0x3134f) return ScriptType::hanja;
-        if (0x31350 <= c && c <= 0x323af) return ScriptType::hanja;
-        if (0x2ff0 <= c && c <= 0x2fff) return ScriptType::ideographic_description_characters;
-        if (0x3040 <= c && c <= 0x309f) return ScriptType::kana;
-        if (0x30a0 <= c && c <= 0x30ff) return ScriptType::kana;
-        if (0x31f0 <= c && c <= 0x31ff) return ScriptType::kana;
-        if (0x1aff0 <= c && c <= 0x1afff) return ScriptType::kana;
-        if (0x1b000 <= c && c <= 0x1b0ff) return ScriptType::kana;
-        if (0x1b100 <= c && c <= 0x1b12f) return ScriptType::kana;
-        if (0x1b130 <= c && c <= 0x1b16f) return ScriptType::kana;
-        if (0x3100 <= c && c <= 0x312f) return ScriptType::bopomofo;
-        if (0x31a0 <= c && c <= 0x31bf) return ScriptType::bopomofo;
-        if (0x3190 <= c && c <= 0x319f) return ScriptType::kanbun;
-        if (0x4dc0 <= c && c <= 0x4dff) return ScriptType::yijing_hexagram_symbols;
-        if (0xa000 <= c && c <= 0xa48f) return ScriptType::yi;
-        if (0xa490 <= c && c <= 0xa4cf) return ScriptType::yi;
-        if (0xa4d0 <= c && c <= 0xa4ff) return ScriptType::lisu;
-        if (0x11fb0 <= c && c <= 0x11fbf) return ScriptType::lisu;
-        if (0xa500 <= c && c <= 0xa63f) return ScriptType::vai;
-        if (0xa6a0 <= c && c <= 0xa6ff) return ScriptType::bamum;
-        if (0x16800 <= c && c <= 0x16a3f) return ScriptType::bamum;
-        if (0xa700 <= c && c <= 0xa71f) return ScriptType::modifier_tone_letters;
-        if (0xa800 <= c && c <= 0xa82f) return ScriptType::syloti_nagri;
-        if (0xa830 <= c && c <= 0xa83f) return ScriptType::common_indic_number_forms;
-        if (0xa840 <= c && c <= 0xa87f) return ScriptType::phags_pa;
-        if (0xa880 <= c && c <= 0xa8df) return ScriptType::saurashtra;
-        if (0xa900 <= c && c <= 0xa92f) return ScriptType::kayah_li;
-        if (0xa930 <= c && c <= 0xa95f) return ScriptType::rejang;
-        if (0xa980 <= c && c <= 0xa9df) return ScriptType::javanese;
-        if (0xaa00 <= c && c <= 0xaa5f) return ScriptType::cham;
-        if (0xaa80 <= c && c <= 0xaadf) return ScriptType::tai_viet;
-        if (0xaae0 <= c && c <= 0xaaff) return ScriptType::meetei_mayek;
-        if (0xabc0 <= c && c <= 0xabff) return ScriptType::meetei_mayek;
-        if (0xe000 <= c && c <= 0xf8ff) return ScriptType::private_use_area;
-        if (0xf0000 <= c && c <= 0xfffff) return ScriptType::private_use_area;
-        if (0x100000 <= c && c <= 0x10ffff) return ScriptType::private_use_area;
-        if (0xfb00 <= c && c <= 0xfb4f) return ScriptType::alphabetic_presentation_forms;
-        if (0xfb50 <= c && c <= 0xfdff) return ScriptType::arabic_presentation_forms_a;
-        if (0xfe00 <= c && c <= 0xfe0f) return ScriptType::variation_selectors;
-        if (0xe0100 <= c && c <= 0xe01ef) return ScriptType::variation_selectors;
-        if (0xfe10 <= c && c <= 0xfe1f) return ScriptType::vertical_forms;
-        if (0xfe20 <= c && c <= 0xfe2f) return ScriptType::combining_half_marks;
-        if (0xfe50 <= c && c <= 0xfe6f) return ScriptType::small_form_variants;
-        if (0xfe70 <= c && c <= 0xfeff) return ScriptType::arabic_presentation_forms_b;
-        if (0xff00 <= c && c <= 0xffef) return ScriptType::halfwidth_and_fullwidth_forms;
-        if (0xfff0 <= c && c <= 0xffff) return ScriptType::specials;
-        if (0x10000 <= c && c <= 0x1007f) return ScriptType::linear_b;
-        if (0x10080 <= c && c <= 0x100ff) return ScriptType::linear_b;
-        if (0x10100 <= c && c <= 0x1013f) return ScriptType::aegean_numbers;
-        if (0x10140 <= c && c <= 0x1018f) return ScriptType::ancient_greek_numbers;
-        if (0x10190 <= c && c <= 0x101cf) return ScriptType::ancient_symbols;
-        if (0x101d0 <= c && c <= 0x101ff) return ScriptType::phaistos_disc;
-        if (0x10280 <= c && c <= 0x1029f) return ScriptType::lycian;
-        if (0x102a0 <= c && c <= 0x102df) return ScriptType::carian;
-        if (0x102e0 <= c && c <= 0x102ff) return ScriptType::coptic_epact_numbers;
-        if (0x10300 <= c && c <= 0x1032f) return ScriptType::old_italic;
-        if (0x10330 <= c && c <= 0x1034f) return ScriptType::gothic;
-        if (0x10350 <= c && c <= 0x1037f) return ScriptType::old_permic;
-        if (0x10380 <= c && c <= 0x1039f) return ScriptType::ugaritic;
-        if (0x103a0 <= c && c <= 0x103df) return ScriptType::old_persian;
-        if (0x10400 <= c && c <= 0x1044f) return ScriptType::deseret;
-        if (0x10450 <= c && c <= 0x1047f) return ScriptType::shavian;
-        if (0x10480 <= c && c <= 0x104af) return ScriptType::osmanya;
-        if (0x104b0 <= c && c <= 0x104ff) return ScriptType::osage;
-        if (0x10500 <= c && c <= 0x1052f) return ScriptType::elbasan;
-        if (0x10530 <= c && c <= 0x1056f) return ScriptType::caucasian_albanian;
-        if (0x10570 <= c && c <= 0x105bf) return ScriptType::vithkuqi;
-        if (0x10600 <= c && c <= 0x1077f) return ScriptType::linear_a;
-        if (0x10800 <= c && c <= 0x1083f) return ScriptType::cypriot_syllabary;
-        if (0x10840 <= c && c <= 0x1085f) return ScriptType::imperial_aramaic;
-        if (0x10860 <= c && c <= 0x1087f) return ScriptType::palmyrene;
-        if (0x10880 <= c && c <= 0x108af) return ScriptType::nabataean;
-        if (0x108e0 <= c && c <= 0x108ff) return ScriptType::hatran;
-        if (0x10900 <= c && c <= 0x1091f) return ScriptType::phoenician;
-        if (0x10920 <= c && c <= 0x1093f) return ScriptType::lydian;
-        if (0x10980 <= c && c <= 0x1099f) return ScriptType::meroitic_hieroglyphs;
-        if (0x109a0 <= c && c <= 0x109ff) return ScriptType::meroitic_cursive;
-        if (0x10a00 <= c && c <= 0x10a5f) return ScriptType::kharoshthi;
-        if (0x10a60 <= c && c <= 0x10a7f) return ScriptType::old_south_arabian;
-        if (0x10a80 <= c && c <= 0x10a9f) return ScriptType::old_north_arabian;
-        if (0x10ac0 <= c && c <= 0x10aff) return ScriptType::manichaean;
-        if (0x10b00 <= c && c <= 0x10b3f) return ScriptType::avestan;
-        if (0x10b40 <= c && c <= 0x10b5f) return ScriptType::inscriptional_parthian;
-        if (0x10b60 <= c && c <= 0x10b7f) return ScriptType::inscriptional_pahlavi;
-        if (0x10b80 <= c && c <= 0x10baf) return ScriptType::psalter_pahlavi;
-        if (0x10c00 <= c && c <= 0x10c4f) return ScriptType::old_turkic;
-        if (0x10c80 <= c && c <= 0x10cff) return ScriptType::old_hungarian;
-        if (0x10d00 <= c && c <= 0x10d3f) return ScriptType::hanifi_rohingya;
-        if (0x10e60 <= c && c <= 0x10e7f) return ScriptType::rumi_numeral_symbols;
-        if (0x10e80 <= c && c <= 0x10ebf) return ScriptType::yezidi;
-        if (0x10f00 <= c && c <= 0x10f2f) return ScriptType::old_sogdian;
-        if (0x10f30 <= c && c <= 0x10f6f) return ScriptType::sogdian;
-        if (0x10f70 <= c && c <= 0x10faf) return ScriptType::old_uyghur;
-        if (0x10fb0 <= c && c <= 0x10fdf) return ScriptType::chorasmian;
-        if (0x10fe0 <= c && c <= 0x10fff) return ScriptType::elymaic;
-        if (0x11000 <= c && c <= 0x1107f) return ScriptType::brahmi;
-        if (0x11080 <= c && c <= 0x110cf) return ScriptType::kaithi;
-        if (0x110d0 <= c && c <= 0x110ff) return ScriptType::sora_sompeng;
-        if (0x11100 <= c && c <= 0x1114f) return ScriptType::chakma;
-        if (0x11150 <= c && c <= 0x1117f) return ScriptType::mahajani;
-        if (0x11180 <= c && c <= 0x111df) return ScriptType::sharada;
-        if (0x111e0 <= c && c <= 0x111ff) return ScriptType::sinhala_archaic_numbers;
-        if (0x11200 <= c && c <= 0x1124f) return ScriptType::khojki;
-        if (0x11280 <= c && c <= 0x112af) return ScriptType::multani;
-        if (0x112b0 <= c && c <= 0x112ff) return ScriptType::khudawadi;
-        if (0x11300 <= c && c <= 0x1137f) return ScriptType::grantha;
-        if (0x11400 <= c && c <= 0x1147f) return ScriptType::newa;
-        if (0x11480 <= c && c <= 0x114df) return ScriptType::tirhuta;
-        if (0x11580 <= c && c <= 0x115ff) return ScriptType::siddham;
-        if (0x11600 <= c && c <= 0x1165f) return ScriptType::modi;
-        if (0x11680 <= c && c <= 0x116cf) return ScriptType::takri;
-        if (0x11700 <= c && c <= 0x1174f) return ScriptType::ahom;
-        if (0x11800 <= c && c <= 0x1184f) return ScriptType::dogra;
-        if (0x118a0 <= c && c <= 0x118ff) return ScriptType::warang_citi;
-        if (0x11900 <= c && c <= 0x1195f) return ScriptType::dives_akuru;
-        if (0x119a0 <= c && c <= 0x119ff) return ScriptType::nandinagari;
-        if (0x11a00 <= c && c <= 0x11a4f) return ScriptType::zanabazar_square;
-        if (0x11a50 <= c && c <= 0x11aaf) return ScriptType::soyombo;
-        if (0x11ac0 <= c && c <= 0x11aff) return ScriptType::pau_cin_hau;
-        if (0x11c00 <= c && c <= 0x11c6f) return ScriptType::bhaiksuki;
-        if (0x11c70 <= c && c <= 0x11cbf) return ScriptType::marchen;
-        if (0x11d00 <= c && c <= 0x11d5f) return ScriptType::masaram_gondi;
-        if (0x11d60 <= c && c <= 0x11daf) return ScriptType::gunjala_gondi;
-        if (0x11ee0 <= c && c <= 0x11eff) return ScriptType::makasar;
-        if (0x11f00 <= c && c <= 0x11f5f) return ScriptType::kawi;
-        if (0x12000 <= c && c <= 0x123ff) return ScriptType::cuneiform;
-        if (0x12400 <= c && c <= 0x1247f) return ScriptType::cuneiform;
-        if (0x12480 <= c && c <= 0x1254f) return ScriptType::early_dynastic_cuneiform;
-        if (0x12f90 <= c && c <= 0x12fff) return ScriptType::cypro_minoan;
-        if (0x13000 <= c && c <= 0x1342f) return ScriptType::egyptian_hieroglyphs;
-        if (0x13430 <= c && c <= 0x1345f) return ScriptType::egyptian_hieroglyphs;
-        if (0x14400 <= c && c <= 0x1467f) return ScriptType::anatolian_hieroglyphs;
-        if (0x16a40 <= c && c <= 0x16a6f) return ScriptType::mro;
-        if (0x16a70 <= c && c <= 0x16acf) return ScriptType::tangsa;
-        if (0x16ad0 <= c && c <= 0x16aff) return ScriptType::bassa_vah;
-        if (0x16b00 <= c && c <= 0x16b8f) return ScriptType::pahawh_hmong;
-        if (0x16e40 <= c && c <= 0x16e9f) return ScriptType::medefaidrin;
-        if (0x16f00 <= c && c <= 0x16f9f) return ScriptType::miao;
-        if (0x16fe0 <= c && c <= 0x16fff) return ScriptType::ideographic_symbols_and_punctuation;
-        if (0x17000 <= c && c <= 0x187ff) return ScriptType::tangut;
-        if (0x18800 <= c && c <= 0x18aff) return ScriptType::tangut;
-        if (0x18d00 <= c && c <= 0x18d7f) return ScriptType::tangut;
-        if (0x18b00 <= c && c <= 0x18cff) return ScriptType::khitan_small_script;
-        if (0x1b170 <= c && c <= 0x1b2ff) return ScriptType::nushu;
-        if (0x1bc00 <= c && c <= 0x1bc9f) return ScriptType::duployan;
-        if (0x1bca0 <= c && c <= 0x1bcaf) return ScriptType::shorthand_format_controls;
-        if (0x1cf00 <= c && c <= 0x1cfcf) return ScriptType::znamenny_musical_notation;
-        if (0x1d000 <= c && c <= 0x1d0ff) return ScriptType::byzantine_musical_symbols;
-        if (0x1d100 <= c && c <= 0x1d1ff) return ScriptType::musical_symbols;
-        if (0x1d200 <= c && c <= 0x1d24f) return ScriptType::ancient_greek_musical_notation;
-        if (0x1d2c0 <= c && c <= 0x1d2df) return ScriptType::kaktovik_numerals;
-        if (0x1d2e0 <= c && c <= 0x1d2ff) return ScriptType::mayan_numerals;
-        if (0x1d300 <= c && c <= 0x1d35f) return ScriptType::tai_xuan_jing_symbols;
-        if (0x1d360 <= c && c <= 0x1d37f) return ScriptType::counting_rod_numerals;
-        if (0x1d400 <= c && c <= 0x1d7ff) return ScriptType::mathematical_alphanumeric_symbols;
-        if (0x1d800 <= c && c <= 0x1daaf) return ScriptType::sutton_signwriting;
-        if (0x1e100 <= c && c <= 0x1e14f) return ScriptType::nyiakeng_puachue_hmong;
-        if (0x1e290 <= c && c <= 0x1e2bf) return ScriptType::toto;
-        if (0x1e2c0 <= c && c <= 0x1e2ff) return ScriptType::wancho;
-        if (0x1e4d0 <= c && c <= 0x1e4ff) return ScriptType::nag_mundari;
-        if (0x1e800 <= c && c <= 0x1e8df) return ScriptType::mende_kikakui;
-        if (0x1e900 <= c && c <= 0x1e95f) return ScriptType::adlam;
-        if (0x1ec70 <= c && c <= 0x1ecbf) return ScriptType::indic_siyaq_numbers;
-        if (0x1ed00 <= c && c <= 0x1ed4f) return ScriptType::ottoman_siyaq_numbers;
-        if (0x1ee00 <= c && c <= 0x1eeff) return ScriptType::arabic_mathematical_alphabetic_symbols;
-        if (0x1f000 <= c && c <= 0x1f02f) return ScriptType::mahjong_tiles;
-        if (0x1f030 <= c && c <= 0x1f09f) return ScriptType::domino_tiles;
-        if (0x1f0a0 <= c && c <= 0x1f0ff) return ScriptType::playing_cards;
-        if (0x1f200 <= c && c <= 0x1f2ff) return ScriptType::enclosed_ideographic_supplement;
-        if (0x1f300 <= c && c <= 0x1f5ff) return ScriptType::symbols_and_pictographs;
-        if (0x1f900 <= c && c <= 0x1f9ff) return ScriptType::symbols_and_pictographs;
-        if (0x1fa70 <= c && c <= 0x1faff) return ScriptType::symbols_and_pictographs;
-        if (0x1f600 <= c && c <= 0x1f64f) return ScriptType::emoticons;
-        if (0x1f680 <= c && c <= 0x1f6ff) return ScriptType::transport_and_map_symbols;
-        if (0x1f700 <= c && c <= 0x1f77f) return ScriptType::alchemical_symbols;
-        if (0x1fa00 <= c && c <= 0x1fa6f) return ScriptType::chess_symbols;
-        if (0x1fb00 <= c && c <= 0x1fbff) return ScriptType::symbols_for_legacy_computing;
-        if (0xe0000 <= c && c <= 0xe007f) return ScriptType::tags;
+        struct ScriptRange
+        {
+            char32_t first, last;
+            ScriptType type;
+        };
+
+        /**
+         * @brief ScriptType of each Unicode block. A character in several ranges takes the first one.
+         */
+        static constexpr ScriptRange scriptRanges[] = {
+        { 0x41, 0x5a, ScriptType::latin },
+        { 0x61, 0x7a, ScriptType::latin },
+        { 0x80, 0xff, ScriptType::latin },
+        { 0x100, 0x17f, ScriptType::latin },
+        { 0x180, 0x24f, ScriptType::latin },
+        { 0x1e00, 0x1eff, ScriptType::latin },
+        { 0x2c60, 0x2c7f, ScriptType::latin },
+        { 0xa720, 0xa7ff, ScriptType::latin },
+        { 0xab30, 0xab6f, ScriptType::latin },
+        { 0x10780, 0x107bf, ScriptType::latin },
+        { 0x1df00, 0x1dfff, ScriptType::latin },
+        { 0x250, 0x2af, ScriptType::ipa_extensions },
+        { 0x2b0, 0x2ff, ScriptType::spacing_modifier_letters },
+        { 0x300, 0x36f, ScriptType::combining_diacritical_marks },
+        { 0x1ab0, 0x1aff, ScriptType::combining_diacritical_marks },
+        { 0x1dc0, 0x1dff, ScriptType::combining_diacritical_marks },
+        { 0x370, 0x3ff, ScriptType::greek_and_coptic },
+        { 0x1f00, 0x1fff, ScriptType::greek_and_coptic },
+        { 0x2c80, 0x2cff, ScriptType::greek_and_coptic },
+        { 0x400, 0x4ff, ScriptType::cyrillic },
+        { 0x500, 0x52f, ScriptType::cyrillic },
+        { 0x1c80, 0x1c8f, ScriptType::cyrillic },
+        { 0x2de0, 0x2dff, ScriptType::cyrillic },
+        { 0xa640, 0xa69f, ScriptType::cyrillic },
+        { 0x1e030, 0x1e08f, ScriptType::cyrillic },
+        { 0x530, 0x58f, ScriptType::armenian },
+        { 0x590, 0x5ff, ScriptType::hebrew },
+        { 0x600, 0x6ff, ScriptType::arabic },
+        { 0x750, 0x77f, ScriptType::arabic },
+        { 0x870, 0x89f, ScriptType::arabic },
+        { 0x8a0, 0x8ff, ScriptType::arabic },
+        { 0x10ec0, 0x10eff, ScriptType::arabic },
+        { 0x700, 0x74f, ScriptType::syriac },
+        { 0x860, 0x86f, ScriptType::syriac },
+        { 0x780, 0x7bf, ScriptType::thaana },
+        { 0x7c0, 0x7ff, ScriptType::nko },
+        { 0x800, 0x83f, ScriptType::samaritan },
+        { 0x840, 0x85f, ScriptType::mandaic },
+        { 0x900, 0x97f, ScriptType::devanagari },
+        { 0x1cd0, 0x1cff, ScriptType::devanagari },
+        { 0xa8e0, 0xa8ff, ScriptType::devanagari },
+        { 0x11b00, 0x11b5f, ScriptType::devanagari },
+        { 0x980, 0x9ff, ScriptType::bengali },
+        { 0xa00, 0xa7f, ScriptType::gurmukhi },
+        { 0xa80, 0xaff, ScriptType::gujarati },
+        { 0xb00, 0xb7f, ScriptType::oriya },
+        { 0xb80, 0xbff, ScriptType::tamil },
+        { 0x11fc0, 0x11fff, ScriptType::tamil },
+        { 0xc00, 0xc7f, ScriptType::telugu },
+        { 0xc80, 0xcff, ScriptType::kannada },
+        { 0xd00, 0xd7f, ScriptType::malayalam },
+        { 0xd80, 0xdff, ScriptType::sinhala },
+        { 0xe00, 0xe7f, ScriptType::thai },
+        { 0xe80, 0xeff, ScriptType::lao },
+        { 0xf00, 0xfff, ScriptType::tibetan },
+        { 0x1000, 0x109f, ScriptType::myanmar },
+        { 0xa9e0, 0xa9ff, ScriptType::myanmar },
+        { 0xaa60, 0xaa7f, ScriptType::myanmar },
+        { 0x10a0, 0x10ff, ScriptType::georgian },
+        { 0x1c90, 0x1cbf, ScriptType::georgian },
+        { 0x2d00, 0x2d2f, ScriptType::georgian },
+        { 0x1100, 0x11ff, ScriptType::hangul },
+        { 0x3130, 0x318f, ScriptType::hangul },
+        { 0xa960, 0xa97f, ScriptType::hangul },
+        { 0xac00, 0xd7af, ScriptType::hangul },
+        { 0xd7b0, 0xd7ff, ScriptType::hangul },
+        { 0x1200, 0x137f, ScriptType::ethiopic },
+        { 0x1380, 0x139f, ScriptType::ethiopic },
+        { 0x2d80, 0x2ddf, ScriptType::ethiopic },
+        { 0xab00, 0xab2f, ScriptType::ethiopic },
+        { 0x1e7e0, 0x1e7ff, ScriptType::ethiopic },
+        { 0x13a0, 0x13ff, ScriptType::cherokee },
+        { 0xab70, 0xabbf, ScriptType::cherokee },
+        { 0x1400, 0x167f, ScriptType::unified_canadian_aboriginal_syllabics },
+        { 0x18b0, 0x18ff, ScriptType::unified_canadian_aboriginal_syllabics },
+        { 0x11ab0, 0x11abf, ScriptType::unified_canadian_aboriginal_syllabics },
+        { 0x1680, 0x169f, ScriptType::ogham },
+        { 0x16a0, 0x16ff, ScriptType::runic },
+        { 0x1700, 0x171f, ScriptType::tagalog },
+        { 0x1720, 0x173f, ScriptType::hanunoo },
+        { 0x1740, 0x175f, ScriptType::buhid },
+        { 0x1760, 0x177f, ScriptType::tagbanwa },
+        { 0x1780, 0x17ff, ScriptType::khmer },
+        { 0x1800, 0x18af, ScriptType::mongolian },
+        { 0x11660, 0x1167f, ScriptType::mongolian },
+        { 0x1900, 0x194f, ScriptType::limbu },
+        { 0x1950, 0x197f, ScriptType::tai_le },
+        { 0x1980, 0x19df, ScriptType::new_tai_lue },
+        { 0x19e0, 0x19ff, ScriptType::khmer_symbols },
+        { 0x1a00, 0x1a1f, ScriptType::buginese },
+        { 0x1a20, 0x1aaf, ScriptType::tai_tham },
+        { 0x1b00, 0x1b7f, ScriptType::balinese },
+        { 0x1b80, 0x1bbf, ScriptType::sundanese },
+        { 0x1cc0, 0x1ccf, ScriptType::sundanese },
+        { 0x1bc0, 0x1bff, ScriptType::batak },
+        { 0x1c00, 0x1c4f, ScriptType::lepcha },
+        { 0x1c50, 0x1c7f, ScriptType::ol_chiki },
+        { 0x1d00, 0x1d7f, ScriptType::phonetic_extensions },
+        { 0x1d80, 0x1dbf, ScriptType::phonetic_extensions },
+        { 0x2000, 0x206f, ScriptType::punctuation },
+        { 0x2e00, 0x2e7f, ScriptType::punctuation },
+        { 0x2070, 0x209f, ScriptType::superscripts_and_subscripts },
+        { 0x20a0, 0x20cf, ScriptType::currency_symbols },
+        { 0x20d0, 0x20ff, ScriptType::combining_diacritical_marks_for_symbols },
+        { 0x2100, 0x214f, ScriptType::letterlike_symbols },
+        { 0x2150, 0x218f, ScriptType::number_forms },
+        { 0x2190, 0x21ff, ScriptType::arrows },
+        { 0x27f0, 0x27ff, ScriptType::arrows },
+        { 0x2900, 0x297f, ScriptType::arrows },
+        { 0x2b00, 0x2bff, ScriptType::arrows },
+        { 0x1f800, 0x1f8ff, ScriptType::arrows },
+        { 0x2200, 0x22ff, ScriptType::mathematical },
+        { 0x27c0, 0x27ef, ScriptType::mathematical },
+        { 0x2980, 0x29ff, ScriptType::mathematical },
+        { 0x2a00, 0x2aff, ScriptType::mathematical },
+        { 0x2300, 0x23ff, ScriptType::miscellaneous_technical },
+        { 0x2400, 0x243f, ScriptType::control_pictures },
+        { 0x2440, 0x245f, ScriptType::optical_character_recognition },
+        { 0x2460, 0x24ff, ScriptType::enclosed_alphanumerics },
+        { 0x1f100, 0x1f1ff, ScriptType::enclosed_alphanumerics },
+        { 0x2500, 0x257f, ScriptType::box_drawing },
+        { 0x2580, 0x259f, ScriptType::block_elements },
+        { 0x25a0, 0x25ff, ScriptType::geometric_shapes },
+        { 0x1f780, 0x1f7ff, ScriptType::geometric_shapes },
+        { 0x2600, 0x26ff, ScriptType::miscellaneous_symbols },
+        { 0x2700, 0x27bf, ScriptType::dingbats },
+        { 0x1f650, 0x1f67f, ScriptType::dingbats },
+        { 0x2800, 0x28ff, ScriptType::braille_patterns },
+        { 0x2c00, 0x2c5f, ScriptType::glagolitic },
+        { 0x1e000, 0x1e02f, ScriptType::glagolitic },
+        { 0x2d30, 0x2d7f, ScriptType::tifinagh },
+        { 0x2e80, 0x2eff, ScriptType::hanja },
+        { 0x2f00, 0x2fdf, ScriptType::hanja },
+        { 0x3000, 0x303f, ScriptType::hanja },
+        { 0x31c0, 0x31ef, ScriptType::hanja },
+        { 0x3200, 0x32ff, ScriptType::hanja },
+        { 0x3300, 0x33ff, ScriptType::hanja },
+        { 0x3400, 0x4dbf, ScriptType::hanja },
+        { 0x4e00, 0x9fff, ScriptType::hanja },
+        { 0xf900, 0xfaff, ScriptType::hanja },
+        { 0xfe30, 0xfe4f, ScriptType::hanja },
+        { 0x20000, 0x2a6df, ScriptType::hanja },
+        { 0x2a700, 0x2b73f, ScriptType::hanja },
+        { 0x2b740, 0x2b81f, ScriptType::hanja },
+        { 0x2b820, 0x2ceaf, ScriptType::hanja },
+        { 0x2ceb0, 0x2ebef, ScriptType::hanja },
+        { 0x2ebf0, 0x2ee5f, ScriptType::hanja },
+        { 0x2f800, 0x2fa1f, ScriptType::hanja },
+        { 0x30000, 0x3134f, ScriptType::hanja },
+        { 0x31350, 0x323af, ScriptType::hanja },
+        { 0x2ff0, 0x2fff, ScriptType::ideographic_description_characters },
+        { 0x3040, 0x309f, ScriptType::kana },
+        { 0x30a0, 0x30ff, ScriptType::kana },
+        { 0x31f0, 0x31ff, ScriptType::kana },
+        { 0x1aff0, 0x1afff, ScriptType::kana },
+        { 0x1b000, 0x1b0ff, ScriptType::kana },
+        { 0x1b100, 0x1b12f, ScriptType::kana },
+        { 0x1b130, 0x1b16f, ScriptType::kana },
+        { 0x3100, 0x312f, ScriptType::bopomofo },
+        { 0x31a0, 0x31bf, ScriptType::bopomofo },
+        { 0x3190, 0x319f, ScriptType::kanbun },
+        { 0x4dc0, 0x4dff, ScriptType::yijing_hexagram_symbols },
+        { 0xa000, 0xa48f, ScriptType::yi },
+        { 0xa490, 0xa4cf, ScriptType::yi },
+        { 0xa4d0, 0xa4ff, ScriptType::lisu },
+        { 0x11fb0, 0x11fbf, ScriptType::lisu },
+        { 0xa500, 0xa63f, ScriptType::vai },
+        { 0xa6a0, 0xa6ff, ScriptType::bamum },
+        { 0x16800, 0x16a3f, ScriptType::bamum },
+        { 0xa700, 0xa71f, ScriptType::modifier_tone_letters },
+        { 0xa800, 0xa82f, ScriptType::syloti_nagri },
+        { 0xa830, 0xa83f, ScriptType::common_indic_number_forms },
+        { 0xa840, 0xa87f, ScriptType::phags_pa },
+        { 0xa880, 0xa8df, ScriptType::saurashtra },
+        { 0xa900, 0xa92f, ScriptType::kayah_li },
+        { 0xa930, 0xa95f, ScriptType::rejang },
+        { 0xa980, 0xa9df, ScriptType::javanese },
+        { 0xaa00, 0xaa5f, ScriptType::cham },
+        { 0xaa80, 0xaadf, ScriptType::tai_viet },
+        { 0xaae0, 0xaaff, ScriptType::meetei_mayek },
+        { 0xabc0, 0xabff, ScriptType::meetei_mayek },
+        { 0xe000, 0xf8ff, ScriptType::private_use_area },
+        { 0xf0000, 0xfffff, ScriptType::private_use_area },
+        { 0x100000, 0x10ffff, ScriptType::private_use_area },
+        { 0xfb00, 0xfb4f, ScriptType::alphabetic_presentation_forms },
+        { 0xfb50, 0xfdff, ScriptType::arabic_presentation_forms_a },
+        { 0xfe00, 0xfe0f, ScriptType::variation_selectors },
+        { 0xe0100, 0xe01ef, ScriptType::variation_selectors },
+        { 0xfe10, 0xfe1f, ScriptType::vertical_forms },
+        { 0xfe20, 0xfe2f, ScriptType::combining_half_marks },
+        { 0xfe50, 0xfe6f, ScriptType::small_form_variants },
+        { 0xfe70, 0xfeff, ScriptType::arabic_presentation_forms_b },
+        { 0xff00, 0xffef, ScriptType::halfwidth_and_fullwidth_forms },
+        { 0xfff0, 0xffff, ScriptType::specials },
+        { 0x10000, 0x1007f, ScriptType::linear_b },
+        { 0x10080, 0x100ff, ScriptType::linear_b },
+        { 0x10100, 0x1013f, ScriptType::aegean_numbers },
+        { 0x10140, 0x1018f, ScriptType::ancient_greek_numbers },
+        { 0x10190, 0x101cf, ScriptType::ancient_symbols },
+        { 0x101d0, 0x101ff, ScriptType::phaistos_disc },
+        { 0x10280, 0x1029f, ScriptType::lycian },
+        { 0x102a0, 0x102df, ScriptType::carian },
+        { 0x102e0, 0x102ff, ScriptType::coptic_epact_numbers },
+        { 0x10300, 0x1032f, ScriptType::old_italic },
+        { 0x10330, 0x1034f, ScriptType::gothic },
+        { 0x10350, 0x1037f, ScriptType::old_permic },
+        { 0x10380, 0x1039f, ScriptType::ugaritic },
+        { 0x103a0, 0x103df, ScriptType::old_persian },
+        { 0x10400, 0x1044f, ScriptType::deseret },
+        { 0x10450, 0x1047f, ScriptType::shavian },
+        { 0x10480, 0x104af, ScriptType::osmanya },
+        { 0x104b0, 0x104ff, ScriptType::osage },
+        { 0x10500, 0x1052f, ScriptType::elbasan },
+        { 0x10530, 0x1056f, ScriptType::caucasian_albanian },
+        { 0x10570, 0x105bf, ScriptType::vithkuqi },
+        { 0x10600, 0x1077f, ScriptType::linear_a },
+        { 0x10800, 0x1083f, ScriptType::cypriot_syllabary },
+        { 0x10840, 0x1085f, ScriptType::imperial_aramaic },
+        { 0x10860, 0x1087f, ScriptType::palmyrene },
+        { 0x10880, 0x108af, ScriptType::nabataean },
+        { 0x108e0, 0x108ff, ScriptType::hatran },
+        { 0x10900, 0x1091f, ScriptType::phoenician },
+        { 0x10920, 0x1093f, ScriptType::lydian },
+        { 0x10980, 0x1099f, ScriptType::meroitic_hieroglyphs },
+        { 0x109a0, 0x109ff, ScriptType::meroitic_cursive },
+        { 0x10a00, 0x10a5f, ScriptType::kharoshthi },
+        { 0x10a60, 0x10a7f, ScriptType::old_south_arabian },
+        { 0x10a80, 0x10a9f, ScriptType::old_north_arabian },
+        { 0x10ac0, 0x10aff, ScriptType::manichaean },
+        { 0x10b00, 0x10b3f, ScriptType::avestan },
+        { 0x10b40, 0x10b5f, ScriptType::inscriptional_parthian },
+        { 0x10b60, 0x10b7f, ScriptType::inscriptional_pahlavi },
+        { 0x10b80, 0x10baf, ScriptType::psalter_pahlavi },
+        { 0x10c00, 0x10c4f, ScriptType::old_turkic },
+        { 0x10c80, 0x10cff, ScriptType::old_hungarian },
+        { 0x10d00, 0x10d3f, ScriptType::hanifi_rohingya },
+        { 0x10e60, 0x10e7f, ScriptType::rumi_numeral_symbols },
+        { 0x10e80, 0x10ebf, ScriptType::yezidi },
+        { 0x10f00, 0x10f2f, ScriptType::old_sogdian },
+        { 0x10f30, 0x10f6f, ScriptType::sogdian },
+        { 0x10f70, 0x10faf, ScriptType::old_uyghur },
+        { 0x10fb0, 0x10fdf, ScriptType::chorasmian },
+        { 0x10fe0, 0x10fff, ScriptType::elymaic },
+        { 0x11000, 0x1107f, ScriptType::brahmi },
+        { 0x11080, 0x110cf, ScriptType::kaithi },
+        { 0x110d0, 0x110ff, ScriptType::sora_sompeng },
+        { 0x11100, 0x1114f, ScriptType::chakma },
+        { 0x11150, 0x1117f, ScriptType::mahajani },
+        { 0x11180, 0x111df, ScriptType::sharada },
+        { 0x111e0, 0x111ff, ScriptType::sinhala_archaic_numbers },
+        { 0x11200, 0x1124f, ScriptType::khojki },
+        { 0x11280, 0x112af, ScriptType::multani },
+        { 0x112b0, 0x112ff, ScriptType::khudawadi },
+        { 0x11300, 0x1137f, ScriptType::grantha },
+        { 0x11400, 0x1147f, ScriptType::newa },
+        { 0x11480, 0x114df, ScriptType::tirhuta },
+        { 0x11580, 0x115ff, ScriptType::siddham },
+        { 0x11600, 0x1165f, ScriptType::modi },
+        { 0x11680, 0x116cf, ScriptType::takri },
+        { 0x11700, 0x1174f, ScriptType::ahom },
+        { 0x11800, 0x1184f, ScriptType::dogra },
+        { 0x118a0, 0x118ff, ScriptType::warang_citi },
+        { 0x11900, 0x1195f, ScriptType::dives_akuru },
+        { 0x119a0, 0x119ff, ScriptType::nandinagari },
+        { 0x11a00, 0x11a4f, ScriptType::zanabazar_square },
+        { 0x11a50, 0x11aaf, ScriptType::soyombo },
+        { 0x11ac0, 0x11aff, ScriptType::pau_cin_hau },
+        { 0x11c00, 0x11c6f, ScriptType::bhaiksuki },
+        { 0x11c70, 0x11cbf, ScriptType::marchen },
+        { 0x11d00, 0x11d5f, ScriptType::masaram_gondi },
+        { 0x11d60, 0x11daf, ScriptType::gunjala_gondi },
+        { 0x11ee0, 0x11eff, ScriptType::makasar },
+        { 0x11f00, 0x11f5f, ScriptType::kawi },
+        { 0x12000, 0x123ff, ScriptType::cuneiform },
+        { 0x12400, 0x1247f, ScriptType::cuneiform },
+        { 0x12480, 0x1254f, ScriptType::early_dynastic_cuneiform },
+        { 0x12f90, 0x12fff, ScriptType::cypro_minoan },
+        { 0x13000, 0x1342f, ScriptType::egyptian_hieroglyphs },
+        { 0x13430, 0x1345f, ScriptType::egyptian_hieroglyphs },
+        { 0x14400, 0x1467f, ScriptType::anatolian_hieroglyphs },
+        { 0x16a40, 0x16a6f, ScriptType::mro },
+        { 0x16a70, 0x16acf, ScriptType::tangsa },
+        { 0x16ad0, 0x16aff, ScriptType::bassa_vah },
+        { 0x16b00, 0x16b8f, ScriptType::pahawh_hmong },
+        { 0x16e40, 0x16e9f, ScriptType::medefaidrin },
+        { 0x16f00, 0x16f9f, ScriptType::miao },
+        { 0x16fe0, 0x16fff, ScriptType::ideographic_symbols_and_punctuation },
+        { 0x17000, 0x187ff, ScriptType::tangut },
+        { 0x18800, 0x18aff, ScriptType::tangut },
+        { 0x18d00, 0x18d7f, ScriptType::tangut },
+        { 0x18b00, 0x18cff, ScriptType::khitan_small_script },
+        { 0x1b170, 0x1b2ff, ScriptType::nushu },
+        { 0x1bc00, 0x1bc9f, ScriptType::duployan },
+        { 0x1bca0, 0x1bcaf, ScriptType::shorthand_format_controls },
+        { 0x1cf00, 0x1cfcf, ScriptType::znamenny_musical_notation },
+        { 0x1d000, 0x1d0ff, ScriptType::byzantine_musical_symbols },
+        { 0x1d100, 0x1d1ff, ScriptType::musical_symbols },
+        { 0x1d200, 0x1d24f, ScriptType::ancient_greek_musical_notation },
+        { 0x1d2c0, 0x1d2df, ScriptType::kaktovik_numerals },
+        { 0x1d2e0, 0x1d2ff, ScriptType::mayan_numerals },
+        { 0x1d300, 0x1d35f, ScriptType::tai_xuan_jing_symbols },
+        { 0x1d360, 0x1d37f, ScriptType::counting_rod_numerals },
+        { 0x1d400, 0x1d7ff, ScriptType::mathematical_alphanumeric_symbols },
+        { 0x1d800, 0x1daaf, ScriptType::sutton_signwriting },
+        { 0x1e100, 0x1e14f, ScriptType::nyiakeng_puachue_hmong },
+        { 0x1e290, 0x1e2bf, ScriptType::toto },
+        { 0x1e2c0, 0x1e2ff, ScriptType::wancho },
+        { 0x1e4d0, 0x1e4ff, ScriptType::nag_mundari },
+        { 0x1e800, 0x1e8df, ScriptType::mende_kikakui },
+        { 0x1e900, 0x1e95f, ScriptType::adlam },
+        { 0x1ec70, 0x1ecbf, ScriptType::indic_siyaq_numbers },
+        { 0x1ed00, 0x1ed4f, ScriptType::ottoman_siyaq_numbers },
+        { 0x1ee00, 0x1eeff, ScriptType::arabic_mathematical_alphabetic_symbols },
+        { 0x1f000, 0x1f02f, ScriptType::mahjong_tiles },
+        { 0x1f030, 0x1f09f, ScriptType::domino_tiles },
+        { 0x1f0a0, 0x1f0ff, ScriptType::playing_cards },
+        { 0x1f200, 0x1f2ff, ScriptType::enclosed_ideographic_supplement },
+        { 0x1f300, 0x1f5ff, ScriptType::symbols_and_pictographs },
+        { 0x1f900, 0x1f9ff, ScriptType::symbols_and_pictographs },
+        { 0x1fa70, 0x1faff, ScriptType::symbols_and_pictographs },
+        { 0x1f600, 0x1f64f, ScriptType::emoticons },
+        { 0x1f680, 0x1f6ff, ScriptType::transport_and_map_symbols },
+        { 0x1f700, 0x1f77f, ScriptType::alchemical_symbols },
+        { 0x1fa00, 0x1fa6f, ScriptType::chess_symbols },
+        { 0x1fb00, 0x1fbff, ScriptType::symbols_for_legacy_computing },
+        { 0xe0000, 0xe007f, ScriptType::tags },
+        };
+
+        /**
+         * @brief Lookup table behind chr2ScriptType.
+         * 
+         * The BMP is split into pages of 256 characters and identical pages are stored once.
+         * Supplementary planes are looked up by binary search over non-overlapping ranges.
+         */
+        class ScriptTable
+        {
+            static constexpr size_t pageBits = 8;
+            static constexpr size_t pageSize = (size_t)1 << pageBits;
+
+            std::array<uint8_t, 0x10000 / pageSize> pageIndex;
+            std::vector<std::array<ScriptType, pageSize>> pages;
+            std::vector<ScriptRange> supplementary;
+
+        public:
+            ScriptTable()
+            {
+                std::vector<ScriptType> bmp(0x10000, ScriptType::unknown);
+                std::vector<char32_t> bounds;
+                for (size_t i = std::end(scriptRanges) - std::begin(scriptRanges); i-- > 0;)
+                {
+                    auto& r = scriptRanges[i];
+                    if (r.first < 0x10000)
+                    {
+                        // paint from the last range so that earlier ranges take precedence
+                        std::fill(bmp.begin() + r.first, bmp.begin() + std::min(r.last, (char32_t)0xFFFF) + 1, r.type);
+                    }
+                    if (r.last >= 0x10000)
+                    {
+                        bounds.emplace_back(std::max(r.first, (char32_t)0x10000));
+                        bounds.emplace_back(r.last + 1);
+                    }
+                }
+
+                for (size_t p = 0; p < pageIndex.size(); ++p)
+                {
+                    std::array<ScriptType, pageSize> page;
+                    std::copy(bmp.begin() + p * pageSize, bmp.begin() + (p + 1) * pageSize, page.begin());
+                    auto it = std::find(pages.begin(), pages.end(), page);
+                    pageIndex[p] = (uint8_t)(it - pages.begin());
+                    if (it == pages.end()) pages.emplace_back(page);
+                }
+
+                // resolve each segment between bounds and merge adjacent segments of the same type
+                std::sort(bounds.begin(), bounds.end());
+                bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+                for (size_t i = 0; i + 1 < bounds.size(); ++i)
+                {
+                    const ScriptType type = chr2ScriptTypeByRanges(bounds[i]);
+                    if (type == ScriptType::unknown) continue;
+                    if (!supplementary.empty() && supplementary.back().last + 1 == bounds[i] && supplementary.back().type == type)
+                    {
+                        supplementary.back().last = bounds[i + 1] - 1;
+                    }
+                    else
+                    {
+                        supplementary.push_back(ScriptRange{ bounds[i], bounds[i + 1] - 1, type });
+                    }
+                }
+            }
+
+            ScriptType operator[](char32_t c) const
+            {
+                if (c < 0x10000) return pages[pageIndex[c >> pageBits]][c & (pageSize - 1)];
+
+                auto it = std::upper_bound(supplementary.begin(), supplementary.end(), c, [](char32_t c, const ScriptRange& r)
+                {
+                    return c < r.first;
+                });
+                if (it == supplementary.begin()) return ScriptType::unknown;
+                --it;
+                return c <= it->last ? it->type : ScriptType::unknown;
+            }
+        };
+    }
+
+    ScriptType chr2ScriptTypeByRanges(char32_t c)
+    {
+        for (auto& r : detail::scriptRanges)
+        {
+            if (r.first <= c && c <= r.last) return r.type;
+        }
         return ScriptType::unknown;
     }
 
+    ScriptType chr2ScriptType(char32_t c) 
+    {
+        // ASCII is either a Latin letter (ScriptType::latin == 1) or unknown (== 0)
+        if (c < 0x80) return static_cast<ScriptType>((uint32_t)((c | 0x20) - 'a') < 26);
+
+        static const detail::ScriptTable table;
+        return table[c];
+    }
+
     const char* getScriptName(ScriptType type) 
     {
         if (type == ScriptType::latin) return "Latin";
@@ -14,42 +14,83 @@ namespace kiwi
 		template<ArchType arch, class KeyType, size_t windowSize>
 		class SkipBigramModel : public SkipBigramModelBase
 		{
-			std::unique_ptr<size_t[]> ptrs;
+			std::unique_ptr<uint64_t[]> ownedPtrs;
 			std::unique_ptr<float[]> restoredFloats;
-			std::unique_ptr<KeyType[]> keyData;
-			std::unique_ptr<uint8_t[]> vocabValidness;
+			std::unique_ptr<KeyType[]> ownedKeyData;
+			std::unique_ptr<uint8_t[]> ownedVocabValidness;
+			const uint64_t* ptrs = nullptr;
+			const KeyType* keyData = nullptr;
+			const uint8_t* vocabValidness = nullptr;
 			const float* discnts = nullptr;
 			const float* compensations = nullptr;
 			float logWindowSize;
+
+			void loadRuntimeLayout()
+			{
+				auto* ptr = reinterpret_cast<const char*>(base.get());
+				auto& header = getHeader();
+				if (base.size() < sizeof(Header) + sizeof(RuntimeHeader))
+				{
+					throw std::runtime_error{ "Invalid runtime layout of the skipbigram model." };
+				}
+				auto& rheader = *reinterpret_cast<const RuntimeHeader*>(ptr + sizeof(Header));
+				if (rheader.archType != static_cast<uint32_t>(arch))
+				{
+					throw std::runtime_error{ std::string{ "The skipbigram model was laid out for " }
+						+ archToStr(static_cast<ArchType>(rheader.archType))
+						+ ", but " + archToStr(arch) + " is required." };
+				}
+				if (header.keySize != sizeof(KeyType) || base.size() < rheader.validnessOffset + header.vocabSize)
+				{
+					throw std::runtime_error{ "Invalid runtime layout of the skipbigram model." };
+				}
+
+				ptrs = reinterpret_cast<const uint64_t*>(ptr + rheader.ptrOffset);
+				keyData = reinterpret_cast<const KeyType*>(ptr + rheader.keyOffset);
+				discnts = reinterpret_cast<const float*>(ptr + rheader.discntOffset);
+				compensations = reinterpret_cast<const float*>(ptr + rheader.compensationOffset);
+				vocabValidness = reinterpret_cast<const uint8_t*>(ptr + rheader.validnessOffset);
+			}
+
 		public:
 			SkipBigramModel(utils::MemoryObject&& mem) : SkipBigramModelBase{ std::move(mem) }
 			{
-				auto* ptr = reinterpret_cast<const char*>(base.get());
 				auto& header = getHeader();
+				logWindowSize = std::log((float)header.windowSize);
+				if (isRuntimeLayout())
+				{
+					loadRuntimeLayout();
+					return;
+				}
+
+				auto* ptr = reinterpret_cast<const char*>(base.get());
 
 				const KeyType* kSizes = reinterpret_cast<const KeyType*>(ptr += sizeof(Header));
-				ptrs = make_unique<size_t[]>(header.vocabSize + 1);
-				ptrs[0] = 0;
+				ownedPtrs = make_unique<uint64_t[]>(header.vocabSize + 1);
+				ownedPtrs[0] = 0;
 				for (size_t i = 0; i < header.vocabSize; ++i)
 				{
-					ptrs[i + 1] = ptrs[i] + kSizes[i];
+					ownedPtrs[i + 1] = ownedPtrs[i] + kSizes[i];
 				}
+				ptrs = ownedPtrs.get();
 
 				size_t totalVocabs = ptrs[header.vocabSize];
-				keyData = make_unique<KeyType[]>(totalVocabs);
+				ownedKeyData = make_unique<KeyType[]>(totalVocabs);
 				restoredFloats = make_unique<float[]>(totalVocabs + (header.quantize ? header.vocabSize : 0));
-				vocabValidness = make_unique<uint8_t[]>(header.vocabSize);
-				std::fill(vocabValidness.get(), vocabValidness.get() + header.vocabSize, 0);
+				ownedVocabValidness = make_unique<uint8_t[]>(header.vocabSize);
+				std::fill(ownedVocabValidness.get(), ownedVocabValidness.get() + header.vocabSize, 0);
+				keyData = ownedKeyData.get();
+				vocabValidness = ownedVocabValidness.get();
 
 				auto kdSrc = reinterpret_cast<const KeyType*>(ptr += header.vocabSize * sizeof(KeyType));
-				std::copy(kdSrc, kdSrc + totalVocabs, keyData.get());
+				std::copy(kdSrc, kdSrc + totalVocabs, ownedKeyData.get());
 				
 				if (header.quantize)
 				{
 					auto discntSrc = reinterpret_cast<const uint8_t*>(ptr += totalVocabs * sizeof(KeyType));
 					auto cmpSrc = reinterpret_cast<const uint8_t*>(ptr += header.vocabSize * sizeof(uint8_t));
 					auto vvSrc = reinterpret_cast<const uint8_t*>(ptr += totalVocabs * sizeof(uint8_t));
-					std::copy(vvSrc, vvSrc + header.vocabSize, vocabValidness.get());
+					std::copy(vvSrc, vvSrc + header.vocabSize, ownedVocabValidness.get());
 
 					auto discntTable = reinterpret_cast<const float*>(ptr += header.vocabSize * sizeof(uint8_t));
 					auto cmpTable = discntTable + 256;
@@ -73,7 +114,7 @@ namespace kiwi
 					std::copy(cmpSrc, cmpSrc + totalVocabs, restoredFloats.get());
 					compensations = restoredFloats.get();
 					auto vvSrc = reinterpret_cast<const uint8_t*>(ptr += totalVocabs * sizeof(float));
-					std::copy(vvSrc, vvSrc + header.vocabSize, vocabValidness.get());
+					std::copy(vvSrc, vvSrc + header.vocabSize, ownedVocabValidness.get());
 				}
 				
 				auto mutableCompensations = restoredFloats.get();
@@ -83,10 +124,8 @@ namespace kiwi
 				{
 					size_t size = ptrs[i + 1] - ptrs[i];
 					if (!size) continue;
-					nst::prepare<arch>(keyData.get() + ptrs[i], mutableCompensations + ptrs[i], size, tempBuf);
+					nst::prepare<arch>(ownedKeyData.get() + ptrs[i], mutableCompensations + ptrs[i], size, tempBuf);
 				}
-
-				logWindowSize = std::log((float)header.windowSize);
 			}
 
 			bool isValidVocab(KeyType k) const
@@ -96,6 +135,39 @@ namespace kiwi
 			}
 
 			float evaluate(const KeyType* history, size_t cnt, KeyType next, float base) const;
+
+			utils::MemoryOwner toRuntimeLayout() const override
+			{
+				static constexpr size_t alignment = 64;
+				auto align = [](size_t offset) { return (offset + alignment - 1) & ~(alignment - 1); };
+
+				const auto& header = getHeader();
+				Header newHeader = header;
+				newHeader.quantize = runtimeLayoutFlag;
+				newHeader.compressed = 0;
+
+				RuntimeHeader rheader = { 0, };
+				rheader.totalVocabs = ptrs[header.vocabSize];
+				rheader.archType = static_cast<uint32_t>(arch);
+				rheader.ptrOffset = align(sizeof(Header) + sizeof(RuntimeHeader));
+				rheader.keyOffset = align(rheader.ptrOffset + (header.vocabSize + 1) * sizeof(uint64_t));
+				rheader.discntOffset = align(rheader.keyOffset + rheader.totalVocabs * sizeof(KeyType));
+				rheader.compensationOffset = align(rheader.discntOffset + header.vocabSize * sizeof(float));
+				rheader.validnessOffset = align(rheader.compensationOffset + rheader.totalVocabs * sizeof(float));
+				const size_t totalSize = rheader.validnessOffset + header.vocabSize;
+
+				utils::MemoryOwner ret{ totalSize };
+				auto* ptr = reinterpret_cast<char*>(ret.get());
+				std::fill(ptr, ptr + totalSize, 0);
+				std::memcpy(ptr, &newHeader, sizeof(Header));
+				std::memcpy(ptr + sizeof(Header), &rheader, sizeof(RuntimeHeader));
+				std::memcpy(ptr + rheader.ptrOffset, ptrs, (header.vocabSize + 1) * sizeof(uint64_t));
+				std::memcpy(ptr + rheader.keyOffset, keyData, rheader.totalVocabs * sizeof(KeyType));
+				std::memcpy(ptr + rheader.discntOffset, discnts, header.vocabSize * sizeof(float));
+				std::memcpy(ptr + rheader.compensationOffset, compensations, rheader.totalVocabs * sizeof(float));
+				std::memcpy(ptr + rheader.validnessOffset, vocabValidness, header.vocabSize);
+				return ret;
+			}
 		};
 
 		template<ArchType archType>
@@ -128,6 +200,15 @@ namespace kiwi
 			};
 		};
 
+		inline ArchType SkipBigramModelBase::getRuntimeLayoutArch(const utils::MemoryObject& mem)
+		{
+			if (mem.size() < sizeof(Header) + sizeof(RuntimeHeader)) return ArchType::default_;
+			auto* ptr = reinterpret_cast<const char*>(mem.get());
+			auto& header = *reinterpret_cast<const Header*>(ptr);
+			if (!(header.quantize & runtimeLayoutFlag)) return ArchType::default_;
+			return static_cast<ArchType>(reinterpret_cast<const RuntimeHeader*>(ptr + sizeof(Header))->archType);
+		}
+
 		inline std::unique_ptr<SkipBigramModelBase> SkipBigramModelBase::create(utils::MemoryObject&& mem, ArchType archType)
 		{
 			static tp::Table<FnCreateOptimizedModel, AvailableArch> table{ CreateOptimizedModelGetter{} };
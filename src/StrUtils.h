@@ -225,6 +225,75 @@ namespace kiwi
 		}
 	}
 
+	/**
+	 * @brief UTF-8 문자열을 복호화하면서 각 UTF-16 코드 유닛과 그 유닛이 시작하는 바이트 위치를 `fn`에 전달한다.
+	 * 
+	 * 서로게이트 쌍의 두 유닛은 같은 바이트 위치를 가진다.
+	 */
+	template<class Fn>
+	inline void forEachUtf16OfUtf8(nonstd::string_view str, Fn&& fn)
+	{
+		for (auto it = str.begin(); it != str.end(); ++it)
+		{
+			const size_t pos = (size_t)(it - str.begin());
+			uint32_t code = 0;
+			uint32_t byte = (uint8_t)*it;
+			if ((byte & 0xF8) == 0xF0)
+			{
+				code = (uint32_t)((byte & 0x07) << 18);
+				if (++it == str.end()) throw UnicodeException{ "unexpected ending" };
+				if (((byte = *it) & 0xC0) != 0x80) throw UnicodeException{ "unexpected trailing byte" };
+				code |= (uint32_t)((byte & 0x3F) << 12);
+				if (++it == str.end()) throw UnicodeException{ "unexpected ending" };
+				if (((byte = *it) & 0xC0) != 0x80) throw UnicodeException{ "unexpected trailing byte" };
+				code |= (uint32_t)((byte & 0x3F) << 6);
+				if (++it == str.end()) throw UnicodeException{ "unexpected ending" };
+				if (((byte = *it) & 0xC0) != 0x80) throw UnicodeException{ "unexpected trailing byte" };
+				code |= (byte & 0x3F);
+			}
+			else if ((byte & 0xF0) == 0xE0)
+			{
+				code = (uint32_t)((byte & 0x0F) << 12);
+				if (++it == str.end()) throw UnicodeException{ "unexpected ending" };
+				if (((byte = *it) & 0xC0) != 0x80) throw UnicodeException{ "unexpected trailing byte" };
+				code |= (uint32_t)((byte & 0x3F) << 6);
+				if (++it == str.end()) throw UnicodeException{ "unexpected ending" };
+				if (((byte = *it) & 0xC0) != 0x80) throw UnicodeException{ "unexpected trailing byte" };
+				code |= (byte & 0x3F);
+			}
+			else if ((byte & 0xE0) == 0xC0)
+			{
+				code = (uint32_t)((byte & 0x1F) << 6);
+				if (++it == str.end()) throw UnicodeException{ "unexpected ending" };
+				if (((byte = *it) & 0xC0) != 0x80) throw UnicodeException{ "unexpected trailing byte" };
+				code |= (byte & 0x3F);
+			}
+			else if ((byte & 0x80) == 0x00)
+			{
+				code = byte;
+			}
+			else
+			{
+				throw UnicodeException{ "unicode error" };
+			}
+
+			if (code < 0x10000)
+			{
+				fn((char16_t)code, pos);
+			}
+			else if (code < 0x10FFFF)
+			{
+				code -= 0x10000;
+				fn((char16_t)(0xD800 | (code >> 10)), pos);
+				fn((char16_t)(0xDC00 | (code & 0x3FF)), pos);
+			}
+			else
+			{
+				throw UnicodeException{ "unicode error" };
+			}
+		}
+	}
+
 	inline std::u16string utf8To16(nonstd::string_view str)
 	{
 		std::u16string ret;
@@ -404,9 +473,11 @@ namespace kiwi
 		return ret;
 	}
 
-	inline std::string utf16To8(nonstd::u16string_view str)
+	/**
+	 * @brief UTF-16 문자열을 UTF-8로 변환하여 `ret`의 뒤에 덧붙인다.
+	 */
+	inline void appendUtf16To8(nonstd::u16string_view str, std::string& ret)
 	{
-		std::string ret;
 		for (auto it = str.begin(); it != str.end(); ++it)
 		{
 			size_t code = *it;
@@ -445,7 +516,12 @@ namespace kiwi
 				throw UnicodeException{ "unicode error" };
 			}
 		}
+	}
 
+	inline std::string utf16To8(nonstd::u16string_view str)
+	{
+		std::string ret;
+		appendUtf16To8(str, ret);
 		return ret;
 	}
 
@@ -542,31 +618,63 @@ namespace kiwi
 		return normalizeHangul(hangul.begin(), hangul.end());
 	}
 
+	/**
+	 * @brief 문자 c가 새 줄의 시작으로 취급되어야 하는지 판단한다. CR 바로 뒤의 LF는 새 줄로 보지 않는다.
+	 */
+	inline bool isNewLine(char16_t c, bool& isCR)
+	{
+		switch (c)
+		{
+		case 0x0D:
+			isCR = true;
+			return true;
+		case 0x0A:
+		{
+			const bool ret = !isCR;
+			isCR = false;
+			return ret;
+		}
+		case 0x0B:
+		case 0x0C:
+		case 0x85:
+		case 0x2028:
+		case 0x2029:
+			isCR = false;
+			return true;
+		}
+		return false;
+	}
+
+	/**
+	 * @brief 문자 하나를 정규화하여 `strOut`에 출력하고, 출력한 문자의 개수를 반환한다.
+	 */
+	template<class StrOut>
+	inline size_t normalizeHangulChar(char16_t c, StrOut& strOut)
+	{
+		if (c == 0xB42C) c = 0xB410;
+		if (0xAC00 <= c && c < 0xD7A4)
+		{
+			int coda = (c - 0xAC00) % 28;
+			*strOut++ = (c - coda);
+			if (coda)
+			{
+				*strOut++ = (coda + 0x11A7);
+				return 2;
+			}
+			return 1;
+		}
+		*strOut++ = c;
+		return 1;
+	}
+
 	template<class It, class StrOut, class PosOut>
 	inline void normalizeHangulWithPosition(It first, It last, StrOut strOut, PosOut posOut)
 	{
 		size_t s = 0;
 		for (; first != last; ++first)
 		{
-			auto c = *first;
 			*posOut++ = s;
-			if (c == 0xB42C) c = 0xB410;
-			if (0xAC00 <= c && c < 0xD7A4)
-			{
-				int coda = (c - 0xAC00) % 28;
-				*strOut++ = (c - coda);
-				s++;
-				if (coda)
-				{
-					*strOut++ = (coda + 0x11A7);
-					s++;
-				}
-			}
-			else
-			{
-				*strOut++ = c;
-				s++;
-			}
+			s += normalizeHangulChar(*first, strOut);
 		}
 		*posOut++ = s;
 	}
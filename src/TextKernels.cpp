@@ -0,0 +1,100 @@
+#include <kiwi/Types.h>
+#include <kiwi/TemplateUtils.hpp>
+#include "ArchAvailable.h"
+#include "TextKernels.h"
+
+namespace kiwi
+{
+	namespace text
+	{
+		struct NormalizeHangulWithPositionGetter
+		{
+			template<std::ptrdiff_t i>
+			struct Wrapper
+			{
+				static constexpr FnNormalizeHangulWithPosition value = &normalizeHangulWithPosition<static_cast<ArchType>(i)>;
+			};
+		};
+
+		struct GetWordPositionsGetter
+		{
+			template<std::ptrdiff_t i>
+			struct Wrapper
+			{
+				static constexpr FnGetWordPositions value = &getWordPositions<static_cast<ArchType>(i)>;
+			};
+		};
+
+		struct NormalizeCodaGetter
+		{
+			template<std::ptrdiff_t i>
+			struct Wrapper
+			{
+				static constexpr FnNormalizeCoda value = &normalizeCoda<static_cast<ArchType>(i)>;
+			};
+		};
+
+		struct FindPatternCandidateGetter
+		{
+			template<std::ptrdiff_t i>
+			struct Wrapper
+			{
+				static constexpr FnFindPatternCandidate value = &findPatternCandidate<static_cast<ArchType>(i)>;
+			};
+		};
+
+		struct Utf8To16Getter
+		{
+			template<std::ptrdiff_t i>
+			struct Wrapper
+			{
+				static constexpr FnUtf8To16 value = &utf8To16<static_cast<ArchType>(i)>;
+			};
+		};
+
+		struct NormalizeUtf8WithPositionGetter
+		{
+			template<std::ptrdiff_t i>
+			struct Wrapper
+			{
+				static constexpr FnNormalizeUtf8WithPosition value = &normalizeUtf8WithPosition<static_cast<ArchType>(i)>;
+			};
+		};
+
+		FnNormalizeHangulWithPosition getNormalizeHangulWithPositionFn(ArchType arch)
+		{
+			static tp::Table<FnNormalizeHangulWithPosition, AvailableArch> table{ NormalizeHangulWithPositionGetter{} };
+			return table[static_cast<std::ptrdiff_t>(arch)];
+		}
+
+		FnGetWordPositions getGetWordPositionsFn(ArchType arch)
+		{
+			static tp::Table<FnGetWordPositions, AvailableArch> table{ GetWordPositionsGetter{} };
+			return table[static_cast<std::ptrdiff_t>(arch)];
+		}
+
+		FnNormalizeCoda getNormalizeCodaFn(ArchType arch)
+		{
+			static tp::Table<FnNormalizeCoda, AvailableArch> table{ NormalizeCodaGetter{} };
+			return table[static_cast<std::ptrdiff_t>(arch)];
+		}
+
+		FnFindPatternCandidate getFindPatternCandidateFn(ArchType arch)
+		{
+			static tp::Table<FnFindPatternCandidate, AvailableArch> table{ FindPatternCandidateGetter{} };
+			return table[static_cast<std::ptrdiff_t>(arch)];
+		}
+
+		FnUtf8To16 getUtf8To16Fn(ArchType arch)
+		{
+			static tp::Table<FnUtf8To16, AvailableArch> table{ Utf8To16Getter{} };
+			return table[static_cast<std::ptrdiff_t>(arch)];
+		}
+
+		FnNormalizeUtf8WithPosition getNormalizeUtf8WithPositionFn(ArchType arch)
+		{
+			static tp::Table<FnNormalizeUtf8WithPosition, AvailableArch> table{ NormalizeUtf8WithPositionGetter{} };
+			return table[static_cast<std::ptrdiff_t>(arch)];
+		}
+	}
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <kiwi/ArchUtils.h>
+#include <kiwi/Types.h>
+
+namespace kiwi
+{
+	/**
+	 * @brief 분석 전처리(UTF-8 복호화, 한글 음절 분해, 어절 번호 생성, 받침 정규화, 패턴 후보 탐색)를 수행하는 아키텍처별 커널.
+	 *
+	 * @details 각 함수는 `ArchType`별로 `src/archImpl/` 아래의 각 파일에서 인스턴스화되며, `get*Fn(arch)`로 선택한다.
+	 * 모든 아키텍처의 결과는 `StrUtils.h`의 스칼라 구현과 같다.
+	 */
+	namespace text
+	{
+		/**
+		 * @brief UTF-16 문자열의 한글 음절을 초성+중성과 종성으로 분해하고 각 문자의 시작 위치를 기록한다.
+		 *
+		 * @param out 최소 `2 * len`개의 문자를 담을 수 있어야 한다.
+		 * @param pos 최소 `len + 1`개의 값을 담을 수 있어야 한다. `pos[i]`는 `str[i]`가 분해되어 `out`에서 시작하는 위치이며,
+		 * `pos[len]`은 출력된 전체 길이이다.
+		 * @return `out`에 출력한 문자의 개수
+		 */
+		template<ArchType arch>
+		size_t normalizeHangulWithPosition(const char16_t* str, size_t len, char16_t* out, uint32_t* pos);
+
+		/**
+		 * @brief 각 문자의 어절 번호를 `out`에 기록한다. 공백이 연속되면 하나의 어절 경계로 취급한다.
+		 *
+		 * @details 어절 번호는 각 어절의 등장 순서이며, 공백은 앞 어절에 속한다.
+		 * 예를 들어 '나는 학교에 간다'로부터 {0, 0, 0, 1, 1, 1, 1, 2, 2}가 생성된다.
+		 *
+		 * @param out 최소 `len`개의 값을 담을 수 있어야 한다.
+		 */
+		template<ArchType arch>
+		void getWordPositions(const char16_t* str, size_t len, uint16_t* out);
+
+		/**
+		 * @brief 분해된 문자열에서 종성 뒤에 이어지는 초성체를 앞 글자의 받침으로 정규화한다. 문자열을 직접 수정한다.
+		 */
+		template<ArchType arch>
+		void normalizeCoda(char16_t* str, size_t len);
+
+		/**
+		 * @brief `matchPattern()`의 패턴이 시작될 수 있는 첫 문자의 위치를 찾는다.
+		 *
+		 * @details 한글, 공백처럼 어떤 패턴도 시작할 수 없는 문자를 블록 단위로 건너뛴다.
+		 * 찾은 문자가 실제로 패턴을 시작하는지는 따로 확인해야 한다.
+		 * @return 그런 문자가 없으면 `len`
+		 */
+		template<ArchType arch>
+		size_t findPatternCandidate(const char16_t* str, size_t len);
+
+		/**
+		 * @brief UTF-8 문자열을 UTF-16으로 변환한다.
+		 *
+		 * @param out 최소 `len`개의 문자를 담을 수 있어야 한다.
+		 * @param bytePositions nullptr가 아니라면 각 코드 유닛이 시작하는 바이트 위치를 기록한다. 최소 `len`개의 값을 담을 수 있어야 한다.
+		 * 서로게이트 쌍의 두 유닛은 같은 바이트 위치를 가진다.
+		 * @return `out`에 출력한 코드 유닛의 개수
+		 * @throw kiwi::UnicodeException 올바르지 않은 UTF-8 문자열이 주어진 경우
+		 */
+		template<ArchType arch>
+		size_t utf8To16(const char* str, size_t len, char16_t* out, size_t* bytePositions);
+
+		/**
+		 * @brief UTF-8 문자열을 복호화하면서 한글 음절 분해, 위치 테이블, 바이트 위치, 어절 번호, 줄바꿈 위치를 한 번에 생성한다.
+		 *
+		 * @details 입력을 작은 구간으로 잘라 `utf8To16`, `normalizeHangulWithPosition`, `getWordPositions`와 같은 처리를
+		 * 구간마다 이어서 수행하므로 문자열 전체의 UTF-16 사본을 만들지 않는다. 위치 정보는 모두 UTF-16 코드 유닛 단위이다.
+		 *
+		 * @param out 최소 `len`개의 문자를 담을 수 있어야 한다. 분해된 문자열의 길이는 UTF-8 바이트 수를 넘지 않는다.
+		 * @param pos, bytePositions 최소 `len + 1`개의 값을 담을 수 있어야 한다. `pos[n]`에는 출력된 전체 길이가 기록되며, `bytePositions[n]`은 기록하지 않는다.
+		 * @param wordPositions 최소 `len`개의 값을 담을 수 있어야 한다.
+		 * @param newlines 새 줄이 시작되는 코드 유닛의 위치가 추가된다.
+		 * @return 변환된 UTF-16 코드 유닛의 개수 `n`
+		 * @throw kiwi::UnicodeException 올바르지 않은 UTF-8 문자열이 주어진 경우
+		 */
+		template<ArchType arch>
+		size_t normalizeUtf8WithPosition(const char* str, size_t len, char16_t* out, uint32_t* pos, size_t* bytePositions, uint16_t* wordPositions, std::vector<size_t>& newlines);
+
+		using FnNormalizeHangulWithPosition = decltype(&normalizeHangulWithPosition<ArchType::none>);
+		using FnGetWordPositions = decltype(&getWordPositions<ArchType::none>);
+		using FnNormalizeCoda = decltype(&normalizeCoda<ArchType::none>);
+		using FnFindPatternCandidate = decltype(&findPatternCandidate<ArchType::none>);
+		using FnUtf8To16 = decltype(&utf8To16<ArchType::none>);
+		using FnNormalizeUtf8WithPosition = decltype(&normalizeUtf8WithPosition<ArchType::none>);
+
+		FnNormalizeHangulWithPosition getNormalizeHangulWithPositionFn(ArchType arch);
+		FnGetWordPositions getGetWordPositionsFn(ArchType arch);
+		FnNormalizeCoda getNormalizeCodaFn(ArchType arch);
+		FnFindPatternCandidate getFindPatternCandidateFn(ArchType arch);
+		FnUtf8To16 getUtf8To16Fn(ArchType arch);
+		FnNormalizeUtf8WithPosition getNormalizeUtf8WithPositionFn(ArchType arch);
+	}
+}
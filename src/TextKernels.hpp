@@ -0,0 +1,904 @@
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+#include <kiwi/BitUtils.h>
+#include <kiwi/Utils.h>
+#include "StrUtils.h"
+#include "TextKernels.h"
+
+#if defined(__x86_64__) || CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64 || defined(KIWI_ARCH_X86) || defined(KIWI_ARCH_X86_64)
+#include <immintrin.h>
+#elif CPUINFO_ARCH_ARM64 || KIWI_ARCH_ARM64
+#include <arm_neon.h>
+#endif
+
+namespace kiwi
+{
+	namespace text
+	{
+		namespace detail
+		{
+			/**
+			 * @brief 아키텍처별 벡터 연산.
+			 *
+			 * @details 특수화는 `charBlock`개의 UTF-16 문자와 `byteBlock`개의 바이트를 한 번에 처리하며,
+			 * 각 문자(바이트)에 대한 판정 결과를 비트마스크로 돌려준다. 특수화가 없는 아키텍처는 스칼라 구현을 사용한다.
+			 */
+			template<ArchType arch>
+			struct TextOps
+			{
+				static constexpr bool available = false;
+			};
+
+			// 한글 음절의 종성 번호를 구하기 위한 나눗셈 상수: 0 <= x < 11172에서 floor(x / 28) == (x * 18725) >> 19
+			static constexpr uint16_t div28Magic = 18725;
+
+			inline uint64_t lowBits(size_t n)
+			{
+				return n >= 64 ? ~(uint64_t)0 : (((uint64_t)1 << n) - 1);
+			}
+
+			inline uint32_t normalizeHangulScalar(const char16_t* str, size_t len, char16_t* out, uint32_t* pos, uint32_t s)
+			{
+				for (size_t i = 0; i < len; ++i)
+				{
+					pos[i] = s;
+					char16_t* o = out + s;
+					s += normalizeHangulChar(str[i], o);
+				}
+				return s;
+			}
+
+			inline void getWordPositionsScalar(const char16_t* str, size_t len, uint16_t* out, uint32_t& position, bool& continuousSpace)
+			{
+				for (size_t i = 0; i < len; ++i)
+				{
+					out[i] = position;
+					if (isSpace(str[i]))
+					{
+						if (!continuousSpace) ++position;
+						continuousSpace = true;
+					}
+					else
+					{
+						continuousSpace = false;
+					}
+				}
+			}
+
+			/**
+			 * @brief `str[begin, end)`에 대해 받침 정규화를 수행한다. 바로 앞 문자는 아직 수정되지 않은 상태여야 한다.
+			 */
+			inline void normalizeCodaScalar(char16_t* str, size_t begin, size_t end)
+			{
+				kiwi::normalizeCoda(str + (begin ? begin - 1 : 0), str + end);
+			}
+
+			/**
+			 * @brief `c`가 `matchPattern()`의 패턴을 시작할 수 있는 문자인지 판정한다.
+			 *
+			 * @details 실제 시작 문자 집합을 포함하는 몇 개의 구간으로 판정하므로 거짓 양성이 있을 수 있다.
+			 * ASCII 문자(이메일, 약어, 숫자, #, @), 이모지가 시작될 수 있는 구간, 상위 서로게이트, 전각 숫자가 해당된다.
+			 */
+			inline bool isPatternCandidate(char16_t c)
+			{
+				return (0x23 <= c && c <= 0x7A)
+					|| (0xA9 <= c && c <= 0xAE)
+					|| (0x2000 <= c && c <= 0x2BFF)
+					|| (0x3030 <= c && c <= 0x3299)
+					|| (0xD800 <= c && c <= 0xDBFF)
+					|| (0xFF10 <= c && c <= 0xFF19);
+			}
+
+			inline size_t findPatternCandidateScalar(const char16_t* str, size_t begin, size_t len)
+			{
+				for (size_t i = begin; i < len; ++i)
+				{
+					if (isPatternCandidate(str[i])) return i;
+				}
+				return len;
+			}
+
+			/**
+			 * @brief `str[p]`에서 시작하는 코드 포인트 하나를 복호화하여 `out[k]`부터 출력하고 `p`와 `k`를 전진시킨다.
+			 *
+			 * @details 예외 처리를 포함하여 `forEachUtf16OfUtf8()`과 같은 방식으로 동작한다.
+			 */
+			inline void decodeUtf8One(const char* str, size_t len, size_t& p, char16_t* out, size_t* bytePositions, size_t& k)
+			{
+				const size_t start = p;
+				uint32_t code = 0;
+				uint32_t byte = (uint8_t)str[p];
+				size_t numTrails = 0;
+				if ((byte & 0xF8) == 0xF0)
+				{
+					code = (uint32_t)((byte & 0x07) << 18);
+					numTrails = 3;
+				}
+				else if ((byte & 0xF0) == 0xE0)
+				{
+					code = (uint32_t)((byte & 0x0F) << 12);
+					numTrails = 2;
+				}
+				else if ((byte & 0xE0) == 0xC0)
+				{
+					code = (uint32_t)((byte & 0x1F) << 6);
+					numTrails = 1;
+				}
+				else if ((byte & 0x80) == 0x00)
+				{
+					code = byte;
+				}
+				else
+				{
+					throw UnicodeException{ "unicode error" };
+				}
+
+				for (size_t t = numTrails; t > 0; --t)
+				{
+					if (++p == len) throw UnicodeException{ "unexpected ending" };
+					if (((byte = (uint8_t)str[p]) & 0xC0) != 0x80) throw UnicodeException{ "unexpected trailing byte" };
+					code |= (byte & 0x3F) << (6 * (t - 1));
+				}
+				++p;
+
+				if (code < 0x10000)
+				{
+					if (bytePositions) bytePositions[k] = start;
+					out[k++] = (char16_t)code;
+				}
+				else if (code < 0x10FFFF)
+				{
+					code -= 0x10000;
+					if (bytePositions) bytePositions[k] = start;
+					out[k++] = (char16_t)(0xD800 | (code >> 10));
+					if (bytePositions) bytePositions[k] = start;
+					out[k++] = (char16_t)(0xDC00 | (code & 0x3FF));
+				}
+				else
+				{
+					throw UnicodeException{ "unicode error" };
+				}
+			}
+
+			template<class Ops>
+			uint32_t normalizeHangulBlocks(const char16_t* str, size_t len, char16_t* out, uint32_t* pos, uint32_t s, std::false_type)
+			{
+				return normalizeHangulScalar(str, len, out, pos, s);
+			}
+
+			/**
+			 * @brief `out[s]`부터 분해 결과를 출력하고 끝난 위치를 반환한다. `pos[len]`은 기록하지 않는다.
+			 */
+			template<class Ops>
+			uint32_t normalizeHangulBlocks(const char16_t* str, size_t len, char16_t* out, uint32_t* pos, uint32_t s, std::true_type)
+			{
+				static constexpr size_t blockSize = Ops::charBlock;
+				alignas(64) char16_t leads[blockSize], tails[blockSize];
+				size_t i = 0;
+				for (; i + blockSize <= len; i += blockSize)
+				{
+					uint64_t syllables;
+					const uint64_t codas = Ops::decompose(str + i, leads, tails, syllables);
+					if (!syllables)
+					{
+						// 한글 음절이 없으면 그대로 복사한다
+						Ops::copyChars(str + i, out + s);
+						Ops::storeIota(pos + i, s);
+						s += blockSize;
+						continue;
+					}
+
+					// 종성은 항상 기록하고 종성이 없는 경우 다음 문자로 덮어써서 분기를 없앤다
+					for (size_t j = 0; j < blockSize; ++j)
+					{
+						pos[i + j] = s;
+						out[s] = leads[j];
+						out[s + 1] = tails[j];
+						s += 1 + (uint32_t)((codas >> j) & 1);
+					}
+				}
+				return normalizeHangulScalar(str + i, len - i, out, pos + i, s);
+			}
+
+			template<class Ops, class IsAvailable>
+			size_t normalizeHangulImpl(const char16_t* str, size_t len, char16_t* out, uint32_t* pos, IsAvailable available)
+			{
+				const uint32_t s = normalizeHangulBlocks<Ops>(str, len, out, pos, 0, available);
+				pos[len] = s;
+				return s;
+			}
+
+			template<class Ops>
+			void getWordPositionsBlocks(const char16_t* str, size_t len, uint16_t* out, uint32_t& position, bool& continuousSpace, std::false_type)
+			{
+				getWordPositionsScalar(str, len, out, position, continuousSpace);
+			}
+
+			/**
+			 * @brief 어절 번호 `position`과 직전 문자가 공백인지 여부 `continuousSpace`에서 이어서 어절 번호를 기록한다.
+			 */
+			template<class Ops>
+			void getWordPositionsBlocks(const char16_t* str, size_t len, uint16_t* out, uint32_t& position, bool& continuousSpace, std::true_type)
+			{
+				static constexpr size_t blockSize = Ops::charBlock;
+				size_t i = 0;
+				for (; i + blockSize <= len; i += blockSize)
+				{
+					const uint64_t spaces = Ops::spaceMask(str + i);
+					if (!spaces)
+					{
+						Ops::fill(out + i, (uint16_t)position);
+						continuousSpace = false;
+						continue;
+					}
+
+					// 공백이 연속되는 구간의 첫 문자에서만 어절 번호가 증가한다
+					const uint64_t starts = spaces & ~((spaces << 1) | (continuousSpace ? 1 : 0));
+					for (size_t j = 0; j < blockSize; ++j)
+					{
+						out[i + j] = (uint16_t)position;
+						position += (uint32_t)((starts >> j) & 1);
+					}
+					continuousSpace = !!((spaces >> (blockSize - 1)) & 1);
+				}
+				getWordPositionsScalar(str + i, len - i, out + i, position, continuousSpace);
+			}
+
+			template<class Ops, class IsAvailable>
+			void getWordPositionsImpl(const char16_t* str, size_t len, uint16_t* out, IsAvailable available)
+			{
+				uint32_t position = 0;
+				bool continuousSpace = false;
+				getWordPositionsBlocks<Ops>(str, len, out, position, continuousSpace, available);
+			}
+
+			template<class Ops>
+			void normalizeCodaImpl(char16_t* str, size_t len, std::false_type)
+			{
+				normalizeCodaScalar(str, 0, len);
+			}
+
+			template<class Ops>
+			void normalizeCodaImpl(char16_t* str, size_t len, std::true_type)
+			{
+				static constexpr size_t blockSize = Ops::charBlock;
+				size_t i = 0;
+				for (; i + blockSize <= len; i += blockSize)
+				{
+					// 초성체 자음(ㄱ~ㅎ)이 없는 구간은 바뀌는 문자가 없다
+					if (!Ops::rangeMask(str + i, 0x3131, 0x314E)) continue;
+					normalizeCodaScalar(str, i, i + blockSize);
+				}
+				normalizeCodaScalar(str, i, len);
+			}
+
+			template<class Ops>
+			size_t findPatternCandidateImpl(const char16_t* str, size_t len, std::false_type)
+			{
+				return findPatternCandidateScalar(str, 0, len);
+			}
+
+			template<class Ops>
+			size_t findPatternCandidateImpl(const char16_t* str, size_t len, std::true_type)
+			{
+				static constexpr size_t blockSize = Ops::charBlock;
+				size_t i = 0;
+				for (; i + blockSize <= len; i += blockSize)
+				{
+					// isPatternCandidate()와 같은 구간들
+					const uint64_t candidates = Ops::rangeMask(str + i, 0x23, 0x7A)
+						| Ops::rangeMask(str + i, 0xA9, 0xAE)
+						| Ops::rangeMask(str + i, 0x2000, 0x2BFF)
+						| Ops::rangeMask(str + i, 0x3030, 0x3299)
+						| Ops::rangeMask(str + i, 0xD800, 0xDBFF)
+						| Ops::rangeMask(str + i, 0xFF10, 0xFF19);
+					if (candidates) return i + utils::countTrailingZeroes(candidates);
+				}
+				return findPatternCandidateScalar(str, i, len);
+			}
+
+			/**
+			 * @brief `str[from, len)`을 변환한다. `bytePositions`에는 `str`을 기준으로 한 위치가 기록된다.
+			 */
+			template<class Ops>
+			size_t utf8To16Impl(const char* str, size_t from, size_t len, char16_t* out, size_t* bytePositions, std::false_type)
+			{
+				size_t p = from, k = 0;
+				while (p < len) decodeUtf8One(str, len, p, out, bytePositions, k);
+				return k;
+			}
+
+			template<class Ops>
+			size_t utf8To16Impl(const char* str, size_t from, size_t len, char16_t* out, size_t* bytePositions, std::true_type)
+			{
+				static constexpr size_t blockSize = Ops::byteBlock;
+				const uint64_t full = lowBits(blockSize);
+				size_t p = from, k = 0;
+				while (p + blockSize <= len)
+				{
+					uint64_t nonAscii, trails, lead3s;
+					Ops::classify(str + p, nonAscii, trails, lead3s);
+					if (!nonAscii)
+					{
+						Ops::widenAscii(str + p, out + k);
+						if (bytePositions)
+						{
+							for (size_t j = 0; j < blockSize; ++j) bytePositions[k + j] = p + j;
+						}
+						k += blockSize;
+						p += blockSize;
+						continue;
+					}
+
+					const uint64_t asciis = ~nonAscii & full;
+					if (!(full & ~(asciis | trails | lead3s)))
+					{
+						// 1바이트와 3바이트 문자로만 이루어진 구간. 블록 끝에 걸친 3바이트 문자는 다음 블록에서 처리한다.
+						const uint64_t cutLeads = lead3s & (full ^ (full >> 2));
+						const size_t n = cutLeads ? utils::countTrailingZeroes(cutLeads) : blockSize;
+						const uint64_t range = lowBits(n);
+						const uint64_t leads = lead3s & range;
+						const uint64_t expectedTrails = (leads << 1) | (leads << 2);
+						if (!(expectedTrails & ~range) && (trails & range) == expectedTrails)
+						{
+							const uint8_t* b = (const uint8_t*)str + p;
+							for (uint64_t starts = (asciis | leads) & range; starts; starts &= starts - 1)
+							{
+								const size_t j = utils::countTrailingZeroes(starts);
+								if (bytePositions) bytePositions[k] = p + j;
+								out[k++] = ((leads >> j) & 1)
+									? (char16_t)(((b[j] & 0x0F) << 12) | ((b[j + 1] & 0x3F) << 6) | (b[j + 2] & 0x3F))
+									: (char16_t)b[j];
+							}
+							p += n;
+							continue;
+						}
+					}
+
+					// 2바이트, 4바이트 문자나 잘못된 바이트가 포함된 구간은 한 문자씩 복호화한다
+					for (const size_t end = p + blockSize; p < end;)
+					{
+						decodeUtf8One(str, len, p, out, bytePositions, k);
+					}
+				}
+				while (p < len) decodeUtf8One(str, len, p, out, bytePositions, k);
+				return k;
+			}
+
+			template<class Ops>
+			void findNewLinesBlocks(const char16_t* str, size_t len, size_t base, bool& isCR, std::vector<size_t>& newlines, std::false_type)
+			{
+				for (size_t i = 0; i < len; ++i)
+				{
+					if (isNewLine(str[i], isCR)) newlines.emplace_back(base + i);
+				}
+			}
+
+			template<class Ops>
+			void findNewLinesBlocks(const char16_t* str, size_t len, size_t base, bool& isCR, std::vector<size_t>& newlines, std::true_type)
+			{
+				static constexpr size_t blockSize = Ops::charBlock;
+				size_t i = 0;
+				for (; i + blockSize <= len; i += blockSize)
+				{
+					// 줄바꿈 문자가 없는 구간은 isCR도 바뀌지 않는다
+					if (!(Ops::rangeMask(str + i, 0x0A, 0x0D) | Ops::rangeMask(str + i, 0x85, 0x85) | Ops::rangeMask(str + i, 0x2028, 0x2029))) continue;
+					findNewLinesBlocks<Ops>(str + i, blockSize, base + i, isCR, newlines, std::false_type{});
+				}
+				findNewLinesBlocks<Ops>(str + i, len - i, base + i, isCR, newlines, std::false_type{});
+			}
+
+			template<class Ops, class IsAvailable>
+			size_t normalizeUtf8Impl(const char* str, size_t len, char16_t* out, uint32_t* pos, size_t* bytePositions, uint16_t* wordPositions, std::vector<size_t>& newlines, IsAvailable available)
+			{
+				// UTF-16으로 변환한 구간이 L1 캐시에 남아 있는 동안 나머지 처리를 끝내도록 입력을 잘라서 처리한다
+								static constexpr size_t segmentSize = 1024;
+				alignas(64) char16_t units[segmentSize];
+				uint32_t s = 0, position = 0;
+				bool continuousSpace = false, isCR = false;
+				size_t k = 0;
+				for (size_t p = 0; p < len;)
+				{
+					size_t end = std::min(p + segmentSize, len);
+					// 문자 중간에서 자르지 않도록 후행 바이트는 다음 구간으로 넘긴다. 잘못된 문자열이라면 다음 구간을 변환할 때 예외가 발생한다
+					for (size_t e = end; e < len && e > p && e + 4 > end; --e)
+					{
+						if (((uint8_t)str[e] & 0xC0) != 0x80)
+						{
+							end = e;
+							break;
+						}
+					}
+
+					const size_t n = utf8To16Impl<Ops>(str, p, end, units, bytePositions + k, available);
+					s = normalizeHangulBlocks<Ops>(units, n, out, pos + k, s, available);
+					getWordPositionsBlocks<Ops>(units, n, wordPositions + k, position, continuousSpace, available);
+					findNewLinesBlocks<Ops>(units, n, k, isCR, newlines, available);
+					k += n;
+					p = end;
+				}
+				pos[k] = s;
+				return k;
+			}
+		}
+
+		template<ArchType arch>
+		size_t normalizeHangulWithPosition(const char16_t* str, size_t len, char16_t* out, uint32_t* pos)
+		{
+			using Ops = detail::TextOps<arch>;
+			return detail::normalizeHangulImpl<Ops>(str, len, out, pos, std::integral_constant<bool, Ops::available>{});
+		}
+
+		template<ArchType arch>
+		void getWordPositions(const char16_t* str, size_t len, uint16_t* out)
+		{
+			using Ops = detail::TextOps<arch>;
+			return detail::getWordPositionsImpl<Ops>(str, len, out, std::integral_constant<bool, Ops::available>{});
+		}
+
+		template<ArchType arch>
+		void normalizeCoda(char16_t* str, size_t len)
+		{
+			using Ops = detail::TextOps<arch>;
+			return detail::normalizeCodaImpl<Ops>(str, len, std::integral_constant<bool, Ops::available>{});
+		}
+
+		template<ArchType arch>
+		size_t findPatternCandidate(const char16_t* str, size_t len)
+		{
+			using Ops = detail::TextOps<arch>;
+			return detail::findPatternCandidateImpl<Ops>(str, len, std::integral_constant<bool, Ops::available>{});
+		}
+
+		template<ArchType arch>
+		size_t utf8To16(const char* str, size_t len, char16_t* out, size_t* bytePositions)
+		{
+			using Ops = detail::TextOps<arch>;
+			return detail::utf8To16Impl<Ops>(str, 0, len, out, bytePositions, std::integral_constant<bool, Ops::available>{});
+		}
+
+		template<ArchType arch>
+		size_t normalizeUtf8WithPosition(const char* str, size_t len, char16_t* out, uint32_t* pos, size_t* bytePositions, uint16_t* wordPositions, std::vector<size_t>& newlines)
+		{
+			using Ops = detail::TextOps<arch>;
+			return detail::normalizeUtf8Impl<Ops>(str, len, out, pos, bytePositions, wordPositions, newlines, std::integral_constant<bool, Ops::available>{});
+		}
+	}
+}
+
+#if defined(__x86_64__) || CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64 || defined(KIWI_ARCH_X86) || defined(KIWI_ARCH_X86_64)
+namespace kiwi
+{
+	namespace text
+	{
+		namespace detail
+		{
+#if defined(_MSC_VER) || defined(__SSE2__) || defined(__AVX2__)
+			template<>
+			struct TextOps<ArchType::sse2>
+			{
+				static constexpr bool available = true;
+				static constexpr size_t charBlock = 16;
+				static constexpr size_t byteBlock = 16;
+
+				static __m128i set1(uint16_t v) { return _mm_set1_epi16((short)v); }
+
+				// lo <= v <= hi 이면 0xFFFF
+				static __m128i inRange(__m128i v, uint16_t lo, uint16_t hi)
+				{
+					return _mm_cmpeq_epi16(_mm_subs_epu16(_mm_sub_epi16(v, set1(lo)), set1(hi - lo)), _mm_setzero_si128());
+				}
+
+				static uint64_t mask16(__m128i a, __m128i b)
+				{
+					return (uint32_t)_mm_movemask_epi8(_mm_packs_epi16(a, b));
+				}
+
+				static __m128i decomposeHalf(__m128i v, char16_t* leads, char16_t* tails, __m128i& syllable)
+				{
+					const __m128i x = _mm_sub_epi16(v, set1(0xAC00));
+					syllable = inRange(v, 0xAC00, 0xD7A3);
+					const __m128i q = _mm_srli_epi16(_mm_mulhi_epu16(x, set1(div28Magic)), 3);
+					const __m128i coda = _mm_and_si128(_mm_sub_epi16(x, _mm_mullo_epi16(q, set1(28))), syllable);
+					const __m128i fix = _mm_and_si128(_mm_cmpeq_epi16(v, set1(0xB42C)), set1(0xB42C - 0xB410));
+					_mm_storeu_si128((__m128i*)leads, _mm_sub_epi16(_mm_sub_epi16(v, fix), coda));
+					_mm_storeu_si128((__m128i*)tails, _mm_add_epi16(coda, set1(0x11A7)));
+					return _mm_cmpeq_epi16(coda, _mm_setzero_si128());
+				}
+
+				static uint64_t decompose(const char16_t* in, char16_t* leads, char16_t* tails, uint64_t& syllables)
+				{
+					__m128i s0, s1;
+					const __m128i n0 = decomposeHalf(_mm_loadu_si128((const __m128i*)in), leads, tails, s0);
+					const __m128i n1 = decomposeHalf(_mm_loadu_si128((const __m128i*)(in + 8)), leads + 8, tails + 8, s1);
+					syllables = mask16(s0, s1);
+					return ~mask16(n0, n1) & 0xFFFF;
+				}
+
+				static __m128i spaceHalf(__m128i v)
+				{
+					__m128i r = inRange(v, 0x09, 0x0D);
+					r = _mm_or_si128(r, _mm_cmpeq_epi16(v, set1(0x20)));
+					r = _mm_or_si128(r, _mm_cmpeq_epi16(v, set1(0xA0)));
+					r = _mm_or_si128(r, _mm_cmpeq_epi16(v, set1(0x1680)));
+					r = _mm_or_si128(r, inRange(v, 0x2000, 0x200A));
+					r = _mm_or_si128(r, _mm_cmpeq_epi16(v, set1(0x202F)));
+					r = _mm_or_si128(r, _mm_cmpeq_epi16(v, set1(0x205F)));
+					r = _mm_or_si128(r, _mm_cmpeq_epi16(v, set1(0x2800)));
+					r = _mm_or_si128(r, _mm_cmpeq_epi16(v, set1(0x3000)));
+					return r;
+				}
+
+				static uint64_t spaceMask(const char16_t* in)
+				{
+					return mask16(spaceHalf(_mm_loadu_si128((const __m128i*)in)), spaceHalf(_mm_loadu_si128((const __m128i*)(in + 8))));
+				}
+
+				static uint64_t rangeMask(const char16_t* in, uint16_t lo, uint16_t hi)
+				{
+					return mask16(inRange(_mm_loadu_si128((const __m128i*)in), lo, hi), inRange(_mm_loadu_si128((const __m128i*)(in + 8)), lo, hi));
+				}
+
+				static void copyChars(const char16_t* in, char16_t* out)
+				{
+					_mm_storeu_si128((__m128i*)out, _mm_loadu_si128((const __m128i*)in));
+					_mm_storeu_si128((__m128i*)(out + 8), _mm_loadu_si128((const __m128i*)(in + 8)));
+				}
+
+				static void storeIota(uint32_t* out, uint32_t s)
+				{
+					__m128i v = _mm_add_epi32(_mm_set1_epi32((int)s), _mm_setr_epi32(0, 1, 2, 3));
+					for (size_t i = 0; i < charBlock; i += 4)
+					{
+						_mm_storeu_si128((__m128i*)(out + i), v);
+						v = _mm_add_epi32(v, _mm_set1_epi32(4));
+					}
+				}
+
+				static void fill(uint16_t* out, uint16_t v)
+				{
+					_mm_storeu_si128((__m128i*)out, set1(v));
+					_mm_storeu_si128((__m128i*)(out + 8), set1(v));
+				}
+
+				static void classify(const char* in, uint64_t& nonAscii, uint64_t& trails, uint64_t& lead3s)
+				{
+					const __m128i v = _mm_loadu_si128((const __m128i*)in);
+					nonAscii = (uint32_t)_mm_movemask_epi8(v);
+					trails = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(v, _mm_set1_epi8((char)0xC0)), _mm_set1_epi8((char)0x80)));
+					lead3s = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(v, _mm_set1_epi8((char)0xF0)), _mm_set1_epi8((char)0xE0)));
+				}
+
+				static void widenAscii(const char* in, char16_t* out)
+				{
+					const __m128i v = _mm_loadu_si128((const __m128i*)in);
+					_mm_storeu_si128((__m128i*)out, _mm_unpacklo_epi8(v, _mm_setzero_si128()));
+					_mm_storeu_si128((__m128i*)(out + 8), _mm_unpackhi_epi8(v, _mm_setzero_si128()));
+				}
+			};
+#endif
+
+#if defined(_MSC_VER) || defined(__SSE4_1__) || defined(__AVX2__)
+			template<>
+			struct TextOps<ArchType::sse4_1> : public TextOps<ArchType::sse2>
+			{
+			};
+#endif
+
+#if defined(_MSC_VER) || defined(__AVX2__)
+			template<>
+			struct TextOps<ArchType::avx2>
+			{
+				static constexpr bool available = true;
+				static constexpr size_t charBlock = 32;
+				static constexpr size_t byteBlock = 32;
+
+				static __m256i set1(uint16_t v) { return _mm256_set1_epi16((short)v); }
+
+				static __m256i inRange(__m256i v, uint16_t lo, uint16_t hi)
+				{
+					return _mm256_cmpeq_epi16(_mm256_subs_epu16(_mm256_sub_epi16(v, set1(lo)), set1(hi - lo)), _mm256_setzero_si256());
+				}
+
+				static uint64_t mask16(__m256i a, __m256i b)
+				{
+					// packs는 128비트 단위로 섞이므로 64비트 단위로 다시 정렬한다
+					return (uint32_t)_mm256_movemask_epi8(_mm256_permute4x64_epi64(_mm256_packs_epi16(a, b), 0xD8));
+				}
+
+				static __m256i decomposeHalf(__m256i v, char16_t* leads, char16_t* tails, __m256i& syllable)
+				{
+					const __m256i x = _mm256_sub_epi16(v, set1(0xAC00));
+					syllable = inRange(v, 0xAC00, 0xD7A3);
+					const __m256i q = _mm256_srli_epi16(_mm256_mulhi_epu16(x, set1(div28Magic)), 3);
+					const __m256i coda = _mm256_and_si256(_mm256_sub_epi16(x, _mm256_mullo_epi16(q, set1(28))), syllable);
+					const __m256i fix = _mm256_and_si256(_mm256_cmpeq_epi16(v, set1(0xB42C)), set1(0xB42C - 0xB410));
+					_mm256_storeu_si256((__m256i*)leads, _mm256_sub_epi16(_mm256_sub_epi16(v, fix), coda));
+					_mm256_storeu_si256((__m256i*)tails, _mm256_add_epi16(coda, set1(0x11A7)));
+					return _mm256_cmpeq_epi16(coda, _mm256_setzero_si256());
+				}
+
+				static uint64_t decompose(const char16_t* in, char16_t* leads, char16_t* tails, uint64_t& syllables)
+				{
+					__m256i s0, s1;
+					const __m256i n0 = decomposeHalf(_mm256_loadu_si256((const __m256i*)in), leads, tails, s0);
+					const __m256i n1 = decomposeHalf(_mm256_loadu_si256((const __m256i*)(in + 16)), leads + 16, tails + 16, s1);
+					syllables = mask16(s0, s1);
+					return ~mask16(n0, n1) & 0xFFFFFFFF;
+				}
+
+				static __m256i spaceHalf(__m256i v)
+				{
+					__m256i r = inRange(v, 0x09, 0x0D);
+					r = _mm256_or_si256(r, _mm256_cmpeq_epi16(v, set1(0x20)));
+					r = _mm256_or_si256(r, _mm256_cmpeq_epi16(v, set1(0xA0)));
+					r = _mm256_or_si256(r, _mm256_cmpeq_epi16(v, set1(0x1680)));
+					r = _mm256_or_si256(r, inRange(v, 0x2000, 0x200A));
+					r = _mm256_or_si256(r, _mm256_cmpeq_epi16(v, set1(0x202F)));
+					r = _mm256_or_si256(r, _mm256_cmpeq_epi16(v, set1(0x205F)));
+					r = _mm256_or_si256(r, _mm256_cmpeq_epi16(v, set1(0x2800)));
+					r = _mm256_or_si256(r, _mm256_cmpeq_epi16(v, set1(0x3000)));
+					return r;
+				}
+
+				static uint64_t spaceMask(const char16_t* in)
+				{
+					return mask16(spaceHalf(_mm256_loadu_si256((const __m256i*)in)), spaceHalf(_mm256_loadu_si256((const __m256i*)(in + 16))));
+				}
+
+				static uint64_t rangeMask(const char16_t* in, uint16_t lo, uint16_t hi)
+				{
+					return mask16(inRange(_mm256_loadu_si256((const __m256i*)in), lo, hi), inRange(_mm256_loadu_si256((const __m256i*)(in + 16)), lo, hi));
+				}
+
+				static void copyChars(const char16_t* in, char16_t* out)
+				{
+					_mm256_storeu_si256((__m256i*)out, _mm256_loadu_si256((const __m256i*)in));
+					_mm256_storeu_si256((__m256i*)(out + 16), _mm256_loadu_si256((const __m256i*)(in + 16)));
+				}
+
+				static void storeIota(uint32_t* out, uint32_t s)
+				{
+					__m256i v = _mm256_add_epi32(_mm256_set1_epi32((int)s), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+					for (size_t i = 0; i < charBlock; i += 8)
+					{
+						_mm256_storeu_si256((__m256i*)(out + i), v);
+						v = _mm256_add_epi32(v, _mm256_set1_epi32(8));
+					}
+				}
+
+				static void fill(uint16_t* out, uint16_t v)
+				{
+					_mm256_storeu_si256((__m256i*)out, set1(v));
+					_mm256_storeu_si256((__m256i*)(out + 16), set1(v));
+				}
+
+				static void classify(const char* in, uint64_t& nonAscii, uint64_t& trails, uint64_t& lead3s)
+				{
+					const __m256i v = _mm256_loadu_si256((const __m256i*)in);
+					nonAscii = (uint32_t)_mm256_movemask_epi8(v);
+					trails = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(v, _mm256_set1_epi8((char)0xC0)), _mm256_set1_epi8((char)0x80)));
+					lead3s = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(v, _mm256_set1_epi8((char)0xF0)), _mm256_set1_epi8((char)0xE0)));
+				}
+
+				static void widenAscii(const char* in, char16_t* out)
+				{
+					_mm256_storeu_si256((__m256i*)out, _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)in)));
+					_mm256_storeu_si256((__m256i*)(out + 16), _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(in + 16))));
+				}
+			};
+#endif
+
+#if defined(_MSC_VER) || defined(__AVX512BW__)
+			template<>
+			struct TextOps<ArchType::avx512bw>
+			{
+				static constexpr bool available = true;
+				static constexpr size_t charBlock = 32;
+				static constexpr size_t byteBlock = 64;
+
+				static __m512i set1(uint16_t v) { return _mm512_set1_epi16((short)v); }
+
+				static __mmask32 inRange(__m512i v, uint16_t lo, uint16_t hi)
+				{
+					return _mm512_cmple_epu16_mask(_mm512_sub_epi16(v, set1(lo)), set1(hi - lo));
+				}
+
+				static uint64_t decompose(const char16_t* in, char16_t* leads, char16_t* tails, uint64_t& syllables)
+				{
+					const __m512i v = _mm512_loadu_si512(in);
+					const __m512i x = _mm512_sub_epi16(v, set1(0xAC00));
+					const __mmask32 syllable = inRange(v, 0xAC00, 0xD7A3);
+					const __m512i q = _mm512_srli_epi16(_mm512_mulhi_epu16(x, set1(div28Magic)), 3);
+					const __m512i coda = _mm512_maskz_sub_epi16(syllable, x, _mm512_mullo_epi16(q, set1(28)));
+					const __m512i fixed = _mm512_mask_sub_epi16(v, _mm512_cmpeq_epi16_mask(v, set1(0xB42C)), v, set1(0xB42C - 0xB410));
+					_mm512_storeu_si512(leads, _mm512_sub_epi16(fixed, coda));
+					_mm512_storeu_si512(tails, _mm512_add_epi16(coda, set1(0x11A7)));
+					syllables = syllable;
+					return _mm512_test_epi16_mask(coda, coda);
+				}
+
+				static uint64_t spaceMask(const char16_t* in)
+				{
+					const __m512i v = _mm512_loadu_si512(in);
+					__mmask32 r = inRange(v, 0x09, 0x0D);
+					r |= _mm512_cmpeq_epi16_mask(v, set1(0x20));
+					r |= _mm512_cmpeq_epi16_mask(v, set1(0xA0));
+					r |= _mm512_cmpeq_epi16_mask(v, set1(0x1680));
+					r |= inRange(v, 0x2000, 0x200A);
+					r |= _mm512_cmpeq_epi16_mask(v, set1(0x202F));
+					r |= _mm512_cmpeq_epi16_mask(v, set1(0x205F));
+					r |= _mm512_cmpeq_epi16_mask(v, set1(0x2800));
+					r |= _mm512_cmpeq_epi16_mask(v, set1(0x3000));
+					return r;
+				}
+
+				static uint64_t rangeMask(const char16_t* in, uint16_t lo, uint16_t hi)
+				{
+					return inRange(_mm512_loadu_si512(in), lo, hi);
+				}
+
+				static void copyChars(const char16_t* in, char16_t* out)
+				{
+					_mm512_storeu_si512(out, _mm512_loadu_si512(in));
+				}
+
+				static void storeIota(uint32_t* out, uint32_t s)
+				{
+					const __m512i v = _mm512_add_epi32(_mm512_set1_epi32((int)s),
+						_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+					_mm512_storeu_si512(out, v);
+					_mm512_storeu_si512(out + 16, _mm512_add_epi32(v, _mm512_set1_epi32(16)));
+				}
+
+				static void fill(uint16_t* out, uint16_t v)
+				{
+					_mm512_storeu_si512(out, set1(v));
+				}
+
+				static void classify(const char* in, uint64_t& nonAscii, uint64_t& trails, uint64_t& lead3s)
+				{
+					const __m512i v = _mm512_loadu_si512(in);
+					nonAscii = _mm512_movepi8_mask(v);
+					trails = _mm512_cmpeq_epi8_mask(_mm512_and_si512(v, _mm512_set1_epi8((char)0xC0)), _mm512_set1_epi8((char)0x80));
+					lead3s = _mm512_cmpeq_epi8_mask(_mm512_and_si512(v, _mm512_set1_epi8((char)0xF0)), _mm512_set1_epi8((char)0xE0));
+				}
+
+				static void widenAscii(const char* in, char16_t* out)
+				{
+					_mm512_storeu_si512(out, _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i*)in)));
+					_mm512_storeu_si512(out + 32, _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i*)(in + 32))));
+				}
+			};
+#endif
+		}
+	}
+}
+#endif
+
+#if CPUINFO_ARCH_ARM64 || KIWI_ARCH_ARM64
+namespace kiwi
+{
+	namespace text
+	{
+		namespace detail
+		{
+			template<>
+			struct TextOps<ArchType::neon>
+			{
+				static constexpr bool available = true;
+				static constexpr size_t charBlock = 16;
+				static constexpr size_t byteBlock = 16;
+
+				static uint16x8_t inRange(uint16x8_t v, uint16_t lo, uint16_t hi)
+				{
+					return vcleq_u16(vsubq_u16(v, vdupq_n_u16(lo)), vdupq_n_u16(hi - lo));
+				}
+
+				// 각 바이트가 0xFF 혹은 0인 벡터에서 바이트마다 한 비트씩 모은다
+				static uint64_t mask8(uint8x16_t m)
+				{
+					static const uint8_t weights[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+					const uint8x16_t w = vandq_u8(m, vld1q_u8(weights));
+					return (uint64_t)vaddv_u8(vget_low_u8(w)) | ((uint64_t)vaddv_u8(vget_high_u8(w)) << 8);
+				}
+
+				static uint64_t mask16(uint16x8_t a, uint16x8_t b)
+				{
+					return mask8(vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+				}
+
+				static uint16x8_t decomposeHalf(uint16x8_t v, char16_t* leads, char16_t* tails, uint16x8_t& syllable)
+				{
+					const uint16x8_t x = vsubq_u16(v, vdupq_n_u16(0xAC00));
+					syllable = inRange(v, 0xAC00, 0xD7A3);
+					const uint16x4_t magic = vdup_n_u16(div28Magic);
+					const uint16x8_t q = vshrq_n_u16(vcombine_u16(
+						vshrn_n_u32(vmull_u16(vget_low_u16(x), magic), 16),
+						vshrn_n_u32(vmull_u16(vget_high_u16(x), magic), 16)
+					), 3);
+					const uint16x8_t coda = vandq_u16(vmlsq_n_u16(x, q, 28), syllable);
+					const uint16x8_t fix = vandq_u16(vceqq_u16(v, vdupq_n_u16(0xB42C)), vdupq_n_u16(0xB42C - 0xB410));
+					vst1q_u16((uint16_t*)leads, vsubq_u16(vsubq_u16(v, fix), coda));
+					vst1q_u16((uint16_t*)tails, vaddq_u16(coda, vdupq_n_u16(0x11A7)));
+					return vceqq_u16(coda, vdupq_n_u16(0));
+				}
+
+				static uint64_t decompose(const char16_t* in, char16_t* leads, char16_t* tails, uint64_t& syllables)
+				{
+					uint16x8_t s0, s1;
+					const uint16x8_t n0 = decomposeHalf(vld1q_u16((const uint16_t*)in), leads, tails, s0);
+					const uint16x8_t n1 = decomposeHalf(vld1q_u16((const uint16_t*)(in + 8)), leads + 8, tails + 8, s1);
+					syllables = mask16(s0, s1);
+					return ~mask16(n0, n1) & 0xFFFF;
+				}
+
+				static uint16x8_t spaceHalf(uint16x8_t v)
+				{
+					uint16x8_t r = inRange(v, 0x09, 0x0D);
+					r = vorrq_u16(r, vceqq_u16(v, vdupq_n_u16(0x20)));
+					r = vorrq_u16(r, vceqq_u16(v, vdupq_n_u16(0xA0)));
+					r = vorrq_u16(r, vceqq_u16(v, vdupq_n_u16(0x1680)));
+					r = vorrq_u16(r, inRange(v, 0x2000, 0x200A));
+					r = vorrq_u16(r, vceqq_u16(v, vdupq_n_u16(0x202F)));
+					r = vorrq_u16(r, vceqq_u16(v, vdupq_n_u16(0x205F)));
+					r = vorrq_u16(r, vceqq_u16(v, vdupq_n_u16(0x2800)));
+					r = vorrq_u16(r, vceqq_u16(v, vdupq_n_u16(0x3000)));
+					return r;
+				}
+
+				static uint64_t spaceMask(const char16_t* in)
+				{
+					return mask16(spaceHalf(vld1q_u16((const uint16_t*)in)), spaceHalf(vld1q_u16((const uint16_t*)(in + 8))));
+				}
+
+				static uint64_t rangeMask(const char16_t* in, uint16_t lo, uint16_t hi)
+				{
+					return mask16(inRange(vld1q_u16((const uint16_t*)in), lo, hi), inRange(vld1q_u16((const uint16_t*)(in + 8)), lo, hi));
+				}
+
+				static void copyChars(const char16_t* in, char16_t* out)
+				{
+					vst1q_u16((uint16_t*)out, vld1q_u16((const uint16_t*)in));
+					vst1q_u16((uint16_t*)(out + 8), vld1q_u16((const uint16_t*)(in + 8)));
+				}
+
+				static void storeIota(uint32_t* out, uint32_t s)
+				{
+					static const uint32_t iota[4] = { 0, 1, 2, 3 };
+					uint32x4_t v = vaddq_u32(vdupq_n_u32(s), vld1q_u32(iota));
+					for (size_t i = 0; i < charBlock; i += 4)
+					{
+						vst1q_u32(out + i, v);
+						v = vaddq_u32(v, vdupq_n_u32(4));
+					}
+				}
+
+				static void fill(uint16_t* out, uint16_t v)
+				{
+					vst1q_u16(out, vdupq_n_u16(v));
+					vst1q_u16(out + 8, vdupq_n_u16(v));
+				}
+
+				static void classify(const char* in, uint64_t& nonAscii, uint64_t& trails, uint64_t& lead3s)
+				{
+					const uint8x16_t v = vld1q_u8((const uint8_t*)in);
+					nonAscii = mask8(vcgeq_u8(v, vdupq_n_u8(0x80)));
+					trails = mask8(vceqq_u8(vandq_u8(v, vdupq_n_u8(0xC0)), vdupq_n_u8(0x80)));
+					lead3s = mask8(vceqq_u8(vandq_u8(v, vdupq_n_u8(0xF0)), vdupq_n_u8(0xE0)));
+				}
+
+				static void widenAscii(const char* in, char16_t* out)
+				{
+					const uint8x16_t v = vld1q_u8((const uint8_t*)in);
+					vst1q_u16((uint16_t*)out, vmovl_u8(vget_low_u8(v)));
+					vst1q_u16((uint16_t*)(out + 8), vmovl_u8(vget_high_u8(v)));
+				}
+			};
+		}
+	}
+}
+#endif
@@ -10,6 +10,17 @@ namespace kiwi
     int toLower(char32_t c, char32_t* out);
     int toUpper(char32_t c, char32_t* out);
 
+    /* ASCII has no special casing, so its case mapping is a single offset of 0x20 and needs no table lookup. */
+    inline char32_t asciiToLower(char32_t c)
+    {
+        return c + ((char32_t)((char32_t)(c - 'A') < 26) << 5);
+    }
+
+    inline char32_t asciiToUpper(char32_t c)
+    {
+        return c - ((char32_t)((char32_t)(c - 'a') < 26) << 5);
+    }
+
     template<class CharIt>
     CharIt decodeUtf8(CharIt s, char32_t& out)
     {
@@ -106,6 +117,11 @@ namespace kiwi
         char32_t buf[4];
         while (first != last)
         {
+            if ((uint8_t)*first < 0x80)
+            {
+                *out++ = asciiToLower(*first++);
+                continue;
+            }
             first = decodeUtf8(first, c);
             size = toLower(c, buf);
             for (int i = 0; i < size; ++i)
@@ -124,6 +140,11 @@ namespace kiwi
         char32_t buf[4];
         while (first != last)
         {
+            if ((uint8_t)*first < 0x80)
+            {
+                *out++ = asciiToUpper(*first++);
+                continue;
+            }
             first = decodeUtf8(first, c);
             size = toUpper(c, buf);
             for (int i = 0; i < size; ++i)
@@ -142,6 +163,11 @@ namespace kiwi
         char32_t buf[4];
         while (first != last)
         {
+            if ((char16_t)*first < 0x80)
+            {
+                *out++ = asciiToLower(*first++);
+                continue;
+            }
             first = decodeUtf16(first, c);
             size = toLower(c, buf);
             for (int i = 0; i < size; ++i)
@@ -160,6 +186,11 @@ namespace kiwi
         char32_t buf[4];
         while (first != last)
         {
+            if ((char16_t)*first < 0x80)
+            {
+                *out++ = asciiToUpper(*first++);
+                continue;
+            }
             first = decodeUtf16(first, c);
             size = toUpper(c, buf);
             for (int i = 0; i < size; ++i)
@@ -1,17 +1,31 @@
 ﻿#include <cassert>
 #include <kiwi/Utils.h>
 #include "StrUtils.h"
+#include "TextKernels.h"
 
 namespace kiwi
 {
+	inline text::FnUtf8To16 selectedUtf8To16()
+	{
+		static const text::FnUtf8To16 fn = text::getUtf8To16Fn(getSelectedArch(ArchType::default_));
+		return fn;
+	}
+
 	std::u16string utf8To16(const std::string & str)
 	{
-		return utf8To16(nonstd::to_string_view(str));
+		std::u16string ret(str.size(), 0);
+		ret.resize(selectedUtf8To16()(str.data(), str.size(), &ret[0], nullptr));
+		return ret;
 	}
 
 	std::u16string utf8To16(const std::string& str, std::vector<size_t>& bytePositions)
 	{
-		return utf8To16(nonstd::to_string_view(str), bytePositions);
+		std::u16string ret(str.size(), 0);
+		bytePositions.resize(str.size());
+		const size_t len = selectedUtf8To16()(str.data(), str.size(), &ret[0], bytePositions.data());
+		ret.resize(len);
+		bytePositions.resize(len);
+		return ret;
 	}
 
 	size_t utf8FromCode(std::string& ret, char32_t code)
@@ -254,7 +268,7 @@ namespace kiwi
 		return 0;
 	}
 
-	size_t getSBType(const std::u16string& form)
+	size_t getSBType(U16StringView form)
 	{
 		size_t format = 0, group = 0;
 		char32_t chr = form[0];
@@ -1,4 +1,5 @@
 #include "../SkipBigramModelImpl.hpp"
+#include "../TextKernels.hpp"
 
 namespace kiwi
 {
@@ -19,4 +20,13 @@ namespace kiwi
 		template class SkipBigramModel<ArchType::avx512bw, uint32_t, 8>;
 		template class SkipBigramModel<ArchType::avx512bw, uint64_t, 8>;
 	}
+	namespace text
+	{
+		template size_t normalizeHangulWithPosition<ArchType::avx512bw>(const char16_t*, size_t, char16_t*, uint32_t*);
+		template void getWordPositions<ArchType::avx512bw>(const char16_t*, size_t, uint16_t*);
+		template void normalizeCoda<ArchType::avx512bw>(char16_t*, size_t);
+		template size_t findPatternCandidate<ArchType::avx512bw>(const char16_t*, size_t);
+		template size_t utf8To16<ArchType::avx512bw>(const char*, size_t, char16_t*, size_t*);
+		template size_t normalizeUtf8WithPosition<ArchType::avx512bw>(const char*, size_t, char16_t*, uint32_t*, size_t*, uint16_t*, std::vector<size_t>&);
+	}
 }
@@ -1,4 +1,5 @@
 #include "../SkipBigramModelImpl.hpp"
+#include "../TextKernels.hpp"
 
 namespace kiwi
 {
@@ -19,4 +20,13 @@ namespace kiwi
 		template class SkipBigramModel<ArchType::neon, uint32_t, 8>;
 		template class SkipBigramModel<ArchType::neon, uint64_t, 8>;
 	}
+	namespace text
+	{
+		template size_t normalizeHangulWithPosition<ArchType::neon>(const char16_t*, size_t, char16_t*, uint32_t*);
+		template void getWordPositions<ArchType::neon>(const char16_t*, size_t, uint16_t*);
+		template void normalizeCoda<ArchType::neon>(char16_t*, size_t);
+		template size_t findPatternCandidate<ArchType::neon>(const char16_t*, size_t);
+		template size_t utf8To16<ArchType::neon>(const char*, size_t, char16_t*, size_t*);
+		template size_t normalizeUtf8WithPosition<ArchType::neon>(const char*, size_t, char16_t*, uint32_t*, size_t*, uint16_t*, std::vector<size_t>&);
+	}
 }
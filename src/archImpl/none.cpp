@@ -1,4 +1,5 @@
 #include "../SkipBigramModelImpl.hpp"
+#include "../TextKernels.hpp"
 
 namespace kiwi
 {
@@ -14,4 +15,20 @@ namespace kiwi
 		template class SkipBigramModel<ArchType::balanced, uint32_t, 8>;
 		template class SkipBigramModel<ArchType::balanced, uint64_t, 8>;
 	}
+	namespace text
+	{
+		template size_t normalizeHangulWithPosition<ArchType::none>(const char16_t*, size_t, char16_t*, uint32_t*);
+		template void getWordPositions<ArchType::none>(const char16_t*, size_t, uint16_t*);
+		template void normalizeCoda<ArchType::none>(char16_t*, size_t);
+		template size_t findPatternCandidate<ArchType::none>(const char16_t*, size_t);
+		template size_t utf8To16<ArchType::none>(const char*, size_t, char16_t*, size_t*);
+		template size_t normalizeUtf8WithPosition<ArchType::none>(const char*, size_t, char16_t*, uint32_t*, size_t*, uint16_t*, std::vector<size_t>&);
+
+		template size_t normalizeHangulWithPosition<ArchType::balanced>(const char16_t*, size_t, char16_t*, uint32_t*);
+		template void getWordPositions<ArchType::balanced>(const char16_t*, size_t, uint16_t*);
+		template void normalizeCoda<ArchType::balanced>(char16_t*, size_t);
+		template size_t findPatternCandidate<ArchType::balanced>(const char16_t*, size_t);
+		template size_t utf8To16<ArchType::balanced>(const char*, size_t, char16_t*, size_t*);
+		template size_t normalizeUtf8WithPosition<ArchType::balanced>(const char*, size_t, char16_t*, uint32_t*, size_t*, uint16_t*, std::vector<size_t>&);
+	}
 }
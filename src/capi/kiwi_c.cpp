@@ -47,9 +47,9 @@ struct kiwi_typo : public TypoTransformer
 struct kiwi_morphset
 {
 	Kiwi* inst = nullptr;
-	std::unordered_set<const Morpheme*> morphemes;
+	MorphemeSet morphemes;
 
-	kiwi_morphset(Kiwi* _inst) : inst{ _inst }
+	kiwi_morphset(Kiwi* _inst) : inst{ _inst }, morphemes{ *_inst }
 	{
 	}
 };
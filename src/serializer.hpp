@@ -7,6 +7,7 @@
 #include <vector>
 #include <map>
 #include <unordered_map>
+#include <tuple>
 #include <cstdio>
 
 namespace kiwi
@@ -354,10 +355,38 @@ namespace kiwi
 			}
 		};
 
-		template<class _Ty1, class Ty2>
-		struct Serializer<std::unordered_map<_Ty1, Ty2>>
+		template<class... Ty>
+		struct Serializer<std::tuple<Ty...>>
+		{
+			using VTy = std::tuple<Ty...>;
+
+			template<size_t... i>
+			void writeImpl(std::ostream& ostr, const VTy& v, detail::seq<i...>)
+			{
+				writeMany(ostr, std::get<i>(v)...);
+			}
+
+			template<size_t... i>
+			void readImpl(std::istream& istr, VTy& v, detail::seq<i...>)
+			{
+				readMany(istr, std::get<i>(v)...);
+			}
+
+			void write(std::ostream& ostr, const VTy& v)
+			{
+				writeImpl(ostr, v, detail::GenSeq<sizeof...(Ty)>{});
+			}
+
+			void read(std::istream& istr, VTy& v)
+			{
+				readImpl(istr, v, detail::GenSeq<sizeof...(Ty)>{});
+			}
+		};
+
+		template<class _Ty1, class Ty2, class Hash, class Eq, class Alloc>
+		struct Serializer<std::unordered_map<_Ty1, Ty2, Hash, Eq, Alloc>>
 		{
-			using VTy = std::unordered_map<_Ty1, Ty2>;
+			using VTy = std::unordered_map<_Ty1, Ty2, Hash, Eq, Alloc>;
 			void write(std::ostream& ostr, const VTy& v)
 			{
 				writeToStream(ostr, (uint32_t)v.size());
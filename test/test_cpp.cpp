@@ -1,7 +1,19 @@
 #include "gtest/gtest.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
 #include <kiwi/Kiwi.h>
 #include <kiwi/HSDataset.h>
 #include "common.h"
+#include "../src/Knlm.hpp"
+#include "../src/FlatHashMap.hpp"
+#include "../src/Arena.hpp"
+#include "../src/FeatureTestor.h"
+#include "../src/PathEvaluator.hpp"
+#include "../src/FrozenTrie.hpp"
+#include "../src/TextKernels.h"
 
 class TestInitializer
 {
@@ -826,6 +838,36 @@ TEST(KiwiCpp, AnalyzeSBG)
 	EXPECT_EQ(tokens[8].str, u"걸");
 }
 
+// 테스트가 끝나면 지워지는 임시 파일 경로. 이미지를 연 Kiwi 객체보다 먼저 선언해야 한다.
+struct TempFile
+{
+	std::string path;
+
+	TempFile(const char* name) : path{ ::testing::TempDir() + name } {}
+	~TempFile() { std::remove(path.c_str()); }
+};
+
+TEST(KiwiCpp, AnalyzeSBGFromImage)
+{
+	TempFile image{ "test_image_sbg.kiwi" };
+	Kiwi kiwi = KiwiBuilder{ MODEL_PATH, 0, BuildOption::none, true }.build();
+	kiwi.save(image.path);
+	Kiwi loaded = Kiwi::loadImage(image.path);
+
+	for (auto& line : loadTestCorpus())
+	{
+		auto expected = kiwi.analyze(line, Match::allWithNormalizing);
+		auto actual = loaded.analyze(line, Match::allWithNormalizing);
+		ASSERT_EQ(expected.first.size(), actual.first.size());
+		for (size_t i = 0; i < expected.first.size(); ++i)
+		{
+			EXPECT_EQ(expected.first[i].str, actual.first[i].str);
+			EXPECT_EQ(expected.first[i].tag, actual.first[i].tag);
+		}
+		EXPECT_FLOAT_EQ(expected.second, actual.second);
+	}
+}
+
 TEST(KiwiCpp, AnalyzeMultithread)
 {
 	auto data = loadTestCorpus();
@@ -843,6 +885,1410 @@ TEST(KiwiCpp, AnalyzeMultithread)
 	EXPECT_EQ(data.size(), results.size());
 }
 
+TEST(KiwiCpp, AnalyzeParallelChunks)
+{
+	auto data = loadTestCorpus();
+	std::string doc;
+	for (size_t i = 0; i < data.size() && i < 100; ++i)
+	{
+		doc += data[i];
+		doc += (i % 7 == 3) ? u8" \"인용된 문장이다.\" " : u8" ";
+	}
+	auto str = utf8To16(doc);
+
+	Kiwi kiwi = KiwiBuilder{ MODEL_PATH, 4 }.build();
+	for (size_t topN : { 1, 3 })
+	{
+		kiwi.setParallelChunks(false);
+		auto expected = kiwi.analyze(str, topN, Match::allWithNormalizing);
+		kiwi.setParallelChunks(true);
+		auto actual = kiwi.analyze(str, topN, Match::allWithNormalizing);
+		ASSERT_EQ(expected.size(), actual.size());
+		for (size_t i = 0; i < expected.size(); ++i)
+		{
+			EXPECT_FLOAT_EQ(expected[i].second, actual[i].second);
+			ASSERT_EQ(expected[i].first.size(), actual[i].first.size());
+			for (size_t j = 0; j < expected[i].first.size(); ++j)
+			{
+				EXPECT_EQ(expected[i].first[j].str, actual[i].first[j].str);
+				EXPECT_EQ(expected[i].first[j].tag, actual[i].first[j].tag);
+				EXPECT_EQ(expected[i].first[j].position, actual[i].first[j].position);
+			}
+		}
+	}
+
+	// 작업량 상한이 설정되면 병렬 탐색을 쓰지 않으므로 상한과 isDegraded()가 문서 전체에 적용된다
+	AnalysisContext context;
+	context.setBudget(AnalysisBudget{ 1000 });
+	kiwi.setParallelChunks(false);
+	auto expectedBudget = kiwi.analyze(context, str, Match::allWithNormalizing);
+	const size_t expectedTransitions = context.usedTransitions();
+	EXPECT_TRUE(context.isDegraded());
+	kiwi.setParallelChunks(true);
+	auto actualBudget = kiwi.analyze(context, str, Match::allWithNormalizing);
+	EXPECT_TRUE(context.isDegraded());
+	EXPECT_EQ(context.usedTransitions(), expectedTransitions);
+	EXPECT_FLOAT_EQ(expectedBudget.second, actualBudget.second);
+	EXPECT_EQ(expectedBudget.first.size(), actualBudget.first.size());
+
+	// 워커는 자신의 기본 컨텍스트에 묶여 탐색하므로, 지정되지 않은 스레드별 arena는 쓰이지 않는다
+	std::vector<std::future<size_t>> reserved;
+	for (size_t i = 0; i < kiwi.getNumThreads() * 4; ++i)
+	{
+		reserved.emplace_back(kiwi.getThreadPool()->enqueue([](size_t)
+		{
+			EXPECT_FALSE(AnalysisContext::Impl::threadDefault().impl().inUse());
+			return utils::Arena::local().reservedBytes();
+		}));
+	}
+	for (auto& f : reserved) EXPECT_EQ(f.get(), 0);
+}
+
+TEST(KiwiCpp, StreamAnalyzer)
+{
+	Kiwi& kiwi = reuseKiwiInstance();
+	auto data = loadTestCorpus();
+	std::string doc;
+	for (size_t i = 0; i < data.size() && i < 50; ++i)
+	{
+		doc += data[i];
+		doc += (i % 3 == 2) ? "\n" : " ";
+	}
+	auto expected = kiwi.analyze(utf8To16(doc), Match::allWithNormalizing).first;
+
+	std::vector<TokenInfo> actual;
+	size_t numSents = 0, maxBuffered = 0;
+	Kiwi::StreamAnalyzer stream{ kiwi, [&](std::vector<TokenInfo>&& sent)
+	{
+		for (auto& t : sent) EXPECT_EQ(t.sentPosition, numSents);
+		numSents++;
+		actual.insert(actual.end(), sent.begin(), sent.end());
+	} };
+	// 멀티바이트 문자가 잘리도록 일정하지 않은 크기로 나누어 입력한다
+	for (size_t i = 0, step = 7; i < doc.size(); i += step, step = step % 31 + 5)
+	{
+		stream.push(doc.substr(i, step));
+		maxBuffered = std::max(maxBuffered, stream.bufferedSize());
+	}
+	stream.finish();
+	EXPECT_EQ(stream.bufferedSize(), 0);
+	EXPECT_LT(maxBuffered, doc.size() / 4);
+	// 확정된 청크 뒤에서 이어서 분석하므로 같은 텍스트를 반복해서 분석하지 않는다
+	EXPECT_LT(stream.analyzedSize(), utf8To16(doc).size() * 8);
+
+	ASSERT_EQ(expected.size(), actual.size());
+	for (size_t i = 0; i < expected.size(); ++i)
+	{
+		EXPECT_EQ(expected[i].str, actual[i].str);
+		EXPECT_EQ(expected[i].tag, actual[i].tag);
+		EXPECT_EQ(expected[i].position, actual[i].position);
+		EXPECT_EQ(expected[i].wordPosition, actual[i].wordPosition);
+		EXPECT_EQ(expected[i].sentPosition, actual[i].sentPosition);
+		EXPECT_EQ(expected[i].lineNumber, actual[i].lineNumber);
+	}
+}
+
+TEST(KiwiCpp, ResultCache)
+{
+	auto data = loadTestCorpus();
+	Kiwi kiwi = KiwiBuilder{ MODEL_PATH, 2 }.build();
+	std::vector<std::string> inputs;
+	for (size_t i = 0; i < 40 && i < data.size(); ++i) inputs.emplace_back(data[i % 20]);
+	auto expected = kiwi.analyzeBatch(inputs, Match::allWithNormalizing);
+	TokenResultColumns u8Expected;
+	kiwi.analyze(inputs[0], u8Expected, Match::allWithNormalizing);
+
+	kiwi.setResultCacheSize(16 << 20);
+	EXPECT_EQ(kiwi.getResultCacheSize(), 16 << 20);
+	auto cached = kiwi.analyzeBatch(inputs, Match::allWithNormalizing);
+	auto stats = kiwi.getResultCacheStats();
+	EXPECT_EQ(stats.hits + stats.misses, inputs.size());
+	EXPECT_GE(stats.hits, 1);
+	EXPECT_EQ(stats.entries, 20);
+	for (size_t i = 0; i < inputs.size(); ++i)
+	{
+		EXPECT_FLOAT_EQ(expected[i].second, cached[i].second);
+		EXPECT_EQ(expected[i].first, cached[i].first);
+	}
+	
+	auto res = kiwi.asyncAnalyze(inputs[0], Match::allWithNormalizing).get();
+	EXPECT_EQ(res.first, expected[0].first);
+	EXPECT_EQ(kiwi.getResultCacheStats().hits, stats.hits + 1);
+
+	// UTF-8 입력을 열 단위로 받는 경로도 같은 캐시를 사용하며, 위치와 길이는 바이트 단위로 채워진다
+	TokenResultColumns u8Cached;
+	kiwi.analyze(inputs[0], u8Cached, Match::allWithNormalizing);
+	EXPECT_EQ(kiwi.getResultCacheStats().hits, stats.hits + 2);
+	EXPECT_EQ(u8Expected.tags, u8Cached.tags);
+	EXPECT_EQ(u8Expected.positions, u8Cached.positions);
+	EXPECT_EQ(u8Expected.lengths, u8Cached.lengths);
+	EXPECT_EQ(u8Expected.u8StrPool, u8Cached.u8StrPool);
+	EXPECT_EQ(u8Expected.u8StrOffsets, u8Cached.u8StrOffsets);
+	EXPECT_FLOAT_EQ(u8Expected.score, u8Cached.score);
+
+	// 옵션이 바뀌면 캐시가 무효화된다
+	kiwi.setTypoCostWeight(kiwi.getTypoCostWeight() + 1);
+	EXPECT_EQ(kiwi.getResultCacheStats().entries, 0);
+	kiwi.analyze(inputs[0], Match::allWithNormalizing);
+	EXPECT_EQ(kiwi.getResultCacheStats().entries, 1);
+
+	// 메모리 예산을 넘지 않는다
+	kiwi.setResultCacheSize(64 << 10);
+	for (auto& d : data) kiwi.analyze(d, Match::allWithNormalizing);
+	stats = kiwi.getResultCacheStats();
+	EXPECT_LE(stats.bytes, 64 << 10);
+	EXPECT_GT(stats.entries, 0);
+
+	kiwi.setResultCacheSize(0);
+	EXPECT_EQ(kiwi.getResultCacheStats().misses, 0);
+}
+
+TEST(KiwiCpp, ResultCacheBlocklistContents)
+{
+	Kiwi kiwi = KiwiBuilder{ MODEL_PATH }.build();
+	kiwi.setResultCacheSize(16 << 20);
+	kiwi.setChunkMemo(ChunkMemoMode::exact);
+	const std::u16string str = u"좋아하다.";
+	auto found = kiwi.findMorpheme(u"좋아하");
+	ASSERT_FALSE(found.empty());
+
+	// 같은 객체의 내용이 바뀌면 캐시된 결과를 재사용하지 않는다
+	MorphemeSet set{ kiwi };
+	EXPECT_EQ(kiwi.analyze(str, Match::allWithNormalizing, &set).first[0].str, u"좋아하");
+	set.insert(found.begin(), found.end());
+	const auto blocked = kiwi.analyze(str, Match::allWithNormalizing, &set);
+	EXPECT_NE(blocked.first[0].str, u"좋아하");
+
+	// 내용이 같다면 다른 객체나 다른 타입이어도 캐시를 공유한다
+	const size_t hits = kiwi.getResultCacheStats().hits;
+	std::unordered_set<const Morpheme*> hashSet{ found.begin(), found.end() };
+	EXPECT_EQ(kiwi.analyze(str, Match::allWithNormalizing, &hashSet).first[0].str, blocked.first[0].str);
+	EXPECT_EQ(kiwi.getResultCacheStats().hits, hits + 1);
+}
+
+TEST(KiwiCpp, ChunkMemo)
+{
+	auto data = loadTestCorpus();
+	std::string doc;
+	for (size_t i = 0; i < 60 && i < data.size(); ++i)
+	{
+		doc += data[i % 15];
+		doc += (i % 4 == 1) ? u8" \"인용된 문장이다.\" " : u8" ";
+	}
+	auto str = utf8To16(doc);
+
+	Kiwi kiwi = KiwiBuilder{ MODEL_PATH }.build();
+	auto expected = kiwi.analyze(str, 2, Match::allWithNormalizing);
+
+	kiwi.setChunkMemo(ChunkMemoMode::exact);
+	EXPECT_EQ(kiwi.getChunkMemoMode(), ChunkMemoMode::exact);
+	for (size_t n = 0; n < 2; ++n)
+	{
+		auto actual = kiwi.analyze(str, 2, Match::allWithNormalizing);
+		ASSERT_EQ(expected.size(), actual.size());
+		for (size_t i = 0; i < expected.size(); ++i)
+		{
+			EXPECT_FLOAT_EQ(expected[i].second, actual[i].second);
+			ASSERT_EQ(expected[i].first.size(), actual[i].first.size());
+			for (size_t j = 0; j < expected[i].first.size(); ++j)
+			{
+				EXPECT_EQ(expected[i].first[j].str, actual[i].first[j].str);
+				EXPECT_EQ(expected[i].first[j].tag, actual[i].first[j].tag);
+				EXPECT_EQ(expected[i].first[j].position, actual[i].first[j].position);
+				EXPECT_EQ(expected[i].first[j].length, actual[i].first[j].length);
+			}
+		}
+	}
+	auto stats = kiwi.getChunkMemoStats();
+	EXPECT_GT(stats.hits, stats.misses);
+	EXPECT_EQ(stats.approximateHits, 0);
+
+	kiwi.setChunkMemo(ChunkMemoMode::approximate);
+	auto approx = kiwi.analyze(str, Match::allWithNormalizing);
+	EXPECT_GT(approx.first.size(), 0);
+	EXPECT_GT(kiwi.getChunkMemoStats().hits, 0);
+
+	kiwi.setChunkMemo(ChunkMemoMode::none);
+	EXPECT_EQ(kiwi.getChunkMemoStats().hits, 0);
+}
+
+TEST(KiwiCpp, ChunkMemoModeInvalidatesResultCache)
+{
+	Kiwi kiwi = KiwiBuilder{ MODEL_PATH }.build();
+	const std::u16string str = u"오늘은 날씨가 좋다. 내일도 날씨가 좋을까?";
+	const auto expected = kiwi.analyze(str, Match::allWithNormalizing);
+
+	kiwi.setResultCacheSize(16 << 20);
+	kiwi.setChunkMemo(ChunkMemoMode::approximate);
+	kiwi.analyze(str, Match::allWithNormalizing);
+	EXPECT_EQ(kiwi.getResultCacheStats().entries, 1);
+
+	// 방식을 바꾸면 이전 방식으로 얻은 결과를 재사용하지 않고 다시 분석한다
+	kiwi.setChunkMemo(ChunkMemoMode::none);
+	EXPECT_EQ(kiwi.getResultCacheStats().entries, 0);
+	const size_t hits = kiwi.getResultCacheStats().hits;
+	const auto actual = kiwi.analyze(str, Match::allWithNormalizing);
+	EXPECT_EQ(kiwi.getResultCacheStats().hits, hits);
+	EXPECT_FLOAT_EQ(actual.second, expected.second);
+	ASSERT_EQ(actual.first.size(), expected.first.size());
+	for (size_t i = 0; i < actual.first.size(); ++i) EXPECT_EQ(actual.first[i].str, expected.first[i].str);
+
+	// 같은 방식으로 다시 설정하는 것은 캐시를 비우지 않는다
+	kiwi.setChunkMemo(ChunkMemoMode::none);
+	EXPECT_EQ(kiwi.getResultCacheStats().entries, 1);
+}
+
+TEST(KiwiCpp, KnLMProgressBatch)
+{
+	using Model = lm::KnLangModel<ArchType::none, uint16_t>;
+	auto base = lm::KnLangModelBase::create(utils::MMap(MODEL_PATH "/sj.knlm"), ArchType::none);
+	auto* knlm = dynamic_cast<const Model*>(base.get());
+	ASSERT_NE(knlm, nullptr);
+	const size_t vocabSize = knlm->getHeader().vocab_size;
+
+	std::mt19937 rng{ 42 };
+	std::vector<int32_t> nodes(1000), batchNodes;
+	std::vector<uint16_t> nexts(nodes.size());
+	for (size_t i = 0; i < nodes.size(); ++i)
+	{
+		nodes[i] = knlm->getBosNodeIdx();
+		for (size_t j = rng() % 5; j > 0; --j) knlm->progress(nodes[i], (uint16_t)(rng() % vocabSize));
+		nexts[i] = rng() % vocabSize;
+	}
+	batchNodes = nodes;
+
+	std::vector<float> expected(nodes.size()), actual(nodes.size());
+	for (size_t i = 0; i < nodes.size(); ++i) expected[i] = knlm->progress(nodes[i], nexts[i]);
+	knlm->progressBatch(batchNodes.data(), nexts.data(), actual.data(), nodes.size());
+	for (size_t i = 0; i < nodes.size(); ++i)
+	{
+		EXPECT_EQ(expected[i], actual[i]);
+		EXPECT_EQ(nodes[i], batchNodes[i]);
+	}
+}
+
+TEST(KiwiCpp, LmTransitionMemo)
+{
+	Kiwi kiwi = KiwiBuilder{ MODEL_PATH, 0, BuildOption::default_, }.build();
+	EXPECT_TRUE(kiwi.getLmTransitionMemo());
+	auto data = loadTestCorpus();
+	if (data.size() > 50) data.resize(50);
+
+	for (size_t topN : { 1, 3 })
+	{
+		kiwi.setLmTransitionMemo(false);
+		EXPECT_EQ(kiwi.getLmTransitionMemoStats().hits, 0);
+		std::vector<std::vector<TokenResult>> expected;
+		for (auto& line : data) expected.emplace_back(kiwi.analyze(utf8To16(line), topN, Match::allWithNormalizing));
+
+		kiwi.setLmTransitionMemo(true);
+		for (size_t i = 0; i < data.size(); ++i)
+		{
+			auto actual = kiwi.analyze(utf8To16(data[i]), topN, Match::allWithNormalizing);
+			ASSERT_EQ(expected[i].size(), actual.size());
+			for (size_t r = 0; r < actual.size(); ++r)
+			{
+				EXPECT_FLOAT_EQ(expected[i][r].second, actual[r].second);
+				ASSERT_EQ(expected[i][r].first.size(), actual[r].first.size());
+				for (size_t j = 0; j < actual[r].first.size(); ++j)
+				{
+					EXPECT_EQ(expected[i][r].first[j].str, actual[r].first[j].str);
+					EXPECT_EQ(expected[i][r].first[j].tag, actual[r].first[j].tag);
+				}
+			}
+		}
+		auto stats = kiwi.getLmTransitionMemoStats();
+		EXPECT_GT(stats.hits, 0);
+		EXPECT_GT(stats.misses, 0);
+	}
+}
+
+TEST(KiwiCpp, LmTransitionMemoToggleWhileAnalyzing)
+{
+	Kiwi kiwi = KiwiBuilder{ MODEL_PATH, 0, BuildOption::default_, }.build();
+	auto data = loadTestCorpus();
+	if (data.size() > 20) data.resize(20);
+	std::vector<float> expected;
+	for (auto& line : data) expected.emplace_back(kiwi.analyze(utf8To16(line), Match::allWithNormalizing).second);
+
+	// 분석 중인 스레드가 있어도 설정을 바꿀 수 있어야 한다
+	std::atomic<bool> done{ false };
+	std::thread toggler{ [&]()
+	{
+		for (size_t i = 0; !done; ++i) kiwi.setLmTransitionMemo(i % 2 == 0);
+	} };
+	for (size_t r = 0; r < 3; ++r)
+	{
+		for (size_t i = 0; i < data.size(); ++i)
+		{
+			EXPECT_FLOAT_EQ(kiwi.analyze(utf8To16(data[i]), Match::allWithNormalizing).second, expected[i]);
+		}
+	}
+	done = true;
+	toggler.join();
+}
+
+static void testTop1Search(Kiwi& kiwi, const std::vector<std::string>& data)
+{
+	for (auto& line : data)
+	{
+		auto str = utf8To16(line);
+		kiwi.setDedicatedTop1(false);
+		auto expected = kiwi.analyze(str, 1, Match::allWithNormalizing);
+		kiwi.setDedicatedTop1(true);
+		auto actual = kiwi.analyze(str, 1, Match::allWithNormalizing);
+		ASSERT_EQ(expected.size(), actual.size());
+		EXPECT_FLOAT_EQ(expected[0].second, actual[0].second);
+		ASSERT_EQ(expected[0].first.size(), actual[0].first.size()) << line;
+		for (size_t j = 0; j < expected[0].first.size(); ++j)
+		{
+			EXPECT_EQ(expected[0].first[j].str, actual[0].first[j].str);
+			EXPECT_EQ(expected[0].first[j].tag, actual[0].first[j].tag);
+			EXPECT_EQ(expected[0].first[j].position, actual[0].first[j].position);
+			EXPECT_EQ(expected[0].first[j].length, actual[0].first[j].length);
+			EXPECT_FLOAT_EQ(expected[0].first[j].score, actual[0].first[j].score);
+		}
+	}
+}
+
+TEST(KiwiCpp, Top1Search)
+{
+	Kiwi kiwi = KiwiBuilder{ MODEL_PATH, 0, BuildOption::default_, }.build();
+	auto data = loadTestCorpus();
+	data.emplace_back(u8"그는 \"정말 그랬다.\" 라고 말했다. 1. 첫째 2. 둘째");
+	data.emplace_back(u8"나 이거 진짜 해보고 싶었거등여ㅋㅋ");
+	testTop1Search(kiwi, data);
+}
+
+TEST(KiwiCpp, Top1SearchChunkOnlyForm)
+{
+	// 후보가 모두 기분석 형태소뿐인 형태는 같은 노드를 미등재어 후보로 한 번 더 탐색하게 된다
+	KiwiBuilder builder{ MODEL_PATH, 0, BuildOption::default_, };
+	std::vector<std::pair<const char16_t*, POSTag>> analyzed;
+	analyzed.emplace_back(u"팅기", POSTag::vv);
+	analyzed.emplace_back(u"었", POSTag::ep);
+	analyzed.emplace_back(u"어", POSTag::ef);
+	builder.addWord(u"팅기", POSTag::vv);
+	builder.addPreAnalyzedWord(u"팅겼어", analyzed);
+	Kiwi kiwi = builder.build();
+	testTop1Search(kiwi, {
+		u8"팅겼어...",
+		u8"공을 팅겼어 그리고 또 팅겼어",
+		u8"어제 그 사람이 팅겼어요?",
+	});
+}
+
+struct CollidingHash
+{
+	size_t operator()(uint32_t v) const
+	{
+		// 상위 7bit는 제어값 비교에 쓰이므로 같게 만들어 탐사와 키 비교를 모두 거치게 한다
+		return (size_t)(v % 5);
+	}
+};
+
+TEST(KiwiCpp, FlatHashMap)
+{
+	utils::FlatHashMap<uint32_t, uint32_t, CollidingHash> map;
+	std::mt19937 rng{ 42 };
+	for (size_t round = 0; round < 600; ++round)
+	{
+		map.clear();
+		EXPECT_TRUE(map.empty());
+		const size_t n = round % 150 + 1;
+		std::vector<uint32_t> keys;
+		for (size_t i = 0; i < n * 2; ++i)
+		{
+			const uint32_t k = rng() % (n + 1);
+			auto inserted = map.emplace(k, (uint32_t)i);
+			auto it = std::find(keys.begin(), keys.end(), k);
+			EXPECT_EQ(inserted.second, it == keys.end());
+			if (inserted.second) keys.emplace_back(k);
+			else *inserted.first += 1000;
+		}
+		ASSERT_EQ(map.size(), keys.size());
+
+		size_t i = 0;
+		map.forEach([&](uint32_t k, uint32_t)
+		{
+			EXPECT_EQ(k, keys[i++]);
+		});
+	}
+}
+
+TEST(KiwiCpp, Arena)
+{
+	utils::Arena arena;
+	EXPECT_EQ(arena.reservedBytes(), 0);
+	{
+		utils::Arena::Scope outer{ arena };
+		utils::ArenaVector<uint64_t> a{ utils::ArenaAllocator<uint64_t>{ arena } };
+		for (uint64_t i = 0; i < 1000; ++i) a.emplace_back(i);
+		EXPECT_EQ(reinterpret_cast<uintptr_t>(a.data()) % alignof(uint64_t), 0);
+		const auto mark = arena.getMark();
+		{
+			utils::Arena::Scope inner{ arena };
+			// 블록 하나보다 큰 할당도 처리되어야 한다
+			utils::ArenaVector<uint32_t> b(100000, 7, utils::ArenaAllocator<uint32_t>{ arena });
+			EXPECT_EQ(std::count(b.begin(), b.end(), 7), 100000);
+		}
+		EXPECT_EQ(arena.getMark().ptr, mark.ptr);
+		EXPECT_EQ(arena.getMark().usedBlocks, mark.usedBlocks);
+		for (uint64_t i = 0; i < 1000; ++i) EXPECT_EQ(a[i], i);
+	}
+	EXPECT_GT(arena.reservedBytes(), 0);
+	size_t reserved = 0;
+	for (int r = 0; r < 10; ++r)
+	{
+		// 같은 크기의 할당을 반복하는 경우 이미 확보한 블록을 재사용한다
+		if (r == 1) reserved = arena.reservedBytes();
+		utils::Arena::Scope scope{ arena };
+		utils::ArenaVector<uint32_t> b(100000, 7, utils::ArenaAllocator<uint32_t>{ arena });
+		utils::ArenaUnorderedMap<uint32_t, uint32_t> m{ 16, Hash<uint32_t>{}, std::equal_to<uint32_t>{}, utils::ArenaAllocator<std::pair<const uint32_t, uint32_t>>{ arena } };
+		for (uint32_t i = 0; i < 100; ++i) m[i] = i;
+		EXPECT_EQ(m.size(), 100);
+	}
+	EXPECT_EQ(arena.reservedBytes(), reserved);
+}
+
+TEST(KiwiCpp, AnalysisContext)
+{
+	Kiwi& kiwi = reuseKiwiInstance();
+	auto data = loadTestCorpus();
+	if (data.size() > 20) data.resize(20);
+
+	AnalysisContext context;
+	EXPECT_EQ(context.memoryUsage(), 0);
+	for (auto& line : data)
+	{
+		auto expected = kiwi.analyze(line, 3, Match::allWithNormalizing);
+		auto actual = kiwi.analyze(context, line, 3, Match::allWithNormalizing);
+		ASSERT_EQ(expected.size(), actual.size());
+		for (size_t r = 0; r < actual.size(); ++r)
+		{
+			EXPECT_FLOAT_EQ(expected[r].second, actual[r].second);
+			ASSERT_EQ(expected[r].first.size(), actual[r].first.size());
+			for (size_t j = 0; j < actual[r].first.size(); ++j)
+			{
+				EXPECT_EQ(expected[r].first[j].str, actual[r].first[j].str);
+				EXPECT_EQ(expected[r].first[j].tag, actual[r].first[j].tag);
+			}
+		}
+	}
+	// 분석이 끝난 뒤에도 버퍼는 다음 분석을 위해 남아 있다
+	const size_t usage = context.memoryUsage();
+	EXPECT_GT(usage, 0);
+	EXPECT_EQ(context.shrinkCount(), 0);
+
+	TokenResultColumns cols;
+	kiwi.analyze(context, data[0], cols, Match::allWithNormalizing);
+	EXPECT_EQ(cols.tags.size(), kiwi.analyze(data[0], Match::allWithNormalizing).first.size());
+
+	context.shrink();
+	EXPECT_EQ(context.memoryUsage(), 0);
+
+	// high-water mark를 넘은 버퍼는 분석이 끝날 때 해제된다
+	AnalysisContext small{ 0 };
+	EXPECT_EQ(small.getHighWaterMark(), 0);
+	auto res = kiwi.analyze(small, data[0], Match::allWithNormalizing);
+	EXPECT_FALSE(res.first.empty());
+	EXPECT_EQ(small.memoryUsage(), 0);
+	EXPECT_EQ(small.shrinkCount(), 1);
+
+	small.setHighWaterMark(usage * 2);
+	kiwi.analyze(small, data[0], Match::allWithNormalizing);
+	EXPECT_GT(small.memoryUsage(), 0);
+	EXPECT_EQ(small.shrinkCount(), 1);
+
+	AnalysisContext moved = std::move(small);
+	EXPECT_GT(moved.memoryUsage(), 0);
+	EXPECT_EQ(moved.shrinkCount(), 1);
+}
+
+TEST(KiwiCpp, AnalysisBudget)
+{
+	Kiwi& kiwi = reuseKiwiInstance();
+	auto data = loadTestCorpus();
+	if (data.size() > 20) data.resize(20);
+
+	AnalysisContext context;
+	EXPECT_TRUE(context.getBudget().unlimited());
+	for (auto& line : data)
+	{
+		auto expected = kiwi.analyze(line, Match::allWithNormalizing);
+		auto actual = kiwi.analyze(context, line, Match::allWithNormalizing);
+		EXPECT_FALSE(context.isDegraded());
+		EXPECT_FLOAT_EQ(expected.second, actual.second);
+		ASSERT_EQ(expected.first.size(), actual.first.size());
+		for (size_t j = 0; j < actual.first.size(); ++j)
+		{
+			EXPECT_EQ(expected.first[j].str, actual.first[j].str);
+			EXPECT_EQ(expected.first[j].tag, actual.first[j].tag);
+		}
+	}
+
+	auto longest = *std::max_element(data.begin(), data.end(), [](const std::string& a, const std::string& b)
+	{
+		return a.size() < b.size();
+	});
+	auto full = kiwi.analyze(context, longest, Match::allWithNormalizing);
+	const size_t fullTransitions = context.usedTransitions();
+	EXPECT_GT(fullTransitions, 0);
+
+	// 상한에 도달한 뒤에는 탐욕적 탐색으로 전환되지만 여전히 문장 전체를 덮는 결과를 낸다
+	context.setBudget(AnalysisBudget{ 1 });
+	auto res = kiwi.analyze(context, longest, 3, Match::allWithNormalizing);
+	EXPECT_TRUE(context.isDegraded());
+	EXPECT_LT(context.usedTransitions(), fullTransitions);
+	ASSERT_FALSE(res.empty());
+	ASSERT_FALSE(res[0].first.empty());
+	EXPECT_EQ(res[0].first.back().position + res[0].first.back().length, full.first.back().position + full.first.back().length);
+
+	context.setBudget(AnalysisBudget{ 0, std::chrono::microseconds{ 1 } });
+	res = kiwi.analyze(context, longest, 3, Match::allWithNormalizing);
+	ASSERT_FALSE(res.empty());
+	EXPECT_FALSE(res[0].first.empty());
+
+	context.setBudget(AnalysisBudget{});
+	kiwi.analyze(context, longest, Match::allWithNormalizing);
+	EXPECT_FALSE(context.isDegraded());
+	EXPECT_EQ(context.usedTransitions(), fullTransitions);
+}
+
+TEST(KiwiCpp, BeamOptions)
+{
+	Kiwi& kiwi = reuseKiwiInstance();
+	auto data = loadTestCorpus();
+	if (data.size() > 20) data.resize(20);
+	EXPECT_TRUE(kiwi.getBeamOptions().unlimited());
+	EXPECT_THROW(kiwi.setBeamOptions(BeamOptions{ 0, 0.f }), std::invalid_argument);
+	EXPECT_THROW(kiwi.setBeamOptions(BeamOptions{ 0, 1.5f }), std::invalid_argument);
+
+	auto analyzeAll = [&](size_t topN, size_t& transitions)
+	{
+		AnalysisContext context;
+		std::vector<std::vector<TokenResult>> ret;
+		transitions = 0;
+		for (auto& line : data)
+		{
+			ret.emplace_back(kiwi.analyze(context, line, topN, Match::allWithNormalizing));
+			transitions += context.usedTransitions();
+		}
+		return ret;
+	};
+
+	for (size_t topN : { 1, 3 })
+	{
+		size_t baseTransitions, transitions;
+		auto expected = analyzeAll(topN, baseTransitions);
+
+		// 충분히 넓은 빔은 결과를 바꾸지 않는다
+		kiwi.setBeamOptions(BeamOptions{ 1000000 });
+		auto actual = analyzeAll(topN, transitions);
+		for (size_t i = 0; i < data.size(); ++i)
+		{
+			ASSERT_EQ(expected[i].size(), actual[i].size());
+			for (size_t r = 0; r < actual[i].size(); ++r)
+			{
+				EXPECT_FLOAT_EQ(expected[i][r].second, actual[i][r].second);
+				EXPECT_EQ(expected[i][r].first.size(), actual[i][r].first.size());
+			}
+		}
+		EXPECT_EQ(transitions, baseTransitions);
+
+		for (auto& opts : { BeamOptions{ 1 }, BeamOptions{ 0, 0.5f }, BeamOptions{ 0, 1.f, 64 }, BeamOptions{ 0, 1.f, 0, true } })
+		{
+			kiwi.setBeamOptions(opts);
+			actual = analyzeAll(topN, transitions);
+			for (size_t i = 0; i < data.size(); ++i)
+			{
+				ASSERT_FALSE(actual[i].empty());
+				EXPECT_FALSE(actual[i][0].first.empty());
+			}
+		}
+		kiwi.setBeamOptions(BeamOptions{ 1 });
+		analyzeAll(topN, transitions);
+		EXPECT_LT(transitions, baseTransitions);
+		kiwi.setBeamOptions(BeamOptions{});
+	}
+}
+
+TEST(KiwiCpp, MorphemeSet)
+{
+	Kiwi& kiwi = reuseKiwiInstance();
+	const std::u16string str = u"좋아하다.";
+	auto found = kiwi.findMorpheme(u"좋아하");
+	ASSERT_FALSE(found.empty());
+
+	MorphemeSet set{ kiwi };
+	EXPECT_TRUE(set.empty());
+	set.insert(found.begin(), found.end());
+	EXPECT_EQ(set.size(), found.size());
+	EXPECT_FALSE(set.insert(found[0]));
+	EXPECT_TRUE(set.contains(found[0]));
+	EXPECT_FALSE(set.contains(kiwi.idToMorph(0)));
+	Morpheme foreign;
+	EXPECT_FALSE(set.insert(&foreign));
+	EXPECT_FALSE(set.insert(nullptr));
+	EXPECT_FALSE(set.contains(&foreign));
+
+	std::unordered_set<const Morpheme*> hashSet{ found.begin(), found.end() };
+	EXPECT_EQ(kiwi.analyze(str, Match::allWithNormalizing).first[0].str, u"좋아하");
+	auto byHashSet = kiwi.analyze(str, Match::allWithNormalizing, &hashSet);
+	auto byBitset = kiwi.analyze(str, Match::allWithNormalizing, &set);
+	EXPECT_NE(byHashSet.first[0].str, u"좋아하");
+	ASSERT_EQ(byHashSet.first.size(), byBitset.first.size());
+	for (size_t i = 0; i < byBitset.first.size(); ++i)
+	{
+		EXPECT_EQ(byHashSet.first[i].str, byBitset.first[i].str);
+		EXPECT_EQ(byHashSet.first[i].tag, byBitset.first[i].tag);
+	}
+	EXPECT_EQ(MorphemeSet(kiwi, hashSet).size(), set.size());
+
+	EXPECT_EQ(kiwi.asyncAnalyze(str, Match::allWithNormalizing, &set).get().first[0].str, byBitset.first[0].str);
+
+	size_t numRead = 0;
+	kiwi.analyze(1, [&]() -> std::u16string
+	{
+		return numRead++ < 3 ? str : std::u16string{};
+	}, [&](std::vector<TokenResult>&& res)
+	{
+		EXPECT_EQ(res[0].first[0].str, byBitset.first[0].str);
+	}, Match::allWithNormalizing, &set);
+
+	for (auto m : found) EXPECT_TRUE(set.erase(m));
+	EXPECT_TRUE(set.empty());
+	EXPECT_EQ(kiwi.analyze(str, Match::allWithNormalizing, &set).first[0].str, u"좋아하");
+}
+
+TEST(KiwiCpp, LeftCondMask)
+{
+	auto check = [](const std::u16string& form)
+	{
+		const auto* first = form.data();
+		const auto* last = form.data() + form.size();
+		const uint16_t mask = FeatureTestor::leftContextMask(first, last);
+		for (size_t v = 0; v <= (size_t)CondVowel::applosive; ++v)
+		{
+			for (size_t p = 0; p <= (size_t)CondPolarity::non_adj; ++p)
+			{
+				EXPECT_EQ(FeatureTestor::isMatched(mask, (CondVowel)v, (CondPolarity)p),
+					FeatureTestor::isMatched(first, last, (CondVowel)v, (CondPolarity)p));
+			}
+		}
+	};
+
+	check(u"");
+	for (char16_t c = u'\uAC00'; c <= u'\uD7A3'; ++c)
+	{
+		check(std::u16string{ c });
+		check(std::u16string{ c, u'\u11AF' });
+		check(std::u16string{ c, u'\uC774' });
+	}
+	for (char16_t c = u'\u11A8'; c <= u'\u11C2'; ++c) check(std::u16string{ u'\uAC00', c });
+	for (char16_t c : { u'a', u'1', u'.', u')' }) check(std::u16string{ c });
+
+	Kiwi& kiwi = reuseKiwiInstance();
+	for (size_t i = 0; i < kiwi.getMorphemeSize(); ++i)
+	{
+		auto* m = kiwi.idToMorph(i);
+		EXPECT_EQ(m->leftCondMask, FeatureTestor::leftContextMask(m->kform));
+	}
+}
+
+TEST(KiwiCpp, EvalTransitionPrefixCombineSocket)
+{
+	Kiwi& kiwi = reuseKiwiInstance();
+	// 결합 소켓을 가진 좌측 형태소(예: `더/V`)와 같은 소켓으로 결합하는 청크 형태소(예: `워/UNK`)를 찾는다
+	std::unordered_map<uint8_t, const Morpheme*> rights;
+	for (size_t i = 0; i < kiwi.getMorphemeSize(); ++i)
+	{
+		auto* m = kiwi.idToMorph(i);
+		if (m->combineSocket && !m->chunks.empty() && !m->complex) rights.emplace(m->combineSocket, m);
+	}
+	const Morpheme* left = nullptr, * right = nullptr;
+	for (size_t i = 0; i < kiwi.getMorphemeSize() && !left; ++i)
+	{
+		auto* m = kiwi.idToMorph(i);
+		if (!m->combineSocket || !m->chunks.empty()) continue;
+		auto it = rights.find(m->combineSocket);
+		if (it == rights.end()) continue;
+		left = m;
+		right = it->second;
+	}
+	ASSERT_TRUE(left && right);
+
+	using Path = WordLL<VoidState<ArchType::none>>;
+	// 두 경로 모두 좌측 결합조건을 만족하지 않도록 마스크를 비워둔다
+	Path socketPath{ left, 0, 0, nullptr, {}, {} };
+	socketPath.wid = (Wid)kiwi.morphToId(left);
+	socketPath.combineSocket = left->combineSocket;
+	socketPath.leftCondMask = 0;
+	Path plainPath{ right->chunks[0], 0, 0, nullptr, {}, {} };
+	plainPath.wid = (Wid)kiwi.morphToId(right->chunks[0]);
+	plainPath.leftCondMask = 0;
+
+	const KGraphNode prev{ 0, 1 }, node{ 1, 2 };
+	std::array<Wid, 4> seq = { 0, };
+	const size_t chSize = right->chunks.size();
+	for (size_t i = 0; i < chSize; ++i) seq[i] = right->chunks[i]->lmMorphemeId;
+
+	// 결합조건 때문에 거부되더라도 결합 소켓에 의한 seq[0] 변경은 이후의 경로에 그대로 유지되어야 한다
+	float candScore = 0;
+	EXPECT_FALSE(PathEvaluator::evalTransitionPrefix(candScore, &kiwi, socketPath, &prev, &node, seq, chSize, right, 0.f, 0.f));
+	EXPECT_EQ(seq[0], left->getCombined()->lmMorphemeId);
+
+	const float ignoreCondScore = -10;
+	EXPECT_TRUE(PathEvaluator::evalTransitionPrefix(candScore, &kiwi, plainPath, &prev, &node, seq, chSize, right, 0.f, ignoreCondScore));
+	EXPECT_FLOAT_EQ(candScore, ignoreCondScore);
+	EXPECT_EQ(seq[0], left->getCombined()->lmMorphemeId);
+}
+
+TEST(KiwiCpp, AnalyzeBatch)
+{
+	auto data = loadTestCorpus();
+	Kiwi kiwi = KiwiBuilder{ MODEL_PATH, 2 }.build();
+	auto results = kiwi.analyzeBatch(data, Match::all);
+	ASSERT_EQ(data.size(), results.size());
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		auto expected = kiwi.analyze(data[i], Match::all);
+		ASSERT_EQ(expected.first.size(), results[i].first.size());
+		for (size_t j = 0; j < expected.first.size(); ++j)
+		{
+			EXPECT_EQ(expected.first[j].str, results[i].first[j].str);
+			EXPECT_EQ(expected.first[j].position, results[i].first[j].position);
+		}
+		EXPECT_FLOAT_EQ(expected.second, results[i].second);
+	}
+
+	std::vector<std::u16string> u16data;
+	for (size_t i = 0; i < 5 && i < data.size(); ++i) u16data.emplace_back(utf8To16(data[i]));
+	auto u16results = kiwi.analyzeBatch(u16data, Match::all);
+	for (size_t i = 0; i < u16data.size(); ++i)
+	{
+		EXPECT_FLOAT_EQ(results[i].second, u16results[i].second);
+	}
+
+	// 모든 워커가 analyzeBatch를 호출해도 교착 상태에 빠지지 않아야 한다
+	std::vector<std::future<std::vector<TokenResult>>> nested;
+	for (size_t t = 0; t < kiwi.getNumThreads(); ++t)
+	{
+		nested.emplace_back(kiwi.getThreadPool()->enqueue([&](size_t)
+		{
+			return kiwi.analyzeBatch(u16data, Match::all);
+		}));
+	}
+	for (auto& f : nested)
+	{
+		auto r = f.get();
+		ASSERT_EQ(u16data.size(), r.size());
+		for (size_t i = 0; i < r.size(); ++i)
+		{
+			EXPECT_FLOAT_EQ(u16results[i].second, r[i].second);
+		}
+	}
+}
+
+TEST(KiwiCpp, AnalyzeColumns)
+{
+	Kiwi& kiwi = reuseKiwiInstance();
+	TokenResultColumns columns;
+	for (auto str : { u"이 번호로 전화를 이따가 꼭 반드시 걸어.", u"나는 학교에 갔다. 그리고 집에 왔다." })
+	{
+		auto expected = kiwi.analyze(str, Match::allWithNormalizing);
+		kiwi.analyze(str, columns, Match::allWithNormalizing, nullptr, {}, true);
+		ASSERT_EQ(expected.first.size(), columns.size());
+		EXPECT_FLOAT_EQ(expected.second, columns.score);
+		for (size_t i = 0; i < columns.size(); ++i)
+		{
+			auto& t = expected.first[i];
+			EXPECT_EQ(t.str, std::u16string(columns.strData(i), columns.strSize(i)));
+			EXPECT_EQ(utf16To8(t.str), std::string(columns.u8StrData(i), columns.u8StrSize(i)));
+			EXPECT_EQ(t.tag, columns.tags[i]);
+			EXPECT_EQ(t.position, columns.positions[i]);
+			EXPECT_EQ(t.length, columns.lengths[i]);
+			EXPECT_EQ(t.wordPosition, columns.wordPositions[i]);
+			EXPECT_EQ(t.sentPosition, columns.sentPositions[i]);
+			EXPECT_EQ((uint32_t)kiwi.morphToId(t.morph), columns.morphIds[i]);
+		}
+	}
+}
+
+TEST(KiwiCpp, AnalyzeUtf8Columns)
+{
+	Kiwi& kiwi = reuseKiwiInstance();
+	TokenResultColumns columns;
+	for (std::string str : { u8"이 번호로 전화를 이따가 꼭 반드시 걸어.", u8"😀 이모지와\r\n줄바꿈이 섞인 문장입니다. abc 123" })
+	{
+		std::vector<size_t> bytePositions;
+		auto u16str = utf8To16(str, bytePositions);
+		bytePositions.emplace_back(str.size());
+		auto expected = kiwi.analyze(u16str, Match::allWithNormalizing);
+		kiwi.analyze(str, columns, Match::allWithNormalizing);
+		ASSERT_EQ(expected.first.size(), columns.size());
+		EXPECT_FLOAT_EQ(expected.second, columns.score);
+		EXPECT_TRUE(columns.strPool.empty());
+		for (size_t i = 0; i < columns.size(); ++i)
+		{
+			auto& t = expected.first[i];
+			EXPECT_EQ(utf16To8(t.str), std::string(columns.u8StrData(i), columns.u8StrSize(i)));
+			EXPECT_EQ(t.tag, columns.tags[i]);
+			EXPECT_EQ(bytePositions[t.position], columns.positions[i]);
+			EXPECT_EQ(bytePositions[t.position + t.length] - bytePositions[t.position], columns.lengths[i]);
+			EXPECT_EQ(t.wordPosition, columns.wordPositions[i]);
+			EXPECT_EQ(t.sentPosition, columns.sentPositions[i]);
+		}
+	}
+}
+
+TEST(KiwiCpp, AnalyzeUtf8ColumnsLongToken)
+{
+	Kiwi& kiwi = reuseKiwiInstance();
+	TokenResultColumns columns;
+	// UTF16으로는 16비트에 들어가지만 UTF-8 바이트 길이는 16비트를 넘는 토큰
+	std::string longToken;
+	for (size_t i = 0; i < 25000; ++i) longToken += u8"가";
+	const std::string str = u8"긴 " + longToken + u8" 토큰";
+	const size_t begin = std::string{ u8"긴 " }.size();
+	kiwi.analyze(str, columns, Match::allWithNormalizing, nullptr, { PretokenizedSpan{ (uint32_t)begin, (uint32_t)(begin + longToken.size()), {} } });
+	auto it = std::find(columns.positions.begin(), columns.positions.end(), (uint32_t)begin);
+	ASSERT_NE(it, columns.positions.end());
+	EXPECT_EQ(columns.lengths[it - columns.positions.begin()], longToken.size());
+}
+
+TEST(KiwiCpp, AnalyzeColumnsDirect)
+{
+	Kiwi& kiwi = reuseKiwiInstance();
+	auto data = loadTestCorpus();
+	std::string doc;
+	for (size_t i = 0; i < 20 && i < data.size(); ++i) doc += data[i] + " ";
+	const auto str = utf8To16(doc);
+
+	// 열 단위 결과는 경로에서 바로 채워지므로, 이전 결과가 남아 있는 객체를 재사용해도 TokenResult와 같은 내용이어야 한다
+	TokenResultColumns columns;
+	kiwi.analyze(utf8To16(data[0]), columns, Match::allWithNormalizing, nullptr, {}, true);
+	const auto expected = kiwi.analyze(str, Match::allWithNormalizing);
+	kiwi.analyze(str, columns, Match::allWithNormalizing, nullptr, {}, true);
+
+	ASSERT_EQ(expected.first.size(), columns.size());
+	EXPECT_FLOAT_EQ(expected.second, columns.score);
+	for (size_t i = 0; i < columns.size(); ++i)
+	{
+		auto& t = expected.first[i];
+		EXPECT_EQ(t.str, std::u16string(columns.strData(i), columns.strSize(i)));
+		EXPECT_EQ(utf16To8(t.str), std::string(columns.u8StrData(i), columns.u8StrSize(i)));
+		EXPECT_EQ(t.tag, columns.tags[i]);
+		EXPECT_EQ(t.position, columns.positions[i]);
+		EXPECT_EQ(t.length, columns.lengths[i]);
+		EXPECT_EQ(t.wordPosition, columns.wordPositions[i]);
+		EXPECT_EQ(t.sentPosition, columns.sentPositions[i]);
+		EXPECT_EQ((uint32_t)kiwi.morphToId(t.morph), columns.morphIds[i]);
+	}
+}
+
+TEST(KiwiCpp, FrozenTrieMapFrom)
+{
+	const std::vector<std::u16string> words = { u"가", u"가나", u"가나다", u"나다", u"다라", u"라마바" };
+	utils::ContinuousTrie<utils::TrieNode<kchar_t, uint32_t>> trie{ 1 };
+	for (size_t i = 0; i < words.size(); ++i)
+	{
+		trie.build(words[i].begin(), words[i].end(), (uint32_t)(i + 1));
+	}
+	utils::FrozenTrie<kchar_t, uint32_t> frozen{ trie, ArchTypeHolder<ArchType::none>{} };
+
+	// 트라이 앞에 정렬되지 않은 데이터가 있어도 배열들은 정렬되어 기록되어야 한다
+	std::ostringstream oss;
+	oss.write("abc", 3);
+	frozen.writeTo(oss);
+	const auto buf = oss.str();
+	utils::MemoryOwner owner{ buf.size() };
+	std::memcpy(owner.get(), buf.data(), buf.size());
+	utils::MemoryObject mem{ std::move(owner) };
+
+	auto checkSame = [&](const utils::FrozenTrie<kchar_t, uint32_t>& t)
+	{
+		ASSERT_EQ(t.size(), frozen.size());
+		for (size_t i = 0; i < t.size(); ++i)
+		{
+			EXPECT_EQ(t.value(i), frozen.value(i));
+		}
+		for (size_t i = 0; i < words.size(); ++i)
+		{
+			auto* node = t.root();
+			for (auto c : words[i])
+			{
+				node = node->template nextOpt<ArchType::none>(t, c);
+				ASSERT_NE(node, nullptr);
+			}
+			EXPECT_EQ(node->val(t), i + 1);
+		}
+		EXPECT_EQ(t.root()->template nextOpt<ArchType::none>(t, u'마'), nullptr);
+	};
+
+	utils::imstream istr{ (const char*)mem.get(), (ptrdiff_t)mem.size() };
+	istr.seekg(3);
+	auto mapped = utils::FrozenTrie<kchar_t, uint32_t>::mapFrom(istr, mem);
+	EXPECT_TRUE(mapped.isView());
+	EXPECT_EQ(istr.curptr(), (const char*)mem.get() + mem.size());
+	checkSame(mapped);
+
+	auto copied = mapped;
+	EXPECT_TRUE(copied.isView());
+	EXPECT_EQ(copied.root(), mapped.root());
+	checkSame(copied);
+
+	std::istringstream iss{ buf };
+	iss.seekg(3);
+	auto loaded = utils::FrozenTrie<kchar_t, uint32_t>::readFrom(iss, [](size_t idx) { return (uint32_t)(idx + 1); });
+	EXPECT_FALSE(loaded.isView());
+	checkSame(loaded);
+}
+
+TEST(KiwiCpp, SaveAndLoadImage)
+{
+	KiwiBuilder builder{ MODEL_PATH, 0, BuildOption::default_, };
+	for (auto* typos : { (const TypoTransformer*)nullptr, &getDefaultTypoSet(DefaultTypoSet::basicTypoSetWithContinual) })
+	{
+		TempFile image{ "test_image.kiwi" };
+		Kiwi kiwi = typos ? builder.build(*typos) : builder.build();
+		kiwi.save(image.path);
+		Kiwi loaded = Kiwi::loadImage(image.path);
+		EXPECT_EQ(kiwi.isTypoTolerant(), loaded.isTypoTolerant());
+		EXPECT_EQ(kiwi.getMorphemeSize(), loaded.getMorphemeSize());
+		EXPECT_FALSE(kiwi.getKnLM()->isRuntimeLayout());
+		EXPECT_TRUE(loaded.getKnLM()->isRuntimeLayout());
+
+		for (auto& line : loadTestCorpus())
+		{
+			auto expected = kiwi.analyze(line, Match::allWithNormalizing);
+			auto actual = loaded.analyze(line, Match::allWithNormalizing);
+			ASSERT_EQ(expected.first.size(), actual.first.size());
+			for (size_t i = 0; i < expected.first.size(); ++i)
+			{
+				EXPECT_EQ(expected.first[i].str, actual.first[i].str);
+				EXPECT_EQ(expected.first[i].tag, actual.first[i].tag);
+				EXPECT_EQ(expected.first[i].position, actual.first[i].position);
+				EXPECT_EQ(kiwi.morphToId(expected.first[i].morph), loaded.morphToId(actual.first[i].morph));
+			}
+			EXPECT_FLOAT_EQ(expected.second, actual.second);
+		}
+
+		auto joiner = loaded.newJoiner();
+		joiner.add(u"먹", POSTag::vv);
+		joiner.add(u"었", POSTag::ep);
+		joiner.add(u"다", POSTag::ef);
+		EXPECT_EQ(joiner.getU16(), u"먹었다");
+	}
+}
+
+TEST(KiwiCpp, SaveAndLoadImageOptions)
+{
+	TempFile image{ "test_image_options.kiwi" };
+	Kiwi kiwi = KiwiBuilder{ MODEL_PATH, 0, BuildOption::default_, }.build(DefaultTypoSet::withoutTypo, 2.5f, TrieBackend::doubleArray);
+	BeamOptions beam;
+	beam.maxStatesPerNode = 4;
+	beam.marginRatio = 0.5f;
+	beam.adaptive = true;
+	kiwi.setBeamOptions(beam);
+	kiwi.setDedicatedTop1(false);
+	kiwi.setParallelChunks(true);
+	kiwi.setResultCacheSize(1 << 20);
+	kiwi.setChunkMemo(ChunkMemoMode::exact, 1 << 20);
+	kiwi.save(image.path);
+
+	Kiwi loaded = Kiwi::loadImage(image.path);
+	EXPECT_EQ(loaded.trieBackend(), TrieBackend::doubleArray);
+	EXPECT_EQ(loaded.getBeamOptions().maxStatesPerNode, 4);
+	EXPECT_FLOAT_EQ(loaded.getBeamOptions().marginRatio, 0.5f);
+	EXPECT_TRUE(loaded.getBeamOptions().adaptive);
+	EXPECT_FALSE(loaded.getDedicatedTop1());
+	EXPECT_TRUE(loaded.getParallelChunks());
+	EXPECT_EQ(loaded.getLmTransitionMemo(), kiwi.getLmTransitionMemo());
+	EXPECT_EQ(loaded.getResultCacheSize(), 1 << 20);
+	EXPECT_EQ(loaded.getChunkMemoMode(), ChunkMemoMode::exact);
+	EXPECT_EQ(loaded.getChunkMemoSize(), 1 << 20);
+
+	for (auto& line : loadTestCorpus())
+	{
+		auto expected = kiwi.analyze(line, Match::allWithNormalizing);
+		auto actual = loaded.analyze(line, Match::allWithNormalizing);
+		ASSERT_EQ(expected.first.size(), actual.first.size());
+		for (size_t i = 0; i < expected.first.size(); ++i)
+		{
+			EXPECT_EQ(expected.first[i].str, actual.first[i].str);
+			EXPECT_EQ(expected.first[i].tag, actual.first[i].tag);
+		}
+		EXPECT_FLOAT_EQ(expected.second, actual.second);
+	}
+}
+
+TEST(KiwiCpp, LoadCorruptedImage)
+{
+	TempFile image{ "test_image_corrupted.kiwi" };
+	Kiwi& kiwi = reuseKiwiInstance();
+	std::ostringstream oss;
+	kiwi.save(oss);
+	const std::string buf = oss.str();
+
+	// 잘린 이미지는 범위 밖을 읽지 않고 예외를 발생시켜야 한다
+	for (size_t size : { buf.size() / 2, buf.size() * 3 / 4, buf.size() - 1 })
+	{
+		{
+			std::ofstream ofs{ image.path, std::ios_base::binary };
+			ofs.write(buf.data(), size);
+		}
+		EXPECT_ANY_THROW(Kiwi::loadImage(image.path)) << size;
+	}
+}
+
+TEST(KiwiCpp, DoubleArrayTrie)
+{
+	KiwiBuilder builder{ MODEL_PATH, 0, BuildOption::default_, };
+	for (auto* typos : { &getDefaultTypoSet(DefaultTypoSet::withoutTypo), &getDefaultTypoSet(DefaultTypoSet::basicTypoSetWithContinual) })
+	{
+		Kiwi kiwi = builder.build(*typos);
+		Kiwi daKiwi = builder.build(*typos, 2.5f, TrieBackend::doubleArray);
+		EXPECT_EQ(kiwi.trieBackend(), TrieBackend::frozen);
+		EXPECT_EQ(daKiwi.trieBackend(), TrieBackend::doubleArray);
+
+		for (auto& line : loadTestCorpus())
+		{
+			auto expected = kiwi.analyze(line, 3, Match::allWithNormalizing);
+			auto actual = daKiwi.analyze(line, 3, Match::allWithNormalizing);
+			ASSERT_EQ(expected.size(), actual.size());
+			for (size_t r = 0; r < expected.size(); ++r)
+			{
+				ASSERT_EQ(expected[r].first.size(), actual[r].first.size());
+				for (size_t i = 0; i < expected[r].first.size(); ++i)
+				{
+					EXPECT_EQ(expected[r].first[i].str, actual[r].first[i].str);
+					EXPECT_EQ(expected[r].first[i].tag, actual[r].first[i].tag);
+					EXPECT_EQ(expected[r].first[i].position, actual[r].first[i].position);
+				}
+				EXPECT_FLOAT_EQ(expected[r].second, actual[r].second);
+			}
+		}
+	}
+}
+
+TEST(KiwiCpp, TextKernels)
+{
+	std::mt19937 rng{ 42 };
+	auto randomChar = [&]() -> char16_t
+	{
+		switch (rng() % 10)
+		{
+		case 0: return u" \t\n\r"[rng() % 4];
+		case 1: return (char16_t)(0x20 + rng() % 0x5F);
+		case 2: return u"\u00A0\u1680\u2000\u2005\u200A\u200B\u202F\u205F\u2800\u3000\u2028"[rng() % 11];
+		case 3: return (char16_t)(0x3131 + rng() % 0x33);
+		case 4: return rng() % 2 ? u'\uB42C' : u'\uB410';
+		case 5: return (char16_t)(0x80 + rng() % 0x780);
+		case 6: return (char16_t)(0x1100 + rng() % 0x100);
+		default: return (char16_t)(0xAC00 + rng() % 11172);
+		}
+	};
+
+	std::vector<std::u16string> inputs;
+	inputs.emplace_back();
+	inputs.emplace_back(100, u'a');
+	inputs.emplace_back(100, u' ');
+	inputs.emplace_back(100, u'\uAC01');
+	for (size_t i = 0; i < 2000; ++i)
+	{
+		std::u16string str;
+		const size_t len = rng() % 300;
+		const size_t mode = rng() % 4;
+		while (str.size() < len)
+		{
+			// 블록 전체가 ASCII이거나 공백이 없는 경우도 만들어지도록 치우친 분포를 섞는다
+			if (mode == 0) str.push_back((char16_t)(0x61 + rng() % 26));
+			else if (mode == 1 && rng() % 8) str.push_back((char16_t)(0xAC00 + rng() % 11172));
+			else if (rng() % 50 == 0)
+			{
+				const uint32_t code = 0x10000 + rng() % 0xFFFFF;
+				str.push_back((char16_t)(0xD800 | ((code - 0x10000) >> 10)));
+				str.push_back((char16_t)(0xDC00 | ((code - 0x10000) & 0x3FF)));
+			}
+			else str.push_back(randomChar());
+		}
+		inputs.emplace_back(std::move(str));
+	}
+
+	// 스칼라 구현(ArchType::none)을 기준으로 모든 아키텍처의 결과가 같은지 확인한다
+	auto refNormalizeHangul = text::getNormalizeHangulWithPositionFn(ArchType::none);
+	auto refNormalizeCoda = text::getNormalizeCodaFn(ArchType::none);
+	auto refUtf8To16 = text::getUtf8To16Fn(ArchType::none);
+	for (auto arch : { ArchType::none, ArchType::balanced, ArchType::sse2, ArchType::sse4_1, ArchType::avx2, ArchType::avx512bw, ArchType::neon })
+	{
+		if (getSelectedArch(arch) != arch) continue;
+		auto normalizeHangul = text::getNormalizeHangulWithPositionFn(arch);
+		auto getWordPositions = text::getGetWordPositionsFn(arch);
+		auto normalizeCoda = text::getNormalizeCodaFn(arch);
+		auto utf8To16 = text::getUtf8To16Fn(arch);
+
+		for (auto& str : inputs)
+		{
+			KString expectedStr(str.size() * 2, 0);
+			std::vector<uint32_t> expectedPos(str.size() + 1);
+			expectedStr.resize(refNormalizeHangul(str.data(), str.size(), &expectedStr[0], expectedPos.data()));
+			KString normalized(str.size() * 2, 0);
+			std::vector<uint32_t> pos(str.size() + 1);
+			normalized.resize(normalizeHangul(str.data(), str.size(), &normalized[0], pos.data()));
+			EXPECT_EQ(normalized, expectedStr) << archToStr(arch);
+			EXPECT_EQ(pos, expectedPos) << archToStr(arch);
+			EXPECT_EQ(pos.back(), normalized.size()) << archToStr(arch);
+
+			std::vector<uint16_t> expectedWordPos;
+			uint16_t wordPos = 0;
+			bool continuousSpace = false;
+			for (auto c : str)
+			{
+				expectedWordPos.emplace_back(wordPos);
+				if (isSpace(c) && !continuousSpace) ++wordPos;
+				continuousSpace = isSpace(c);
+			}
+			std::vector<uint16_t> wordPositions(str.size());
+			getWordPositions(str.data(), str.size(), wordPositions.data());
+			EXPECT_EQ(wordPositions, expectedWordPos) << archToStr(arch);
+
+			refNormalizeCoda(&expectedStr[0], expectedStr.size());
+			normalizeCoda(&normalized[0], normalized.size());
+			EXPECT_EQ(normalized, expectedStr) << archToStr(arch);
+
+			std::string u8str = utf16To8(str);
+			std::vector<size_t> expectedBytePos;
+			for (size_t i = 0, b = 0; i < str.size(); ++i)
+			{
+				expectedBytePos.emplace_back(b);
+				if (0xD800 <= str[i] && str[i] < 0xDC00)
+				{
+					expectedBytePos.emplace_back(b);
+					++i;
+					b += 4;
+				}
+				else b += str[i] < 0x80 ? 1 : (str[i] < 0x800 ? 2 : 3);
+			}
+			std::u16string expectedU16 = str;
+
+			for (size_t corrupt = 0; corrupt < 2; ++corrupt)
+			{
+				std::string expectedError, error;
+				if (corrupt)
+				{
+					if (u8str.empty()) break;
+					u8str[rng() % u8str.size()] = (char)(0x80 + rng() % 0x80);
+					expectedU16.assign(u8str.size(), 0);
+					expectedBytePos.resize(u8str.size());
+					try
+					{
+						const size_t len = refUtf8To16(u8str.data(), u8str.size(), &expectedU16[0], expectedBytePos.data());
+						expectedU16.resize(len);
+						expectedBytePos.resize(len);
+					}
+					catch (const UnicodeException& e)
+					{
+						expectedError = e.what();
+					}
+				}
+
+				std::u16string u16(u8str.size(), 0);
+				std::vector<size_t> bytePos(u8str.size());
+				try
+				{
+					const size_t len = utf8To16(u8str.data(), u8str.size(), &u16[0], bytePos.data());
+					u16.resize(len);
+					bytePos.resize(len);
+				}
+				catch (const UnicodeException& e)
+				{
+					error = e.what();
+				}
+
+				EXPECT_EQ(error, expectedError) << archToStr(arch);
+				if (!expectedError.empty()) continue;
+				EXPECT_EQ(u16, expectedU16) << archToStr(arch);
+				EXPECT_EQ(bytePos, expectedBytePos) << archToStr(arch);
+			}
+		}
+	}
+}
+
+TEST(KiwiCpp, NormalizeUtf8WithPosition)
+{
+	std::mt19937 rng{ 42 };
+	const std::vector<std::u16string> fragments = {
+		u"a", u"abc ", u" ", u"  ", u"\t", u"\r\n", u"\r", u"\n", u"\u2028", u"\u0085",
+		u"\uAC00", u"\uAC01\uB42C", u"\u3131", u"\u00E9", u"\U0001F44D", u"\u2000", u"\u3000",
+	};
+
+	std::vector<std::string> inputs;
+	inputs.emplace_back();
+	for (size_t i = 0; i < 200; ++i)
+	{
+		// 내부적으로 잘라서 처리하는 구간의 경계에 여러 바이트 문자가 걸치도록 충분히 길게 만든다
+		std::u16string str;
+		const size_t len = rng() % 5000;
+		while (str.size() < len) str += fragments[rng() % fragments.size()];
+		inputs.emplace_back(utf16To8(str));
+	}
+
+	// utf8To16, normalizeHangulWithPosition, getWordPositions를 차례로 적용한 결과와 같아야 한다
+	for (auto arch : { ArchType::none, ArchType::balanced, ArchType::sse2, ArchType::sse4_1, ArchType::avx2, ArchType::avx512bw, ArchType::neon })
+	{
+		if (getSelectedArch(arch) != arch) continue;
+		auto utf8To16 = text::getUtf8To16Fn(arch);
+		auto normalizeHangul = text::getNormalizeHangulWithPositionFn(arch);
+		auto getWordPositions = text::getGetWordPositionsFn(arch);
+		auto normalizeUtf8 = text::getNormalizeUtf8WithPositionFn(arch);
+		for (auto& u8str : inputs)
+		{
+			std::u16string u16(u8str.size(), 0);
+			std::vector<size_t> expectedBytePos(u8str.size());
+			const size_t len = utf8To16(u8str.data(), u8str.size(), &u16[0], expectedBytePos.data());
+			u16.resize(len);
+			expectedBytePos.resize(len);
+			KString expectedStr(len * 2, 0);
+			std::vector<uint32_t> expectedPos(len + 1);
+			expectedStr.resize(normalizeHangul(u16.data(), len, &expectedStr[0], expectedPos.data()));
+			std::vector<uint16_t> expectedWordPos(len);
+			getWordPositions(u16.data(), len, expectedWordPos.data());
+			std::vector<size_t> expectedNewlines;
+			bool isCR = false;
+			for (size_t i = 0; i < len; ++i)
+			{
+				if (isNewLine(u16[i], isCR)) expectedNewlines.emplace_back(i);
+			}
+
+			KString normalized(u8str.size(), 0);
+			std::vector<uint32_t> pos(u8str.size() + 1);
+			std::vector<size_t> bytePos(u8str.size() + 1), newlines;
+			std::vector<uint16_t> wordPos(u8str.size());
+			const size_t n = normalizeUtf8(u8str.data(), u8str.size(), &normalized[0], pos.data(), bytePos.data(), wordPos.data(), newlines);
+			ASSERT_EQ(n, len) << archToStr(arch);
+			normalized.resize(pos[n]);
+			pos.resize(n + 1);
+			bytePos.resize(n);
+			wordPos.resize(n);
+			EXPECT_EQ(normalized, expectedStr) << archToStr(arch);
+			EXPECT_EQ(pos, expectedPos) << archToStr(arch);
+			EXPECT_EQ(bytePos, expectedBytePos) << archToStr(arch);
+			EXPECT_EQ(wordPos, expectedWordPos) << archToStr(arch);
+			EXPECT_EQ(newlines, expectedNewlines) << archToStr(arch);
+		}
+
+		std::string broken = inputs.back() + "\x80";
+		KString normalized(broken.size(), 0);
+		std::vector<uint32_t> pos(broken.size() + 1);
+		std::vector<size_t> bytePos(broken.size() + 1), newlines;
+		std::vector<uint16_t> wordPos(broken.size());
+		EXPECT_THROW(normalizeUtf8(broken.data(), broken.size(), &normalized[0], pos.data(), bytePos.data(), wordPos.data(), newlines), UnicodeException) << archToStr(arch);
+	}
+}
+
+TEST(KiwiCpp, FindPatterns)
+{
+	std::mt19937 rng{ 42 };
+	const std::vector<std::u16string> fragments = {
+		u"http://", u"https://", u"www.", u"kiwi", u".com", u".co.kr", u"/path?q=1&x=2", u":8080", u"/",
+		u"@", u"#", u"user", u"_name", u"mail", u"+tag", u"%", u"-", u".", u",", u":", u"(", u")",
+		u"0", u"12", u"1,000", u",00", u"3.14", u"2023-01-01", u"12:30:45", u"1/2/3", u"010-1234-5678", u"1. ", u"１２",
+		u"U.S.A. ", u"e.g.", u"Mr. ", u"abcdefgh.", u"h", u"ttp",
+		u"\U0001F44D", u"❤️", u"‍", u"\U0001F3FB", u"\U0001F468‍\U0001F469", u"©️", u"㊙️",
+		u" ", u"  ", u"\t", u"\n", u"한글", u"을", u"ㄱㄱ", u"ᆫ",
+	};
+
+	std::vector<std::u16string> inputs;
+	inputs.emplace_back();
+	inputs.emplace_back(100, u'a');
+	inputs.emplace_back(100, u'1');
+	inputs.emplace_back(100, u'가');
+	for (size_t i = 0; i < 3000; ++i)
+	{
+		std::u16string str;
+		const size_t numFragments = rng() % 40;
+		for (size_t j = 0; j < numFragments; ++j)
+		{
+			if (rng() % 8 == 0) str.push_back((char16_t)(0x20 + rng() % 0x5F));
+			else str += fragments[rng() % fragments.size()];
+		}
+		inputs.emplace_back(std::move(str));
+	}
+
+	// 각 위치에서 matchPattern()을 호출하고 매칭된 길이만큼 건너뛰는 결과와 같아야 한다
+	auto findByMatchPattern = [](const std::u16string& str, size_t from, Match matchOptions)
+	{
+		std::vector<std::tuple<uint32_t, uint32_t, POSTag>> ret;
+		for (size_t n = from; n < str.size();)
+		{
+			auto m = matchPattern(n ? str[n - 1] : u' ', str.data() + n, str.data() + str.size(), matchOptions);
+			if (m.first)
+			{
+				ret.emplace_back((uint32_t)n, (uint32_t)(n + m.first), m.second);
+				n += m.first;
+			}
+			else ++n;
+		}
+		return ret;
+	};
+
+	const Match matchOptionsList[] = { Match::none, Match::all, Match::url | Match::email, Match::serial | Match::emoji, Match::hashtag | Match::mention };
+	for (auto arch : { ArchType::none, ArchType::balanced, ArchType::sse2, ArchType::sse4_1, ArchType::avx2, ArchType::avx512bw, ArchType::neon })
+	{
+		if (getSelectedArch(arch) != arch) continue;
+		for (auto& str : inputs)
+		{
+			for (auto matchOptions : matchOptionsList)
+			{
+				const size_t from = str.empty() ? 0 : rng() % (str.size() + 1);
+				for (size_t f : { (size_t)0, from })
+				{
+					auto expected = findByMatchPattern(str, f, matchOptions);
+					Vector<PatternSpan> spans;
+					findPatterns(str.data(), str.size(), f, str.size(), matchOptions, spans, arch);
+					std::vector<std::tuple<uint32_t, uint32_t, POSTag>> found;
+					for (auto& s : spans) found.emplace_back(s.begin, s.end, s.tag);
+					EXPECT_EQ(found, expected) << archToStr(arch) << " " << utf16To8(str);
+
+					// 짧은 구간씩 나누어 이어서 찾아도 결과가 같아야 한다
+					spans.clear();
+					const size_t window = 1 + rng() % 16;
+					for (size_t n = f; n < str.size();)
+					{
+						n = findPatterns(str.data(), str.size(), n, n + window, matchOptions, spans, arch);
+					}
+					found.clear();
+					for (auto& s : spans) found.emplace_back(s.begin, s.end, s.tag);
+					EXPECT_EQ(found, expected) << archToStr(arch) << " window=" << window << " " << utf16To8(str);
+				}
+			}
+		}
+	}
+}
+
+TEST(KiwiCpp, AnalyzeLongDocumentPatterns)
+{
+	Kiwi& kiwi = reuseKiwiInstance();
+	// 패턴이 시작될 수 있는 문자가 많은 문장을 이어 붙여도, 각 청크 안의 패턴은 문장 하나를 분석할 때와 똑같이 인식되어야 한다.
+	// 문서 길이에 따른 분석 시간은 tools/benchmark.cpp의 longdoc 벤치마크로 확인한다.
+	const std::u16string sentence = u"2023-01-01에 https://kiwi.com/path 에서 user@mail.com 으로 1,000개를 보냈다. ";
+	const size_t repeat = 500;
+	auto single = kiwi.analyze(sentence, Match::all).first;
+	std::u16string doc;
+	for (size_t i = 0; i < repeat; ++i) doc += sentence;
+	auto res = kiwi.analyze(doc, Match::all).first;
+
+	ASSERT_EQ(res.size(), single.size() * repeat);
+	for (size_t i = 0; i < res.size(); ++i)
+	{
+		auto& expected = single[i % single.size()];
+		EXPECT_EQ(res[i].str, expected.str);
+		EXPECT_EQ(res[i].tag, expected.tag);
+		EXPECT_EQ(res[i].position, expected.position + (i / single.size()) * sentence.size());
+	}
+}
+
 TEST(KiwiCpp, AnalyzeError01)
 {
 	Kiwi& kiwi = reuseKiwiInstance();
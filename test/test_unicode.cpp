@@ -0,0 +1,47 @@
+#include "gtest/gtest.h"
+#include <kiwi/ScriptType.h>
+#include "../src/UnicodeCase.h"
+
+using namespace kiwi;
+
+TEST(KiwiCppUnicode, ScriptTypeTable)
+{
+	for (char32_t c = 0; c < 0x110100; ++c)
+	{
+		ASSERT_EQ(chr2ScriptType(c), chr2ScriptTypeByRanges(c)) << std::hex << (uint32_t)c;
+	}
+
+	EXPECT_EQ(chr2ScriptType(U'a'), ScriptType::latin);
+	EXPECT_EQ(chr2ScriptType(U'@'), ScriptType::unknown);
+	EXPECT_EQ(chr2ScriptType(U'한'), ScriptType::hangul);
+	EXPECT_EQ(chr2ScriptType(U'漢'), ScriptType::hanja);
+	EXPECT_EQ(chr2ScriptType(0x1F600), ScriptType::emoticons);
+	EXPECT_EQ(chr2ScriptType(0xE0001), ScriptType::tags);
+}
+
+TEST(KiwiCppUnicode, CaseMapping)
+{
+	for (char32_t c = 0; c < 0x80; ++c)
+	{
+		const bool upper = U'A' <= c && c <= U'Z', lower = U'a' <= c && c <= U'z';
+		EXPECT_EQ(toLower(c), upper ? c + 0x20 : c);
+		EXPECT_EQ(toUpper(c), lower ? c - 0x20 : c);
+	}
+
+	// 단일 문자 대응은 전체 대응의 결과가 한 글자일 때 그것과 같아야 한다
+	char32_t buf[4];
+	for (char32_t c = 0; c < 0x110100; ++c)
+	{
+		if (toLower(c, buf) == 1) ASSERT_EQ(toLower(c), buf[0]) << std::hex << (uint32_t)c;
+		if (toUpper(c, buf) == 1) ASSERT_EQ(toUpper(c), buf[0]) << std::hex << (uint32_t)c;
+	}
+
+	EXPECT_EQ(toLower(0x212A), U'k');
+	EXPECT_EQ(toLower(0x130, buf), 2);
+	EXPECT_EQ(buf[0], U'i');
+	EXPECT_EQ(buf[1], 0x307);
+	EXPECT_EQ(toUpper(0xDF, buf), 2);
+	EXPECT_EQ(toLower(std::u16string{ u"ÀBC Ω Kiwi" }), u"àbc ω kiwi");
+	EXPECT_EQ(toUpper(std::u16string{ u"àbc ω Kiwi" }), u"ÀBC Ω KIWI");
+	EXPECT_EQ(toLower(std::string{ u8"ÀBC Ω Kiwi" }), u8"àbc ω kiwi");
+}
@@ -0,0 +1,717 @@
+#include <iostream>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <cstring>
+#include <random>
+#include <unordered_map>
+
+#include <kiwi/Kiwi.h>
+#include <tclap/CmdLine.h>
+#include "toolUtils.h"
+#include "../src/FlatHashMap.hpp"
+#include "../src/KTrie.h"
+#include "../src/FrozenTrie.hpp"
+#include "../src/DoubleArrayTrie.hpp"
+#include "../src/ArchAvailable.h"
+#include "../src/TextKernels.h"
+#include "../src/UnicodeCase.h"
+
+using namespace std;
+using namespace kiwi;
+
+struct BenchmarkInput
+{
+	vector<u16string> lines;
+	size_t bytes = 0;
+	int repeat = 1;
+	const KiwiBuilder* builder = nullptr;
+};
+
+void printElapsed(const string& name, double tm, const BenchmarkInput& input)
+{
+	const double kb = input.bytes * input.repeat / 1024.;
+	cout << name << ": " << tm << " ms, " << kb / (tm / 1000) << " KB/s" << endl;
+}
+
+int benchTop1(Kiwi& kw, const BenchmarkInput& input)
+{
+	size_t mismatches = 0;
+	double elapsed[2] = { 0, };
+	vector<TokenResult> results[2];
+	// 캐시 효과를 고르게 하기 위해 두 방식을 번갈아 실행한다
+	for (int r = 0; r < input.repeat; ++r)
+	{
+		for (bool dedicated : { false, true })
+		{
+			kw.setDedicatedTop1(dedicated);
+			auto& out = results[dedicated ? 1 : 0];
+			out.clear();
+			tutils::Timer timer;
+			for (auto& line : input.lines)
+			{
+				out.emplace_back(kw.analyze(line, 1, Match::allWithNormalizing)[0]);
+			}
+			elapsed[dedicated ? 1 : 0] += timer.getElapsed();
+		}
+
+		for (size_t i = 0; i < results[0].size(); ++i)
+		{
+			auto& a = results[0][i].first;
+			auto& b = results[1][i].first;
+			if (a.size() != b.size() || !equal(a.begin(), a.end(), b.begin(), [](const TokenInfo& x, const TokenInfo& y)
+			{
+				return x.str == y.str && x.tag == y.tag && x.position == y.position;
+			}))
+			{
+				++mismatches;
+			}
+		}
+	}
+
+	printElapsed("generic search", elapsed[0], input);
+	printElapsed("dedicated top-1 search", elapsed[1], input);
+	cout << "Speed-up: " << elapsed[0] / elapsed[1] << "x" << endl;
+	cout << "Mismatches: " << mismatches << endl;
+	return mismatches ? 1 : 0;
+}
+
+int benchLmMemo(Kiwi& kw, const BenchmarkInput& input)
+{
+	for (size_t topN : { 1, 3 })
+	{
+		double elapsed[2] = { 0, };
+		LmMemoStats stats;
+		for (int r = 0; r < input.repeat; ++r)
+		{
+			for (bool memo : { false, true })
+			{
+				kw.setLmTransitionMemo(memo);
+				tutils::Timer timer;
+				for (auto& line : input.lines)
+				{
+					kw.analyze(line, topN, Match::allWithNormalizing);
+				}
+				elapsed[memo ? 1 : 0] += timer.getElapsed();
+				if (memo) stats = kw.getLmTransitionMemoStats();
+			}
+		}
+
+		cout << "topN=" << topN << endl;
+		printElapsed("without memo", elapsed[0], input);
+		printElapsed("with memo", elapsed[1], input);
+		cout << "Hit ratio: " << (double)stats.hits / max(stats.hits + stats.misses, (size_t)1)
+			<< " (" << stats.hits << " / " << stats.hits + stats.misses << ")" << endl;
+	}
+	return 0;
+}
+
+// PathHash<SbgState>와 같은 배치를 가진 키
+struct BeamKey
+{
+	int32_t node;
+	array<uint16_t, 4> lastMorphemes;
+	uint8_t rootId, spState;
+
+	bool operator==(const BeamKey& o) const
+	{
+		return node == o.node && lastMorphemes == o.lastMorphemes && rootId == o.rootId && spState == o.spState;
+	}
+};
+
+// 기존 PathHash의 해시: 메모리를 워드 단위로 xor한다
+struct XorBeamKeyHash
+{
+	size_t operator()(const BeamKey& p) const
+	{
+		size_t ret = 0;
+		auto ptr = reinterpret_cast<const uint32_t*>(&p);
+		for (size_t i = 0; i < sizeof(BeamKey) / sizeof(uint32_t); ++i)
+		{
+			ret ^= ptr[i];
+		}
+		return ret;
+	}
+};
+
+struct MixBeamKeyHash
+{
+	size_t operator()(const BeamKey& p) const
+	{
+		uint64_t h = (uint32_t)p.node;
+		for (auto m : p.lastMorphemes)
+		{
+			h = (h ^ m) * 0x9e3779b97f4a7c15ull;
+		}
+		h ^= ((uint64_t)p.rootId << 40) | ((uint64_t)p.spState << 48);
+		return (size_t)utils::mixHash(h);
+	}
+};
+
+template<class Map, class InsertFn>
+double runPathMap(Map& map, const vector<vector<BeamKey>>& rounds, size_t& sum, InsertFn&& insert)
+{
+	tutils::Timer timer;
+	for (auto& keys : rounds)
+	{
+		map.clear();
+		for (size_t i = 0; i < keys.size(); ++i)
+		{
+			sum += insert(map, keys[i], (uint32_t)i);
+		}
+		sum += map.size();
+	}
+	return timer.getElapsed();
+}
+
+int benchPathMap(Kiwi&, const BenchmarkInput& input)
+{
+	mt19937_64 rng{ 42 };
+	for (size_t beamSize : { 4, 16, 64, 256 })
+	{
+		// 형태소 하나를 평가할 때처럼, 후보 수의 4배만큼 삽입하며 그 중 3/4은 이미 있는 키와 겹친다
+		const size_t numRounds = (1 << 20) / beamSize;
+		vector<vector<BeamKey>> rounds(numRounds);
+		for (auto& keys : rounds)
+		{
+			const int32_t baseNode = uniform_int_distribution<int32_t>{ 0, 1 << 20 }(rng);
+			vector<BeamKey> distinct(beamSize);
+			for (auto& k : distinct)
+			{
+				memset(&k, 0, sizeof(k));
+				k.node = baseNode + uniform_int_distribution<int32_t>{ 0, 64 }(rng);
+				for (auto& m : k.lastMorphemes) m = uniform_int_distribution<uint16_t>{ 0, 2048 }(rng);
+				k.spState = uniform_int_distribution<int>{ 0, 3 }(rng);
+			}
+			for (size_t i = 0; i < beamSize * 4; ++i)
+			{
+				keys.emplace_back(distinct[uniform_int_distribution<size_t>{ 0, beamSize - 1 }(rng)]);
+			}
+		}
+
+		double elapsed[3] = { 0, };
+		size_t sums[3] = { 0, };
+		unordered_map<BeamKey, uint32_t, XorBeamKeyHash> xorMap;
+		unordered_map<BeamKey, uint32_t, MixBeamKeyHash> mixMap;
+		utils::FlatHashMap<BeamKey, uint32_t, MixBeamKeyHash> flatMap;
+		for (int r = 0; r < input.repeat; ++r)
+		{
+			elapsed[0] += runPathMap(xorMap, rounds, sums[0], [](unordered_map<BeamKey, uint32_t, XorBeamKeyHash>& m, const BeamKey& k, uint32_t v)
+			{
+				return m.emplace(k, v).first->second;
+			});
+			elapsed[1] += runPathMap(mixMap, rounds, sums[1], [](unordered_map<BeamKey, uint32_t, MixBeamKeyHash>& m, const BeamKey& k, uint32_t v)
+			{
+				return m.emplace(k, v).first->second;
+			});
+			elapsed[2] += runPathMap(flatMap, rounds, sums[2], [](utils::FlatHashMap<BeamKey, uint32_t, MixBeamKeyHash>& m, const BeamKey& k, uint32_t v)
+			{
+				return *m.emplace(k, v).first;
+			});
+		}
+
+		const double ops = numRounds * beamSize * 4. * input.repeat;
+		cout << "beam=" << beamSize << endl;
+		cout << "  unordered_map + xor hash: " << elapsed[0] / ops * 1e6 << " ns/op" << endl;
+		cout << "  unordered_map + mix hash: " << elapsed[1] / ops * 1e6 << " ns/op" << endl;
+		cout << "  FlatHashMap + mix hash: " << elapsed[2] / ops * 1e6 << " ns/op" << endl;
+		if (sums[0] != sums[1] || sums[0] != sums[2])
+		{
+			cout << "Mismatches in results!" << endl;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+// splitByTrie와 같은 방식으로 트라이를 따라가며 일치하는 형태의 수를 센다
+template<ArchType arch, class Trie>
+size_t scanTrie(const Trie& trie, const vector<u16string>& lines)
+{
+	size_t found = 0;
+	auto countMatches = [&](decltype(trie.root()) node)
+	{
+		for (auto submatcher = node; submatcher; submatcher = submatcher->fail())
+		{
+			auto cand = submatcher->val(trie);
+			if (!cand) break;
+			else if (!trie.hasSubmatch(cand)) ++found;
+		}
+	};
+
+	for (auto& line : lines)
+	{
+		auto* curNode = trie.root();
+		for (auto c : line)
+		{
+			auto* nextNode = curNode->template nextOpt<arch>(trie, c);
+			while (!nextNode)
+			{
+				if (!curNode->fail()) break;
+				curNode = curNode->fail();
+				countMatches(curNode);
+				nextNode = curNode->template nextOpt<arch>(trie, c);
+			}
+			curNode = nextNode ? nextNode : trie.root();
+			countMatches(curNode);
+		}
+	}
+	return found;
+}
+
+using FnScanFrozenTrie = decltype(&scanTrie<ArchType::none, utils::FrozenTrie<kchar_t, const Form*>>);
+
+struct ScanFrozenTrieGetter
+{
+	template<std::ptrdiff_t i>
+	struct Wrapper
+	{
+		static constexpr FnScanFrozenTrie value = &scanTrie<static_cast<ArchType>(i), utils::FrozenTrie<kchar_t, const Form*>>;
+	};
+};
+
+int benchTrie(Kiwi& kw, const BenchmarkInput& input)
+{
+	// 모든 형태소의 형태로 사전 트라이를 만든다
+	vector<u16string> formStrs;
+	for (size_t i = 0; i < kw.getMorphemeSize(); ++i)
+	{
+		auto* kform = kw.idToMorph(i)->kform;
+		if (kform && !kform->empty()) formStrs.emplace_back(kform->begin(), kform->end());
+	}
+	sort(formStrs.begin(), formStrs.end());
+	formStrs.erase(unique(formStrs.begin(), formStrs.end()), formStrs.end());
+
+	vector<Form> forms(formStrs.size());
+	utils::ContinuousTrie<KTrie> formTrie{ 1 };
+	{
+		size_t estimatedNodeSize = 0;
+		for (auto& f : formStrs) estimatedNodeSize += f.size();
+		formTrie.reserveMore(estimatedNodeSize);
+		decltype(formTrie)::CacheStore<u16string> cache;
+		for (size_t i = 0; i < formStrs.size(); ++i)
+		{
+			formTrie.buildWithCaching(formStrs[i], &forms[i], cache);
+		}
+	}
+
+	utils::DoubleArrayTrie<kchar_t, const Form*> daTrie{ formTrie };
+	auto frozenTrie = utils::freezeTrie(move(formTrie), kw.archType());
+	static tp::Table<FnScanFrozenTrie, AvailableArch> scanFrozen{ ScanFrozenTrieGetter{} };
+	auto* scanFrozenFn = scanFrozen[static_cast<std::ptrdiff_t>(kw.archType())];
+
+	size_t found[2] = { 0, };
+	double elapsed[2] = { 0, };
+	for (int r = 0; r < input.repeat; ++r)
+	{
+		tutils::Timer timer;
+		found[0] = (*scanFrozenFn)(frozenTrie, input.lines);
+		elapsed[0] += timer.getElapsed();
+		timer.reset();
+		found[1] = scanTrie<ArchType::none>(daTrie, input.lines);
+		elapsed[1] += timer.getElapsed();
+	}
+
+	cout << "Forms: " << formStrs.size() << endl;
+	cout << "FrozenTrie: " << frozenTrie.memoryUsage() / 1024. << " KB" << endl;
+	cout << "DoubleArrayTrie: " << daTrie.memoryUsage() / 1024. << " KB (" << daTrie.size() << " slots)" << endl;
+	printElapsed("FrozenTrie scan", elapsed[0], input);
+	printElapsed("DoubleArrayTrie scan", elapsed[1], input);
+	cout << "Speed-up: " << elapsed[0] / elapsed[1] << "x" << endl;
+	if (found[0] != found[1])
+	{
+		cout << "Mismatches in results!" << endl;
+		return 1;
+	}
+
+	if (!input.builder) return 0;
+
+	// 형태 분할을 포함한 전체 분석 시간도 비교한다
+	Kiwi daKiwi = input.builder->build({}, 2.5f, TrieBackend::doubleArray);
+	double analyzeElapsed[2] = { 0, };
+	for (int r = 0; r < input.repeat; ++r)
+	{
+		Kiwi* kiwis[2] = { &kw, &daKiwi };
+		for (size_t i = 0; i < 2; ++i)
+		{
+			tutils::Timer timer;
+			for (auto& line : input.lines)
+			{
+				kiwis[i]->analyze(line, 1, Match::allWithNormalizing);
+			}
+			analyzeElapsed[i] += timer.getElapsed();
+		}
+	}
+	printElapsed("analyze with FrozenTrie", analyzeElapsed[0], input);
+	printElapsed("analyze with DoubleArrayTrie", analyzeElapsed[1], input);
+	return 0;
+}
+
+int benchText(Kiwi& kw, const BenchmarkInput& input)
+{
+	// 분석 전처리(UTF-8 변환, 한글 분해, 어절 번호 생성)만 스칼라 구현과 선택된 아키텍처에서 각각 측정한다
+	vector<string> u8lines;
+	size_t maxLen = 0;
+	for (auto& line : input.lines)
+	{
+		u8lines.emplace_back(utf16To8(line));
+		maxLen = max(maxLen, u8lines.back().size());
+	}
+
+	u16string u16(maxLen, 0), normalized(maxLen * 2, 0);
+	vector<size_t> bytePositions(maxLen);
+	vector<uint32_t> positions(maxLen + 1);
+	vector<uint16_t> wordPositions(maxLen);
+
+	const ArchType archs[2] = { ArchType::none, kw.archType() };
+	double elapsed[2] = { 0, };
+	size_t checksum[2] = { 0, };
+	for (size_t i = 0; i < 2; ++i)
+	{
+		auto utf8To16Fn = text::getUtf8To16Fn(archs[i]);
+		auto normalizeHangulFn = text::getNormalizeHangulWithPositionFn(archs[i]);
+		auto getWordPositionsFn = text::getGetWordPositionsFn(archs[i]);
+		tutils::Timer timer;
+		for (int r = 0; r < input.repeat; ++r)
+		{
+			for (auto& line : u8lines)
+			{
+				const size_t len = utf8To16Fn(line.data(), line.size(), &u16[0], bytePositions.data());
+				checksum[i] += normalizeHangulFn(u16.data(), len, &normalized[0], positions.data());
+				getWordPositionsFn(u16.data(), len, wordPositions.data());
+				checksum[i] += len ? wordPositions[len - 1] : 0;
+			}
+		}
+		elapsed[i] = timer.getElapsed();
+	}
+
+	printElapsed(string{ "text (" } + archToStr(archs[0]) + ")", elapsed[0], input);
+	printElapsed(string{ "text (" } + archToStr(archs[1]) + ")", elapsed[1], input);
+	cout << "Speed-up: " << elapsed[0] / elapsed[1] << "x" << endl;
+	if (checksum[0] != checksum[1])
+	{
+		cout << "Mismatches in results!" << endl;
+		return 1;
+	}
+
+	// 입력 전체를 하나의 문서로 이어 붙여, 중간 UTF-16 사본을 거치는 방식과 구간별로 한 번에 처리하는 방식을 비교한다
+	string doc;
+	for (auto& line : u8lines) doc += line + "\n";
+	const size_t n = doc.size();
+	u16.resize(n);
+	normalized.resize(n * 2);
+	bytePositions.resize(n + 1);
+	positions.resize(n + 1);
+	wordPositions.resize(n);
+	vector<size_t> newlines;
+	double docElapsed[2] = { 0, };
+	size_t docChecksum[2] = { 0, };
+	{
+		auto utf8To16Fn = text::getUtf8To16Fn(archs[1]);
+		auto normalizeHangulFn = text::getNormalizeHangulWithPositionFn(archs[1]);
+		auto getWordPositionsFn = text::getGetWordPositionsFn(archs[1]);
+		tutils::Timer timer;
+		for (int r = 0; r < input.repeat; ++r)
+		{
+			newlines.clear();
+			const size_t len = utf8To16Fn(doc.data(), n, &u16[0], bytePositions.data());
+			docChecksum[0] += normalizeHangulFn(u16.data(), len, &normalized[0], positions.data());
+			getWordPositionsFn(u16.data(), len, wordPositions.data());
+			bool isCR = false;
+			for (size_t i = 0; i < len; ++i)
+			{
+				if (isNewLine(u16[i], isCR)) newlines.emplace_back(i);
+			}
+			docChecksum[0] += newlines.size() + (len ? wordPositions[len - 1] : 0);
+		}
+		docElapsed[0] = timer.getElapsed();
+	}
+	{
+		auto normalizeUtf8Fn = text::getNormalizeUtf8WithPositionFn(archs[1]);
+		tutils::Timer timer;
+		for (int r = 0; r < input.repeat; ++r)
+		{
+			newlines.clear();
+			const size_t len = normalizeUtf8Fn(doc.data(), n, &normalized[0], positions.data(), bytePositions.data(), wordPositions.data(), newlines);
+			docChecksum[1] += positions[len];
+			docChecksum[1] += newlines.size() + (len ? wordPositions[len - 1] : 0);
+		}
+		docElapsed[1] = timer.getElapsed();
+	}
+	printElapsed(string{ "text document, multi-pass (" } + archToStr(archs[1]) + ")", docElapsed[0], input);
+	printElapsed(string{ "text document, fused (" } + archToStr(archs[1]) + ")", docElapsed[1], input);
+	if (docChecksum[0] != docChecksum[1])
+	{
+		cout << "Mismatches in results!" << endl;
+		return 1;
+	}
+	return 0;
+}
+
+int benchScript(Kiwi& kw, const BenchmarkInput& input)
+{
+	// 라틴 문자, 한자, 이모지 등이 섞인 문자열을 만든다
+	mt19937 rng{ 42 };
+	vector<char32_t> chrs;
+	for (size_t i = 0; i < 100000; ++i)
+	{
+		switch (rng() % 6)
+		{
+		case 0: chrs.emplace_back(U'A' + rng() % 58); break;
+		case 1: chrs.emplace_back(0xC0 + rng() % 0x190); break;
+		case 2: chrs.emplace_back(0x4E00 + rng() % 0x5200); break;
+		case 3: chrs.emplace_back(0x3040 + rng() % 0xC0); break;
+		case 4: chrs.emplace_back(0x1F300 + rng() % 0x700); break;
+		default: chrs.emplace_back(0x400 + rng() % 0x100); break;
+		}
+	}
+	const double kb = chrs.size() * input.repeat / 1024.;
+
+	auto measure = [&](const char* name, size_t(*fn)(const vector<char32_t>&))
+	{
+		size_t checksum = 0;
+		tutils::Timer timer;
+		for (int r = 0; r < input.repeat; ++r) checksum += fn(chrs);
+		const double tm = timer.getElapsed();
+		cout << name << ": " << tm << " ms, " << kb / (tm / 1000) << " Kchr/s" << endl;
+		return checksum;
+	};
+
+	const size_t byRanges = measure("chr2ScriptType (ranges)", [](const vector<char32_t>& chrs)
+	{
+		size_t sum = 0;
+		for (auto c : chrs) sum += (size_t)chr2ScriptTypeByRanges(c);
+		return sum;
+	});
+	const size_t byTable = measure("chr2ScriptType (table)", [](const vector<char32_t>& chrs)
+	{
+		size_t sum = 0;
+		for (auto c : chrs) sum += (size_t)chr2ScriptType(c);
+		return sum;
+	});
+	measure("toLower16", [](const vector<char32_t>& chrs)
+	{
+		// 공백 단위로 나눈 토큰마다 소문자로 변환한다
+		static u16string text;
+		if (text.empty())
+		{
+			for (size_t i = 0; i < chrs.size(); ++i)
+			{
+				encodeUtf16(chrs[i], back_inserter(text));
+				if (i % 5 == 4) text.push_back(u' ');
+			}
+		}
+		size_t sum = 0;
+		u16string lowered;
+		for (size_t b = 0, e; b < text.size(); b = e + 1)
+		{
+			e = min(text.find(u' ', b), text.size());
+			lowered.clear();
+			toLower16(text.begin() + b, text.begin() + e, back_inserter(lowered));
+			sum += lowered.size();
+		}
+		return sum;
+	});
+
+	if (byRanges != byTable)
+	{
+		cout << "Mismatches in results!" << endl;
+		return 1;
+	}
+	return 0;
+}
+
+int benchPattern(Kiwi& kw, const BenchmarkInput& input)
+{
+	// 입력 문장에 URL, 이메일, 해시태그, 숫자 등이 섞인 웹 문서 형태의 문장을 더한다
+	mt19937 rng{ 42 };
+	const vector<u16string> fragments = {
+		u"https://github.com/bab2min/Kiwi", u"kiwi@example.com", u"#키위", u"@mention", u"2024-01-01",
+		u"1,234.5", u"U.S.A.", u"Kiwi", u"morphological", u"\U0001F44D", u"12:30", u"010-1234-5678",
+	};
+	vector<u16string> lines = input.lines;
+	for (size_t i = 0; i < input.lines.size(); ++i)
+	{
+		u16string line = input.lines[i];
+		for (size_t j = 0; j < 4; ++j)
+		{
+			const size_t p = line.empty() ? 0 : rng() % line.size();
+			line.insert(p, u" " + fragments[rng() % fragments.size()] + u" ");
+		}
+		lines.emplace_back(move(line));
+	}
+	size_t chrs = 0;
+	for (auto& line : lines) chrs += line.size();
+	const double kb = chrs * input.repeat / 1024.;
+
+	auto measure = [&](const char* name, const function<size_t(const u16string&)>& fn)
+	{
+		size_t checksum = 0;
+		tutils::Timer timer;
+		for (int r = 0; r < input.repeat; ++r)
+		{
+			for (auto& line : lines) checksum = checksum * 31 + fn(line);
+		}
+		const double tm = timer.getElapsed();
+		cout << name << ": " << tm << " ms, " << kb / (tm / 1000) << " Kchr/s" << endl;
+		return checksum;
+	};
+
+	const size_t byMatchPattern = measure("matchPattern", [](const u16string& line)
+	{
+		size_t sum = 0;
+		for (size_t n = 0; n < line.size();)
+		{
+			auto m = matchPattern(n ? line[n - 1] : u' ', line.data() + n, line.data() + line.size(), Match::all);
+			if (m.first)
+			{
+				sum = sum * 31 + n * 7 + m.first * 3 + (size_t)m.second;
+				n += m.first;
+			}
+			else ++n;
+		}
+		return sum;
+	});
+
+	size_t mismatches = 0;
+	for (auto arch : { ArchType::none, getSelectedArch(ArchType::default_) })
+	{
+		Vector<PatternSpan> spans;
+		const size_t byFindPatterns = measure((string{ "findPatterns (" } + archToStr(arch) + ")").c_str(), [&](const u16string& line)
+		{
+			spans.clear();
+			findPatterns(line.data(), line.size(), 0, Match::all, spans, arch);
+			size_t sum = 0;
+			for (auto& s : spans) sum = sum * 31 + s.begin * 7 + (s.end - s.begin) * 3 + (size_t)s.tag;
+			return sum;
+		});
+		if (byFindPatterns != byMatchPattern) ++mismatches;
+	}
+
+	if (mismatches)
+	{
+		cout << "Mismatches in results!" << endl;
+		return 1;
+	}
+	return 0;
+}
+
+int benchLongDocument(Kiwi& kw, const BenchmarkInput& input)
+{
+	// 입력 전체를 이어 붙인 문서를 여러 번 반복해 길이를 늘려가며, 분석 시간이 문서 길이에 비례하여 늘어나는지 확인한다
+	u16string unit;
+	for (auto& line : input.lines)
+	{
+		unit += line;
+		unit += u' ';
+	}
+
+	double baseline = 0;
+	for (size_t scale : { 1, 2, 4, 8 })
+	{
+		u16string doc;
+		for (size_t i = 0; i < scale; ++i) doc += unit;
+
+		tutils::Timer timer;
+		for (int r = 0; r < input.repeat; ++r)
+		{
+			kw.analyze(doc, 1, Match::allWithNormalizing);
+		}
+		const double tm = timer.getElapsed();
+		if (scale == 1) baseline = tm;
+		const double kb = input.bytes * scale * input.repeat / 1024.;
+		cout << "x" << scale << ": " << tm << " ms, " << kb / (tm / 1000) << " KB/s, "
+			<< tm / baseline << "x of x1 (linear: " << scale << "x)" << endl;
+	}
+	return 0;
+}
+
+int run(const string& modelPath, const string& benchName, bool sbg, int repeat, const vector<string>& files)
+{
+	const std::map<string, function<int(Kiwi&, const BenchmarkInput&)>> benchmarks = {
+		{ "top1", benchTop1 },
+		{ "lmmemo", benchLmMemo },
+		{ "pathmap", benchPathMap },
+		{ "trie", benchTrie },
+		{ "text", benchText },
+		{ "script", benchScript },
+		{ "pattern", benchPattern },
+		{ "longdoc", benchLongDocument },
+	};
+
+	try
+	{
+		auto it = benchmarks.find(benchName);
+		if (it == benchmarks.end())
+		{
+			throw runtime_error{ "unknown benchmark: " + benchName };
+		}
+
+		BenchmarkInput input;
+		input.repeat = max(repeat, 1);
+		for (auto& f : files)
+		{
+			ifstream in{ f };
+			if (!in)
+			{
+				throw runtime_error{ "cannot open file: " + f };
+			}
+
+			for (string line; getline(in, line);)
+			{
+				if (line.empty()) continue;
+				input.bytes += line.size();
+				input.lines.emplace_back(utf8To16(line));
+			}
+		}
+
+		tutils::Timer timer;
+		KiwiBuilder builder{ modelPath, 1, BuildOption::default_, sbg };
+		Kiwi kw = builder.build();
+		input.builder = &builder;
+		cout << "Kiwi v" << KIWI_VERSION_STRING << endl;
+		cout << "Loading Time : " << timer.getElapsed() << " ms" << endl;
+		cout << "ArchType : " << archToStr(kw.archType()) << endl;
+		cout << "ModelType : " << (sbg ? "sbg" : "knlm") << endl;
+		cout << "Input : " << input.lines.size() << " lines, " << (input.bytes / 1024.) << " KB x " << input.repeat << endl;
+		cout << "== " << benchName << " ==" << endl;
+		return it->second(kw, input);
+	}
+	catch (const exception& e)
+	{
+		cerr << e.what() << endl;
+		return -1;
+	}
+}
+
+using namespace TCLAP;
+
+int main(int argc, const char* argv[])
+{
+	tutils::setUTF8Output();
+
+	CmdLine cmd{ "Kiwi Benchmark", ' ', KIWI_VERSION_STRING };
+
+	ValueArg<string> model{ "m", "model", "Kiwi model path", true, "", "string" };
+	ValueArg<string> bench{ "b", "bench", "benchmark to run (top1, lmmemo, pathmap, trie, text, script, pattern, longdoc)", false, "top1", "string" };
+	ValueArg<int> repeat{ "r", "repeat", "number of repetitions", false, 3, "int > 0" };
+	SwitchArg sbg{ "", "sbg", "use SkipBigram" };
+	UnlabeledMultiArg<string> files{ "inputs", "input files", true, "string" };
+
+	cmd.add(model);
+	cmd.add(bench);
+	cmd.add(repeat);
+	cmd.add(sbg);
+	cmd.add(files);
+
+	try
+	{
+		cmd.parse(argc, argv);
+	}
+	catch (const ArgException& e)
+	{
+		cerr << "error: " << e.error() << " for arg " << e.argId() << endl;
+		return -1;
+	}
+	return run(model, bench, sbg, repeat, files.getValue());
+}
@@ -11,10 +11,37 @@
 using namespace std;
 using namespace kiwi;
 
+string beamToStr(const BeamOptions& beam)
+{
+	if (beam.unlimited()) return "unlimited";
+	string ret;
+	if (beam.maxStatesPerNode) ret += "states=" + to_string(beam.maxStatesPerNode) + " ";
+	if (beam.marginRatio < 1) ret += "margin=" + to_string(beam.marginRatio).substr(0, 4) + " ";
+	if (beam.chunkStateBudget) ret += "budget=" + to_string(beam.chunkStateBudget) + " ";
+	if (beam.adaptive) ret += "auto ";
+	ret.pop_back();
+	return ret;
+}
+
+/**
+ * @brief `--beam-sweep`에서 차례로 평가하는 빔 설정들
+ */
+vector<BeamOptions> beamSweepSettings()
+{
+	vector<BeamOptions> ret;
+	ret.emplace_back();
+	for (size_t s : { 64, 16, 8, 4, 2, 1 }) ret.emplace_back(BeamOptions{ s });
+	for (float m : { 0.75f, 0.5f, 0.25f }) ret.emplace_back(BeamOptions{ 0, m });
+	for (size_t b : { 4096, 1024, 256 }) ret.emplace_back(BeamOptions{ 0, 1.f, b });
+	ret.emplace_back(BeamOptions{ 0, 1.f, 0, true });
+	ret.emplace_back(BeamOptions{ 8, 1.f, 0, true });
+	return ret;
+}
+
 int doEvaluate(const string& modelPath, const string& output, const vector<string>& input, 
 	bool normCoda, bool zCoda, bool multiDict, bool useSBG, 
 	float typoCostWeight, bool bTypo, bool cTypo,
-	int repeat)
+	int repeat, const vector<BeamOptions>& beams)
 {
 	try
 	{
@@ -42,58 +69,81 @@ int doEvaluate(const string& modelPath, const string& output, const vector<strin
 		cout << "LM Size : " << (kw.getKnLM()->getMemory().size() / 1024. / 1024.) << " MB" << endl;
 		cout << "Mem Usage : " << (tutils::getCurrentPhysicalMemoryUsage() / 1024.) << " MB\n" << endl;
 		
-		double avgMicro = 0, avgMacro = 0;
-		double cnt = 0;
-		for (auto& tf : input)
+		struct SweepResult
+		{
+			double micro, macro, timePerLine;
+		};
+		vector<SweepResult> sweep;
+		for (auto& beam : beams)
 		{
-			cout << "Test file: " << tf << endl;
-			try
+			kw.setBeamOptions(beam);
+			if (beams.size() > 1 || !beam.unlimited()) cout << "Beam : " << beamToStr(beam) << endl;
+			double avgMicro = 0, avgMacro = 0, totalTime = 0;
+			size_t totalLines = 0;
+			double cnt = 0;
+			for (auto& tf : input)
 			{
-				Evaluator test{ tf, &kw, (normCoda ? Match::allWithNormalizing : Match::all) & ~(zCoda ? Match::none : Match::zCoda) };
-				tutils::Timer total;
-				for (int i = 0; i < repeat; ++i)
+				cout << "Test file: " << tf << endl;
+				try
 				{
-					test.run();
-				}
-				double tm = total.getElapsed() / repeat;
-				auto result = test.evaluate();
+					Evaluator test{ tf, &kw, (normCoda ? Match::allWithNormalizing : Match::all) & ~(zCoda ? Match::none : Match::zCoda) };
+					tutils::Timer total;
+					for (int i = 0; i < repeat; ++i)
+					{
+						test.run();
+					}
+					double tm = total.getElapsed() / repeat;
+					auto result = test.evaluate();
 
-				cout << result.micro << ", " << result.macro << endl;
-				cout << "Total (" << result.totalCount << " lines) Time : " << tm << " ms" << endl;
-				cout << "Time per Line : " << tm / result.totalCount << " ms" << endl;
+					cout << result.micro << ", " << result.macro << endl;
+					cout << "Total (" << result.totalCount << " lines) Time : " << tm << " ms" << endl;
+					cout << "Time per Line : " << tm / result.totalCount << " ms" << endl;
 
-				avgMicro += result.micro;
-				avgMacro += result.macro;
-				cnt++;
+					avgMicro += result.micro;
+					avgMacro += result.macro;
+					totalTime += tm;
+					totalLines += result.totalCount;
+					cnt++;
 
-				if (!output.empty())
-				{
-					const size_t last_slash_idx = tf.find_last_of("\\/");
-					string name;
-					if (last_slash_idx != tf.npos) name = tf.substr(last_slash_idx + 1);
-					else name = tf;
-
-					ofstream out{ output + "/" + name };
-					out << result.micro << ", " << result.macro << endl;
-					out << "Total (" << result.totalCount << ") Time : " << tm << " ms" << endl;
-					out << "Time per Unit : " << tm / result.totalCount << " ms" << endl;
-					for (auto t : test.getErrors())
+					if (!output.empty())
 					{
-						t.writeResult(out);
+						const size_t last_slash_idx = tf.find_last_of("\\/");
+						string name;
+						if (last_slash_idx != tf.npos) name = tf.substr(last_slash_idx + 1);
+						else name = tf;
+
+						ofstream out{ output + "/" + name };
+						out << result.micro << ", " << result.macro << endl;
+						out << "Total (" << result.totalCount << ") Time : " << tm << " ms" << endl;
+						out << "Time per Unit : " << tm / result.totalCount << " ms" << endl;
+						for (auto t : test.getErrors())
+						{
+							t.writeResult(out);
+						}
 					}
+					cout << "================" << endl;
+				}
+				catch (const std::exception& e)
+				{
+					cerr << e.what() << endl;
 				}
-				cout << "================" << endl;
 			}
-			catch (const std::exception& e)
+
+			cout << endl << "================" << endl;
+			cout << "Avg Score" << endl;
+			cout << avgMicro / cnt << ", " << avgMacro / cnt << endl;
+			cout << "================" << endl;
+			sweep.emplace_back(SweepResult{ avgMicro / cnt, avgMacro / cnt, totalTime / max(totalLines, (size_t)1) });
+		}
+
+		if (beams.size() > 1)
+		{
+			cout << endl << "Beam\tMicro\tMacro\tTime per Line (ms)" << endl;
+			for (size_t i = 0; i < beams.size(); ++i)
 			{
-				cerr << e.what() << endl;
+				cout << beamToStr(beams[i]) << '\t' << sweep[i].micro << '\t' << sweep[i].macro << '\t' << sweep[i].timePerLine << endl;
 			}
 		}
-
-		cout << endl << "================" << endl;
-		cout << "Avg Score" << endl;
-		cout << avgMicro / cnt << ", " << avgMacro / cnt << endl;
-		cout << "================" << endl;
 		return 0;
 	}
 	catch (const exception& e)
@@ -119,6 +169,11 @@ int main(int argc, const char* argv[])
 	SwitchArg bTypo{ "", "btypo", "make basic-typo-tolerant model", false };
 	SwitchArg cTypo{ "", "ctypo", "make continual-typo-tolerant model", false };
 	ValueArg<int> repeat{ "", "repeat", "repeat evaluation for benchmark", false, 1, "int" };
+	ValueArg<size_t> maxStates{ "", "max-states", "max number of paths kept per node", false, 0, "int" };
+	ValueArg<float> margin{ "", "margin", "score margin relative to the cut-off threshold, in (0, 1]", false, 1.f, "float" };
+	ValueArg<size_t> stateBudget{ "", "state-budget", "max number of paths kept per chunk", false, 0, "int" };
+	SwitchArg autoBeam{ "", "auto-beam", "narrow the beam on long or ambiguous chunks", false };
+	SwitchArg beamSweep{ "", "beam-sweep", "evaluate a preset list of beam settings and print accuracy/speed for each", false };
 	UnlabeledMultiArg<string> files{ "files", "evaluation set files", true, "string" };
 
 	cmd.add(model);
@@ -132,6 +187,11 @@ int main(int argc, const char* argv[])
 	cmd.add(bTypo);
 	cmd.add(cTypo);
 	cmd.add(repeat);
+	cmd.add(maxStates);
+	cmd.add(margin);
+	cmd.add(stateBudget);
+	cmd.add(autoBeam);
+	cmd.add(beamSweep);
 
 	try
 	{
@@ -142,7 +202,10 @@ int main(int argc, const char* argv[])
 		cerr << "error: " << e.error() << " for arg " << e.argId() << endl;
 		return -1;
 	}
+	vector<BeamOptions> beams;
+	if (beamSweep) beams = beamSweepSettings();
+	else beams.emplace_back(BeamOptions{ maxStates, margin, stateBudget, autoBeam });
 	return doEvaluate(model, output, files.getValue(), 
-		!noNormCoda, !noZCoda, !noMulti, useSBG, typoWeight, bTypo, cTypo, repeat);
+		!noNormCoda, !noZCoda, !noMulti, useSBG, typoWeight, bTypo, cTypo, repeat, beams);
 }
 
@@ -8,19 +8,31 @@
 using namespace std;
 using namespace kiwi;
 
-int run(const KiwiBuilder::ModelBuildArgs& args, const string& output, bool skipBigram)
+int run(const KiwiBuilder::ModelBuildArgs& args, const string& output, bool skipBigram, bool runtimeLayout, const string& runtimeOutput)
 {
 	try
 	{
 		tutils::Timer timer;
 		if (skipBigram)
 		{
+			// 모델을 mmap으로 연 채로 같은 파일을 덮어쓰면 읽는 도중에 파일이 잘리므로 별도의 경로에 저장한다.
+			if (runtimeLayout && (runtimeOutput.empty() || runtimeOutput == output))
+			{
+				throw invalid_argument{ "`--runtime_output` must be a directory different from `--output` when building skipbigram model with `--runtime_layout`" };
+			}
 			cout << "Build SkipBigram model based on KnLM: " << output << endl;
-			KiwiBuilder kb{ output, args };
+			{
+				KiwiBuilder kb{ output, args };
+			}
+			if (runtimeLayout)
+			{
+				cout << "Save the runtime layout: " << runtimeOutput << endl;
+				KiwiBuilder{ output, 0, BuildOption::none, true }.saveModel(runtimeOutput, true);
+			}
 		}
 		else
 		{
-			KiwiBuilder{ args }.saveModel(output);
+			KiwiBuilder{ args }.saveModel(output, runtimeLayout);
 		}
 		double tm = timer.getElapsed();
 		cout << "Total: " << tm << " ms " << endl;
@@ -46,12 +58,14 @@ int main(int argc, const char* argv[])
 	SwitchArg quantize{ "", "quantize", "quantize LM" };
 	SwitchArg tagHistory{ "", "history", "use tag history of LM" };
 	SwitchArg skipBigram{ "", "skipbigram", "build skipbigram model" };
+	SwitchArg runtimeLayout{ "", "runtime_layout", "save LM (and skipbigram model) in the runtime layout for the current architecture" };
 	ValueArg<size_t> workers{ "w", "workers", "number of workers", false, 1, "int" };
 	ValueArg<size_t> morMinCnt{ "", "morpheme_min_cnt", "min count of morpheme", false, 10, "int" };
 	ValueArg<size_t> lmOrder{ "", "order", "order of LM", false, 4, "int" };
 	ValueArg<size_t> lmMinCnt{ "", "min_cnt", "min count of LM", false, 1, "int" };
 	ValueArg<size_t> lmLastOrderMinCnt{ "", "last_min_cnt", "min count of the last order of LM", false, 2, "int" };
 	ValueArg<string> output{ "o", "output", "output model path", true, "", "string" };
+	ValueArg<string> runtimeOutput{ "", "runtime_output", "path to save the runtime layout of skipbigram model (must differ from output)", false, "", "string" };
 	UnlabeledMultiArg<string> inputs{ "inputs", "input copora", true, "string" };
 
 	cmd.add(output);
@@ -61,6 +75,8 @@ int main(int argc, const char* argv[])
 	cmd.add(quantize);
 	cmd.add(tagHistory);
 	cmd.add(skipBigram);
+	cmd.add(runtimeLayout);
+	cmd.add(runtimeOutput);
 	cmd.add(morMinCnt);
 	cmd.add(lmOrder);
 	cmd.add(lmMinCnt);
@@ -87,6 +103,6 @@ int main(int argc, const char* argv[])
 	args.lmMinCnt = lmMinCnt;
 	args.lmLastOrderMinCnt = lmLastOrderMinCnt;
 	args.numWorkers = workers;
-	return run(args, output, skipBigram);
+	return run(args, output, skipBigram, runtimeLayout, runtimeOutput);
 }
 